@@ -0,0 +1,764 @@
+// ENGINEER_OLD.CPP Rev: 10/19/26.
+// The switch-based Legacy/TMCC encoder from just before the table-driven one, kept here (renamed Engineer_Old) so
+// Test_Engineer_Encoding.cpp can compare the two byte for byte.  Only translateToTMCC(), translateToLegacy() and the
+// checksum/range helpers they call are kept; the function bodies are exactly as they were in libraries/Engineer/Engineer.cpp.
+// Nothing else in the tree uses this, so it won't follow later changes to Engineer; that's the point.
+
+#include "Engineer_Old.h"
+
+Engineer_Old::legacyCommandStruct Engineer_Old::translateToTMCC(byte t_devNum, byte t_devCommand, byte t_devParm1, byte t_devParm2) {
+  // Rev: 05/04/24.
+  // Populate a Legacy (actually TMCC) command buffer, 3- or 6-bytes long.
+  // It's necessary to prefix this return type with "Engineer_Old::" because it's a private struct.
+  // Only gets called when t_devType = TMCC Engine or Train; other device types handled by other functions.
+  // Translate a Delayed Action "plain English" command into a TMCC 3- or 6-byte command.
+  // We'll use our class global 9-byte struct variable m_legacyCommandRecord to hold our calculated TMCC command bytes.
+  // Remember, bytes 1..9 are element 0..8!
+  // The following TMCC Engine/Train commands (t_devCommand) are supported:
+  //   * LEGACY_ACTION_EMERG_STOP
+  //   * LEGACY_ACTION_ABS_SPEED
+  //   * LEGACY_ACTION_STOP_IMMED (treated as Abs Speed = 0)
+  //   * LEGACY_ACTION_FORWARD
+  //   * LEGACY_ACTION_REVERSE
+  //   * LEGACY_ACTION_FRONT_COUPLER
+  //   * LEGACY_ACTION_REAR_COUPLER
+  //   * LEGACY_SOUND_HORN_NORMAL
+  //   * LEGACY_SOUND_BELL_ON, LEGACY_SOUND_BELL_OFF: Future.  Not sure how they work as there is only one Bell command in TMCC.
+  //   * TMCC_DIALOGUE, StationSounds Diner dialogue commands specified as t_devParm1:
+  //     * TMCC_DIALOGUE_STATION_ARRIVAL         When STOPPED: PA announcement i.e. "The Daylight is now arriving."
+  //     * TMCC_DIALOGUE_STATION_DEPARTURE       When STOPPED: PA announcement i.e. "The Daylight is now departing."
+  //     * TMCC_DIALOGUE_CONDUCTOR_ARRIVAL       When STOPPED: Conductor says i.e. "Watch your step."
+  //     * TMCC_DIALOGUE_CONDUCTOR_DEPARTURE     When STOPPED: Conductor says i.e. "Watch your step." then "All aboard!"
+  //     * TMCC_DIALOGUE_CONDUCTOR_TICKETS_DINER When MOVING: Conductor says "Welcome aboard/Tickets please/1st seating."
+  //     * TMCC_DIALOGUE_CONDUCTOR_STOPPING      When MOVING: Conductor says "Next stop coming up."
+  // NOTE: The above commands are LEGACY_* constants because they're just the "plain English" version of the commands, such as
+  //       LEGACY_ACTION_ABS_SPEED.  Based on the device type (Legacy vs TMCC) we'll call the appropriate "translateToXXX"
+  //       function (here), which by virtue of being called knows what type of device (Legacy vs TMCC, though we'll have to look it
+  //       up in Loco Ref in order to differentiate between Engine vs Train.)
+  //       I'm not clear, as of 5/4/24, how TMCC_DIALOGUE will be specified in Delayed Action, because unlike the rest of the above
+  //       commands, the Conductor (whoever populates Delayed Action) would need to know that it's talking to a TMCC device vs a
+  //       Legacy device.  Of course at this point, ALL StationSounds diner cars, and other devices with dialogue, will be TMCC.
+  // NOTE: I don't think we need to support the TMCC Momentum commands (Low/Med/High -- there is no "off") because momentum is
+  //       handled by the Legacy remote.  I.e. when you set momentum, you see successive speed commands coming from the remote, not
+  //       a single speed command sent to loco and then the loco slows down on its own.  Ditto with Legacy Momentum.
+
+  // First confirm that we have a valid device type and number...
+  byte t_devType;  // Will be TMCC eNgine or tRain (N/R)
+  t_devType = m_pLoco->devType(t_devNum);  // N|R else bug in database
+  // We should only be sent commands for TMCC Engines or Trains so confirm this:
+  if (outOfRangeTMCCDevType(t_devType)) {
+    sprintf(lcdString, "ENG'R TMCC DT ERR!"); pLCD2004->println(lcdString); Serial.println(lcdString); endWithFlashingLED(5);
+  }
+  // TMCC train num can be 1..9, engine num can be 1..50.
+  if (t_devCommand != LEGACY_ACTION_EMERG_STOP) {
+    if (outOfRangeDevNum(t_devType, t_devNum)) {
+      sprintf(lcdString, "ENG'R TMCC DN ERROR!"); pLCD2004->println(lcdString); Serial.println(lcdString); endWithFlashingLED(5);
+    }
+  }
+
+  // Clear out all nine bytes...even though TMCC can use at most 6.
+  for (byte j = 0; j < LEGACY_CMD_BYTES; j++) {  // Always 9 bytes, 0..8
+    m_legacyCommandRecord.legacyCommandByte[j] = 0;
+  }
+
+  // We ALWAYS know what byte 0 will be for TMCC:
+  m_legacyCommandRecord.legacyCommandByte[0] = 0xFE;  // 254
+
+  // We ALWAYS know what byte 1 (second byte) will be for TMCC (except emergency stop, which we'll override when needed)
+  // 05/05/24: HERE IS AN ALTERNATIVE WAY TO BUILD THE SECOND TMCC COMMAND BYTE:
+  // Byte is combination of device type field and first 7 bit of TMCC address:
+  // If TMCC Engine, binaryDeviceType = 0x00.  If TMCC Train, binaryDeviceType = 0xC8.
+  //   m_legacyCommandRecord.legacyCommandByte[1] = (binaryDeviceType | (t_devNum >> 1));
+  if (t_devType == DEV_TYPE_TMCC_ENGINE) {
+    // Bit pattern is 00AA AAAA:
+    //   AA AAAA is everything except the right-most bit of the device number.
+    m_legacyCommandRecord.legacyCommandByte[1] = (t_devNum >> 1);
+  } else {  // Must be TMCC Train
+    // Bit pattern is 1100 1AAA:
+    //   AAA is everything except the right-most bit of the device number.
+    // Hence, it's the same as for a TMCC Engine, except we need to add 1100 1000 which is 0xC8.
+    m_legacyCommandRecord.legacyCommandByte[1] = (0xC8 + (t_devNum >> 1));  // 0xC8 = binary 1100 1000
+  }
+
+  // Byte 2 (third byte) of any TMCC command is the same regardless if this is for an Engine or a Train.
+  // Bit pattern is ACCD DDDD:
+  //   A is the right-most bit of the device number (t_locoNum)
+  //   CC is the two-bit command category -- usually 00, but 01 for momentum commands and 11 for speed commands.
+  //   D DDDD command number, such as 1 1100 for "Blow Horn."
+  // If CC = 00, then add 0x00 = 0000 (all commands except momentum and absolute speed.)
+  // If CC = 01, then add 0x02 = 0010 (momentum commands.)
+  // If CC = 11, then add 0x06 = 0110 (speed commands.)
+  // There are no Command Categories of 10.
+  // 05/05/24: HERE IS AN ALTERNATIVE WAY TO BUILD THE THIRD TMCC COMMAND BYTE (using bitwise OR, rather than addition.)
+  // Byte 3 is last bit of TMCC address, command field (2 bits), plus data field:
+  //   m_legacyCommandRecord.legacyCommandByte[2] = ((t_devNum << 7) | (commandField << 5) | dataField);
+
+  switch (t_devCommand) {
+
+    case LEGACY_ACTION_EMERG_STOP:     //  We'll do System Halt which turns off PowerMasters too!
+    {
+      m_legacyCommandRecord.legacyCommandByte[1] = 0xFF;
+      m_legacyCommandRecord.legacyCommandByte[2] = 0xFF;
+      break;
+    }
+
+    case LEGACY_ACTION_ABS_SPEED:      // Requires Parm1 0..31
+    {
+      // Speed can be 0..31 for TMCC
+      if (outOfRangeLocoSpeed(t_devType, t_devParm1)) {
+        sprintf(lcdString, "ENG'R TMCC SPD ERR!"); pLCD2004->println(lcdString); Serial.println(lcdString); endWithFlashingLED(5);
+      }
+      // First put the right-most bit of t_devNum as the left-most  bit of byte #3: X000 0000
+      m_legacyCommandRecord.legacyCommandByte[2] = (t_devNum << 7);
+      // For speed commands, the command bits are 11: 0110 0000
+      m_legacyCommandRecord.legacyCommandByte[2] += 0x60;  // Adding binary 0110 0000 = 0x60
+      // Plus the 5-bit speed 0..31.
+      m_legacyCommandRecord.legacyCommandByte[2] += t_devParm1;
+      break;
+    }
+
+    case LEGACY_ACTION_STOP_IMMED:      // We'll treat this as Abs Speed 0 for TMCC
+    {
+      // First put the right-most bit of t_devNum as the left-most  bit of byte #3: X000 0000
+      m_legacyCommandRecord.legacyCommandByte[2] = (t_devNum << 7);
+      // For speed commands, the command bits are 11: 0110 0000
+      m_legacyCommandRecord.legacyCommandByte[2] += 0x60;  // Adding binary 0110 0000 = 0x60
+      // Plus the 5-bit speed, which is zero, so we'll skip this step.
+      break;
+    }
+
+    case LEGACY_ACTION_FORWARD:
+    {
+      // First put the right-most bit of t_devNum as the left-most  bit of byte #3: X000 0000
+      m_legacyCommandRecord.legacyCommandByte[2] = (t_devNum << 7);
+      // For Forward, the rest of the third byte is zero, so nothing more to do.
+      break;
+    }
+
+    case LEGACY_ACTION_REVERSE:
+    {
+      // First put the right-most bit of t_devNum as the left-most  bit of byte #3: X000 0000
+      m_legacyCommandRecord.legacyCommandByte[2] = (t_devNum << 7);
+      // For Reverse, just add 0x03 to the third byte.
+      m_legacyCommandRecord.legacyCommandByte[2] += 0x03;  // Adding binary 0000 0011 = 0x03
+      break;
+    }
+
+    case LEGACY_ACTION_FRONT_COUPLER:
+    {
+      // First put the right-most bit of t_devNum as the left-most  bit of byte #3: X000 0000
+      m_legacyCommandRecord.legacyCommandByte[2] = (t_devNum << 7);
+      // For Front Coupler, just add 0x05 to the third byte.
+      m_legacyCommandRecord.legacyCommandByte[2] += 0x05;  // Adding binary 0000 0101 = 0x05
+      break;
+    }
+
+    case LEGACY_ACTION_REAR_COUPLER:
+    {
+      // First put the right-most bit of t_devNum as the left-most  bit of byte #3: X000 0000
+      m_legacyCommandRecord.legacyCommandByte[2] = (t_devNum << 7);
+      // For Rear Coupler, just add 0x06 to the third byte.
+      m_legacyCommandRecord.legacyCommandByte[2] += 0x06;  // Adding binary 0000 0110 = 0x06
+      break;
+    }
+
+    case LEGACY_SOUND_HORN_NORMAL:
+    {
+      // First put the right-most bit of t_devNum as the left-most  bit of byte #3: X000 0000
+      m_legacyCommandRecord.legacyCommandByte[2] = (t_devNum << 7);
+      // For Horn, add 0x1C to the third byte.
+      m_legacyCommandRecord.legacyCommandByte[2] += 0x1C;  // Adding binary 0001 1100 = 0x1C
+      break;
+    }
+
+    case LEGACY_SOUND_BELL_ON:
+    case LEGACY_SOUND_BELL_OFF:
+    {
+      // Unsupported but not an error.  Not sure what Bell Off would even do.  Treat it as "Ring Bell"
+      // First put the right-most bit of t_devNum as the left-most  bit of byte #3: X000 0000
+      m_legacyCommandRecord.legacyCommandByte[2] = (t_devNum << 7);
+      // For Bell, add 0x1D to the third byte.
+      m_legacyCommandRecord.legacyCommandByte[2] += 0x1D;  // Adding binary 0001 1101 = 0x1D
+        break;
+    }
+
+    case TMCC_DIALOGUE:
+      {
+        // For "TMCC_DIALOGUE", which is for StationSounds Diner cars, t_devParm1 must specify which of the six supported dialogues are
+        // wanted.  Some of these TMCC StationSounds Diner commands are 3 bytes (single keypad numeric key press), and some are 6 bytes
+        // (combo numberic key press of Alt-1 + a numberic.)
+        // NOTE: All of my StationSounds Diners are TMCC; no need for Legacy StationSounds support at this time.
+        // These are either 3-byte or 6 bytes commands.
+        // TMCC STATIONSOUNDS DINER DIALOGUE COMMANDS specified as Parm1:
+        //   TMCC_DIALOGUE_STATION_ARRIVAL         = 1;  // 6 bytes: Aux1+7. When STOPPED: PA announcement i.e. "The Daylight is now arriving."
+        //   TMCC_DIALOGUE_STATION_DEPARTURE       = 2;  // 3 bytes: 7.      When STOPPED: PA announcement i.e. "The Daylight is now departing."
+        //   TMCC_DIALOGUE_CONDUCTOR_ARRIVAL       = 3;  // 6 bytes: Aux1+2. When STOPPED: Conductor says i.e. "Watch your step."
+        //   TMCC_DIALOGUE_CONDUCTOR_DEPARTURE     = 4;  // 3 bytes: 2.      When STOPPED: Conductor says i.e. "Watch your step." then "All aboard!"
+        //   TMCC_DIALOGUE_CONDUCTOR_TICKETS_DINER = 5;  // 3 bytes: 2.      When MOVING: Conductor says "Welcome aboard/Tickets please/1st seating."
+        //   TMCC_DIALOGUE_CONDUCTOR_STOPPING      = 6;  // 6 bytes: Aux1+2. When MOVING: Conductor says "Next stop coming up."
+        // So there are FOUR unique possible commands.
+        if (outOfRangeTMCCDialogueNum(t_devParm1)) {  // Must be 1..6
+          sprintf(lcdString, "ENG TMCC BAD DIALOG!"); pLCD2004->println(lcdString); Serial.println(lcdString); endWithFlashingLED(5);
+        }
+
+        // Regardless if it's a 3-byte or a 6-byte TMCC command, bytes 1 and 2 (and 4 and 5 if used) will always be the same.
+        // So we could compress this code, but for readability we're going to assign every byte in every switch-case block.
+        switch (t_devParm1) {  // Which of the six dialogues are desired?
+
+          case TMCC_DIALOGUE_STATION_ARRIVAL:  // 2 bytes: Aux1 + 7
+            {
+              m_legacyCommandRecord.legacyCommandByte[2] = (t_devNum << 7) + 0x09;  // Aux button; same for Train vs Engine.
+              // Since this is a 6-byte command, keep going...
+              m_legacyCommandRecord.legacyCommandByte[3] = m_legacyCommandRecord.legacyCommandByte[0];
+              m_legacyCommandRecord.legacyCommandByte[4] = m_legacyCommandRecord.legacyCommandByte[1];
+              m_legacyCommandRecord.legacyCommandByte[5] = (t_devNum << 7) + 0x17;  // 0x17 = digit 7 on keypad
+              break;
+            }
+
+          case TMCC_DIALOGUE_STATION_DEPARTURE:  // 1 byte: 7
+            {
+              m_legacyCommandRecord.legacyCommandByte[2] = (t_devNum << 7) + 0x17;  // 0x17 = digit 7 on keypad
+              break;
+            }
+
+          case TMCC_DIALOGUE_CONDUCTOR_ARRIVAL:   // 2 bytes: Aux1 + 2
+          case TMCC_DIALOGUE_CONDUCTOR_STOPPING:  // 2 bytes: Aux1 + 2
+            {
+              m_legacyCommandRecord.legacyCommandByte[2] = (t_devNum << 7) + 0x09;  // Aux button; same for Train vs Engine.
+              // Since this is a 6-byte command, keep going...
+              m_legacyCommandRecord.legacyCommandByte[3] = m_legacyCommandRecord.legacyCommandByte[0];
+              m_legacyCommandRecord.legacyCommandByte[4] = m_legacyCommandRecord.legacyCommandByte[1];
+              m_legacyCommandRecord.legacyCommandByte[5] = (t_devNum << 7) + 0x12;  // 0x12 = digit 2 on keypad
+              break;
+            }
+
+          case TMCC_DIALOGUE_CONDUCTOR_DEPARTURE:      // 1 byte: 2
+          case TMCC_DIALOGUE_CONDUCTOR_TICKETS_DINER:  // 1 byte: 2
+            {
+              m_legacyCommandRecord.legacyCommandByte[2] = (t_devNum << 7) + 0x12;  // 0x12 = digit 2 on keypad
+              break;
+            }
+
+          default:  // Bad news if we get here; it means none of the TMCC dialogues was what we passed
+            {
+              sprintf(lcdString, "ENG'R TMCC DLG ERR!"); pLCD2004->println(lcdString); Serial.println(lcdString); endWithFlashingLED(5);
+            }
+        }  // End of switch "which of the six TMCC Dialogue commands are we decoding?"
+      }  // End of "it's a TMCC Dialogue command"
+
+    default:  // Uh oh, we didn't recognize the command
+      {
+        sprintf(lcdString, "ENG'R TMCC BAD CMD!"); pLCD2004->println(lcdString); Serial.println(lcdString); endWithFlashingLED(5);
+      }
+
+  }  // End of "which device command were we sent to decode?"
+
+  // Okay, we have populated m_legacyCommandRecord[] with the appropriate TMCC command; either 3 or 6 bytes.
+  if (m_debugOn) {
+    sprintf(lcdString, "TCMD %c %i %i", t_devType, t_devNum, t_devParm1); Serial.println(lcdString);
+    sprintf(lcdString, "%X %X %X", m_legacyCommandRecord.legacyCommandByte[0], m_legacyCommandRecord.legacyCommandByte[1],
+            m_legacyCommandRecord.legacyCommandByte[2]); Serial.println(lcdString);
+  }
+  return m_legacyCommandRecord;  // We're done with TMCC so exit this function
+
+}
+
+Engineer_Old::legacyCommandStruct Engineer_Old::translateToLegacy(byte t_devNum, byte t_devCommand, byte t_devParm1, byte t_devParm2) {
+  // Rev: 05/24/24.
+  // Populate a Legacy command buffer, 3- to 9-bytes long.
+  // It's necessary to prefix this return type with "Engineer_Old::" because it's a private struct.
+  // Only gets called when t_devType = Legacy Engine or Train; other device types handled by other functions.
+  // Translate a Delayed Action "plain English" command into a Legacy 3-, 6-, or 9-byte command.
+  // We'll use our class global 9-byte struct variable m_legacyCommandRecord to hold our calculated Legacy command bytes.
+  // Remember, bytes 1..9 are element 0..8!
+  // The following Legacy Engine/Train commands (t_devCommand) are supported:
+  //   * LEGACY_ACTION_STARTUP_SLOW
+  //   * LEGACY_ACTION_STARTUP_FAST
+  //   * LEGACY_ACTION_SHUTDOWN_SLOW
+  //   * LEGACY_ACTION_SHUTDOWN_FAST
+  //   * LEGACY_ACTION_SET_SMOKE      (9-byte command)
+  //   * LEGACY_ACTION_EMERG_STOP
+  //   * LEGACY_ACTION_ABS_SPEED (includes support for PowerMaster 91..94 on/off as speed 1/0.)
+  //   * LEGACY_ACTION_MOMENTUM_OFF
+  //   * LEGACY_ACTION_STOP_IMMED
+  //   * LEGACY_ACTION_FORWARD
+  //   * LEGACY_ACTION_REVERSE
+  //   * LEGACY_ACTION_FRONT_COUPLER
+  //   * LEGACY_ACTION_REAR_COUPLER
+  //   * LEGACY_SOUND_HORN_NORMAL
+  //   * LEGACY_SOUND_HORN_QUILLING  Requires intensity 0..15
+  //   * LEGACY_SOUND_REFUEL   With minor dialogue.  Nothing on SP 1440.  Steam only??? *******************
+  //   * LEGACY_SOUND_DIESEL_RPM Diesel only. Requires Parm 0..7
+  //   * LEGACY_SOUND_WATER_INJECT  Steam only.
+  //   * LEGACY_SOUND_ENGINE_LABOR  Diesel only?  Barely discernable on SP 1440. *******************
+  //   * LEGACY_SOUND_BELL_OFF
+  //   * LEGACY_SOUND_BELL_ON
+  //   * LEGACY_SOUND_BRAKE_SQUEAL    Only works when moving.  Short chirp.
+  //   * LEGACY_SOUND_AUGER           Steam only.
+  //   * LEGACY_SOUND_AIR_RELEASE     Can barely hear.  Not sure if it works on steam as well as diesel? **************
+  //   * LEGACY_SOUND_LONG_LETOFF     Diesel and (presumably) steam. Long hiss. *****************
+  //   * LEGACY_SOUND_MSTR_VOL_UP     There are 10 possible volumes (9 excluding "off") i.e. 0..9.
+  //   * LEGACY_SOUND_MSTR_VOL_DOWN   No way to go directly to a master vol level, so we must step up/down as desired.
+  //   * LEGACY_SOUND_BLEND_VOL_UP    Tried this but wasn't able to get any response (same with 9-byte mstr vol up/down)
+  //   * LEGACY_SOUND_BLEND_VOL_DOWN  Tried this but wasn't able to get any response (same with 9-byte mstr vol up/down)
+  //   * LEGACY_SOUND_COCK_CLEAR_ON   Steam only. This is a 9-byte 0x74 Legacy Railsounds FX Trigger
+  //   * LEGACY_SOUND_COCK_CLEAR_OFF  Steam only. This is a 9-byte 0x74 Legacy Railsounds FX Trigger
+  //   * LEGACY_DIALOGUE              Separate function.  For any of 38 Legacy Dialogues, which will be passed as a parm.
+
+  // First confirm that we have a valid device type and number...
+  byte t_devType;  // Will be Legacy Engine or Train (E/T)
+  if ((t_devNum >= LOCO_ID_POWERMASTER_1) && (t_devNum <= LOCO_ID_POWERMASTER_4)) {
+    t_devType = DEV_TYPE_LEGACY_ENGINE;  // E
+  } else {  // Anything other than a PowerMaster look up -- better be DEV_TYPE_LEGACY_ENGINE or DEV_TYPE_LEGACY_TRAIN.
+    t_devType = m_pLoco->devType(t_devNum);  // E|T else bug in database
+  }
+  // We should only be sent commands for Legacy Engines or Trains so confirm this:
+  if (outOfRangeLegacyDevType(t_devType)) {
+    sprintf(lcdString, "ENG'R LEG DT ERR!"); pLCD2004->println(lcdString); Serial.println(lcdString); endWithFlashingLED(5);
+  }
+  // Loco engine and train nums can only be 1..50 (and PowerMasters 91.94), but ignore t_devNum for Emergency Stop.
+  if (t_devCommand != LEGACY_ACTION_EMERG_STOP) {
+    if (outOfRangeDevNum(t_devType, t_devNum)) {
+      sprintf(lcdString, "ENG'R LEG DN ERROR!"); pLCD2004->println(lcdString); Serial.println(lcdString); endWithFlashingLED(5);
+    }
+  }
+
+  // Clear out all nine bytes...so we can always check byte 4 (element 3) for 0 to see if it's a 3-byte, and also
+  // check byte 7 (element 6) for 0 to see if it's a 6-byte command, else it's a 9-byte command.
+  for (byte j = 0; j < LEGACY_CMD_BYTES; j++) {  // Always 9 bytes, 0..8
+    m_legacyCommandRecord.legacyCommandByte[j] = 0;
+  }
+
+  // We ALWAYS know what byte 0 will be, depending if it's a Legacy Engine vs Train, so we'll do that at the top:
+  if (t_devType == DEV_TYPE_LEGACY_ENGINE) {  // Legacy Engine
+    m_legacyCommandRecord.legacyCommandByte[0] = 0xF8;
+  } else {  // Can only be Legacy Train
+    m_legacyCommandRecord.legacyCommandByte[0] = 0xF9;
+  }
+
+  switch (t_devCommand) {
+
+    // Let's do the 3-byte Legacy commands first.
+    case LEGACY_ACTION_STARTUP_SLOW:   //
+      {
+        m_legacyCommandRecord.legacyCommandByte[1] = (t_devNum * 2) + 1;  // Shift left one bit, add 1
+        m_legacyCommandRecord.legacyCommandByte[2] = 0xFB;
+        break;
+      }
+
+    case LEGACY_ACTION_STARTUP_FAST:   //
+      {
+        m_legacyCommandRecord.legacyCommandByte[1] = (t_devNum * 2) + 1;  // Shift left one bit, add 1
+        m_legacyCommandRecord.legacyCommandByte[2] = 0xFC;
+        break;
+      }
+
+    case LEGACY_ACTION_SHUTDOWN_SLOW:  //
+      {
+        m_legacyCommandRecord.legacyCommandByte[1] = (t_devNum * 2) + 1;  // Shift left one bit, add 1
+        m_legacyCommandRecord.legacyCommandByte[2] = 0xFD;
+        break;
+      }
+
+    case LEGACY_ACTION_SHUTDOWN_FAST:  //
+      {
+        m_legacyCommandRecord.legacyCommandByte[1] = (t_devNum * 2) + 1;  // Shift left one bit, add 1
+        m_legacyCommandRecord.legacyCommandByte[2] = 0xFE;
+        break;
+      }
+
+    case LEGACY_ACTION_EMERG_STOP:     //  E-stop is actually F8/F9 + FF FF; we'll do System Halt instead turns off PowerMasters too!
+      {
+        m_legacyCommandRecord.legacyCommandByte[0] = 0xFE;
+        m_legacyCommandRecord.legacyCommandByte[1] = 0xFF;
+        m_legacyCommandRecord.legacyCommandByte[2] = 0xFF;
+        break;
+      }
+
+    case LEGACY_ACTION_ABS_SPEED:      // Requires Parm1 0..199
+      {
+        // Speed can be 0..199 for Legacy
+        if (outOfRangeLocoSpeed(t_devType, t_devParm1)) {
+          sprintf(lcdString, "ENG'R LEG SPD ERR!"); pLCD2004->println(lcdString); Serial.println(lcdString); endWithFlashingLED(5);
+        }
+        m_legacyCommandRecord.legacyCommandByte[1] = (t_devNum * 2);      // Shift loco num left one bit, add 0
+        m_legacyCommandRecord.legacyCommandByte[2] = t_devParm1;          // Absolute speed value 0..199
+        break;
+      }
+
+    case LEGACY_ACTION_MOMENTUM_OFF:   // We will never set Momentum to any value but zero.
+      {
+        byte t_momentum = 0;  // We can set momentum from 0..7 but in this case 0 = momentum OFF
+        m_legacyCommandRecord.legacyCommandByte[1] = (t_devNum * 2);      // Shift left one bit, add 0
+        m_legacyCommandRecord.legacyCommandByte[2] = 0xC8 + t_momentum;   // Parm1 better be 0..7
+        break;
+      }
+
+    case LEGACY_ACTION_STOP_IMMED:     // Prefer over Abs Spd 0 b/c overrides momentum if instant stop desired.
+      {
+        m_legacyCommandRecord.legacyCommandByte[1] = (t_devNum * 2);      // Shift left one bit, add 0
+        m_legacyCommandRecord.legacyCommandByte[2] = 0xFB;
+        break;
+      }
+
+    case LEGACY_ACTION_FORWARD:        // Delayed Action table command types
+      {
+        m_legacyCommandRecord.legacyCommandByte[1] = (t_devNum * 2) + 1;  // Shift left one bit, add 1
+        m_legacyCommandRecord.legacyCommandByte[2] = 0x00;
+        break;
+      }
+
+    case LEGACY_ACTION_REVERSE:        //
+      {
+        m_legacyCommandRecord.legacyCommandByte[1] = (t_devNum * 2) + 1;  // Shift left one bit, add 1
+        m_legacyCommandRecord.legacyCommandByte[2] = 0x03;
+        break;
+      }
+
+    case LEGACY_ACTION_FRONT_COUPLER:  //
+      {
+        m_legacyCommandRecord.legacyCommandByte[1] = (t_devNum * 2) + 1;  // Shift left one bit, add 1
+        m_legacyCommandRecord.legacyCommandByte[2] = 0x05;
+        break;
+      }
+
+    case LEGACY_ACTION_REAR_COUPLER:   //
+      {
+        m_legacyCommandRecord.legacyCommandByte[1] = (t_devNum * 2) + 1;  // Shift left one bit, add 1
+        m_legacyCommandRecord.legacyCommandByte[2] = 0x06;
+        break;
+      }
+
+    case LEGACY_NUMERIC_PRESS:
+      {
+        m_legacyCommandRecord.legacyCommandByte[1] = (t_devNum * 2) + 1;  // Shift left one bit, add 1
+        m_legacyCommandRecord.legacyCommandByte[2] = 0x10 + t_devParm1;   // Keypad digit 0..9
+        break;
+      }
+
+    case LEGACY_SOUND_HORN_NORMAL:     //
+      {
+        m_legacyCommandRecord.legacyCommandByte[1] = (t_devNum * 2) + 1;  // Shift left one bit, add 1
+        m_legacyCommandRecord.legacyCommandByte[2] = 0x1C;
+        break;
+      }
+
+    case LEGACY_SOUND_HORN_QUILLING:   // Requires intensity 0..15
+      {
+        if (outOfRangeQuill(t_devParm1)) {
+          sprintf(lcdString, "ENG'R QUILL ERROR!"); pLCD2004->println(lcdString); Serial.println(lcdString); endWithFlashingLED(5);
+        }
+        m_legacyCommandRecord.legacyCommandByte[1] = (t_devNum * 2) + 1;  // Shift left one bit, add 1
+        m_legacyCommandRecord.legacyCommandByte[2] = 0xE0 + t_devParm1;   // Parm1 better be 0..15
+        break;
+      }
+
+    case LEGACY_SOUND_REFUEL:          // With minor dialogue.  Nothing on SP 1440.  Steam only??? *******************
+      {
+        m_legacyCommandRecord.legacyCommandByte[1] = (t_devNum * 2) + 1;  // Shift left one bit, add 1
+        m_legacyCommandRecord.legacyCommandByte[2] = 0x2D;
+        break;
+      }
+
+    case LEGACY_SOUND_DIESEL_RPM:      // Diesel only. Requires Parm 0..7
+      {
+        if (outOfRangeRPM(t_devParm1)) {
+          sprintf(lcdString, "ENG'R RPM ERROR!"); pLCD2004->println(lcdString); Serial.println(lcdString); endWithFlashingLED(5);
+        }
+        m_legacyCommandRecord.legacyCommandByte[1] = (t_devNum * 2) + 1;  // Shift left one bit, add 1
+        m_legacyCommandRecord.legacyCommandByte[2] = 0xA0 + t_devParm1;   // Parm1 better be 0..7
+        break;
+      }
+
+    case LEGACY_SOUND_WATER_INJECT:    // Steam only.
+      {
+        m_legacyCommandRecord.legacyCommandByte[1] = (t_devNum * 2) + 1;  // Shift left one bit, add 1
+        m_legacyCommandRecord.legacyCommandByte[2] = 0xA8;
+        break;
+      }
+
+    case LEGACY_SOUND_ENGINE_LABOR:    // Diesel only?  Barely discernable on SP 1440. *******************
+      {
+        if (outOfRangeLabor(t_devParm1)) {
+          sprintf(lcdString, "ENG LABOR ERROR!"); pLCD2004->println(lcdString); Serial.println(lcdString); endWithFlashingLED(5);
+        }
+        m_legacyCommandRecord.legacyCommandByte[1] = (t_devNum * 2) + 1;  // Shift left one bit, add 1
+        m_legacyCommandRecord.legacyCommandByte[2] = 0xC0 + t_devParm1;   // Parm1 better be 0..31
+        break;
+      }
+
+    case LEGACY_SOUND_BELL_OFF:        //
+      {
+        m_legacyCommandRecord.legacyCommandByte[1] = (t_devNum * 2) + 1;  // Shift left one bit, add 1
+        m_legacyCommandRecord.legacyCommandByte[2] = 0xF4;
+        break;
+      }
+
+    case LEGACY_SOUND_BELL_ON:         //
+      {
+        m_legacyCommandRecord.legacyCommandByte[1] = (t_devNum * 2) + 1;  // Shift left one bit, add 1
+        m_legacyCommandRecord.legacyCommandByte[2] = 0xF5;
+        break;
+      }
+
+    case LEGACY_SOUND_BRAKE_SQUEAL:    // Only works when moving.  Short chirp.
+      {
+        m_legacyCommandRecord.legacyCommandByte[1] = (t_devNum * 2) + 1;  // Shift left one bit, add 1
+        m_legacyCommandRecord.legacyCommandByte[2] = 0xF6;
+        break;
+      }
+
+    case LEGACY_SOUND_AUGER:           // Steam only.
+      {
+        m_legacyCommandRecord.legacyCommandByte[1] = (t_devNum * 2) + 1;  // Shift left one bit, add 1
+        m_legacyCommandRecord.legacyCommandByte[2] = 0xF7;
+        break;
+      }
+
+    case LEGACY_SOUND_AIR_RELEASE:     // Can barely hear.  Not sure if it works on steam as well as diesel? **************
+      {
+        m_legacyCommandRecord.legacyCommandByte[1] = (t_devNum * 2) + 1;  // Shift left one bit, add 1
+        m_legacyCommandRecord.legacyCommandByte[2] = 0xF8;
+        break;
+      }
+
+    case LEGACY_SOUND_LONG_LETOFF:     // Diesel and (presumably) steam. Long hiss. *****************
+      {
+        m_legacyCommandRecord.legacyCommandByte[1] = (t_devNum * 2) + 1;  // Shift left one bit, add 1
+        m_legacyCommandRecord.legacyCommandByte[2] = 0xFA;
+        break;
+      }
+
+    // Now handle all of the 9-byte Legacy commands now...
+
+    case LEGACY_ACTION_SET_SMOKE:      // 0x7C FX Control Trigger requires parm 0x00..0x03 (Off/Low/Med/Hi)
+      {
+        if (outOfRangeSmoke(t_devParm1)) {
+          sprintf(lcdString, "ENG SMOKE ERROR!"); pLCD2004->println(lcdString); Serial.println(lcdString); endWithFlashingLED(5);
+        }
+        // Rev: 06/12/22
+        // Set Legacy loco smoke level to OFF, LOW, MED, or HIGH
+        // level: 0=Smoke OFF, 1=Smoke LOW, 2=Smoke MED, 3=Smoke HIGH
+        // This is a Legacy 9-byte Effects Control 0x7C
+        // *** WORD 1 of 3 ***  Already know m_legacyCommandRecord.legacyCommandByte[0] = 0xF8 or 0xF9
+        m_legacyCommandRecord.legacyCommandByte[1] = (t_devNum * 2) + 1;  // Shift loco num left one bit, add 1
+        m_legacyCommandRecord.legacyCommandByte[2] = 0x7C;  // Word 1 of 3, byte 3 = 0x7C (Effects Controls)
+        // *** WORD 2 of 3 ***
+        m_legacyCommandRecord.legacyCommandByte[3] = 0xFB;  // Legacy 2nd and 3rd set of 3-byte "words" ALWAYS start with FB
+        if (t_devType == 'E') {
+          m_legacyCommandRecord.legacyCommandByte[4] = (t_devNum * 2) + 0;  // Add 0 if we're addressing a Legacy Engine
+        } else {
+          m_legacyCommandRecord.legacyCommandByte[4] = (t_devNum * 2) + 1;  // Add 1 if we're addressing a Legacy Train
+        }
+        m_legacyCommandRecord.legacyCommandByte[5] = t_devParm1;  // Smoke off = 00, smoke Low/Med/High = 01/02/03
+        // *** WORD 3 of 3 ***
+        // For the third 3-byte word, the first two bytes of word 3 are always the same as the first two bytes of word 2
+        m_legacyCommandRecord.legacyCommandByte[6] = m_legacyCommandRecord.legacyCommandByte[3];
+        m_legacyCommandRecord.legacyCommandByte[7] = m_legacyCommandRecord.legacyCommandByte[4];
+        // Last byte is a one's complement checksum of 5 previous bytes: starting at zero: 1, 2, 4, 5, and 7.
+        m_legacyCommandRecord.legacyCommandByte[8] = legacyChecksum(m_legacyCommandRecord.legacyCommandByte[1], 
+                                                                    m_legacyCommandRecord.legacyCommandByte[2],
+                                                                    m_legacyCommandRecord.legacyCommandByte[4],
+                                                                    m_legacyCommandRecord.legacyCommandByte[5],
+                                                                    m_legacyCommandRecord.legacyCommandByte[7]);
+        break;
+      }
+
+    // We'll handle all six of the 0x74 Railsounds FX Triggers in one block, as only 1 byte differs among them...
+    case LEGACY_SOUND_MSTR_VOL_UP:     // 0x74 Railsounds FX Trigger There are 10 poss vols: 0..9.  Can't set specifically and couldn't tell what it affected (not main vol.)
+    case LEGACY_SOUND_MSTR_VOL_DOWN:   // 0x74 Railsounds FX Trigger No way to go directly to a master vol level.
+    case LEGACY_SOUND_BLEND_VOL_UP:    // 0x74 Railsounds FX Trigger.  Tried this but wasn't able to get any response (same with 9-byte mstr vol up/down)
+    case LEGACY_SOUND_BLEND_VOL_DOWN:  // 0x74 Railsounds FX Trigger.  Tried this but wasn't able to get any response (same with 9-byte mstr vol up/down)
+    case LEGACY_SOUND_COCK_CLEAR_ON:   // 0x74 Railsounds FX Trigger.  Steam only. This is a 9-byte 0x74 Legacy Railsounds FX Trigger
+    case LEGACY_SOUND_COCK_CLEAR_OFF:  // 0x74 Railsounds FX Trigger.  Steam only. This is a 9-byte 0x74 Legacy Railsounds FX Trigger
+      {
+        m_legacyCommandRecord.legacyCommandByte[1] = (t_devNum * 2) + 1;  // Shift loco num left one bit, add 1
+        m_legacyCommandRecord.legacyCommandByte[2] = 0x74;  // Word 1 of 3, byte 3 = 0x74 (Railsounds FX Triggers)
+        // *** WORD 2 of 3 ***
+        m_legacyCommandRecord.legacyCommandByte[3] = 0xFB;  // Legacy 2nd and 3rd set of 3-byte "words" ALWAYS start with FB
+        if (t_devType == 'E') {
+          m_legacyCommandRecord.legacyCommandByte[4] = (t_devNum * 2) + 0;  // Add 0 if we're addressing a Legacy Engine
+        } else {
+          m_legacyCommandRecord.legacyCommandByte[4] = (t_devNum * 2) + 1;  // Add 1 if we're addressing a Legacy Train
+        }
+        m_legacyCommandRecord.legacyCommandByte[5] = t_devCommand;  // Command = Legacy hex value of command needed
+        // *** WORD 3 of 3 ***
+        // For the third 3-byte word, the first two bytes of word 3 are always the same as the first two bytes of word 2
+        m_legacyCommandRecord.legacyCommandByte[6] = m_legacyCommandRecord.legacyCommandByte[3];
+        m_legacyCommandRecord.legacyCommandByte[7] = m_legacyCommandRecord.legacyCommandByte[4];
+        // Last byte is a one's complement checksum of 5 previous bytes: starting at zero: 1, 2, 4, 5, and 7.
+        m_legacyCommandRecord.legacyCommandByte[8] = legacyChecksum(m_legacyCommandRecord.legacyCommandByte[1], 
+                                                                    m_legacyCommandRecord.legacyCommandByte[2],
+                                                                    m_legacyCommandRecord.legacyCommandByte[4],
+                                                                    m_legacyCommandRecord.legacyCommandByte[5],
+                                                                    m_legacyCommandRecord.legacyCommandByte[7]);
+        break;
+      }
+
+    // We'll handle all 38 of the 0x72 Railsounds Dialogue Triggers in one block, as only 1 byte differs among them...
+    case LEGACY_DIALOGUE:              // Separate function.  For any of the 38 Legacy Dialogues (9-byte 0x72), which will be passed as a parm.
+      {
+        // Rev: 06/12/22
+        // Dialogue is specified in t_devParm1 as a const, but equals the hex value of the Legacy 0x72 dialogue code
+        if (outOfRangeLegacyDialogueNum(t_devParm1)) {
+          sprintf(lcdString, "ENG LEG DIALOG ERR!"); pLCD2004->println(lcdString); Serial.println(lcdString); endWithFlashingLED(5);
+        }
+
+        m_legacyCommandRecord.legacyCommandByte[1] = (t_devNum * 2) + 1;  // Shift loco num left one bit, add 1
+        m_legacyCommandRecord.legacyCommandByte[2] = 0x72;  // Word 1 of 3, byte 3 = 0x72 (Railsounds Dialogue Triggers)
+        // *** WORD 2 of 3 ***
+        m_legacyCommandRecord.legacyCommandByte[3] = 0xFB;  // Legacy 2nd and 3rd set of 3-byte "words" ALWAYS start with FB
+        if (t_devType == 'E') {
+          m_legacyCommandRecord.legacyCommandByte[4] = (t_devNum * 2) + 0;  // Add 0 if we're addressing a Legacy Engine
+        } else {
+          m_legacyCommandRecord.legacyCommandByte[4] = (t_devNum * 2) + 1;  // Add 1 if we're addressing a Legacy Train
+        }
+        m_legacyCommandRecord.legacyCommandByte[5] = t_devParm1;  // Dialogue number i.e. 0x0E is specified in parm1
+        // *** WORD 3 of 3 ***
+        // For the third 3-byte word, the first two bytes of word 3 are always the same as the first two bytes of word 2
+        m_legacyCommandRecord.legacyCommandByte[6] = m_legacyCommandRecord.legacyCommandByte[3];
+        m_legacyCommandRecord.legacyCommandByte[7] = m_legacyCommandRecord.legacyCommandByte[4];
+        // Last byte is a one's complement checksum of 5 previous bytes: starting at zero: 1, 2, 4, 5, and 7.
+        m_legacyCommandRecord.legacyCommandByte[8] = legacyChecksum(m_legacyCommandRecord.legacyCommandByte[1], 
+                                                                    m_legacyCommandRecord.legacyCommandByte[2],
+                                                                    m_legacyCommandRecord.legacyCommandByte[4],
+                                                                    m_legacyCommandRecord.legacyCommandByte[5],
+                                                                    m_legacyCommandRecord.legacyCommandByte[7]);
+        break;
+      }
+    default:
+      {
+        // If we fall thorough to here, we have an unsupported command type
+        sprintf(lcdString, "ENG'R LEG BAD CMD!"); pLCD2004->println(lcdString); Serial.println(lcdString); endWithFlashingLED(4);
+      }
+  }  // End of "switch" which Legacy command are we decoding?
+
+  // Okay, we have populated m_legacyCommandRecord[] with the appropriate Legacy command; either 3, 6, or 9 bytes.
+  if (m_debugOn) {
+    sprintf(lcdString, "LCMD %c %i %i", t_devType, t_devNum, t_devParm1); Serial.println(lcdString);
+    sprintf(lcdString, "%X %X %X", m_legacyCommandRecord.legacyCommandByte[0], m_legacyCommandRecord.legacyCommandByte[1],
+      m_legacyCommandRecord.legacyCommandByte[2]); Serial.println(lcdString);
+  }
+  return m_legacyCommandRecord;  // We're done with Legacy so exit this function
+}
+
+
+// ***************************************************************************
+// ***** LEGACY COMMAND CHECKSUM and LEGACY/TMCC FUNCTION RANGE CHECKING *****
+// ***************************************************************************
+
+byte Engineer_Old::legacyChecksum(byte leg1, byte leg2, byte leg4, byte leg5, byte leg7) {  // Using leg0..leg8 (not leg1..leg9)
+  // 6/29/15: Calculate the "one's compliment" checksum required when sending "multi-word" commands to Legacy.
+  // This function receives the five bytes from a 3-word Legacy command that are used in calculation of the checksum, and returns
+  // the checksum.  Add up the five byte values, take the MOD256 remainder (which is automatically done by virtue of storing the
+  // result of the addition in a byte-size variable,) and then take the One's Compliment which is simply inverting all of the bits.
+  // We use the "~" operator to do a bitwise invert.
+  return ~(leg1 + leg2 + leg4 + leg5 + leg7);
+}
+
+bool Engineer_Old::outOfRangeTMCCDevType(char t_devType) {
+  if ((t_devType != DEV_TYPE_TMCC_ENGINE) && (t_devType != DEV_TYPE_TMCC_TRAIN)) {
+    return true;  // true means it's out of range
+  } else {
+    return false;
+  }
+}
+
+bool Engineer_Old::outOfRangeLegacyDevType(char t_devType) {
+  if ((t_devType != DEV_TYPE_LEGACY_ENGINE) && (t_devType != DEV_TYPE_LEGACY_TRAIN)) {
+    return true;  // true means it's out of range
+  } else {
+    return false;
+  }
+}
+
+bool Engineer_Old::outOfRangeDevNum(char t_devType, byte t_devNum) {
+  if (t_devType == DEV_TYPE_ACCESSORY) {
+    if ((t_devNum < 0) || (t_devNum > (TOTAL_LEG_ACCY_RELAYS - 1))) {
+      return true;  // true means it's out of range
+    }
+  } else if (t_devType == DEV_TYPE_TMCC_TRAIN) {  // TMCC Train can be 1..9
+    if ((t_devNum < 1) || (t_devNum > 9)) {
+      return true;  // true means it's out of range
+    }
+  } else {  // For all other device types except Accessories and TMCC Trains i.e. TMCC Engines or Legacy Trains/Engines
+    if (((t_devNum < 1) || (t_devNum > 50)) &&
+       ((t_devNum < LOCO_ID_POWERMASTER_1) || (t_devNum > LOCO_ID_POWERMASTER_4))) {  // Anything else can be 1..50 or 91..94
+      return true;  // true means it's out of range
+    }
+  }
+  // If we fall through to here, we've found no objections.
+  return false;  // false means it's not out of range
+}
+
+bool Engineer_Old::outOfRangeTMCCDialogueNum(byte t_devParm1) {  // Must be 1..6
+  // Rev: 06/12/22
+  // TMCC Stationsounds Diner
+  // Valid values are six consts defined arbitrarily as 1..6 (as consts)
+  if ((t_devParm1 < 0) || (t_devParm1 > 6)) {
+    return true;  // true means it's out of range
+  } else {
+    return false;  // false means it's NOT out of range
+  }
+}
+
+bool Engineer_Old::outOfRangeLocoSpeed(char t_devType, byte t_devParm1) {
+  if ((t_devType == DEV_TYPE_TMCC_ENGINE) || (t_devType == DEV_TYPE_TMCC_TRAIN)) {  // TMCC 'N' Engine or 'R' Train can be 0..31
+    if ((t_devParm1 < 0) || (t_devParm1 > 31)) {
+      return true;  // true means it's out of range
+    }
+  }
+  // Anything else can have speed 0..1999
+  if ((t_devParm1 < 0) || (t_devParm1 > 199)) {  // Only 0..199 are valid
+    return true;  // true means it's out of range
+  } else {
+    return false;
+  }
+}
+
+bool Engineer_Old::outOfRangeQuill(byte t_devParm1) {
+  if ((t_devParm1 < 0) || (t_devParm1 > 15)) {  // Only 0..15 are valid
+    return true;  // true means it's out of range
+  } else {
+    return false;
+  }
+}
+
+bool Engineer_Old::outOfRangeRPM(byte t_devParm1) {
+  if ((t_devParm1 < 0) || (t_devParm1 > 7)) {  // Only 0..7 are valid
+    return true;  // true means it's out of range
+  } else {
+    return false;
+  }
+}
+
+bool Engineer_Old::outOfRangeLabor(byte t_devParm1) {
+  if ((t_devParm1 < 0) || (t_devParm1 > 31)) {  // Only 0..31 are valid
+    return true;  // true means it's out of range
+  } else {
+    return false;
+  }
+}
+
+bool Engineer_Old::outOfRangeSmoke(byte t_devParm1) {
+  if ((t_devParm1 < 0) || (t_devParm1 > 3)) {  // Only 0..3 are valid
+    return true;  // true means it's out of range
+  } else {
+    return false;
+  }
+}
+
+bool Engineer_Old::outOfRangeLegacyDialogueNum(byte t_devParm1) {
+  // Rev: 06/12/22
+  // Legacy Railsounds Dialogue Triggers (0x72)
+  // Only 6-20, 34-35, 48, 61-65, and 104-118 are valid
+  if (((t_devParm1 >=   6) && (t_devParm1 <=  20)) ||
+      ((t_devParm1 >=  34) && (t_devParm1 <=  35)) ||
+      ((t_devParm1 >=  48) && (t_devParm1 <=  48)) ||
+      ((t_devParm1 >=  61) && (t_devParm1 <=  65)) ||
+      ((t_devParm1 >= 104) && (t_devParm1 <= 118))) {
+    return false;  // false means it's NOT out of range
+  } else {
+    return true;  // true means it's out of range
+  }
+}
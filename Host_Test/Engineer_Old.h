@@ -0,0 +1,41 @@
+// ENGINEER_OLD.H Rev: 10/19/26.
+// The old switch-based Legacy/TMCC encoder; see Engineer_Old.cpp.  Everything is public so the test can call it directly.
+
+#ifndef ENGINEER_OLD_H
+#define ENGINEER_OLD_H
+
+#include <Train_Consts_Global.h>
+#include <Train_Functions.h>
+#include <Display_2004.h>
+#include <Loco_Reference.h>
+
+class Engineer_Old {
+
+  public:
+
+    struct legacyCommandStruct {
+      byte legacyCommandByte[LEGACY_CMD_BYTES];  // There will always be 9 elements, 0..8, though often only 0..2 will be used.
+    };
+
+    legacyCommandStruct translateToTMCC(byte t_devNum, byte t_devCommand, byte t_devParm1, byte t_devParm2);
+    legacyCommandStruct translateToLegacy(byte t_devNum, byte t_devCommand, byte t_devParm1, byte t_devParm2);
+
+    byte legacyChecksum(byte leg1, byte leg2, byte leg4, byte leg5, byte leg7);
+    bool outOfRangeTMCCDevType(char t_devType);  // N/R = TMCC eNgine or tRain (not turnout Normal/Reverse)
+    bool outOfRangeLegacyDevType(char t_devType);  // E/T = Legacy Engine or Train
+    bool outOfRangeDevNum(char t_devType, byte t_devNum);  // Can be 1..9 or 1..50 depending on TMCC Train vs other
+    bool outOfRangeTMCCDialogueNum(byte t_devParm1);
+    bool outOfRangeLocoSpeed(char t_devType, byte t_devParm1);
+    bool outOfRangeQuill(byte t_devParm1);
+    bool outOfRangeRPM(byte t_devParm1);
+    bool outOfRangeLabor(byte t_devParm1);
+    bool outOfRangeSmoke(byte t_devParm1);
+    bool outOfRangeLegacyDialogueNum(byte t_devParm1);
+
+    legacyCommandStruct m_legacyCommandRecord;
+    Loco_Reference* m_pLoco = nullptr;  // Only devType() is called, and the test supplies that
+    bool m_debugOn = false;
+
+};
+
+#endif
@@ -0,0 +1,99 @@
+// HOST_FERRO.CPP Rev: 10/19/26.
+// Host stand-in for Hackscribble_Ferro.cpp: the FRAM chip is the hostFRAM[] array, so the real FRAM class and every table class
+// that reads and writes through it run unchanged on the host.  A test can fill hostFRAM[] from an image file (hostLoadFRAM), or
+// let the libraries' populate() functions write to it.
+
+#include <Hackscribble_Ferro.h>
+#include "Host_Test.h"
+
+byte hostFRAM[HOST_FRAM_BYTES];
+
+boolean Hackscribble_Ferro::_spiIsRunning = false;
+byte Hackscribble_Ferro::_spiClockDivider = 0;
+
+bool hostLoadFRAM(const char* t_fileName) {
+  memset(hostFRAM, 0, sizeof(hostFRAM));
+  FILE* f = fopen(t_fileName, "rb");
+  if (f == nullptr) {
+    return false;
+  }
+  size_t n = fread(hostFRAM, 1, sizeof(hostFRAM), f);
+  fclose(f);
+  return n == sizeof(hostFRAM);
+}
+
+Hackscribble_Ferro::Hackscribble_Ferro(ferroPartNumber partNumber, byte chipSelect) {
+  _partNumber = partNumber;
+  _chipSelect = chipSelect;
+  _bottomAddress = 0;
+  _topAddress = HOST_FRAM_BYTES - 1;
+}
+
+ferroResult Hackscribble_Ferro::ferroBegin() {
+  _spiIsRunning = true;
+  return ferroOK;
+}
+
+ferroPartNumber Hackscribble_Ferro::getPartNumber() {
+  return _partNumber;
+}
+
+byte Hackscribble_Ferro::readProductID() {
+  return 0;
+}
+
+unsigned long Hackscribble_Ferro::getBottomAddress() {
+  return _bottomAddress;
+}
+
+unsigned long Hackscribble_Ferro::getTopAddress() {
+  return _topAddress;
+}
+
+ferroResult Hackscribble_Ferro::checkForFRAM() {
+  return ferroOK;
+}
+
+ferroResult Hackscribble_Ferro::format() {
+  memset(hostFRAM, 0, sizeof(hostFRAM));
+  return ferroOK;
+}
+
+ferroResult Hackscribble_Ferro::_checkRange(unsigned long startAddress, unsigned long numberOfBytes) {
+  if (startAddress > _topAddress) return ferroBadStartAddress;
+  if (numberOfBytes == 0) return ferroBadNumberOfBytes;
+  if (startAddress + numberOfBytes - 1 > _topAddress) return ferroBadFinishAddress;
+  return ferroOK;
+}
+
+ferroResult Hackscribble_Ferro::readFerro(unsigned long startAddress, byte numberOfBytes, byte* buffer) {
+  return readFerroStream(startAddress, numberOfBytes, buffer);
+}
+
+ferroResult Hackscribble_Ferro::writeFerro(unsigned long startAddress, byte numberOfBytes, byte* buffer) {
+  return writeFerroStream(startAddress, numberOfBytes, buffer);
+}
+
+ferroResult Hackscribble_Ferro::readFerroStream(unsigned long startAddress, unsigned int numberOfBytes, byte* buffer) {
+  ferroResult result = _checkRange(startAddress, numberOfBytes);
+  if (result == ferroOK) {
+    memcpy(buffer, &hostFRAM[startAddress], numberOfBytes);
+  }
+  return result;
+}
+
+ferroResult Hackscribble_Ferro::writeFerroStream(unsigned long startAddress, unsigned int numberOfBytes, byte* buffer) {
+  ferroResult result = _checkRange(startAddress, numberOfBytes);
+  if (result == ferroOK) {
+    memcpy(&hostFRAM[startAddress], buffer, numberOfBytes);
+  }
+  return result;
+}
+
+void Hackscribble_Ferro::setSPIClockDivider(byte clockDivider) {
+  _spiClockDivider = clockDivider;
+}
+
+byte Hackscribble_Ferro::getSPIClockDivider() {
+  return _spiClockDivider;
+}
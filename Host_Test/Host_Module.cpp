@@ -0,0 +1,13 @@
+// HOST_MODULE.CPP Rev: 10/19/26.
+// THIS_MODULE for a host program that plays more than one module; Layout_Sim.cpp runs MAS, LEG and SNS in one process.
+// Train_Functions.h declares "extern const byte THIS_MODULE" and the libraries only read it at run time (i.e. Message decides
+// which messages are for us), so defining it here without const lets hostSetModule() switch modules before each one's turn.
+// Don't #include Train_Functions.h here; its const declaration would conflict with this definition.
+
+#include "Host_Test.h"
+
+byte THIS_MODULE = ARDUINO_NUL;
+
+void hostSetModule(const byte t_module) {
+  THIS_MODULE = t_module;
+}
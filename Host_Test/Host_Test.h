@@ -0,0 +1,36 @@
+// HOST_TEST.H Rev: 10/19/26.
+// Tiny check framework shared by the Host_Test/Test_*.cpp programs; see run_tests.sh.
+// Host_Train_Functions.cpp stands in for Train_Functions.cpp, and its endWithFlashingLED() throws Host_Fatal instead of
+// flashing forever, so a test can confirm that a library treats bad input as fatal.
+// Host_Ferro.cpp stands in for Hackscribble_Ferro.cpp, so a test that links FRAM.cpp gets an FRAM in hostFRAM[].
+// Host_Module.cpp defines a THIS_MODULE that can change, for a program that plays several modules (Layout_Sim.cpp.)
+
+#ifndef HOST_TEST_H
+#define HOST_TEST_H
+
+#include <Arduino.h>
+#include <Train_Consts_Global.h>
+
+struct Host_Fatal {
+  int numFlashes;
+};
+
+extern unsigned int hostChecks;
+extern unsigned int hostFailures;
+
+#define CHECK(t_cond) do { hostChecks++; if (!(t_cond)) { hostFailures++; \
+  printf("  FAILED %s:%d: %s\n", __FILE__, __LINE__, #t_cond); } } while (0)
+
+#define CHECK_FATAL(t_stmt) do { hostChecks++; bool fatal = false; \
+  try { t_stmt; } catch (Host_Fatal&) { fatal = true; } \
+  if (!fatal) { hostFailures++; printf("  FAILED %s:%d: not fatal: %s\n", __FILE__, __LINE__, #t_stmt); } } while (0)
+
+int hostTestResult(const char* t_name);  // Prints the summary line; returns the process exit code.
+
+const unsigned long HOST_FRAM_BYTES = FRAM_ADDR_TOP + 1;
+extern byte hostFRAM[HOST_FRAM_BYTES];  // Host_Ferro.cpp
+bool hostLoadFRAM(const char* t_fileName);  // Fill hostFRAM[] from an image file; false if missing or the wrong size.
+
+void hostSetModule(const byte t_module);  // Host_Module.cpp: ARDUINO_MAS, ARDUINO_LEG, etc. for the module about to run
+
+#endif
@@ -0,0 +1,76 @@
+// HOST_TRAIN_FUNCTIONS.CPP Rev: 10/19/26.
+// Host stand-ins for the parts of Train_Functions.cpp that the libraries under test call.  The real file needs the Mega's
+// memory layout and halts by flashing an LED forever; here a fatal error throws Host_Fatal back to the test.
+
+#include <Train_Functions.h>
+#include "Host_Test.h"
+
+unsigned int hostChecks = 0;
+unsigned int hostFailures = 0;
+
+void (*pFlushBeforeHalt)() = nullptr;
+Centipede* pShiftRegister = nullptr;
+
+int hostTestResult(const char* t_name) {
+  printf("%s: %u checks, %u failed.\n", t_name, hostChecks, hostFailures);
+  return (hostFailures == 0) ? 0 : 1;
+}
+
+void haltIfHaltPinPulledLow() {
+  return;
+}
+
+void chirp() {
+  return;  // No piezo on the host
+}
+
+void endWithFlashingLED(int t_numFlashes) {
+  if (pFlushBeforeHalt != nullptr) {
+    pFlushBeforeHalt();
+  }
+  if (pLCD2004 != nullptr) {
+    pLCD2004->flush();
+  }
+  Host_Fatal fatal = { t_numFlashes };
+  throw fatal;
+}
+
+byte getLowByte(unsigned t_val) {
+  return (byte)(t_val & 0xFF);
+}
+
+byte getHighByte(unsigned t_val) {
+  return (byte)((t_val >> 8) & 0xFF);
+}
+
+bool readBit(unsigned t_val, byte t_bit) {
+  return ((t_val >> t_bit) & 1) != 0;
+}
+
+unsigned setBit(unsigned t_val, byte t_bit) {
+  return t_val | (1u << t_bit);
+}
+
+unsigned clearBit(unsigned t_val, byte t_bit) {
+  return t_val & ~(1u << t_bit);
+}
+
+unsigned toggleBit(unsigned t_val, byte t_bit) {
+  return t_val ^ (1u << t_bit);
+}
+
+unsigned writeBit(unsigned t_val, byte t_bit, byte t_bitVal) {
+  return t_bitVal ? setBit(t_val, t_bit) : clearBit(t_val, t_bit);
+}
+
+unsigned int freeMemory() {
+  return 0;  // No SRAM to measure on the host
+}
+
+void* arenaAllocate(const __FlashStringHelper* t_name, const unsigned int t_bytes, const byte t_arena) {
+  void* p = calloc(1, t_bytes);  // One heap on the host; the arena doesn't matter
+  if (p == nullptr) {
+    endWithFlashingLED(1);
+  }
+  return p;
+}
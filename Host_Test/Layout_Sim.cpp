@@ -0,0 +1,1107 @@
+// LAYOUT_SIM.CPP Rev: 10/19/26.
+// Host layout simulator.  Runs MAS's and LEG's Auto-mode loops on the real libraries (Dispatcher, Train_Progress, Block and
+// Turnout Reservation, Conductor, Delayed_Action, Engineer) against a FRAM image, on the stub/ clock, and plays SNS with a model
+// of the trains: each loco moves at the Loco Reference mm/sec for the Legacy speed Engineer last sent it, and trips and clears
+// sensors as its front and rear pass them.  Every message (Routes, Mode, Sensor trips and clears) goes over a simulated RS485
+// bus through the real Message class, so hours of Auto mode run in seconds with nothing on the bench.
+//
+//   Layout_Sim <host image> [--hours 8] [--train LOCO:BLOCK ...] [--seed 1] [--speed-error 0.05] [--mainline-mm 3000]
+//                           [--deadlock-minutes 10] [--trace] [--quiet]
+//
+// The image comes from "O_FRAM_Populator/FRAM_Image.py build --host" (run_tests.sh makes one), and every --train i.e. 5:BW03 is
+// Registered the way MAS and LEG do it: setInitialRoute() on both Train Progress tables, block reserved, stop sensor tripped.
+// Train lengths, speeds and momentum come from Loco Reference; block lengths from Block Reservation, except mainline blocks
+// (length 0) which get --mainline-mm.  Each loco really runs its Loco Reference mm/sec times a random factor (--speed-error is
+// its std dev) so stops come out long or short, as on a real layout.
+//
+// MAS and LEG both run their Auto/Park loops as O_MAS.ino and O_LEG.ino do, a pass at a time, until the bus is quiet, then the
+// trains move TICK_MS.  Where O_LEG's loop isn't finished yet (see LEGAutoParkMode()) we fill in what it will need to do:
+// VL01..VL04 become the loco's Crawl/Low/Medium/High speed, VL01 from Low/Medium/High is timed with getDistanceAndMomentum(), a
+// VL00 in the middle of a route stops the loco and Conductor starts it again (in the new direction) when it has stopped, and
+// sensor clears advance Tail and Next-To-Clear as in MAS.  SNS's Request-To-Send line can't be pulled low on the host, so we send
+// MAS's Ok-To-Send for it.
+//
+// REPORT: routes completed per hour (total and per train), stop-position error (how far past the Stop sensor we came to rest,
+// less what populateLocoSlowToStop() should take from Crawl), how far trains crawled before the stop sensor, how often one got
+// there faster than Crawl, deadlocks (no sensor tripped for --deadlock-minutes; the layout is then Registered again and the run
+// continues), and any sensor tripped by two trains at once (a reservation bug.)  Exit code is 1 if a library hit a fatal error,
+// two trains collided, or no routes were completed.
+
+#include <Train_Functions.h>
+#include <Message.h>
+#include <FRAM.h>
+#include <Display_2004.h>
+#include <Turnout_Reservation.h>
+#include <Sensor_Block.h>
+#include <Block_Reservation.h>
+#include <Deadlock.h>
+#include <Loco_Reference.h>
+#include <Route_Reference.h>
+#include <Train_Progress.h>
+#include <Mode_Dial.h>
+#include <Dispatcher.h>
+#include <Delayed_Action.h>
+#include <Engineer.h>
+#include <Conductor.h>
+#include "Host_Test.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdarg>
+#include <deque>
+#include <map>
+#include <math.h>
+#include <random>
+#include <string>
+#include <vector>
+
+char lcdString[LCD_WIDTH + 1] = "Layout simulator";
+Display_2004* pLCD2004 = nullptr;
+
+void Centipede::digitalWrite(int, int) {}  // Engineer's accessory relays; there's no Centipede on the host
+
+const unsigned long TICK_MS           =   50;  // Train movement step; MAS and LEG run until the bus is quiet between steps
+const unsigned long CLOCK_TICK_MICROS =   10;  // Every millis()/micros() call costs this much simulated time
+const unsigned int  TURNOUT_MM        =  300;  // Track between blocks, for each turnout in the route
+const unsigned long STOP_MS           = 3000;  // populateLocoSlowToStop() takes 3 seconds
+const unsigned long REVERSE_PAUSE_MS  = 2000;  // LEG: after stopping to reverse direction, pause this long before starting again
+const int           BUS_RX_BYTES      =   60;  // More than this waiting and Message::getMessageRS485() calls it an overflow
+const unsigned int  PASSES_MAX        =  200;  // Passes for the bus to go quiet before we call it a live-lock
+const unsigned long NEVER             = 99999999;  // As in Train_Progress::setInitialRoute(); "don't start until told to"
+
+// *** The modules.  MAS and LEG each have their own Train Progress; everything else read from FRAM is shared. ***
+FRAM*                pStorage            = nullptr;
+Turnout_Reservation* pTurnoutReservation = nullptr;
+Sensor_Block*        pSensorBlock        = nullptr;
+Block_Reservation*   pBlockReservation   = nullptr;
+Deadlock_Reference*  pDeadlock           = nullptr;
+Loco_Reference*      pLoco               = nullptr;
+Route_Reference*     pRoute              = nullptr;
+
+Message*        pMASMessage      = nullptr;  // MAS
+Train_Progress* pMASTrainProgress = nullptr;
+Mode_Dial*      pModeSelector    = nullptr;
+Dispatcher*     pDispatcher      = nullptr;
+byte modeCurrent  = MODE_AUTO;
+byte stateCurrent = STATE_RUNNING;
+
+Message*        pLEGMessage      = nullptr;  // LEG
+Train_Progress* pLEGTrainProgress = nullptr;
+Delayed_Action* pDelayedAction   = nullptr;
+Engineer*       pEngineer        = nullptr;
+Conductor*      pConductor       = nullptr;
+
+Message*        pSNSMessage      = nullptr;  // SNS
+
+// MAS's RS485 port is Serial2 as on the Mega; LEG and SNS get their own ports on the same simulated bus.
+HardwareSerial legBus;
+HardwareSerial snsBus;
+HardwareSerial lcdPort;  // The one LCD; output discarded
+HardwareSerial* const busPorts[] = { &Serial2, &legBus, &snsBus };
+const int BUS_PORTS = 3;
+std::deque<byte> busPending[BUS_PORTS];  // Bytes on the wire to each port that its receive buffer can't hold yet
+
+// *** The model trains.  Positions are mm along the train's current "leg": from where it last started moving to its next stop.
+struct Sim_Event {
+  char         kind;        // 'B' front enters a block, 'T' front trips a sensor, 'C' rear clears a sensor
+  byte         sensorNum;
+  byte         elementPtr;  // 'T': LEG Train Progress element holding the sensor
+  routeElement block;       // 'B': BEnn/BWnn
+};
+
+struct Sim_Train {
+  byte         locoNum;
+  routeElement home;         // Where --train put it, and where we put it back after a deadlock
+  double       factor;       // Actual speed / Loco Reference speed
+  byte         speed[5];     // Legacy speed for Stop, Crawl, Low, Medium, High, from Loco Reference
+  double       mmPerSec[5];  // ...and mm/sec at each
+  double       length;
+  routeElement block;        // Block and direction the front is in
+  double       front;
+  double       overshoot;    // How far past the Stop sensor we came to rest, last time we stopped
+  bool         moving;
+  byte         layoutPtr;    // Next LEG Train Progress element to turn into track
+  bool         legEnds;      // Laid out through a VL00 in the middle of the route; the rest is the next leg
+  bool         atEnd;        // Laid out through the end of the route (the final VL00 may still be overwritten)
+  double       cursor;       // Where the next block or turnout starts
+  routeElement frame;        // Block being laid out, and where it starts and ends
+  double       frameStart;
+  double       frameEnd;
+  std::multimap<double, Sim_Event> events;  // By position; same position keeps the order they were laid out
+  std::deque<std::pair<byte, bool>> covered;  // Sensors tripped but not yet reported cleared, oldest first; true once rear passed
+  double       lastTripPos;
+  bool         stopTripped;  // Tripped a sensor followed by VL00 on this leg
+  bool         routeEnds;    // ...and it was the route's Stop sensor
+  std::deque<byte> routeStops;  // LEG stopPtr of each route received, oldest first; tripping it completes that route
+  double       crawlFrom;    // Where we got down to Crawl on this leg, < 0 if we're above Crawl
+  bool         overran;
+  unsigned int routes;
+};
+
+std::vector<Sim_Train> trains;
+byte sensorTrains[TOTAL_SENSORS + 1];  // How many trains are over each sensor
+
+struct Sim_Options {
+  const char*   imageName     = nullptr;
+  double        hours         = 8.0;
+  unsigned long seed          = 1;
+  double        speedError    = 0.05;
+  unsigned int  mainlineMm    = 3000;
+  double        deadlockMinutes = 10.0;
+  bool          trace         = false;
+  bool          quiet         = false;
+} options;
+
+struct Sim_Stats {
+  unsigned long       routes     = 0;
+  unsigned long       deadlocks  = 0;
+  unsigned long       collisions = 0;
+  unsigned long       hotArrivals = 0;
+  unsigned long       crawlFallbacks = 0;  // VL01 where getDistanceAndMomentum() couldn't be used
+  unsigned long       overruns   = 0;
+  std::vector<double> stopErrors;
+  std::vector<double> crawlMm;
+} stats;
+
+unsigned long lastProgressMicros = 0;  // Last time any train tripped a sensor
+std::string consoleTail;               // End of everything sent to Serial, for a post-mortem
+
+// *** Time and logging ***
+
+static double simSeconds() {
+  return (double)hostMicros / 1000000.0;
+}
+
+static void logLine(const char* t_format, ...) {
+  if (options.quiet) {
+    return;
+  }
+  char line[160];
+  va_list args;
+  va_start(args, t_format);
+  vsnprintf(line, sizeof(line), t_format, args);
+  va_end(args);
+  unsigned long secs = (unsigned long)simSeconds();
+  printf("%3lu:%02lu:%02lu %s\n", secs / 3600, (secs / 60) % 60, secs % 60, line);
+}
+
+// *** The RS485 bus ***
+
+static void drainConsole() {
+  // Serial is each module's serial monitor; Serial3 is LEG's Legacy base, and lcdPort the LCD.  Keep the tail of Serial.
+  if (Serial.hostOutLen > 0) {
+    std::string text((const char*)Serial.hostOut, Serial.hostOutLen);
+    if (options.trace) {
+      fputs(text.c_str(), stdout);
+    }
+    consoleTail += text;
+    if (consoleTail.size() > 4000) {
+      consoleTail.erase(0, consoleTail.size() - 2000);
+    }
+    Serial.hostOutLen = 0;
+  }
+  Serial3.hostOutLen = 0;
+  lcdPort.hostOutLen = 0;
+}
+
+static void busDeliver() {
+  // Whatever each module sent is heard by the other two, as fast as their receive buffers will take it.
+  for (int from = 0; from < BUS_PORTS; from++) {
+    HardwareSerial* port = busPorts[from];
+    for (int to = 0; to < BUS_PORTS; to++) {
+      if (to != from) {
+        busPending[to].insert(busPending[to].end(), port->hostOut, port->hostOut + port->hostOutLen);
+      }
+    }
+    port->hostOutLen = 0;
+  }
+  for (int to = 0; to < BUS_PORTS; to++) {
+    while ((!busPending[to].empty()) && (busPorts[to]->available() < BUS_RX_BYTES)) {
+      byte b = busPending[to].front();
+      busPorts[to]->hostFeed(&b, 1);
+      busPending[to].pop_front();
+    }
+  }
+  drainConsole();
+}
+
+static bool busIsQuiet() {
+  for (int p = 0; p < BUS_PORTS; p++) {
+    if ((!busPending[p].empty()) || (busPorts[p]->available() > 0)) {
+      return false;
+    }
+  }
+  return true;
+}
+
+static void busClear() {
+  for (int p = 0; p < BUS_PORTS; p++) {
+    busPending[p].clear();
+    busPorts[p]->hostClear();
+  }
+  drainConsole();
+}
+
+// *** MAS: one pass of MASAutoParkMode(), and its MASSensorTripped()/MASSensorCleared() ***
+
+static void MASSensorTripped(const byte t_sensorNum) {
+  byte locoNum = pMASTrainProgress->locoThatTrippedSensor(t_sensorNum);
+  if (pMASTrainProgress->lastTrippedPtr(locoNum) == pMASTrainProgress->stopPtr(locoNum)) {
+    return;
+  }
+  byte tempTPPointer = pMASTrainProgress->lastTrippedPtr(locoNum);
+  routeElement tempTPElement;
+  do {
+    tempTPPointer = pMASTrainProgress->incrementTrainProgressPtr(tempTPPointer);
+    tempTPElement = pMASTrainProgress->peek(locoNum, tempTPPointer);
+  } while (tempTPElement.routeRecType != SN);
+  pMASTrainProgress->setNextToTripPtr(locoNum, tempTPPointer);
+  pMASTrainProgress->setParked(locoNum, false);
+  pDispatcher->throwTurnoutsToNextSensor(locoNum);
+}
+
+static void MASSensorCleared(const byte t_sensorNum) {
+  byte locoNum = pMASTrainProgress->locoThatClearedSensor(t_sensorNum);
+  byte tempTPPointer = pMASTrainProgress->tailPtr(locoNum);
+  routeElement tempTPElement;
+  do {
+    tempTPPointer = pMASTrainProgress->incrementTrainProgressPtr(tempTPPointer);
+    tempTPElement = pMASTrainProgress->peek(locoNum, tempTPPointer);
+    if ((tempTPElement.routeRecType == BE) || (tempTPElement.routeRecType == BW)) {
+      if (pMASTrainProgress->blockOccursAgainInRoute(locoNum, tempTPElement.routeRecVal, tempTPPointer) == false) {
+        pBlockReservation->releaseBlock(tempTPElement.routeRecVal);
+      }
+    } else if ((tempTPElement.routeRecType == TN) || (tempTPElement.routeRecType == TR)) {
+      if (pMASTrainProgress->turnoutOccursAgainInRoute(locoNum, tempTPElement.routeRecVal, tempTPPointer) == false) {
+        pTurnoutReservation->release(tempTPElement.routeRecVal);
+      }
+    }
+  } while (tempTPElement.routeRecType != SN);
+  if (tempTPPointer != pMASTrainProgress->nextToClearPtr(locoNum)) {
+    sprintf(lcdString, "NTC POINTER ERR!"); pLCD2004->println(lcdString); Serial.println(lcdString); endWithFlashingLED(1);
+  }
+  pMASTrainProgress->setTailPtr(locoNum, pMASTrainProgress->nextToClearPtr(locoNum));
+  tempTPPointer = pMASTrainProgress->tailPtr(locoNum);
+  do {
+    tempTPPointer = pMASTrainProgress->incrementTrainProgressPtr(tempTPPointer);
+    tempTPElement = pMASTrainProgress->peek(locoNum, tempTPPointer);
+  } while (tempTPElement.routeRecType != SN);
+  pMASTrainProgress->setNextToClearPtr(locoNum, tempTPPointer);
+}
+
+static void MASPass() {
+  hostSetModule(ARDUINO_MAS);
+  pLCD2004->service();
+  char msgType = pMASMessage->available();
+  if (msgType == 'S') {
+    byte sensorNum;
+    char trippedOrCleared;
+    pMASMessage->getSNStoALLSensorStatus(&sensorNum, &trippedOrCleared);
+    pSensorBlock->setSensorStatus(sensorNum, trippedOrCleared);
+    if (trippedOrCleared == SENSOR_STATUS_TRIPPED) {
+      MASSensorTripped(sensorNum);
+    } else {
+      MASSensorCleared(sensorNum);
+    }
+  } else if (msgType != ' ') {
+    sprintf(lcdString, "AUTO MSG ERR %c", msgType); pLCD2004->println(lcdString); Serial.println(lcdString); endWithFlashingLED(1);
+  }
+  byte statePrevious = stateCurrent;
+  pDispatcher->dispatch(modeCurrent, &stateCurrent);
+  if (stateCurrent != statePrevious) {
+    pMASMessage->sendMAStoALLModeState(modeCurrent, stateCurrent);
+  }
+}
+
+// *** LEG: one pass of LEGAutoParkMode(), with the parts O_LEG doesn't have yet ***
+
+static byte legacySpeed(const byte t_locoNum, const byte t_locoSpeed) {
+  // VL00..VL04 to this loco's Legacy speed.
+  switch (t_locoSpeed) {
+    case LOCO_SPEED_CRAWL:  return pLoco->crawlSpeed(t_locoNum);
+    case LOCO_SPEED_LOW:    return pLoco->lowSpeed(t_locoNum);
+    case LOCO_SPEED_MEDIUM: return pLoco->medSpeed(t_locoNum);
+    case LOCO_SPEED_HIGH:   return pLoco->highSpeed(t_locoNum);
+  }
+  return 0;
+}
+
+static void LEGSpeedChange(const unsigned long t_startTime, const byte t_locoNum, const byte t_locoSpeed) {
+  // Any speed change but slowing to Crawl or Stop: the loco's medium momentum.
+  pDelayedAction->populateLocoSpeedChange(t_startTime, t_locoNum, pLoco->medSpeedSteps(t_locoNum),
+                                          pLoco->medMsStepDelay(t_locoNum), legacySpeed(t_locoNum, t_locoSpeed));
+}
+
+static void LEGSlowToCrawl(const byte t_locoNum, const byte t_elementPtr) {
+  // VL01 at Low/Medium/High: keep going, then slow so we reach Crawl just as we trip the Stop sensor of the block we're entering,
+  // which is the next BE/BW before the next sensor.  getDistanceAndMomentum() is fatal unless we're at exactly Low/Medium/High,
+  // and can't help if the block is shorter than our MmToCrawl (or a mainline block of unknown length), so otherwise slow now.
+  const byte currentSpeed = pLEGTrainProgress->currentSpeed(t_locoNum);
+  if (currentSpeed <= pLoco->crawlSpeed(t_locoNum)) {
+    LEGSpeedChange(millis(), t_locoNum, LOCO_SPEED_CRAWL);
+    return;
+  }
+  unsigned int sidingLength = 0;
+  byte tempTPPointer = t_elementPtr;
+  routeElement tempTPElement;
+  do {
+    tempTPPointer = pLEGTrainProgress->incrementTrainProgressPtr(tempTPPointer);
+    tempTPElement = pLEGTrainProgress->peek(t_locoNum, tempTPPointer);
+    if ((tempTPElement.routeRecType == BE) || (tempTPElement.routeRecType == BW)) {
+      sidingLength = pBlockReservation->length(tempTPElement.routeRecVal);
+      break;
+    }
+  } while ((tempTPElement.routeRecType != SN) && (tempTPPointer != pLEGTrainProgress->headPtr(t_locoNum)));
+  unsigned int mmToCrawl = 0;
+  if (currentSpeed == pLoco->lowSpeed(t_locoNum)) {
+    mmToCrawl = pLoco->lowMmToCrawl(t_locoNum);
+  } else if (currentSpeed == pLoco->medSpeed(t_locoNum)) {
+    mmToCrawl = pLoco->medMmToCrawl(t_locoNum);
+  } else if (currentSpeed == pLoco->highSpeed(t_locoNum)) {
+    mmToCrawl = pLoco->highMmToCrawl(t_locoNum);
+  }
+  if ((mmToCrawl == 0) || (sidingLength < mmToCrawl)) {
+    stats.crawlFallbacks++;
+    LEGSpeedChange(millis(), t_locoNum, LOCO_SPEED_CRAWL);
+    return;
+  }
+  byte crawlSpeed;
+  unsigned int msDelayAfterEntry;
+  byte speedSteps;
+  unsigned int msStepDelay;
+  pLoco->getDistanceAndMomentum(t_locoNum, currentSpeed, sidingLength, &crawlSpeed, &msDelayAfterEntry, &speedSteps, &msStepDelay);
+  pDelayedAction->populateLocoSpeedChange(millis() + msDelayAfterEntry, t_locoNum, speedSteps, msStepDelay, crawlSpeed);
+}
+
+static void LEGSensorTripped(const byte t_sensorNum) {
+  byte locoNum = pLEGTrainProgress->locoThatTrippedSensor(t_sensorNum);
+  pConductor->postEvent(CONDUCTOR_EVENT_SENSOR_TRIPPED, locoNum);
+  byte tempTPPointer;
+  routeElement tempTPElement;
+  if (pLEGTrainProgress->atEndOfRoute(locoNum)) {  // The Stop sensor; the VL00 after it stops us
+    tempTPPointer = pLEGTrainProgress->stopPtr(locoNum);
+    while ((tempTPPointer = pLEGTrainProgress->incrementTrainProgressPtr(tempTPPointer)) != pLEGTrainProgress->headPtr(locoNum)) {
+      tempTPElement = pLEGTrainProgress->peek(locoNum, tempTPPointer);
+      if ((tempTPElement.routeRecType == VL) && (tempTPElement.routeRecVal == LOCO_SPEED_STOP)) {
+        pDelayedAction->populateLocoSlowToStop(locoNum);
+        break;
+      }
+    }
+    pLEGTrainProgress->setTimeToStart(locoNum, NEVER);  // Until an Extension route arrives
+    return;
+  }
+  // Handle each element up to the next sensor.  After a VL00 (stopping to reverse) leave the FD/RD and VLs for Conductor to
+  // start once we've stopped, as it does for an Extension route.
+  bool stopping = false;
+  tempTPPointer = pLEGTrainProgress->nextToTripPtr(locoNum);
+  do {
+    tempTPPointer = pLEGTrainProgress->incrementTrainProgressPtr(tempTPPointer);
+    tempTPElement = pLEGTrainProgress->peek(locoNum, tempTPPointer);
+    if (stopping) {
+      continue;
+    }
+    if (tempTPElement.routeRecType == FD) {
+      pDelayedAction->populateLocoCommand(millis(), locoNum, LEGACY_ACTION_FORWARD, 0, 0);
+    } else if (tempTPElement.routeRecType == RD) {
+      pDelayedAction->populateLocoCommand(millis(), locoNum, LEGACY_ACTION_REVERSE, 0, 0);
+    } else if (tempTPElement.routeRecType == VL) {
+      if (tempTPElement.routeRecVal == LOCO_SPEED_STOP) {
+        pDelayedAction->populateLocoSlowToStop(locoNum);
+        stopping = true;
+      } else if (tempTPElement.routeRecVal == LOCO_SPEED_CRAWL) {
+        LEGSlowToCrawl(locoNum, tempTPPointer);
+      } else {
+        LEGSpeedChange(millis(), locoNum, tempTPElement.routeRecVal);
+      }
+    }
+  } while (tempTPElement.routeRecType != SN);
+  pLEGTrainProgress->setNextToTripPtr(locoNum, tempTPPointer);
+  if (stopping) {
+    pLEGTrainProgress->setTimeToStart(locoNum, millis() + STOP_MS + REVERSE_PAUSE_MS);
+    pConductor->postEvent(CONDUCTOR_EVENT_ROUTE_ADDED, locoNum);
+  }
+}
+
+static void LEGSensorCleared(const byte t_sensorNum) {
+  // Same pointer bookkeeping as MAS, without the reservations.
+  byte locoNum = pLEGTrainProgress->locoThatClearedSensor(t_sensorNum);
+  pLEGTrainProgress->setTailPtr(locoNum, pLEGTrainProgress->nextToClearPtr(locoNum));
+  byte tempTPPointer = pLEGTrainProgress->tailPtr(locoNum);
+  routeElement tempTPElement;
+  do {
+    tempTPPointer = pLEGTrainProgress->incrementTrainProgressPtr(tempTPPointer);
+    tempTPElement = pLEGTrainProgress->peek(locoNum, tempTPPointer);
+  } while (tempTPElement.routeRecType != SN);
+  pLEGTrainProgress->setNextToClearPtr(locoNum, tempTPPointer);
+}
+
+static std::string routeText(const unsigned int t_routeRecNum) {
+  // " BE13 SN18 FD00 VL02 ..." for --trace
+  static const char* const types[] = { "??", "??", "ER", "SN", "BE", "BW", "TN", "TR", "FD", "RD", "VL", "TD", "BX" };
+  std::string text;
+  for (byte i = 0; i < FRAM_SEGMENTS_ROUTE_REF; i++) {
+    routeElement element = pRoute->getElement(t_routeRecNum, i);
+    if ((element.routeRecType == ER) || (element.routeRecType > BX)) {
+      break;
+    }
+    char name[8];
+    snprintf(name, sizeof(name), " %s%02i", types[element.routeRecType], element.routeRecVal);
+    text += name;
+  }
+  return text;
+}
+
+static void LEGPass() {
+  hostSetModule(ARDUINO_LEG);
+  pEngineer->executeConductorCommand();
+  byte locoNum;
+  while ((locoNum = pConductor->locoReadyToStart()) != 0) {
+    pDelayedAction->populateLocoWhistleHorn(millis(), locoNum, LEGACY_PATTERN_DEPARTING);
+    unsigned long departTime = millis() + 2000;
+    byte tempTPPointer = pLEGTrainProgress->lastTrippedPtr(locoNum);
+    routeElement tempTPElement;
+    while ((tempTPPointer = pLEGTrainProgress->incrementTrainProgressPtr(tempTPPointer)) != pLEGTrainProgress->nextToTripPtr(locoNum)) {
+      tempTPElement = pLEGTrainProgress->peek(locoNum, tempTPPointer);
+      if (tempTPElement.routeRecType == FD) {
+        pDelayedAction->populateLocoCommand(departTime, locoNum, LEGACY_ACTION_FORWARD, 0, 0);
+      } else if (tempTPElement.routeRecType == RD) {
+        pDelayedAction->populateLocoCommand(departTime, locoNum, LEGACY_ACTION_REVERSE, 0, 0);
+      } else if ((tempTPElement.routeRecType == VL) && (tempTPElement.routeRecVal > LOCO_SPEED_STOP)) {
+        LEGSpeedChange(departTime, locoNum, tempTPElement.routeRecVal);
+      }
+    }
+    pLEGTrainProgress->setTimeToStart(locoNum, NEVER);
+  }
+  char msgType = pLEGMessage->available();
+  if (msgType == 'R') {
+    char extOrCont;
+    unsigned int routeRecNum;
+    unsigned int countdown;
+    pLEGMessage->getMAStoALLRoute(&locoNum, &extOrCont, &routeRecNum, &countdown);
+    if (extOrCont == ROUTE_TYPE_EXTENSION) {
+      pLEGTrainProgress->addExtensionRoute(locoNum, routeRecNum, (unsigned long)countdown * 1000UL);
+      pConductor->postEvent(CONDUCTOR_EVENT_ROUTE_ADDED, locoNum);
+    } else if (extOrCont == ROUTE_TYPE_CONTINUATION) {
+      pLEGTrainProgress->addContinuationRoute(locoNum, routeRecNum);
+    }
+    for (auto& train : trains) {
+      if (train.locoNum == locoNum) {
+        train.routeStops.push_back(pLEGTrainProgress->stopPtr(locoNum));
+      }
+    }
+    logLine("Loco %2i %s route %u%s", locoNum, (extOrCont == ROUTE_TYPE_EXTENSION) ? "Extension" : "Continuation",
+            pRoute->getRouteID(routeRecNum), options.trace ? routeText(routeRecNum).c_str() : "");
+  } else if (msgType == 'S') {
+    byte sensorNum;
+    char trippedOrCleared;
+    pLEGMessage->getSNStoALLSensorStatus(&sensorNum, &trippedOrCleared);
+    if (trippedOrCleared == SENSOR_STATUS_TRIPPED) {
+      LEGSensorTripped(sensorNum);
+    } else {
+      LEGSensorCleared(sensorNum);
+    }
+  } else if (msgType == 'M') {
+    byte mode;
+    byte state;
+    pLEGMessage->getMAStoALLModeState(&mode, &state);  // We never press Stop, so nothing to do
+  } else if (msgType != ' ') {
+    sprintf(lcdString, "AUTO MODE MSG ERR!"); pLCD2004->println(lcdString); Serial.println(lcdString); endWithFlashingLED(1);
+  }
+}
+
+// *** SNS ***
+
+static void SNSPass() {
+  hostSetModule(ARDUINO_SNS);
+  pSNSMessage->available();  // Nothing addressed to SNS in Auto mode but the Ok-To-Send, which sendSensorChange() waits for
+}
+
+static void runModules() {
+  // Each module takes turns until nothing is left on the bus.
+  for (unsigned int pass = 0; pass < PASSES_MAX; pass++) {
+    MASPass();
+    busDeliver();
+    LEGPass();
+    busDeliver();
+    SNSPass();
+    busDeliver();
+    if (busIsQuiet()) {
+      return;
+    }
+  }
+  printf("RS485 bus never went quiet.\n");
+  endWithFlashingLED(1);
+}
+
+static void sendSensorChange(const byte t_sensorNum, const char t_trippedOrCleared) {
+  // As O_SNS: read anything waiting for us first, then wait for MAS's Ok-To-Send and send the change to everyone.
+  while (!busIsQuiet()) {
+    SNSPass();
+    busDeliver();
+    MASPass();
+    busDeliver();
+    LEGPass();
+    busDeliver();
+  }
+  hostSetModule(ARDUINO_MAS);
+  pMASMessage->sendMAStoSNSRequestSensor(0);
+  busDeliver();
+  hostSetModule(ARDUINO_SNS);
+  pSNSMessage->sendSNStoALLSensorStatus(t_sensorNum, t_trippedOrCleared);
+  busDeliver();
+  runModules();
+}
+
+// *** Train movement ***
+
+static double blockLength(const byte t_blockNum) {
+  unsigned int length = pBlockReservation->length(t_blockNum);
+  return (length == 0) ? options.mainlineMm : length;
+}
+
+static double speedMmPerSec(const Sim_Train& t_train, const byte t_legacySpeed) {
+  // Straight lines between Loco Reference's Crawl/Low/Medium/High points; the last line continues above High.
+  if (t_legacySpeed == 0) {
+    return 0.0;
+  }
+  int i = 1;
+  while ((i < 4) && (t_legacySpeed > t_train.speed[i])) {
+    i++;
+  }
+  double run = (double)t_train.speed[i] - t_train.speed[i - 1];
+  double rise = t_train.mmPerSec[i] - t_train.mmPerSec[i - 1];
+  double mmPerSec = t_train.mmPerSec[i - 1];
+  if (run > 0) {
+    mmPerSec = mmPerSec + (rise * ((double)t_legacySpeed - t_train.speed[i - 1]) / run);
+  }
+  return t_train.factor * mmPerSec;
+}
+
+static double nominalStopMm(const Sim_Train& t_train) {
+  // populateLocoSlowToStop() from Crawl: about half Crawl speed for a second, then two seconds at Legacy speed 1.
+  return ((t_train.mmPerSec[LOCO_SPEED_CRAWL] * 0.5) + (2.0 * speedMmPerSec(t_train, 1) / t_train.factor));
+}
+
+static double sensorPosition(const Sim_Train& t_train, const byte t_sensorNum) {
+  // A sensor in the block being laid out is at its entry or exit end; any other is where the next block starts.
+  if (pSensorBlock->whichBlock(t_sensorNum) != t_train.frame.routeRecVal) {
+    return t_train.cursor;
+  }
+  char entryEnd = (t_train.frame.routeRecType == BE) ? SENSOR_END_WEST : SENSOR_END_EAST;
+  return (pSensorBlock->whichEnd(t_sensorNum) == entryEnd) ? t_train.frameStart : t_train.frameEnd;
+}
+
+static void addEvent(Sim_Train* t_train, const double t_pos, const char t_kind, const byte t_sensorNum, const byte t_elementPtr,
+                     const routeElement t_block) {
+  Sim_Event event = { t_kind, t_sensorNum, t_elementPtr, t_block };
+  t_train->events.insert(std::make_pair(t_pos, event));
+}
+
+static void layOutBlock(Sim_Train* t_train, const routeElement t_block) {
+  t_train->frame = t_block;
+  t_train->frameStart = t_train->cursor;
+  t_train->frameEnd = t_train->cursor + blockLength(t_block.routeRecVal);
+  t_train->cursor = t_train->frameEnd;
+}
+
+static void extendLayout(Sim_Train* t_train) {
+  // Turn LEG's Train Progress into track ahead of the train, up to a VL00 in mid-route or the end of the route.  The element
+  // before Head is left alone as an Extension route will overwrite it, and a Continuation route will add more after it.
+  const byte locoNum = t_train->locoNum;
+  while (!t_train->legEnds) {
+    byte lastPtr = pLEGTrainProgress->decrementTrainProgressPtr(pLEGTrainProgress->headPtr(locoNum));
+    if (t_train->layoutPtr == lastPtr) {
+      t_train->atEnd = true;
+      return;
+    }
+    t_train->atEnd = false;
+    byte elementPtr = t_train->layoutPtr;
+    routeElement element = pLEGTrainProgress->peek(locoNum, elementPtr);
+    t_train->layoutPtr = pLEGTrainProgress->incrementTrainProgressPtr(elementPtr);
+    if ((element.routeRecType == BE) || (element.routeRecType == BW)) {
+      addEvent(t_train, t_train->cursor, 'B', 0, elementPtr, element);
+      layOutBlock(t_train, element);
+    } else if ((element.routeRecType == TN) || (element.routeRecType == TR)) {
+      t_train->cursor = t_train->cursor + TURNOUT_MM;
+    } else if (element.routeRecType == SN) {
+      double pos = sensorPosition(*t_train, element.routeRecVal);
+      addEvent(t_train, pos, 'T', element.routeRecVal, elementPtr, element);
+      addEvent(t_train, pos + t_train->length, 'C', element.routeRecVal, elementPtr, element);
+    } else if ((element.routeRecType == VL) && (element.routeRecVal == LOCO_SPEED_STOP)) {
+      t_train->legEnds = true;
+    }
+  }
+}
+
+static void startLeg(Sim_Train* t_train) {
+  // The train is starting to move from a stop.  If its route starts by reversing through the block it's in, the front is now
+  // where the rear was.  Either way, the block it's in is the first thing on the new leg.
+  const byte locoNum = t_train->locoNum;
+  const byte lastPtr = pLEGTrainProgress->decrementTrainProgressPtr(pLEGTrainProgress->headPtr(locoNum));
+  byte elementPtr = t_train->layoutPtr;
+  routeElement element = { ER, 0 };
+  while (elementPtr != lastPtr) {
+    element = pLEGTrainProgress->peek(locoNum, elementPtr);
+    if ((element.routeRecType == BE) || (element.routeRecType == BW) || (element.routeRecType == TN) ||
+        (element.routeRecType == TR)) {
+      break;
+    }
+    elementPtr = pLEGTrainProgress->incrementTrainProgressPtr(elementPtr);
+  }
+  const double length = blockLength(t_train->block.routeRecVal);
+  t_train->events.clear();
+  t_train->cursor = 0.0;
+  if ((elementPtr != lastPtr) && ((element.routeRecType == BE) || (element.routeRecType == BW)) &&
+      (element.routeRecVal == t_train->block.routeRecVal)) {
+    if (element.routeRecType != t_train->block.routeRecType) {
+      t_train->front = std::min(std::max(t_train->length - t_train->overshoot, 0.0), length);
+    } else {
+      t_train->front = length + t_train->overshoot;
+    }
+    layOutBlock(t_train, element);
+    t_train->layoutPtr = pLEGTrainProgress->incrementTrainProgressPtr(elementPtr);
+  } else {
+    t_train->front = length + t_train->overshoot;
+    layOutBlock(t_train, t_train->block);
+  }
+  t_train->block = t_train->frame;
+  for (auto& sensor : t_train->covered) {  // Where the rear will clear whatever we're still sitting on
+    if (!sensor.second) {
+      double pos = t_train->front - t_train->length;
+      if (pSensorBlock->whichBlock(sensor.first) == t_train->frame.routeRecVal) {
+        pos = sensorPosition(*t_train, sensor.first);
+      }
+      addEvent(t_train, pos + t_train->length, 'C', sensor.first, 0, element);
+    }
+  }
+  t_train->legEnds = false;
+  t_train->atEnd = false;
+  t_train->stopTripped = false;
+  t_train->routeEnds = false;
+  t_train->crawlFrom = -1.0;
+  t_train->overran = false;
+  t_train->moving = true;
+  extendLayout(t_train);
+}
+
+static void stopped(Sim_Train* t_train) {
+  t_train->moving = false;
+  t_train->overshoot = max(0.0, t_train->front - t_train->lastTripPos);
+  if (t_train->stopTripped) {
+    stats.stopErrors.push_back(t_train->overshoot - nominalStopMm(*t_train));
+  }
+  if (t_train->routeEnds) {
+    logLine("Loco %2i stopped in %s%02i, %.0f mm past the sensor", t_train->locoNum,
+            (t_train->block.routeRecType == BE) ? "BE" : "BW", t_train->block.routeRecVal, t_train->overshoot);
+  }
+}
+
+static void sensorTripped(Sim_Train* t_train, const double t_pos, const Sim_Event& t_event) {
+  const byte sensorNum = t_event.sensorNum;
+  t_train->covered.push_back(std::make_pair(sensorNum, false));
+  t_train->lastTripPos = t_pos;
+  lastProgressMicros = hostMicros;
+  if ((!t_train->routeStops.empty()) && (t_event.elementPtr == t_train->routeStops.front())) {  // Stopping or continuing
+    t_train->routeStops.pop_front();
+    t_train->routes++;
+    stats.routes++;
+  }
+  routeElement next = pLEGTrainProgress->peek(t_train->locoNum, pLEGTrainProgress->incrementTrainProgressPtr(t_event.elementPtr));
+  if ((next.routeRecType == VL) && (next.routeRecVal == LOCO_SPEED_STOP)) {  // The sensor we should stop at
+    // Whatever follows the VL00 is for the next leg, even if it's an Extension route that arrives before we've stopped.
+    t_train->stopTripped = true;
+    t_train->routeEnds = (t_event.elementPtr == pLEGTrainProgress->stopPtr(t_train->locoNum));
+    t_train->legEnds = true;
+    if (pLEGTrainProgress->currentSpeed(t_train->locoNum) > t_train->speed[LOCO_SPEED_CRAWL]) {
+      stats.hotArrivals++;
+    } else if (t_train->crawlFrom >= 0.0) {
+      stats.crawlMm.push_back(t_pos - t_train->crawlFrom);
+    }
+  }
+  if (options.trace) {
+    printf("Loco %2i trips  SN%02i\n", t_train->locoNum, sensorNum);
+  }
+  if (sensorTrains[sensorNum]++ > 0) {  // Someone else is already on it, so SNS sees no change
+    stats.collisions++;
+    logLine("COLLISION: Loco %2i tripped SN%02i, which another train is on", t_train->locoNum, sensorNum);
+    return;
+  }
+  sendSensorChange(sensorNum, SENSOR_STATUS_TRIPPED);
+}
+
+static void sensorCleared(Sim_Train* t_train, const Sim_Event& t_event) {
+  // Train Progress expects clears in the order the sensors were tripped, which is the order the rear passes them.
+  for (auto& sensor : t_train->covered) {
+    if ((sensor.first == t_event.sensorNum) && (!sensor.second)) {
+      sensor.second = true;
+      break;
+    }
+  }
+  while ((!t_train->covered.empty()) && (t_train->covered.front().second)) {
+    const byte sensorNum = t_train->covered.front().first;
+    t_train->covered.pop_front();
+    if (options.trace) {
+      printf("Loco %2i clears SN%02i\n", t_train->locoNum, sensorNum);
+    }
+    if (--sensorTrains[sensorNum] == 0) {
+      sendSensorChange(sensorNum, SENSOR_STATUS_CLEARED);
+    }
+  }
+}
+
+struct Sim_Due {  // An event that falls within this step, and when
+  unsigned long micros;
+  size_t        train;
+  double        pos;
+  Sim_Event     event;
+};
+
+static void moveTrains(const unsigned long t_stepMicros) {
+  // Move every train for one step at the speed Engineer last sent it, then trip and clear sensors in time order.
+  std::vector<Sim_Due> due;
+  const unsigned long stepStart = hostMicros;
+  for (size_t i = 0; i < trains.size(); i++) {
+    Sim_Train* train = &trains[i];
+    const byte legacy = pLEGTrainProgress->currentSpeed(train->locoNum);
+    if (!train->moving) {
+      if (legacy == 0) {
+        continue;
+      }
+      startLeg(train);
+    }
+    extendLayout(train);
+    if (legacy > train->speed[LOCO_SPEED_CRAWL]) {
+      train->crawlFrom = -1.0;
+    } else if ((legacy > 0) && (train->crawlFrom < 0.0)) {
+      train->crawlFrom = train->front;
+    }
+    const double mmPerSec = speedMmPerSec(*train, legacy);
+    const double newFront = train->front + (mmPerSec * t_stepMicros / 1000000.0);
+    for (auto it = train->events.begin(); (it != train->events.end()) && (it->first <= newFront); ) {
+      double ahead = max(0.0, it->first - train->front);
+      unsigned long micros = stepStart + ((mmPerSec > 0) ? (unsigned long)(ahead * 1000000.0 / mmPerSec) : 0);
+      due.push_back({ min(micros, stepStart + t_stepMicros), i, it->first, it->second });
+      it = train->events.erase(it);
+    }
+    train->front = newFront;
+    if ((train->atEnd || train->legEnds) && (!train->overran) && (train->front > train->cursor + train->length)) {
+      train->overran = true;
+      stats.overruns++;
+      logLine("Loco %2i ran past the end of its route", train->locoNum);
+    }
+    if ((legacy == 0) && train->moving) {
+      stopped(train);
+    }
+  }
+  std::stable_sort(due.begin(), due.end(), [](const Sim_Due& a, const Sim_Due& b) { return a.micros < b.micros; });
+  for (auto& d : due) {
+    if (hostMicros < d.micros) {
+      hostMicros = d.micros;
+    }
+    Sim_Train* train = &trains[d.train];
+    if (d.event.kind == 'B') {
+      train->block = d.event.block;
+    } else if (d.event.kind == 'T') {
+      sensorTripped(train, d.pos, d.event);
+    } else {
+      sensorCleared(train, d.event);
+    }
+  }
+}
+
+// *** Registration, and starting over after a deadlock ***
+
+static void registerTrains() {
+  hostSetModule(ARDUINO_MAS);
+  for (auto& train : trains) {
+    const byte locoNum = train.locoNum;
+    pMASTrainProgress->setInitialRoute(locoNum, train.home);
+    pLEGTrainProgress->setInitialRoute(locoNum, train.home);
+    pBlockReservation->reserveBlock(train.home.routeRecVal, train.home.routeRecType, locoNum);
+    byte stopSensor = (train.home.routeRecType == BE) ? pBlockReservation->eastSensor(train.home.routeRecVal)
+                                                       : pBlockReservation->westSensor(train.home.routeRecVal);
+    pSensorBlock->setSensorStatus(stopSensor, SENSOR_STATUS_TRIPPED);
+    sensorTrains[stopSensor]++;
+    train.block = train.home;
+    train.overshoot = nominalStopMm(train);
+    train.front = blockLength(train.home.routeRecVal) + train.overshoot;
+    train.lastTripPos = blockLength(train.home.routeRecVal);
+    train.moving = false;
+    train.layoutPtr = pLEGTrainProgress->decrementTrainProgressPtr(pLEGTrainProgress->headPtr(locoNum));
+    train.legEnds = false;
+    train.atEnd = true;
+    train.events.clear();
+    train.covered.clear();
+    train.covered.push_back(std::make_pair(stopSensor, false));
+    train.routeStops.clear();
+  }
+  pDispatcher->startDispatching(modeCurrent);
+  hostSetModule(ARDUINO_LEG);
+  pConductor->resetEvents();
+  lastProgressMicros = hostMicros;
+}
+
+static void resetLayout() {
+  busClear();
+  hostSetModule(ARDUINO_MAS);
+  pMASTrainProgress->begin(pBlockReservation, pRoute);
+  pBlockReservation->releaseAllBlocks();
+  pTurnoutReservation->releaseAll();
+  for (byte sensorNum = 1; sensorNum <= TOTAL_SENSORS; sensorNum++) {
+    pSensorBlock->setSensorStatus(sensorNum, SENSOR_STATUS_CLEARED);
+    sensorTrains[sensorNum] = 0;
+  }
+  hostSetModule(ARDUINO_LEG);
+  pLEGTrainProgress->begin(pBlockReservation, pRoute);
+  pDelayedAction->initDelayedActionTable(false);
+  pEngineer->initLegacyCommandBuf(false);
+  registerTrains();
+}
+
+static void reportDeadlock() {
+  stats.deadlocks++;
+  logLine("DEADLOCK: no sensor tripped in %.0f minutes", options.deadlockMinutes);
+  if (!options.quiet) {
+    for (auto& train : trains) {
+      printf("           Loco %2i in %s%02i, %s\n", train.locoNum, (train.block.routeRecType == BE) ? "BE" : "BW",
+             train.block.routeRecVal, train.moving ? "moving" : "stopped");
+    }
+  }
+  resetLayout();
+}
+
+// *** Setup and report ***
+
+static bool parseTrain(const char* t_arg) {
+  // LOCO:BLOCK i.e. 5:BW03
+  unsigned int locoNum;
+  char direction[3];
+  unsigned int blockNum;
+  if ((sscanf(t_arg, "%u:%2[BEWbew]%u", &locoNum, direction, &blockNum) != 3) || (locoNum < 1) || (locoNum > TOTAL_TRAINS) ||
+      (blockNum < 1) || (blockNum > TOTAL_BLOCKS) || (toupper(direction[0]) != 'B')) {
+    return false;
+  }
+  Sim_Train train = Sim_Train();
+  train.locoNum = (byte)locoNum;
+  train.home.routeRecType = (toupper(direction[1]) == 'E') ? BE : BW;
+  train.home.routeRecVal = (byte)blockNum;
+  trains.push_back(train);
+  return true;
+}
+
+static void usage() {
+  printf("Usage: Layout_Sim <host image> [--hours H] [--train LOCO:BLOCK ...] [--seed N] [--speed-error E]\n"
+         "                  [--mainline-mm MM] [--deadlock-minutes M] [--trace] [--quiet]\n");
+}
+
+static bool parseOptions(int argc, char* argv[]) {
+  for (int i = 1; i < argc; i++) {
+    const std::string arg = argv[i];
+    const bool hasValue = (i + 1 < argc);
+    if ((arg == "--hours") && hasValue) {
+      options.hours = atof(argv[++i]);
+    } else if ((arg == "--train") && hasValue) {
+      if (!parseTrain(argv[++i])) {
+        printf("Bad --train %s; want LOCO:BLOCK i.e. 5:BW03\n", argv[i]);
+        return false;
+      }
+    } else if ((arg == "--seed") && hasValue) {
+      options.seed = strtoul(argv[++i], nullptr, 10);
+    } else if ((arg == "--speed-error") && hasValue) {
+      options.speedError = atof(argv[++i]);
+    } else if ((arg == "--mainline-mm") && hasValue) {
+      options.mainlineMm = (unsigned int)atoi(argv[++i]);
+    } else if ((arg == "--deadlock-minutes") && hasValue) {
+      options.deadlockMinutes = atof(argv[++i]);
+    } else if (arg == "--trace") {
+      options.trace = true;
+    } else if (arg == "--quiet") {
+      options.quiet = true;
+    } else if ((arg[0] != '-') && (options.imageName == nullptr)) {
+      options.imageName = argv[i];
+    } else {
+      return false;
+    }
+  }
+  return (options.imageName != nullptr) && (options.hours > 0);
+}
+
+static bool setupModules() {
+  pLCD2004 = new Display_2004(&lcdPort, SERIAL1_SPEED);
+  pLCD2004->setQueued(true);
+  pStorage = new FRAM(MB85RS4MT, PIN_IO_FRAM_CS);
+  pStorage->begin();
+  if (!hostLoadFRAM(options.imageName)) {
+    printf("Can't load FRAM image %s\n", options.imageName);
+    return false;
+  }
+  pTurnoutReservation = new Turnout_Reservation;
+  pTurnoutReservation->begin(pStorage);
+  pSensorBlock = new Sensor_Block;
+  pSensorBlock->begin(pStorage);
+  pBlockReservation = new Block_Reservation;
+  pBlockReservation->begin(pStorage, nullptr);
+  pLoco = new Loco_Reference;
+  pLoco->begin(pStorage);
+  pDeadlock = new Deadlock_Reference;
+  pDeadlock->begin(pStorage, pBlockReservation, pLoco);
+  pRoute = new Route_Reference;
+  pRoute->begin(pStorage);
+
+  hostSetModule(ARDUINO_MAS);
+  pMASMessage = new Message;
+  pMASMessage->begin(&Serial2, SERIAL2_SPEED);
+  pMASTrainProgress = new Train_Progress;
+  pMASTrainProgress->begin(pBlockReservation, pRoute);
+  pModeSelector = new Mode_Dial;
+  pModeSelector->begin(&modeCurrent, &stateCurrent);
+  modeCurrent = MODE_AUTO;  // As if the operator had turned the dial to Auto and pressed Start
+  stateCurrent = STATE_RUNNING;
+  pDispatcher = new Dispatcher;
+  pDispatcher->begin(pMASMessage, pLoco, pBlockReservation, pTurnoutReservation, pSensorBlock, pRoute, pDeadlock,
+                     pMASTrainProgress, pModeSelector);
+
+  hostSetModule(ARDUINO_LEG);
+  pLEGMessage = new Message;
+  pLEGMessage->begin(&legBus, SERIAL2_SPEED);
+  pLEGTrainProgress = new Train_Progress;
+  pLEGTrainProgress->begin(pBlockReservation, pRoute);
+  pDelayedAction = new Delayed_Action;
+  pDelayedAction->begin(pLoco, pLEGTrainProgress);
+  pEngineer = new Engineer;
+  pEngineer->begin(pLoco, pLEGTrainProgress, pDelayedAction, nullptr);
+  pConductor = new Conductor;
+  pConductor->begin(pStorage, pBlockReservation, pLEGTrainProgress, pDelayedAction, pEngineer);
+
+  hostSetModule(ARDUINO_SNS);
+  pSNSMessage = new Message;
+  pSNSMessage->begin(&snsBus, SERIAL2_SPEED);
+  busClear();
+  return true;
+}
+
+static bool setupTrains() {
+  std::mt19937 random(options.seed);
+  std::normal_distribution<double> speedError(1.0, options.speedError);
+  for (auto& train : trains) {
+    const byte locoNum = train.locoNum;
+    if (!pLoco->active(locoNum)) {
+      printf("Loco %i isn't in Loco Reference.\n", locoNum);
+      return false;
+    }
+    if (pBlockReservation->reservedForTrain(train.home.routeRecVal) != LOCO_ID_NULL) {
+      printf("Block %i is already taken.\n", train.home.routeRecVal);
+      return false;
+    }
+    pBlockReservation->reserveBlock(train.home.routeRecVal, train.home.routeRecType, locoNum);  // Just to catch duplicates
+    train.factor = std::min(std::max(speedError(random), 0.5), 1.5);
+    train.length = pLoco->length(locoNum);
+    train.speed[LOCO_SPEED_STOP] = 0;
+    train.mmPerSec[LOCO_SPEED_STOP] = 0;
+    train.speed[LOCO_SPEED_CRAWL] = pLoco->crawlSpeed(locoNum);
+    train.mmPerSec[LOCO_SPEED_CRAWL] = pLoco->crawlMmPerSec(locoNum);
+    train.speed[LOCO_SPEED_LOW] = pLoco->lowSpeed(locoNum);
+    train.mmPerSec[LOCO_SPEED_LOW] = pLoco->lowMmPerSec(locoNum);
+    train.speed[LOCO_SPEED_MEDIUM] = pLoco->medSpeed(locoNum);
+    train.mmPerSec[LOCO_SPEED_MEDIUM] = pLoco->medMmPerSec(locoNum);
+    train.speed[LOCO_SPEED_HIGH] = pLoco->highSpeed(locoNum);
+    train.mmPerSec[LOCO_SPEED_HIGH] = pLoco->highMmPerSec(locoNum);
+  }
+  pBlockReservation->releaseAllBlocks();
+  return true;
+}
+
+static void report(const double t_wallSeconds) {
+  const double hours = simSeconds() / 3600.0;
+  printf("\nSimulated %.1f hours in %.1f sec (%.0fx real time.)\n", hours, t_wallSeconds,
+         hours * 3600.0 / max(t_wallSeconds, 0.001));
+  printf("Trains:                %u\n", (unsigned int)trains.size());
+  printf("Routes completed:      %lu (%.1f per hour)\n", stats.routes, stats.routes / hours);
+  for (auto& train : trains) {
+    char name[ALPHA_WIDTH + 1] = "";
+    pLoco->alphaDesc(train.locoNum, name, ALPHA_WIDTH);
+    name[ALPHA_WIDTH] = 0;
+    printf("  Loco %2i %-8.8s       %u (%.1f per hour, speed %+.1f%%)\n", train.locoNum, name, train.routes,
+           train.routes / hours, (train.factor - 1.0) * 100.0);
+  }
+  printf("Deadlocks:             %lu\n", stats.deadlocks);
+  printf("Sensor collisions:     %lu\n", stats.collisions);
+  printf("Ran past end of route: %lu\n", stats.overruns);
+  if (!stats.stopErrors.empty()) {
+    double sum = 0.0;
+    double worst = 0.0;
+    for (double e : stats.stopErrors) {
+      sum += e;
+      if (fabs(e) > fabs(worst)) {
+        worst = e;
+      }
+    }
+    const double mean = sum / stats.stopErrors.size();
+    double squares = 0.0;
+    for (double e : stats.stopErrors) {
+      squares += (e - mean) * (e - mean);
+    }
+    printf("Stops:                 %u\n", (unsigned int)stats.stopErrors.size());
+    printf("Stop error (mm):       mean %+.0f, std dev %.0f, worst %+.0f\n", mean, sqrt(squares / stats.stopErrors.size()),
+           worst);
+    printf("Arrived above Crawl:   %lu\n", stats.hotArrivals);
+  }
+  printf("Slowed to Crawl early: %lu (no getDistanceAndMomentum() for that block)\n", stats.crawlFallbacks);
+  if (!stats.crawlMm.empty()) {
+    double sum = 0.0;
+    double longest = 0.0;
+    for (double c : stats.crawlMm) {
+      sum += c;
+      longest = max(longest, c);
+    }
+    printf("Crawl before stop (mm): mean %.0f, longest %.0f\n", sum / stats.crawlMm.size(), longest);
+  }
+  if (!options.quiet) {  // The modules' own statistics, since the last Registration
+    hostSetModule(ARDUINO_MAS);
+    pDispatcher->displayStats();
+    hostSetModule(ARDUINO_LEG);
+    pConductor->displayStats();
+    pEngineer->displayStats();
+    fwrite(Serial.hostOut, 1, Serial.hostOutLen, stdout);
+    Serial.hostOutLen = 0;
+  }
+}
+
+int main(int argc, char* argv[]) {
+  if (!parseOptions(argc, argv)) {
+    usage();
+    return 1;
+  }
+  srand(options.seed);
+  hostTickMicros = CLOCK_TICK_MICROS;
+  const auto wallStart = std::chrono::steady_clock::now();
+  try {
+    if (!setupModules()) {
+      return 1;
+    }
+    if (trains.empty() || !setupTrains()) {
+      printf("Need one --train LOCO:BLOCK per train, each in a different block.\n");
+      return 1;
+    }
+    resetLayout();
+    const unsigned long endMicros = (unsigned long)(options.hours * 3600.0 * 1000000.0);
+    const unsigned long deadlockMicros = (unsigned long)(options.deadlockMinutes * 60.0 * 1000000.0);
+    while (hostMicros < endMicros) {
+      runModules();
+      const unsigned long stepEnd = hostMicros + (TICK_MS * 1000UL);
+      moveTrains(TICK_MS * 1000UL);
+      if (hostMicros < stepEnd) {
+        hostMicros = stepEnd;
+      }
+      if (hostMicros - lastProgressMicros > deadlockMicros) {
+        reportDeadlock();
+      }
+    }
+  } catch (Host_Fatal& fatal) {
+    drainConsole();
+    printf("FATAL \"%s\" (%i flashes) at %.1f sec.  Last output:\n%s\n", lcdString, fatal.numFlashes, simSeconds(),
+           consoleTail.substr(consoleTail.size() > 1000 ? consoleTail.size() - 1000 : 0).c_str());
+    return 1;
+  }
+  report(std::chrono::duration<double>(std::chrono::steady_clock::now() - wallStart).count());
+  return ((stats.collisions == 0) && (stats.routes > 0)) ? 0 : 1;
+}
@@ -0,0 +1,220 @@
+// TEST_DISPLAY_2004.CPP Rev: 10/19/26.
+// Host test of libraries/Display_2004 against a simulated Digole 2004 LCD on Serial1.  The simulator decodes the "TP" x y
+// (set print position) and "TT" text\0 (print text) commands into a 4 x 20 screen, and models Serial1's 63-byte transmit
+// buffer draining at 115200 baud, so we can check that queued mode:
+//   - doesn't allocate its ring until setQueued(true), so modules that never queue don't pay for it;
+//   - sends nothing from println(), and from service() never more than fits in the transmit buffer (so write() never waits);
+//   - leaves at least LCD_SEND_GAP_US (2ms) between runs, and ends up showing exactly what direct mode would have shown;
+//   - drops the oldest waiting lines when the ring overflows and says "LCD DROPPED n" in their place;
+//   - shows everything queued when turned off, and when endWithFlashingLED() halts.
+// This checks the logic and the serial timing; whether the Digole itself is happy with a 2ms gap is a hardware question.
+
+#include <Display_2004.h>
+#include "Host_Test.h"
+#include <new>
+
+const byte THIS_MODULE = ARDUINO_MAS;
+char lcdString[LCD_WIDTH + 1] = "MAS host test";
+Display_2004* pLCD2004 = nullptr;
+
+// Count heap use, to see when Display_2004 allocates its ring.
+static unsigned long hostNewBytes = 0;
+void* operator new(size_t t_bytes) {
+  hostNewBytes += t_bytes;
+  void* p = malloc(t_bytes);
+  if (p == nullptr) throw std::bad_alloc();
+  return p;
+}
+void operator delete(void* t_p) noexcept { free(t_p); }
+void operator delete(void* t_p, size_t) noexcept { free(t_p); }
+
+class Digole_Sim : public HardwareSerial {
+  public:
+    static const int TX_BUF = 63;             // Arduino HardwareSerial transmit buffer, less one
+    static const unsigned long BYTE_US = 87;  // 10 bits at 115200 baud
+    char screen[4][LCD_WIDTH + 1];
+    unsigned long bytesSent = 0;
+    unsigned long runs = 0;               // "TP" commands seen
+    unsigned long lastRunUs = 0;
+    unsigned long minRunGapUs = 0xFFFFFFFF;
+    bool blocked = false;                 // Set if a write had to wait for room in the transmit buffer
+    bool sawDropped = false;              // "LCD DROPPED" appeared on the screen
+
+    Digole_Sim() { clear(); }
+    void resetStats() {  // Direct mode blocks and paces with delay(), so only count from here on
+      runs = 0;
+      minRunGapUs = 0xFFFFFFFF;
+      blocked = false;
+    }
+    void clear() {
+      for (byte r = 0; r < 4; r++) {
+        memset(screen[r], ' ', LCD_WIDTH);
+        screen[r][LCD_WIDTH] = '\0';
+      }
+    }
+    int availableForWrite() {
+      drain();
+      return TX_BUF - m_pending;
+    }
+    size_t write(uint8_t t_c) {
+      drain();
+      if (m_pending >= TX_BUF) {
+        blocked = true;  // The real write() would spin here until a byte went out
+        hostMicros += BYTE_US;
+        drain();
+      }
+      m_pending++;
+      bytesSent++;
+      decode(t_c);
+      return 1;
+    }
+    using Print::write;
+    bool rowIs(byte t_row, const char* t_text) {  // t_text padded with spaces to 20 chars
+      char want[LCD_WIDTH + 1];
+      snprintf(want, sizeof(want), "%-20s", t_text);
+      return strcmp(screen[t_row], want) == 0;
+    }
+
+  private:
+    int m_pending = 0;
+    unsigned long m_drainedUs = 0;
+    byte m_state = 0;
+    byte m_x = 0;
+    byte m_y = 0;
+
+    void drain() {
+      while ((m_pending > 0) && (hostMicros - m_drainedUs >= BYTE_US)) {
+        m_pending--;
+        m_drainedUs += BYTE_US;
+      }
+      if (m_pending == 0) m_drainedUs = hostMicros;
+    }
+    void decode(uint8_t t_c) {
+      switch (m_state) {
+        case 0: m_state = (t_c == 'T') ? 1 : 0; break;
+        case 1:
+          if (t_c == 'P') {
+            m_state = 2;
+            if (runs++ > 0 && hostMicros - lastRunUs < minRunGapUs) minRunGapUs = hostMicros - lastRunUs;
+            lastRunUs = hostMicros;
+          } else {
+            m_state = (t_c == 'T') ? 3 : 0;
+          }
+          break;
+        case 2: m_x = t_c; m_state = 4; break;
+        case 4: m_y = t_c; m_state = 0; break;
+        case 3:
+          if (t_c == 0) {
+            m_state = 0;
+            for (byte r = 0; r < 4; r++) {
+              if (strncmp(screen[r], "LCD DROPPED", 11) == 0) sawDropped = true;
+            }
+          } else if ((m_y < 4) && (m_x < LCD_WIDTH)) {
+            screen[m_y][m_x++] = t_c;
+          }
+          break;
+      }
+    }
+};
+
+Digole_Sim lcdSim;
+
+static unsigned long servicePasses(unsigned long t_passes) {  // One Auto/Park loop pass every 100us
+  unsigned long sent = lcdSim.bytesSent;
+  for (unsigned long i = 0; i < t_passes; i++) {
+    hostMicros += 100;
+    pLCD2004->service();
+  }
+  return lcdSim.bytesSent - sent;
+}
+
+static void testDirectModeAllocatesNoRing() {
+  hostNewBytes = 0;
+  pLCD2004 = new Display_2004(&lcdSim, SERIAL1_SPEED);
+  unsigned long objectBytes = hostNewBytes;
+  pLCD2004->begin();
+  pLCD2004->println("Line A");
+  pLCD2004->println("Line B");
+  CHECK(lcdSim.rowIs(2, "Line A") && lcdSim.rowIs(3, "Line B"));
+  CHECK(hostNewBytes == objectBytes);  // Nothing more allocated in direct mode
+  CHECK(objectBytes < 4u * (LCD_WIDTH + 1) + 64);  // m_line[] plus Digole's and our bookkeeping; no ring
+  pLCD2004->setQueued(true);
+  CHECK(hostNewBytes > objectBytes + 8u * (LCD_WIDTH + 1));  // Now the ring is allocated...
+  unsigned long queuedBytes = hostNewBytes;
+  pLCD2004->setQueued(false);
+  pLCD2004->setQueued(true);
+  CHECK(hostNewBytes == queuedBytes);  // ...once.
+  pLCD2004->setQueued(false);
+}
+
+static void testQueuedPrintlnSendsNothing() {
+  pLCD2004->setQueued(true);
+  lcdSim.resetStats();
+  unsigned long sent = lcdSim.bytesSent;
+  pLCD2004->println("Line C");
+  pLCD2004->println("Line D");
+  CHECK(lcdSim.bytesSent == sent);
+  CHECK(lcdSim.rowIs(3, "Line B"));  // Still the old screen
+  servicePasses(500);
+  CHECK(lcdSim.rowIs(0, "Line A") && lcdSim.rowIs(1, "Line B") && lcdSim.rowIs(2, "Line C") && lcdSim.rowIs(3, "Line D"));
+  CHECK(!lcdSim.blocked);
+  CHECK(lcdSim.minRunGapUs >= 2000);
+  CHECK(servicePasses(100) == 0);  // Nothing left to send
+}
+
+static void testOverflowDropsOldest() {
+  char line[LCD_WIDTH + 1];
+  for (byte i = 0; i < 12; i++) {  // Ring holds 8
+    sprintf(line, "Burst %i", i);
+    pLCD2004->println(line);
+  }
+  servicePasses(2000);
+  CHECK(lcdSim.sawDropped);
+  CHECK(lcdSim.rowIs(0, "Burst 8") && lcdSim.rowIs(1, "Burst 9") && lcdSim.rowIs(2, "Burst 10") && lcdSim.rowIs(3, "Burst 11"));
+  CHECK(!lcdSim.blocked);
+  CHECK(lcdSim.minRunGapUs >= 2000);
+}
+
+static void testOnlyChangesAreSent() {
+  pLCD2004->println("Burst 11");  // Rows 0..2 scroll to what's on rows 1..3, so every row changes; then the same again
+  servicePasses(500);
+  unsigned long sent = lcdSim.bytesSent;
+  pLCD2004->printRowCol(4, 20, "X");
+  servicePasses(500);
+  CHECK(lcdSim.rowIs(3, "Burst 11           X"));
+  CHECK(lcdSim.bytesSent - sent <= 1 + 7);  // One char plus "TP" x y, "TT" and the null
+}
+
+static void testPrintRowColKeepsOrder() {
+  pLCD2004->println("First");
+  pLCD2004->printRowCol(4, 10, "<<");  // Must land on "First", which was printed before it
+  servicePasses(500);
+  CHECK(lcdSim.rowIs(3, "First    <<"));
+}
+
+static void testTurningOffFlushes() {
+  pLCD2004->println("Last queued");
+  pLCD2004->setQueued(false);
+  CHECK(lcdSim.rowIs(3, "Last queued"));
+  pLCD2004->println("Direct again");
+  CHECK(lcdSim.rowIs(2, "Last queued") && lcdSim.rowIs(3, "Direct again"));
+}
+
+static void testFatalErrorIsShown() {
+  pLCD2004->setQueued(true);
+  CHECK_FATAL({ pLCD2004->println("FATAL ERROR"); endWithFlashingLED(1); });
+  CHECK(lcdSim.rowIs(3, "FATAL ERROR"));
+  pLCD2004->setQueued(false);
+}
+
+int main() {
+  hostTickMicros = 10;  // flush() spins on micros(), so let the clock run
+  testDirectModeAllocatesNoRing();
+  testQueuedPrintlnSendsNothing();
+  testOverflowDropsOldest();
+  testOnlyChangesAreSent();
+  testPrintRowColKeepsOrder();
+  testTurningOffFlushes();
+  testFatalErrorIsShown();
+  return hostTestResult("Display_2004");
+}
@@ -0,0 +1,186 @@
+// TEST_ENGINEER_ENCODING.CPP Rev: 10/19/26.
+// Host test of the table-driven Legacy/TMCC encoder in libraries/Engineer (translateToLegacy() and translateToTMCC().)
+// 1. Compares every command byte, and whether the call was fatal, with the old switch-based encoder (Engineer_Old.cpp) for
+//    every device type, loco 0..99 and command 0..49, over Parm 1 0..255 at the loco range edges and over the Parm 1 table
+//    limits for the other locos.  Only the two intended behavior changes may differ:
+// 2. TMCC_DIALOGUE used to fall through into the "TMCC BAD CMD" default and halt even for a good dialogue.  It now sends the
+//    3- or 6-byte StationSounds Diner key presses that the old code had built before falling through.
+// 3. LEGACY_NUMERIC_PRESS used to accept any Parm 1 and send 0x10 + parm; it now halts on digits above 9.
+
+#include <Train_Consts_Global.h>
+#include <Train_Functions.h>
+#include <Display_2004.h>
+#include <Loco_Reference.h>
+#include <Train_Progress.h>
+#include <Delayed_Action.h>
+#include <Event_Journal.h>
+#include <Loop_Profiler.h>
+#define private public  // The translate functions are private
+#include <Engineer.h>
+#undef private
+#include "Engineer_Old.h"
+#include "Host_Test.h"
+
+const byte THIS_MODULE = ARDUINO_LEG;
+char lcdString[LCD_WIDTH + 1] = "LEG host test";
+Display_2004* pLCD2004 = nullptr;
+
+// Loco_Reference::devType() normally reads FRAM; here every loco is whatever type the test is sweeping.
+static char hostDevType = DEV_TYPE_LEGACY_ENGINE;
+char Loco_Reference::devType(const byte t_locoNum) {
+  return hostDevType;
+}
+
+// The encoder never calls these collaborators; they're only here so Engineer.cpp links.
+bool Delayed_Action::getAction(char*, byte*, byte*, byte*, byte*) { return false; }
+void Train_Progress::setStopped(const byte, const bool) {}
+void Train_Progress::setTimeStopped(const byte, unsigned long) {}
+void Train_Progress::setSpeedAndTime(const byte, const byte, const unsigned long) {}
+void Centipede::digitalWrite(int, int) {}
+void Event_Journal::log(const byte, const byte, const unsigned int, const byte, const unsigned int) {}
+void Loop_Profiler::record(const byte, const unsigned long) {}
+
+Engineer* pNew = nullptr;
+Engineer_Old* pOld = nullptr;
+
+struct Result {
+  bool fatal;
+  int flashes;
+  byte bytes[LEGACY_CMD_BYTES];
+};
+
+static Result encodeNew(bool t_tmcc, byte t_num, byte t_cmd, byte t_parm) {
+  Result r = { false, 0, { 0 } };
+  try {
+    Engineer::legacyCommandStruct c = t_tmcc ? pNew->translateToTMCC(t_num, t_cmd, t_parm, 0) :
+                                               pNew->translateToLegacy(t_num, t_cmd, t_parm, 0);
+    memcpy(r.bytes, c.legacyCommandByte, LEGACY_CMD_BYTES);
+  } catch (Host_Fatal& f) {
+    r.fatal = true;
+    r.flashes = f.numFlashes;
+  }
+  return r;
+}
+
+static Result encodeOld(bool t_tmcc, byte t_num, byte t_cmd, byte t_parm) {
+  Result r = { false, 0, { 0 } };
+  try {
+    Engineer_Old::legacyCommandStruct c = t_tmcc ? pOld->translateToTMCC(t_num, t_cmd, t_parm, 0) :
+                                                   pOld->translateToLegacy(t_num, t_cmd, t_parm, 0);
+    memcpy(r.bytes, c.legacyCommandByte, LEGACY_CMD_BYTES);
+  } catch (Host_Fatal& f) {
+    r.fatal = true;
+    r.flashes = f.numFlashes;
+  }
+  return r;
+}
+
+// Every Parm 1 is tried for locos at and around each range boundary; other locos get the parms at and around each table limit.
+static const byte edgeLocos[] = { 0, 1, 2, 8, 9, 10, 11, 49, 50, 51, 90, 91, 92, 94, 95, 99 };
+static const byte edgeParms[] = { 0, 1, 2, 3, 4, 6, 7, 8, 9, 10, 15, 16, 31, 32, 118, 119, 199, 200, 255 };
+
+static bool isEdgeLoco(byte t_num) {
+  for (byte i = 0; i < sizeof(edgeLocos); i++) {
+    if (edgeLocos[i] == t_num) return true;
+  }
+  return false;
+}
+
+static void testSameAsOldEncoder() {
+  // Every combination must match the old encoder, except for the two intended changes which are tested separately below.
+  const char devTypes[] = { DEV_TYPE_LEGACY_ENGINE, DEV_TYPE_LEGACY_TRAIN, DEV_TYPE_TMCC_ENGINE, DEV_TYPE_TMCC_TRAIN,
+                            DEV_TYPE_ACCESSORY };
+  unsigned long compared = 0;
+  unsigned long mismatches = 0;
+  unsigned long dialogueChanges = 0;
+  unsigned long numericChanges = 0;
+  for (byte d = 0; d < sizeof(devTypes); d++) {
+    hostDevType = devTypes[d];
+    bool tmcc = (hostDevType == DEV_TYPE_TMCC_ENGINE) || (hostDevType == DEV_TYPE_TMCC_TRAIN);
+    for (byte num = 0; num < 100; num++) {
+      for (byte cmd = 0; cmd < 50; cmd++) {
+        unsigned parms = isEdgeLoco(num) ? 256 : sizeof(edgeParms);
+        for (unsigned i = 0; i < parms; i++) {
+          byte parm = isEdgeLoco(num) ? (byte)i : edgeParms[i];
+          Result n = encodeNew(tmcc, num, cmd, parm);
+          Result o = encodeOld(tmcc, num, cmd, parm);
+          compared++;
+          bool same = (n.fatal == o.fatal) && (n.fatal ? (n.flashes == o.flashes) : !memcmp(n.bytes, o.bytes, LEGACY_CMD_BYTES));
+          if (same) continue;
+          if (tmcc && (cmd == TMCC_DIALOGUE) && (parm >= 1) && (parm <= 6) && o.fatal && !n.fatal) {
+            dialogueChanges++;
+          } else if (!tmcc && (cmd == LEGACY_NUMERIC_PRESS) && (parm > 9) && !o.fatal && n.fatal) {
+            numericChanges++;
+          } else {
+            if (mismatches++ < 10) {
+              printf("  Differs: type %c loco %i cmd %i parm %i: old %s, new %s\n", hostDevType, num, cmd, parm,
+                     o.fatal ? "fatal" : "ok", n.fatal ? "fatal" : "ok");
+            }
+          }
+        }
+      }
+    }
+  }
+  printf("  Compared %lu encodings; %lu TMCC_DIALOGUE and %lu LEGACY_NUMERIC_PRESS differences are intended.\n",
+         compared, dialogueChanges, numericChanges);
+  CHECK(mismatches == 0);
+  CHECK(dialogueChanges > 0);
+  CHECK(numericChanges > 0);
+}
+
+static void testTMCCDialogueNoLongerHalts() {
+  // BEHAVIOR CHANGE: the old encoder halted ("ENG'R TMCC BAD CMD!") on every TMCC_DIALOGUE.
+  struct { byte parm; byte key1; byte key2; } dialogues[] = {
+    { TMCC_DIALOGUE_STATION_ARRIVAL,         0x09, 0x17 },  // Aux1 + 7
+    { TMCC_DIALOGUE_STATION_DEPARTURE,       0x17, 0x00 },  // 7
+    { TMCC_DIALOGUE_CONDUCTOR_ARRIVAL,       0x09, 0x12 },  // Aux1 + 2
+    { TMCC_DIALOGUE_CONDUCTOR_DEPARTURE,     0x12, 0x00 },  // 2
+    { TMCC_DIALOGUE_CONDUCTOR_TICKETS_DINER, 0x12, 0x00 },  // 2
+    { TMCC_DIALOGUE_CONDUCTOR_STOPPING,      0x09, 0x12 }   // Aux1 + 2
+  };
+  hostDevType = DEV_TYPE_TMCC_ENGINE;
+  for (byte i = 0; i < 6; i++) {
+    const byte loco = 11;  // Odd, so the low address bit lands in bit 7 of the key press bytes
+    CHECK(encodeOld(true, loco, TMCC_DIALOGUE, dialogues[i].parm).fatal);
+    Result r = encodeNew(true, loco, TMCC_DIALOGUE, dialogues[i].parm);
+    CHECK(!r.fatal);
+    CHECK(r.bytes[0] == 0xFE);
+    CHECK(r.bytes[1] == (loco >> 1));
+    CHECK(r.bytes[2] == (byte)(0x80 + dialogues[i].key1));
+    if (dialogues[i].key2 == 0) {  // 3-byte command
+      CHECK(r.bytes[3] == 0 && r.bytes[4] == 0 && r.bytes[5] == 0);
+    } else {  // 6-byte command repeats bytes 1 and 2 ahead of the second key
+      CHECK(r.bytes[3] == 0xFE);
+      CHECK(r.bytes[4] == (loco >> 1));
+      CHECK(r.bytes[5] == (byte)(0x80 + dialogues[i].key2));
+    }
+  }
+  hostDevType = DEV_TYPE_TMCC_TRAIN;
+  Result r = encodeNew(true, 4, TMCC_DIALOGUE, TMCC_DIALOGUE_STATION_DEPARTURE);
+  CHECK(!r.fatal && r.bytes[0] == 0xFE && r.bytes[1] == 0xC8 + 2 && r.bytes[2] == 0x17);
+  CHECK(encodeNew(true, 4, TMCC_DIALOGUE, 0).fatal);  // Dialogue numbers are still 1..6
+  CHECK(encodeNew(true, 4, TMCC_DIALOGUE, 7).fatal);
+}
+
+static void testNumericPressRejectsDigitsAbove9() {
+  // BEHAVIOR CHANGE: the old encoder sent 0x10 + parm for any parm, i.e. 0x1A for "10", which is a different Legacy command.
+  hostDevType = DEV_TYPE_LEGACY_ENGINE;
+  for (byte digit = 0; digit <= 9; digit++) {
+    Result r = encodeNew(false, 12, LEGACY_NUMERIC_PRESS, digit);
+    CHECK(!r.fatal && r.bytes[0] == 0xF8 && r.bytes[1] == 12 * 2 + 1 && r.bytes[2] == 0x10 + digit);
+  }
+  CHECK(!encodeOld(false, 12, LEGACY_NUMERIC_PRESS, 10).fatal);
+  Result r = encodeNew(false, 12, LEGACY_NUMERIC_PRESS, 10);
+  CHECK(r.fatal && r.flashes == 5);
+  CHECK(encodeNew(false, 12, LEGACY_NUMERIC_PRESS, 255).fatal);
+}
+
+int main() {
+  pLCD2004 = new Display_2004(&Serial1, SERIAL1_SPEED);
+  pNew = new Engineer;
+  pOld = new Engineer_Old;
+  testSameAsOldEncoder();
+  testTMCCDialogueNoLongerHalts();
+  testNumericPressRejectsDigitsAbove9();
+  return hostTestResult("Engineer encoding");
+}
@@ -0,0 +1,230 @@
+// TEST_FRAM_IMAGE.CPP Rev: 10/19/26.
+// Host test of the FRAM image builder, O_FRAM_Populator/FRAM_Tables.py.  run_tests.sh has it build a host-layout image
+// ("FRAM_Image.py build --host") and passes us the image and the builder's report.  We check the builder's record size for
+// every table against sizeof() of the library's struct, then read every field of every record through the libraries, once
+// from the image and once after the real populate() functions have written a blank FRAM, and check that they agree.
+// Route_Reference::populate() only writes its active GROUP, so routes are compared only where populate() wrote them.
+//
+//   Test_FRAM_Image <host image> <builder report>
+
+#define private public  // For sizeof() each table's private record struct, and Deadlock_Reference's record
+#include <Turnout_Reservation.h>
+#include <Sensor_Block.h>
+#include <Block_Reservation.h>
+#include <Deadlock.h>
+#include <Loco_Reference.h>
+#include <Route_Reference.h>
+#undef private
+#include "Host_Test.h"
+#include <string>
+#include <vector>
+
+const byte THIS_MODULE = ARDUINO_NUL;
+char lcdString[LCD_WIDTH + 1] = "FRAM host test";
+Display_2004* pLCD2004 = nullptr;
+
+FRAM*                pStorage            = nullptr;
+Turnout_Reservation* pTurnoutReservation = nullptr;
+Sensor_Block*        pSensorBlock        = nullptr;
+Block_Reservation*   pBlockReservation   = nullptr;
+Deadlock_Reference*  pDeadlock           = nullptr;
+Loco_Reference*      pLoco               = nullptr;
+Route_Reference*     pRoute              = nullptr;
+
+struct Field {
+  std::string label;
+  long value;
+};
+
+static void take(std::vector<Field>* t_fields, const char* t_table, unsigned int t_recNum, const char* t_name, long t_value) {
+  char label[64];
+  snprintf(label, sizeof(label), "%s %u %s", t_table, t_recNum, t_name);
+  t_fields->push_back({ label, t_value });
+}
+
+#define TAKE(t_table, t_recNum, t_getter) take(&fields, t_table, t_recNum, #t_getter, (long)(t_getter))
+
+static std::vector<Field> readTables() {
+  // Every field of every record, via the libraries' getters, from whatever is in hostFRAM[].
+  std::vector<Field> fields;
+  for (byte n = 1; n <= TOTAL_TURNOUTS; n++) {
+    TAKE("Turnout", n, pTurnoutReservation->getLastOrientation(n));
+    TAKE("Turnout", n, pTurnoutReservation->reservedForTrain(n));
+  }
+  for (byte n = 1; n <= TOTAL_SENSORS; n++) {
+    TAKE("Sensor", n, pSensorBlock->getSensorNumber(n));
+    TAKE("Sensor", n, pSensorBlock->whichBlock(n));
+    TAKE("Sensor", n, pSensorBlock->whichEnd(n));
+    TAKE("Sensor", n, pSensorBlock->getSensorStatus(n));
+  }
+  for (byte n = 1; n <= TOTAL_BLOCKS; n++) {
+    TAKE("Block", n, pBlockReservation->reservedForTrain(n));
+    TAKE("Block", n, pBlockReservation->reservedDirection(n));
+    TAKE("Block", n, pBlockReservation->westSensor(n));
+    TAKE("Block", n, pBlockReservation->eastSensor(n));
+    TAKE("Block", n, pBlockReservation->westboundSpeed(n));
+    TAKE("Block", n, pBlockReservation->eastboundSpeed(n));
+    TAKE("Block", n, pBlockReservation->length(n));
+    TAKE("Block", n, pBlockReservation->sidingType(n));
+    TAKE("Block", n, pBlockReservation->isParkingSiding(n));
+    TAKE("Block", n, pBlockReservation->stationType(n));
+    TAKE("Block", n, pBlockReservation->forbidden(n));
+    TAKE("Block", n, pBlockReservation->isTunnel(n));
+    TAKE("Block", n, pBlockReservation->gradeDirection(n));
+  }
+  for (byte n = 1; n <= FRAM_RECS_DEADLOCK; n++) {
+    pDeadlock->getDeadlockRecord(n);
+    TAKE("Deadlock", n, pDeadlock->m_deadlock.deadlockNum);
+    TAKE("Deadlock", n, pDeadlock->m_deadlock.destination.routeRecType);
+    TAKE("Deadlock", n, pDeadlock->m_deadlock.destination.routeRecVal);
+    for (byte i = 0; i < FRAM_FIELDS_DEADLOCK; i++) {
+      take(&fields, "Deadlock", n, "threat type", pDeadlock->m_deadlock.threatList[i].routeRecType);
+      take(&fields, "Deadlock", n, "threat val", pDeadlock->m_deadlock.threatList[i].routeRecVal);
+    }
+  }
+  for (byte n = 1; n <= TOTAL_TRAINS; n++) {
+    char text[ALPHA_WIDTH];
+    TAKE("Loco", n, pLoco->locoNum(n));
+    TAKE("Loco", n, pLoco->active(n));
+    pLoco->alphaDesc(n, text, ALPHA_WIDTH);
+    for (byte i = 0; i < ALPHA_WIDTH; i++) take(&fields, "Loco", n, "alphaDesc", text[i]);
+    TAKE("Loco", n, pLoco->devType(n));
+    TAKE("Loco", n, pLoco->steamOrDiesel(n));
+    TAKE("Loco", n, pLoco->passOrFreight(n));
+    pLoco->restrictions(n, text, RESTRICT_WIDTH);
+    for (byte i = 0; i < RESTRICT_WIDTH; i++) take(&fields, "Loco", n, "restrictions", text[i]);
+    TAKE("Loco", n, pLoco->length(n));
+    TAKE("Loco", n, pLoco->opCarLocoNum(n));
+    TAKE("Loco", n, pLoco->crawlSpeed(n));
+    TAKE("Loco", n, pLoco->crawlMmPerSec(n));
+    TAKE("Loco", n, pLoco->lowSpeed(n));
+    TAKE("Loco", n, pLoco->lowMmPerSec(n));
+    TAKE("Loco", n, pLoco->lowSpeedSteps(n));
+    TAKE("Loco", n, pLoco->lowMsStepDelay(n));
+    TAKE("Loco", n, pLoco->lowMmToCrawl(n));
+    TAKE("Loco", n, pLoco->medSpeed(n));
+    TAKE("Loco", n, pLoco->medMmPerSec(n));
+    TAKE("Loco", n, pLoco->medSpeedSteps(n));
+    TAKE("Loco", n, pLoco->medMsStepDelay(n));
+    TAKE("Loco", n, pLoco->medMmToCrawl(n));
+    TAKE("Loco", n, pLoco->highSpeed(n));
+    TAKE("Loco", n, pLoco->highMmPerSec(n));
+    TAKE("Loco", n, pLoco->highSpeedSteps(n));
+    TAKE("Loco", n, pLoco->highMsStepDelay(n));
+    TAKE("Loco", n, pLoco->highMmToCrawl(n));
+  }
+  for (unsigned int n = 0; n < FRAM_RECS_ROUTE_TOTAL; n++) {
+    TAKE("Route", n, pRoute->getRouteID(n));  // Always first for a route; see compareTables()
+    TAKE("Route", n, pRoute->getOrigin(n).routeRecType);
+    TAKE("Route", n, pRoute->getOrigin(n).routeRecVal);
+    TAKE("Route", n, pRoute->getDest(n).routeRecType);
+    TAKE("Route", n, pRoute->getDest(n).routeRecVal);
+    TAKE("Route", n, pRoute->getPark(n));
+    TAKE("Route", n, pRoute->getPriority(n));
+    for (byte i = 0; i < FRAM_SEGMENTS_ROUTE_REF; i++) {
+      take(&fields, "Route", n, "element type", pRoute->getElement(n, i).routeRecType);
+      take(&fields, "Route", n, "element val", pRoute->getElement(n, i).routeRecVal);
+    }
+  }
+  return fields;
+}
+
+static void checkSizes(const char* t_reportName) {
+  // The builder's report has a "struct <name> <bytes>" line for every table; those must be the host compiler's sizeof().
+  struct { const char* name; unsigned int size; } structs[] = {
+    { "turnoutReservationStruct", sizeof(Turnout_Reservation::turnoutReservationStruct) },
+    { "sensorBlockStruct",        sizeof(Sensor_Block::sensorBlockStruct) },
+    { "blockReservationStruct",   sizeof(Block_Reservation::blockReservationStruct) },
+    { "deadlockStruct",           sizeof(Deadlock_Reference::deadlockStruct) },
+    { "locoReferenceStruct",      sizeof(Loco_Reference::locoReferenceStruct) },
+    { "routeReferenceStruct",     sizeof(Route_Reference::routeReferenceStruct) },
+  };
+  FILE* f = fopen(t_reportName, "r");
+  CHECK(f != nullptr);
+  if (f == nullptr) {
+    return;
+  }
+  char line[256];
+  unsigned int found = 0;
+  while (fgets(line, sizeof(line), f) != nullptr) {
+    char name[64];
+    unsigned int size;
+    if (sscanf(line, "struct %63s %u", name, &size) != 2) {
+      continue;
+    }
+    for (auto& s : structs) {
+      if (strcmp(name, s.name) == 0) {
+        found++;
+        if (size != s.size) {
+          printf("  %s: builder says %u bytes, sizeof() is %u\n", name, size, s.size);
+        }
+        CHECK(size == s.size);
+      }
+    }
+  }
+  fclose(f);
+  CHECK(found == sizeof(structs) / sizeof(structs[0]));
+}
+
+static void compareTables(const std::vector<Field>& t_image, const std::vector<Field>& t_populated) {
+  // Routes that populate() didn't write (Route ID 0) are skipped, from their Route ID up to the next route's.
+  CHECK(t_image.size() == t_populated.size());
+  unsigned int mismatches = 0;
+  unsigned int compared = 0;
+  bool skipping = false;
+  for (size_t i = 0; (i < t_image.size()) && (i < t_populated.size()); i++) {
+    if (t_populated[i].label.find("getRouteID") != std::string::npos) {
+      skipping = (t_populated[i].value == 0);
+    }
+    if (skipping) {
+      continue;
+    }
+    compared++;
+    if ((t_image[i].label != t_populated[i].label) || (t_image[i].value != t_populated[i].value)) {
+      if (++mismatches <= 10) {
+        printf("  %s: image %ld, populate() %ld\n", t_image[i].label.c_str(), t_image[i].value, t_populated[i].value);
+      }
+    }
+  }
+  CHECK(mismatches == 0);
+  CHECK(compared > 1000);  // Guard against comparing nothing
+}
+
+int main(int argc, char* argv[]) {
+  if (argc != 3) {
+    printf("Usage: Test_FRAM_Image <host image> <builder report>\n");
+    return 1;
+  }
+  checkSizes(argv[2]);
+
+  pStorage = new FRAM(MB85RS4MT, PIN_IO_FRAM_CS);
+  pStorage->begin();
+  pTurnoutReservation = new Turnout_Reservation;
+  pSensorBlock = new Sensor_Block;
+  pBlockReservation = new Block_Reservation;
+  pLoco = new Loco_Reference;
+  pDeadlock = new Deadlock_Reference;
+  pRoute = new Route_Reference;
+
+  CHECK(hostLoadFRAM(argv[1]));
+  CHECK(memcmp(hostFRAM + FRAM_ADDR_REV_DATE, FRAMVERSION, 3) == 0);
+  pTurnoutReservation->begin(pStorage);  // Releases every turnout, which the image already has
+  pSensorBlock->begin(pStorage);
+  pBlockReservation->begin(pStorage, nullptr);
+  pLoco->begin(pStorage);
+  pDeadlock->begin(pStorage, pBlockReservation, pLoco);
+  pRoute->begin(pStorage);
+  std::vector<Field> image = readTables();
+
+  memset(hostFRAM, 0, sizeof(hostFRAM));
+  pTurnoutReservation->populate();
+  pSensorBlock->populate();
+  pBlockReservation->populate();
+  pLoco->populate();
+  pDeadlock->populate();
+  pRoute->populate();
+  std::vector<Field> populated = readTables();
+
+  compareTables(image, populated);
+  return hostTestResult("FRAM image");
+}
@@ -0,0 +1,118 @@
+// TEST_TURNOUT_CMD_BUF.CPP Rev: 10/19/26.
+// Host test of libraries/Turnout_Cmd_Buf: enqueue/dequeue order, empty and full, wrap-around, coalescing of a waiting
+// command for the same turnout, and the fatal error on a bad turnout number or direction.
+
+#include <Turnout_Cmd_Buf.h>
+#include "Host_Test.h"
+
+const byte THIS_MODULE = ARDUINO_SWT;
+char lcdString[LCD_WIDTH + 1] = "SWT host test";
+Display_2004* pLCD2004 = nullptr;
+
+Turnout_Cmd_Buf* pBuf = nullptr;
+
+static void testEmpty() {
+  byte num = 99;
+  char dir = '?';
+  CHECK(pBuf->isEmpty());
+  CHECK(!pBuf->isFull());
+  CHECK(!pBuf->dequeue(&num, &dir));
+  CHECK(!pBuf->peek(&num, &dir));
+  CHECK(num == 99 && dir == '?');  // Untouched when empty
+}
+
+static void testFifoOrder() {
+  byte num;
+  char dir;
+  pBuf->begin();
+  pBuf->enqueue(5, TURNOUT_DIR_NORMAL);
+  pBuf->enqueue(1, TURNOUT_DIR_REVERSE);
+  pBuf->enqueue(TOTAL_TURNOUTS, TURNOUT_DIR_NORMAL);
+  CHECK(!pBuf->isEmpty());
+  CHECK(pBuf->peek(&num, &dir) && num == 5 && dir == TURNOUT_DIR_NORMAL);
+  CHECK(pBuf->dequeue(&num, &dir) && num == 5 && dir == TURNOUT_DIR_NORMAL);
+  CHECK(pBuf->dequeue(&num, &dir) && num == 1 && dir == TURNOUT_DIR_REVERSE);
+  CHECK(pBuf->dequeue(&num, &dir) && num == TOTAL_TURNOUTS && dir == TURNOUT_DIR_NORMAL);
+  CHECK(pBuf->isEmpty());
+  CHECK(!pBuf->dequeue(&num, &dir));
+}
+
+static void testFull() {
+  // With coalescing the buffer is full only when every turnout has a command waiting.
+  byte num;
+  char dir;
+  pBuf->begin();
+  for (byte t = 1; t <= TOTAL_TURNOUTS; t++) {
+    CHECK(!pBuf->isFull());
+    pBuf->enqueue(t, (t & 1) ? TURNOUT_DIR_REVERSE : TURNOUT_DIR_NORMAL);
+  }
+  CHECK(pBuf->isFull());
+  CHECK(!pBuf->isEmpty());
+  pBuf->enqueue(7, TURNOUT_DIR_NORMAL);  // Coalesces, so a full buffer still accepts it
+  CHECK(pBuf->isFull());
+  for (byte t = 1; t <= TOTAL_TURNOUTS; t++) {
+    CHECK(pBuf->dequeue(&num, &dir));
+    CHECK(num == t);
+    CHECK(dir == ((t == 7) ? TURNOUT_DIR_NORMAL : ((t & 1) ? TURNOUT_DIR_REVERSE : TURNOUT_DIR_NORMAL)));
+  }
+  CHECK(pBuf->isEmpty());
+}
+
+static void testWrapAround() {
+  // Keep a few commands waiting while head and tail go round the ring several times.
+  byte num;
+  char dir;
+  byte next = 1;    // Next turnout to enqueue
+  byte expect = 1;  // Next turnout we expect back
+  pBuf->begin();
+  for (byte i = 0; i < 3; i++) {
+    pBuf->enqueue(next, TURNOUT_DIR_REVERSE);
+    next = (next % TOTAL_TURNOUTS) + 1;
+  }
+  for (unsigned i = 0; i < 3u * TOTAL_TURNOUTS; i++) {
+    CHECK(pBuf->dequeue(&num, &dir) && num == expect && dir == TURNOUT_DIR_REVERSE);
+    expect = (expect % TOTAL_TURNOUTS) + 1;
+    pBuf->enqueue(next, TURNOUT_DIR_REVERSE);
+    next = (next % TOTAL_TURNOUTS) + 1;
+  }
+  for (byte i = 0; i < 3; i++) {
+    CHECK(pBuf->dequeue(&num, &dir) && num == expect);
+    expect = (expect % TOTAL_TURNOUTS) + 1;
+  }
+  CHECK(pBuf->isEmpty());
+}
+
+static void testCoalesce() {
+  byte num;
+  char dir;
+  pBuf->begin();
+  pBuf->enqueue(3, TURNOUT_DIR_NORMAL);
+  pBuf->enqueue(4, TURNOUT_DIR_NORMAL);
+  pBuf->enqueue(3, TURNOUT_DIR_REVERSE);  // Updates the waiting command for 3, which keeps its place
+  pBuf->enqueue(3, TURNOUT_DIR_NORMAL);
+  pBuf->enqueue(3, TURNOUT_DIR_REVERSE);
+  CHECK(pBuf->dequeue(&num, &dir) && num == 3 && dir == TURNOUT_DIR_REVERSE);
+  pBuf->enqueue(3, TURNOUT_DIR_NORMAL);   // 3 was dequeued (being fired), so this is a new command behind 4
+  CHECK(pBuf->dequeue(&num, &dir) && num == 4 && dir == TURNOUT_DIR_NORMAL);
+  CHECK(pBuf->dequeue(&num, &dir) && num == 3 && dir == TURNOUT_DIR_NORMAL);
+  CHECK(pBuf->isEmpty());
+}
+
+static void testBadCommands() {
+  pBuf->begin();
+  CHECK_FATAL(pBuf->enqueue(0, TURNOUT_DIR_NORMAL));
+  CHECK_FATAL(pBuf->enqueue(TOTAL_TURNOUTS + 1, TURNOUT_DIR_NORMAL));
+  CHECK_FATAL(pBuf->enqueue(1, 'X'));
+}
+
+int main() {
+  pLCD2004 = new Display_2004(&Serial1, SERIAL1_SPEED);
+  pBuf = new Turnout_Cmd_Buf;
+  testEmpty();
+  testFifoOrder();
+  testFull();
+  testWrapAround();
+  testCoalesce();
+  testBadCommands();
+  return hostTestResult("Turnout_Cmd_Buf");
+}
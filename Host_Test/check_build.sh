@@ -0,0 +1,83 @@
+#!/bin/sh
+# CHECK_BUILD.SH Rev: 10/19/26.
+# Host compile check of the train libraries and O_* sketches against the stubs in Host_Test/stub, at the
+# normal layout size and at double size (LAYOUT_LEVELS=2, see Train_Consts_Global.h).  This catches
+# table-size overflows (byte counters, FRAM address math, static_asserts) without an AVR toolchain.  It does
+# not check that the result fits in a Mega; the Arduino IDE's memory report is still the final word on that.
+# -fpermissive lets the AVR-only pointer-to-16-bit casts in Train_Functions' memory map through on 64-bit hosts.
+# Everything is built with -Wall, and any warning not listed in known_warnings.txt fails the check, at either level.  Known
+# warnings are matched by file and message, not line number.  -Wno-format-overflow because a host long is 64 bits, so gcc's
+# sprintf size checks are wrong for the Mega.
+#
+#   cd Host_Test && ./check_build.sh          Check LAYOUT_LEVELS 1 and 2.
+#   ./check_build.sh 2                        Check only LAYOUT_LEVELS=2.
+#
+# Sketches in UNFINISHED are known not to compile yet (work in progress); their errors are reported but
+# don't fail the check.
+
+HERE=$(cd "$(dirname "$0")" && pwd)
+REPO=$(dirname "$HERE")
+CXX=${CXX:-g++}
+OUT=${TMPDIR:-/tmp}/host_check_build
+mkdir -p "$OUT"
+
+LIBS="Block_Reservation Centipede Conductor Deadlock Delayed_Action DigoleSerial Dispatcher Display_2004 Engineer
+  Event_Journal FRAM Hackscribble_Ferro Loco_Reference Loop_Profiler Message Mode_Dial Occupancy_LEDs QuadAlphaNum
+  Rotary_Prompt Route_Reference Sensor_Block Train_Functions Train_Progress Tsunami Turnout_Cmd_Buf Turnout_Reservation"
+SKETCHES="O_BTN O_FRAM_Duplicator O_FRAM_Populator O_LED O_LEG O_MAS O_OCC O_Roller_Distance O_Roller_Speed O_SNS O_SWT"
+UNFINISHED="O_LEG O_OCC"
+LEVELS=${1:-"1 2"}
+
+INC="-I$HERE/stub"
+for d in "$REPO"/libraries/*/; do INC="$INC -I$d"; done
+FLAGS="-std=gnu++11 -fpermissive -Wall -Wno-format-overflow -c -o /dev/null -include Arduino.h"
+
+# Prints any warning in $OUT/err.txt that isn't in known_warnings.txt, as "file: message", and returns 1 if there were any.
+new_warnings() {
+  grep "warning:" "$OUT/err.txt" | sed -e "s|^$REPO/||" -e 's/:[0-9]*:[0-9]*: warning: /: /' | sort -u |
+    grep -Fxv -f "$HERE/known_warnings.txt" > "$OUT/new_warnings.txt"
+  [ -s "$OUT/new_warnings.txt" ] || return 0
+  sed 's/^/          NEW WARNING: /' "$OUT/new_warnings.txt"
+  return 1
+}
+
+FAILED=0
+for levels in $LEVELS; do
+  echo "=== LAYOUT_LEVELS=$levels ==="
+  for lib in $LIBS; do
+    for src in "$REPO/libraries/$lib"/*.cpp; do
+      [ -f "$src" ] || continue
+      if $CXX $FLAGS -DLAYOUT_LEVELS=$levels $INC "$src" 2> "$OUT/err.txt"; then
+        if new_warnings > "$OUT/report.txt"; then
+          echo "  ok      $lib/$(basename "$src")"
+        else
+          echo "  FAILED  $lib/$(basename "$src")"; cat "$OUT/report.txt"
+          FAILED=$((FAILED + 1))
+        fi
+      else
+        echo "  FAILED  $lib/$(basename "$src")"; sed 's/^/          /' "$OUT/err.txt" | grep "error" | head -5
+        FAILED=$((FAILED + 1))
+      fi
+    done
+  done
+  for sketch in $SKETCHES; do
+    python3 "$HERE/ino_proto.py" "$REPO/$sketch/$sketch.ino" "$OUT/$sketch.cpp" || exit 2
+    if $CXX $FLAGS -DLAYOUT_LEVELS=$levels $INC -x c++ "$OUT/$sketch.cpp" 2> "$OUT/err.txt"; then
+      if new_warnings > "$OUT/report.txt"; then
+        echo "  ok      $sketch"
+      else
+        echo "  FAILED  $sketch"; cat "$OUT/report.txt"
+        FAILED=$((FAILED + 1))
+      fi
+    else
+      errors=$(grep -c "error" "$OUT/err.txt")
+      case " $UNFINISHED " in
+        *" $sketch "*) echo "  (wip)   $sketch: $errors errors in unfinished code";;
+        *) echo "  FAILED  $sketch"; grep "error" "$OUT/err.txt" | head -5 | sed 's/^/          /'
+           FAILED=$((FAILED + 1));;
+      esac
+    fi
+  done
+done
+echo "$FAILED failed."
+[ $FAILED -eq 0 ]
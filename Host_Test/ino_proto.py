@@ -0,0 +1,33 @@
+# INO_PROTO.PY Rev: 10/19/26.
+# Turns an Arduino .ino sketch into a .cpp that g++ can compile, the way the Arduino IDE does: a prototype for every
+# top-level function is inserted ahead of the first function definition, with #line directives so compiler messages
+# still point at the sketch's own line numbers.
+#
+#   python3 ino_proto.py O_MAS/O_MAS.ino /tmp/O_MAS.cpp
+
+import re
+import sys
+
+FUNC_DEF = re.compile(r'^((?:const\s+)?(?:unsigned\s+)?[A-Za-z_][\w<>]*\s*\**\s+\**)([A-Za-z_]\w*)\s*\(([^;{]*)\)\s*\{')
+
+def main(argv):
+    if len(argv) != 3:
+        sys.exit("Usage: python3 ino_proto.py <sketch.ino> <out.cpp>")
+    with open(argv[1], newline="", encoding="latin-1") as f:
+        lines = f.read().replace("\r\n", "\n").split("\n")
+    protos = []
+    first = None
+    for i, line in enumerate(lines):
+        m = FUNC_DEF.match(line)
+        if m and (m.group(2) not in ("if", "while", "for", "switch")) and not line.startswith("ISR"):
+            if first is None:
+                first = i
+            protos.append(m.group(1) + m.group(2) + "(" + m.group(3) + ");")
+    if first is None:
+        first = 0
+    out = lines[:first] + protos + ['#line %d "%s"' % (first + 1, argv[1])] + lines[first:]
+    with open(argv[2], "w", encoding="latin-1") as f:
+        f.write("\n".join(out))
+
+if __name__ == "__main__":
+    main(sys.argv)
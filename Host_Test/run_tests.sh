@@ -0,0 +1,76 @@
+#!/bin/sh
+# RUN_TESTS.SH Rev: 10/19/26.
+# Builds and runs the host tests in this directory.  Each Test_<Name>.cpp is linked with the library sources listed
+# for it below, the Arduino stubs in stub/, and Host_Train_Functions.cpp (which replaces Train_Functions.cpp.)
+# Layout_Sim.cpp, the layout simulator, is built the same way and run as a test: two hours of Auto mode with four trains.
+#
+#   cd Host_Test && ./run_tests.sh              Run every test.
+#   ./run_tests.sh Turnout_Cmd_Buf              Run one test.
+
+HERE=$(cd "$(dirname "$0")" && pwd)
+REPO=$(dirname "$HERE")
+CXX=${CXX:-g++}
+OUT=${TMPDIR:-/tmp}/host_run_tests
+mkdir -p "$OUT"
+
+INC="-I$HERE -I$HERE/stub"
+for d in "$REPO"/libraries/*/; do INC="$INC -I$d"; done
+FLAGS="-std=gnu++11 -g -w -include Arduino.h"
+
+# Library sources each test links against (besides the stubs.)
+sources() {
+  case $1 in
+    Turnout_Cmd_Buf) echo "Turnout_Cmd_Buf Display_2004 DigoleSerial";;
+    Engineer_Encoding) echo "Engineer Display_2004 DigoleSerial";;  # Plus Engineer_Old.cpp, see extras()
+    Display_2004) echo "Display_2004 DigoleSerial";;
+    FRAM_Image) echo "FRAM Turnout_Reservation Sensor_Block Block_Reservation Deadlock Loco_Reference Route_Reference
+                      Event_Journal Display_2004 DigoleSerial";;
+    Layout_Sim) echo "Dispatcher Train_Progress Conductor Delayed_Action Engineer Message Mode_Dial FRAM Turnout_Reservation
+                      Sensor_Block Block_Reservation Deadlock Loco_Reference Route_Reference Loop_Profiler Event_Journal
+                      Display_2004 DigoleSerial";;
+  esac
+}
+
+# Extra files from this directory that a test needs.
+extras() {
+  case $1 in
+    Engineer_Encoding) echo "$HERE/Engineer_Old.cpp";;  # Old switch-based encoder, from just before the table-driven one
+    FRAM_Image) echo "$HERE/Host_Ferro.cpp";;  # FRAM in memory
+    Layout_Sim) echo "$HERE/Host_Ferro.cpp $HERE/Host_Module.cpp";;  # Plus a THIS_MODULE that can switch between MAS/LEG/SNS
+  esac
+}
+
+# Anything a test needs done before it runs; prints the test's command line arguments.
+prepare() {
+  case $1 in
+    FRAM_Image)  # Host-layout image from the PC image builder, and its report of record sizes
+      host_image || return 1
+      echo "$OUT/fram_host.bin $OUT/fram_host.txt";;
+    Layout_Sim)  # Two hours of Auto mode on the host-layout image
+      host_image || return 1
+      echo "$OUT/fram_host.bin --hours 2 --seed 1 --quiet --train 2:BE01 --train 4:BE04 --train 5:BW03 --train 8:BE13";;
+  esac
+}
+
+host_image() {
+  if ! python3 -B "$REPO/O_FRAM_Populator/FRAM_Image.py" build "$OUT/fram_host.bin" --host > "$OUT/fram_host.txt"; then
+    cat "$OUT/fram_host.txt" >&2; return 1
+  fi
+}
+
+TESTS=${1:-"Turnout_Cmd_Buf Engineer_Encoding Display_2004 FRAM_Image Layout_Sim"}
+FAILED=0
+for test in $TESTS; do
+  MAIN="$HERE/Test_$test.cpp"
+  [ -f "$MAIN" ] || MAIN="$HERE/$test.cpp"  # Layout_Sim.cpp is a tool in its own right, not just a test
+  SRCS="$MAIN $HERE/Host_Train_Functions.cpp $HERE/stub/Arduino_Host.cpp $(extras $test)"
+  for lib in $(sources $test); do SRCS="$SRCS $REPO/libraries/$lib/$lib.cpp"; done
+  if ! $CXX $FLAGS $INC $SRCS -o "$OUT/$test"; then
+    echo "$test: BUILD FAILED"; FAILED=$((FAILED + 1))
+  elif ! ARGS=$(prepare $test); then
+    echo "$test: PREPARE FAILED"; FAILED=$((FAILED + 1))
+  elif ! "$OUT/$test" $ARGS; then
+    FAILED=$((FAILED + 1))
+  fi
+done
+[ $FAILED -eq 0 ]
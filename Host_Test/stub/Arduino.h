@@ -0,0 +1,184 @@
+// ARDUINO.H (HOST STUB) Rev: 10/19/26.
+// Just enough of the Arduino core to compile the train libraries and O_* sketches with g++ on a PC, so
+// layout-size changes (e.g. LAYOUT_LEVELS=2) can be checked without an AVR toolchain, and so pure-logic
+// libraries can be linked into small host tests.  Nothing here talks to real hardware.
+// The clock is a counter: millis()/micros() advance it by hostTickMicros per call, and delay() adds to it.
+// Print is functional (output goes to the derived class's write()); HardwareSerial captures its output
+// in hostOut[] so a test can inspect what a library sent.
+
+#pragma once
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+#include <stdlib.h>
+
+typedef uint8_t byte;
+typedef bool boolean;
+
+#define PROGMEM
+#define F(x) (reinterpret_cast<const __FlashStringHelper*>(x))
+#define HIGH 1
+#define LOW 0
+#define INPUT 0
+#define OUTPUT 1
+#define INPUT_PULLUP 2
+#define LSBFIRST 0
+#define MSBFIRST 1
+#define SPI_MODE0 0
+#define DEC 10
+#define HEX 16
+#define OCT 8
+#define BIN 2
+#define A0 54
+#define A1 55
+#define A2 56
+#define A3 57
+#define A4 58
+#define A5 59
+#define A6 60
+#define A7 61
+#define A8 62
+#define A9 63
+#define A10 64
+#define A11 65
+#define A12 66
+#define A13 67
+#define A14 68
+#define A15 69
+#define SS 53
+#define RAMEND 0x21FF
+#define XRAMEND 0xFFFF
+
+// ATmega2560 register names used by the QuadRAM setup and memory map code.
+extern volatile uint8_t SREG;
+extern volatile uint8_t XMCRA;
+extern volatile uint8_t XMCRB;
+extern volatile uint8_t WDTCSR;
+extern volatile uint16_t SP;
+#define SRE 7
+#ifndef _BV
+#define _BV(b) (1 << (b))
+#endif
+extern char* __malloc_heap_start;
+extern char* __malloc_heap_end;
+
+#define bitRead(v,b) (((v) >> (b)) & 1)
+#define bitSet(v,b) ((v) |= (1UL << (b)))
+#define bitClear(v,b) ((v) &= ~(1UL << (b)))
+#define bitWrite(v,b,x) ((x) ? bitSet(v,b) : bitClear(v,b))
+#define highByte(w) ((uint8_t)((w) >> 8))
+#define lowByte(w) ((uint8_t)((w) & 0xff))
+inline unsigned int word(uint8_t h, uint8_t l) { return (h << 8) | l; }
+template<class T> T min(T a, T b) { return a < b ? a : b; }
+template<class T> T max(T a, T b) { return a > b ? a : b; }
+
+// Host clock.  Tests set hostTickMicros > 0 when the code under test spins on millis().
+extern unsigned long hostMicros;
+extern unsigned long hostTickMicros;
+inline unsigned long micros() { hostMicros += hostTickMicros; return hostMicros; }
+inline unsigned long millis() { hostMicros += hostTickMicros; return hostMicros / 1000UL; }
+inline void delay(unsigned long t_ms) { hostMicros += t_ms * 1000UL; }
+inline void delayMicroseconds(unsigned int t_us) { hostMicros += t_us; }
+
+inline void pinMode(int, int) {}
+inline void digitalWrite(int, int) {}
+inline int digitalRead(int) { return HIGH; }
+inline int analogRead(int) { return 0; }
+inline void analogWrite(int, int) {}
+inline void randomSeed(unsigned long) {}
+inline void cli() {}
+inline void sei() {}
+inline void noInterrupts() {}
+inline void interrupts() {}
+inline long random(long t_max) { return t_max > 0 ? rand() % t_max : 0; }
+inline long random(long t_min, long t_max) { return t_max > t_min ? t_min + rand() % (t_max - t_min) : t_min; }
+
+// Pin-to-port helpers used by Hackscribble_Ferro's fast chip-select.
+#define NOT_A_PIN 0
+#define NOT_ON_TIMER 0
+inline uint8_t digitalPinToTimer(int) { return NOT_ON_TIMER; }
+inline uint8_t digitalPinToBitMask(int) { return 1; }
+inline uint8_t digitalPinToPort(int) { return 1; }
+inline void turnOffPWM(uint8_t) {}
+inline volatile uint8_t* portOutputRegister(uint8_t) { static volatile uint8_t reg; return &reg; }
+
+// Flash access is plain memory on the host.
+inline uint8_t pgm_read_byte(const void* p) { return *(const uint8_t*)p; }
+inline uint16_t pgm_read_word(const void* p) { return *(const uint16_t*)p; }
+inline uint32_t pgm_read_dword(const void* p) { return *(const uint32_t*)p; }
+inline void* memcpy_P(void* d, const void* s, size_t n) { return memcpy(d, s, n); }
+#define strcpy_P(d,s) strcpy((d),(s))
+#define strlen_P(s) strlen(s)
+inline char* dtostrf(double t_val, signed char t_width, unsigned char t_prec, char* t_buf) {
+  sprintf(t_buf, "%*.*f", t_width, t_prec, t_val);
+  return t_buf;
+}
+
+class __FlashStringHelper;
+class String {
+  public:
+    String() {}
+    String(const char*) {}
+    const char* c_str() const { return ""; }
+    unsigned length() const { return 0; }
+    long toInt() const { return 0; }
+    String& operator+=(char) { return *this; }
+    String& operator+=(const char*) { return *this; }
+};
+class Printable {};
+
+class Print {
+  public:
+    virtual ~Print() {}
+    virtual size_t write(uint8_t t_c) { return 1; }
+    virtual size_t write(const uint8_t* t_buf, size_t t_len);
+    size_t write(const char* t_str) { return write((const uint8_t*)t_str, strlen(t_str)); }
+    size_t print(const char* t_str) { return write(t_str); }
+    size_t print(const __FlashStringHelper* t_str) { return write((const char*)t_str); }
+    size_t print(const String&) { return 0; }
+    size_t print(const Printable&) { return 0; }
+    size_t print(char t_c) { return write((uint8_t)t_c); }
+    size_t print(unsigned char t_n, int t_base = DEC) { return print((unsigned long)t_n, t_base); }
+    size_t print(int t_n, int t_base = DEC) { return print((long)t_n, t_base); }
+    size_t print(unsigned int t_n, int t_base = DEC) { return print((unsigned long)t_n, t_base); }
+    size_t print(long t_n, int t_base = DEC);
+    size_t print(unsigned long t_n, int t_base = DEC);
+    size_t print(double t_n, int t_digits = 2);
+    size_t println() { return write("\r\n"); }
+    template<class T> size_t println(T t_val) { size_t n = print(t_val); return n + println(); }
+    template<class T> size_t println(T t_val, int t_fmt) { size_t n = print(t_val, t_fmt); return n + println(); }
+};
+
+class Stream : public Print {
+  public:
+    virtual int available() { return 0; }
+    virtual int read() { return -1; }
+    virtual int peek() { return -1; }
+    virtual void flush() {}
+    int readBytes(char* t_buf, int t_len);
+    size_t readBytes(uint8_t* t_buf, size_t t_len) { return readBytes((char*)t_buf, (int)t_len); }
+    void setTimeout(unsigned long) {}
+};
+
+// Output is appended to hostOut[] (wraps when full); input comes from hostIn[] via hostFeed().
+class HardwareSerial : public Stream {
+  public:
+    void begin(unsigned long) {}
+    void end() {}
+    operator bool() { return true; }
+    virtual int availableForWrite() { return 63; }
+    virtual size_t write(uint8_t t_c);
+    using Print::write;
+    virtual int available();
+    virtual int read();
+    virtual int peek();
+    void hostFeed(const uint8_t* t_buf, unsigned int t_len);
+    void hostClear() { hostOutLen = 0; hostInHead = hostInTail = 0; }
+    static const unsigned int HOST_BUF = 4096;
+    uint8_t hostOut[HOST_BUF];
+    unsigned int hostOutLen = 0;
+    uint8_t hostIn[HOST_BUF];
+    unsigned int hostInHead = 0;
+    unsigned int hostInTail = 0;
+};
+extern HardwareSerial Serial, Serial1, Serial2, Serial3;
@@ -0,0 +1,87 @@
+// ARDUINO_HOST.CPP (HOST STUB) Rev: 10/19/26.
+// Definitions behind Arduino.h, SPI.h and Wire.h for linking host tests.
+
+#include <Arduino.h>
+#include <SPI.h>
+#include <Wire.h>
+
+volatile uint8_t SREG = 0;
+volatile uint8_t XMCRA = 0;
+volatile uint8_t XMCRB = 0;
+volatile uint8_t WDTCSR = 0;
+volatile uint16_t SP = RAMEND;
+char* __malloc_heap_start = 0;
+char* __malloc_heap_end = 0;
+
+unsigned long hostMicros = 0;
+unsigned long hostTickMicros = 0;
+
+HardwareSerial Serial, Serial1, Serial2, Serial3;
+SPIClass SPI;
+TwoWire Wire;
+
+size_t Print::write(const uint8_t* t_buf, size_t t_len) {
+  size_t n = 0;
+  while (t_len--) n += write(*t_buf++);
+  return n;
+}
+
+size_t Print::print(long t_n, int t_base) {
+  if (t_base != DEC) return print((unsigned long)(uint32_t)t_n, t_base);  // 32-bit like the AVR
+  char buf[24];
+  snprintf(buf, sizeof(buf), "%ld", t_n);
+  return write(buf);
+}
+
+size_t Print::print(unsigned long t_n, int t_base) {
+  char buf[40];
+  char* p = &buf[sizeof(buf) - 1];
+  *p = 0;
+  if (t_base < 2) t_base = DEC;
+  do {
+    int d = t_n % t_base;
+    *--p = (char)(d < 10 ? '0' + d : 'A' + d - 10);
+    t_n /= t_base;
+  } while (t_n);
+  return write(p);
+}
+
+size_t Print::print(double t_n, int t_digits) {
+  char buf[40];
+  snprintf(buf, sizeof(buf), "%.*f", t_digits, t_n);
+  return write(buf);
+}
+
+int Stream::readBytes(char* t_buf, int t_len) {
+  int n = 0;
+  while (n < t_len && available()) t_buf[n++] = (char)read();
+  return n;
+}
+
+size_t HardwareSerial::write(uint8_t t_c) {
+  if (hostOutLen == HOST_BUF) hostOutLen = 0;
+  hostOut[hostOutLen++] = t_c;
+  return 1;
+}
+
+int HardwareSerial::available() {
+  return (int)((hostInTail + HOST_BUF - hostInHead) % HOST_BUF);
+}
+
+int HardwareSerial::read() {
+  if (hostInHead == hostInTail) return -1;
+  uint8_t c = hostIn[hostInHead];
+  hostInHead = (hostInHead + 1) % HOST_BUF;
+  return c;
+}
+
+int HardwareSerial::peek() {
+  return (hostInHead == hostInTail) ? -1 : hostIn[hostInHead];
+}
+
+void HardwareSerial::hostFeed(const uint8_t* t_buf, unsigned int t_len) {
+  while (t_len--) {
+    hostIn[hostInTail] = *t_buf++;
+    hostInTail = (hostInTail + 1) % HOST_BUF;
+  }
+}
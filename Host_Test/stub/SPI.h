@@ -0,0 +1,23 @@
+// SPI.H (HOST STUB) Rev: 10/19/26.  No-op SPI bus so Hackscribble_Ferro compiles on the host.
+#pragma once
+#include <Arduino.h>
+#define SPI_CLOCK_DIV2 0x04
+#define SPI_CLOCK_DIV4 0x00
+#define SPI_CLOCK_DIV8 0x05
+struct SPISettings {
+  SPISettings() {}
+  SPISettings(unsigned long, int, int) {}
+};
+class SPIClass {
+  public:
+    void begin() {}
+    void end() {}
+    uint8_t transfer(uint8_t) { return 0; }
+    void transfer(void*, size_t) {}
+    void beginTransaction(SPISettings) {}
+    void endTransaction() {}
+    void setClockDivider(int) {}
+    void setBitOrder(int) {}
+    void setDataMode(int) {}
+};
+extern SPIClass SPI;
@@ -0,0 +1,16 @@
+// TIMERONE.H (HOST STUB) Rev: 10/19/26.  Shadows libraries/TimerOne, which is all AVR timer registers.
+#pragma once
+#include <Arduino.h>
+class TimerOne {
+  public:
+    void initialize(unsigned long t_microseconds = 1000000) {}
+    void setPeriod(unsigned long) {}
+    void start() {}
+    void stop() {}
+    void restart() {}
+    void resume() {}
+    void attachInterrupt(void (*t_isr)()) {}
+    void attachInterrupt(void (*t_isr)(), unsigned long) {}
+    void detachInterrupt() {}
+};
+extern TimerOne Timer1;
@@ -0,0 +1,15 @@
+// WIRE.H (HOST STUB) Rev: 10/19/26.  No-op I2C bus so Centipede compiles on the host.
+#pragma once
+#include <Arduino.h>
+class TwoWire {
+  public:
+    void begin() {}
+    void setClock(long) {}
+    void beginTransmission(int) {}
+    int endTransmission() { return 0; }
+    size_t write(uint8_t) { return 1; }
+    int requestFrom(int, int) { return 0; }
+    int available() { return 0; }
+    int read() { return 0; }
+};
+extern TwoWire Wire;
@@ -0,0 +1,10 @@
+#pragma once
+#include <Arduino.h>
+#define wdt_reset()
+#define wdt_disable()
+#define WDCE 4
+#define WDE 3
+#define WDIE 6
+#define WDP2 2
+#define WDP1 1
+#define ISR(v) void v()
@@ -0,0 +1 @@
+// Empty on the host: Arduino.h supplies the pin-to-port helpers Hackscribble_Ferro needs.
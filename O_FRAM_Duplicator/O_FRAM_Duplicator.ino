@@ -1,8 +1,12 @@
-// FRAM_DUPLICATOR.INO Rev: 07/30/24.  FINISHED AND TESTED.
+// FRAM_DUPLICATOR.INO Rev: 10/19/26.  FINISHED AND TESTED.
+// 10/19/26: Copy in 1KB streamed pages (vs. 128-byte read/write pairs), keeping a CRC of every source page as it's copied, so the
+//           verify pass only has to read the destination FRAM.  Displays throughput in KB/s.  Optional FRAM_DIFF_ONLY mode only
+//           rewrites pages that differ, which also serves as a compare-only pass when the two FRAMs already match.
 // 07/30/24: Commented out FRAM rev date check.
 // Copies from one FRAM to another, in either direction depending on if digital pin is grounded or floating.
-// Always performs a test to confirm both FRAMs are identical after copying.
-// There's currently no way to just compare two FRAMs without first doing a copy one way or the other.
+// Always performs a per-page CRC verify to confirm both FRAMs are identical after copying.
+// Both FRAMs share the one SPI bus, so a read from one can't overlap a write to the other; speed comes from long streamed
+// transfers instead.  At SPI_CLOCK_DIV2 a full 512KB copy plus verify takes seconds rather than minutes.
 // DO NOT PLUG IN OR UNPLUG A FRAM WITH POWER CONNECTED TO THE ARDUINO!
 // The reason we have a "direction of copy" is because it's such a hassle to populate the first updated FRAM, since we need to
 // re-compile + re-run the O_FRAM_Populator.ino several times in order to get all of the FRAM tables populated, due to memory.
@@ -31,10 +35,15 @@
 // This can be skipped unless there is a question about the FRAM, or if it's never been used before.
 //#define PERFORM_FRAM_TEST_BEFORE_COPY
 
+// Un-comment the following to read both FRAMs and only rewrite the pages that differ.  Slower than a plain copy to a blank FRAM,
+// but when re-cloning a FRAM after a small change to the Master, almost nothing gets written.  Reports how many pages differed.
+//#define FRAM_DIFF_ONLY
+
 #include <Train_Consts_Global.h>
 #include <Train_Functions.h>
+#include <util/crc16.h>  // AVR-libc _crc_ccitt_update()
 const byte THIS_MODULE = ARDUINO_NUL;  // Global just needs to be defined for use by Train_Functions.cpp and Message.cpp.
-char lcdString[LCD_WIDTH + 1] = "DUP 07/30/24";  // Global array holds 20-char string + null, sent to Digole 2004 LCD.
+char lcdString[LCD_WIDTH + 1] = "DUP 10/19/26";  // Global array holds 20-char string + null, sent to Digole 2004 LCD.
 
 // *** SERIAL LCD DISPLAY CLASS ***
 // #include <Display_2004.h> is already in <Train_Functions.h> so not needed here.
@@ -54,6 +63,13 @@ const byte FRAM_MODE_READ   =  1;  // Value doesn't have any special meaning; ju
 const byte FRAM_MODE_WRITE  =  2;  //                                "                            _READ
 byte copyMode;                     // Will become either FRAM_MODE_READ or FRAM_MODE_WRITE
 
+// Each 512KB FRAM (being used as of 3/1/23) has 524,288 bytes: 0..524,287, which is 512 pages of 1KB.
+const unsigned int FRAM_PAGE_BYTES = 1024;  // Bytes per readStream()/writeStream()
+const unsigned int FRAM_PAGES      =  512;  // (topAddress + 1) / FRAM_PAGE_BYTES
+byte pageBuffer1[FRAM_PAGE_BYTES];          // Global rather than local so we don't put 2KB on the stack
+byte pageBuffer2[FRAM_PAGE_BYTES];          // Only used by FRAM_DIFF_ONLY
+unsigned int pageCRC[FRAM_PAGES];           // CRC of each source page, saved while copying and checked by confirmDuplicateFRAM()
+
 // *****************************************************************************************
 // **************************************  S E T U P  **************************************
 // *****************************************************************************************
@@ -132,20 +148,12 @@ void loop() {  // Nothing to do here
 // *****************************************************************************************
 
 void duplicateFRAM() {
-  // Rev: 03/06/23.
+  // Rev: 10/19/26.
   // I could embed this as a new function in FRAM.h/FRAM.cpp, but with two separate FRAMs and this being the only code that will
   // ever duplicate a FRAM, we'll just keep it local to FRAM_Duplicator.ino.
-  // Each 512KB FRAM (being used as of 3/1/23) has 524,288 bytes: 0..524,287.  This is 2,048 groups of 256 bytes.
-  // Since I must specify the number of bytes to read/write as a single byte value, the maximum number of bytes to read/write at
-  // once is 255.  Thus, I'll just do this in groups of 128 bytes for a nice round number.
-  // So each 512KB FRAM has 4,096 groups of 128 bytes.
 
-  unsigned long bottomAddress        = pStorageMaster->bottomAddress();  // 0
-  unsigned long topAddress           = pStorageMaster->topAddress();     // 524,287 (524,288 - 1)
-  byte          bytesToTransfer      = 128;                                // Number of bytes to read/write at a single go
-
-  byte dataBuffer[bytesToTransfer];
-  byte* pDataBuffer = dataBuffer;  // Same as saying &dataBuffer[0]
+  FRAM* pSource = nullptr;
+  FRAM* pDestination = nullptr;
 
   if (copyMode == FRAM_MODE_READ) {  // Oh, we want to transfer from our "copy" into the master FRAM
 
@@ -156,14 +164,8 @@ void duplicateFRAM() {
       pStorageMaster->testFRAM();  // Writes then reads random data to entire FRAM.
       // If we return from the test, it tested okay.
     #endif
-    sprintf(lcdString, "Copying..."); pLCD2004->println(lcdString); Serial.println(lcdString);
-
-    for (unsigned long FRAMAddress = bottomAddress; FRAMAddress < topAddress; FRAMAddress = FRAMAddress + bytesToTransfer) {
-      if ((FRAMAddress % 16384) == 0) Serial.print(".");  // Occasionally print a dot to show progress is being made
-      // Serial.println(FRAMAddress);  // This shows addresses written are 0, 128, 256, 384, ... 524,160 -- as expected.
-      pStorageCopy->read(FRAMAddress, bytesToTransfer, pDataBuffer);
-      pStorageMaster->write(FRAMAddress, bytesToTransfer, pDataBuffer);
-    }
+    pSource = pStorageCopy;
+    pDestination = pStorageMaster;
 
   } else if (copyMode == FRAM_MODE_WRITE) {  // Okay, this is our "normal" copy-from-master-to-duplicate FRAM mode
 
@@ -174,13 +176,8 @@ void duplicateFRAM() {
       pStorageCopy->testFRAM();  // Writes then reads random data to entire FRAM.
       // If we return from the test, it tested okay.
     #endif
-    sprintf(lcdString, "Copying..."); pLCD2004->println(lcdString); Serial.println(lcdString);
-    for (unsigned long FRAMAddress = bottomAddress; FRAMAddress < topAddress; FRAMAddress = FRAMAddress + bytesToTransfer) {
-      if ((FRAMAddress % 16384) == 0) Serial.print(".");  // Occasionally print a dot to show progress is being made
-      // Serial.println(FRAMAddress);  // This shows addresses written are 0, 128, 256, 384, ... 524,160 -- as expected.
-      pStorageMaster->read(FRAMAddress, bytesToTransfer, pDataBuffer);
-      pStorageCopy->write(FRAMAddress, bytesToTransfer, pDataBuffer);
-    }
+    pSource = pStorageMaster;
+    pDestination = pStorageCopy;
 
   } else {  // Yikes we have a big problem!
 
@@ -188,33 +185,93 @@ void duplicateFRAM() {
 
   }
 
+  #ifdef FRAM_DIFF_ONLY
+    sprintf(lcdString, "Diff copying..."); pLCD2004->println(lcdString); Serial.println(lcdString);
+  #else
+    sprintf(lcdString, "Copying..."); pLCD2004->println(lcdString); Serial.println(lcdString);
+  #endif
+  unsigned int pagesWritten = 0;
+  unsigned long startTime = millis();
+  for (unsigned int pageNum = 0; pageNum < FRAM_PAGES; pageNum++) {
+    unsigned long FRAMAddress = (unsigned long)pageNum * FRAM_PAGE_BYTES;
+    pSource->readStream(FRAMAddress, FRAM_PAGE_BYTES, pageBuffer1);
+    pageCRC[pageNum] = pageCRC16(pageBuffer1);
+    #ifdef FRAM_DIFF_ONLY
+      pDestination->readStream(FRAMAddress, FRAM_PAGE_BYTES, pageBuffer2);
+      if (memcmp(pageBuffer1, pageBuffer2, FRAM_PAGE_BYTES) != 0) {
+        pDestination->writeStream(FRAMAddress, FRAM_PAGE_BYTES, pageBuffer1);
+        pagesWritten++;
+      }
+    #else
+      pDestination->writeStream(FRAMAddress, FRAM_PAGE_BYTES, pageBuffer1);
+      pagesWritten++;
+    #endif
+    if (((pageNum + 1) % 64) == 0) {  // Every 64KB
+      displayProgress(pageNum + 1, startTime);
+    }
+  }
+  sprintf(lcdString, "COPY %u KB/s", kilobytesPerSecond(FRAM_PAGES, startTime)); pLCD2004->println(lcdString); Serial.println(lcdString);
+  sprintf(lcdString, "%u of %u pgs wrtn", pagesWritten, FRAM_PAGES); pLCD2004->println(lcdString); Serial.println(lcdString);
+
   return;
 
 }
 
 bool confirmDuplicateFRAM() {
+  // Rev: 10/19/26.
+  // Compares the CRC of every destination page with the CRC of the source page we saved while copying, so we only need to read
+  // the destination FRAM.  Reports every page that doesn't match, rather than stopping at the first one.
 
-  sprintf(lcdString, "Comparing..."); pLCD2004->println(lcdString); Serial.println(lcdString);
-
-  unsigned long bottomAddress        = pStorageMaster->bottomAddress();  // 0
-  unsigned long topAddress           = pStorageMaster->topAddress();     // 524,287 (524,288 - 1)
-  byte          bytesToTransfer      = 128;                                // Number of bytes to read/write at a single go
-
-  byte dataBuffer1[bytesToTransfer];
-  byte dataBuffer2[bytesToTransfer];
-  byte* pDataBuffer1 = dataBuffer1;  // Same as saying &dataBuffer1[0]
-  byte* pDataBuffer2 = dataBuffer2;  // Same as saying &dataBuffer2[0]
-
-  for (unsigned long FRAMAddress = bottomAddress; FRAMAddress < topAddress; FRAMAddress = FRAMAddress + bytesToTransfer) {
-    if ((FRAMAddress % 16384) == 0) Serial.print(".");  // Occasionally print a dot to show progress is being made
-    // Serial.println(FRAMAddress);  // This shows addresses written are 0, 128, 256, 384, ... 524,160 -- as expected.
-    pStorageCopy->read(FRAMAddress, bytesToTransfer, pDataBuffer1);
-    pStorageMaster->read(FRAMAddress, bytesToTransfer, pDataBuffer2);
-    for (byte i = 0; i < bytesToTransfer; i++) {  // For bytes 0..127 of the buffers we just read
-      if (pDataBuffer1[i] != pDataBuffer2[i]) {
-        return false;
-      }
+  sprintf(lcdString, "Verifying..."); pLCD2004->println(lcdString); Serial.println(lcdString);
+
+  FRAM* pDestination = pStorageCopy;
+  if (copyMode == FRAM_MODE_READ) {
+    pDestination = pStorageMaster;
+  }
+  unsigned int badPages = 0;
+  unsigned long startTime = millis();
+  for (unsigned int pageNum = 0; pageNum < FRAM_PAGES; pageNum++) {
+    pDestination->readStream((unsigned long)pageNum * FRAM_PAGE_BYTES, FRAM_PAGE_BYTES, pageBuffer1);
+    if (pageCRC16(pageBuffer1) != pageCRC[pageNum]) {
+      Serial.print(F("CRC mismatch page ")); Serial.print(pageNum);
+      Serial.print(F(" at address ")); Serial.println((unsigned long)pageNum * FRAM_PAGE_BYTES);
+      badPages++;
+    }
+    if (((pageNum + 1) % 64) == 0) {  // Every 64KB
+      displayProgress(pageNum + 1, startTime);
     }
   }
-  return true;  // Returns true if duplicate checks out okay
+  sprintf(lcdString, "VERIFY %u KB/s", kilobytesPerSecond(FRAM_PAGES, startTime)); pLCD2004->println(lcdString); Serial.println(lcdString);
+  if (badPages > 0) {
+    sprintf(lcdString, "%u BAD PAGES!", badPages); pLCD2004->println(lcdString); Serial.println(lcdString);
+  }
+  return (badPages == 0);  // Returns true if duplicate checks out okay
+}
+
+unsigned int pageCRC16(const byte t_page[]) {
+  // Rev: 10/19/26.
+  // CRC-CCITT of one FRAM_PAGE_BYTES page.  Any single changed byte (or bit) in a page changes its CRC.
+  unsigned int crc = 0xFFFF;
+  for (unsigned int i = 0; i < FRAM_PAGE_BYTES; i++) {
+    crc = _crc_ccitt_update(crc, t_page[i]);
+  }
+  return crc;
+}
+
+unsigned int kilobytesPerSecond(const unsigned int t_pages, const unsigned long t_startTime) {
+  // Rev: 10/19/26.
+  // With FRAM_PAGE_BYTES = 1024, pages are KB.
+  unsigned long elapsed = millis() - t_startTime;
+  if (elapsed == 0) {
+    elapsed = 1;
+  }
+  return (unsigned int)(((unsigned long)t_pages * 1000) / elapsed);
+}
+
+void displayProgress(const unsigned int t_pagesDone, const unsigned long t_startTime) {
+  // Rev: 10/19/26.
+  // Serial only; the LCD is too slow to update this often and would scroll the mode messages away.
+  Serial.print(t_pagesDone); Serial.print(F("KB of ")); Serial.print(FRAM_PAGES); Serial.print(F("KB, "));
+  Serial.print(kilobytesPerSecond(t_pagesDone, t_startTime)); Serial.println(F(" KB/s"));
+  return;
 }
@@ -0,0 +1,108 @@
+# EVENT_JOURNAL.PY Rev: 10/19/26.
+# Decodes the Event_Journal ring in a FRAM image saved with FRAM_Image.py, and prints the same timeline as Event_Journal::dump()
+# on the Serial monitor -- without having to get the module that wrote it running again.  Each module that keeps a journal (MAS
+# and LEG so far) writes it to its own FRAM, so plug that module's FRAM into the Populator Mega and save it.  Requires Python 3.
+#
+#   python Event_Journal.py fram.bin              Whole journal, oldest record first.
+#   python Event_Journal.py fram.bin --last 200   Only the most recent 200 records.
+#   python Event_Journal.py fram.bin --levels 2   Image is from a layout built with LAYOUT_LEVELS 2 (the journal moves.)
+#
+# Header (6 bytes at FRAM_ADDR_MAS_LOG_FILE): signature 0x4A4C ("JL"), records written (unsigned long.)  Then the ring of 12-byte
+# records: timestamp (millis), module, event type, loco, item, route element, value.  All little-endian, as on the Mega.
+
+import argparse
+import struct
+import sys
+
+# *** Consts copied from Train_Consts_Global.h ***
+FRAM_BYTES_ROUTE_REF_PER_LEVEL = 166912
+FRAM_BYTES_MAS_LOG_FILE = 98310
+ARDUINO_NAMES = ["NUL", "MAS", "LEG", "SNS", "BTN", "SWT", "LED", "OCC"]
+BE = 4
+SENSOR_STATUS_TRIPPED = ord("T")
+LOCO_ID_NULL = 0
+
+# *** Consts copied from Event_Journal.h ***
+JOURNAL_SIGNATURE = 0x4A4C
+HEADER_FORMAT = "<HL"      # journalHeaderStruct
+RECORD_FORMAT = "<LBBBBHH"  # journalRecordStruct
+JOURNAL_EVENT_BOOT = 1
+JOURNAL_EVENT_MODE_STATE = 2
+JOURNAL_EVENT_SENSOR_TRIP = 3
+JOURNAL_EVENT_ROUTE_ADDED = 4
+JOURNAL_EVENT_BLOCK_RESERVED = 5
+JOURNAL_EVENT_BLOCK_RELEASED = 6
+JOURNAL_EVENT_TURNOUT_THROWN = 7
+JOURNAL_EVENT_LEGACY_CMD = 8
+
+
+def journal_address(levels):
+    # FRAM_ADDR_MAS_LOG_FILE, worked out table by table the way Train_Consts_Global.h does; 186026 with one level.
+    route_ref = 256 + 256 * levels + 512 * levels + 2048 * levels + 2048 * levels + 7594 + 6400 * levels
+    return route_ref + FRAM_BYTES_ROUTE_REF_PER_LEVEL * levels
+
+
+def describe(event_type, loco_num, item, route_element, value):
+    # Same wording as Event_Journal::dump().
+    if event_type == JOURNAL_EVENT_BOOT:
+        return "BOOT ----------------"
+    if event_type == JOURNAL_EVENT_MODE_STATE:
+        return "Mode %d State %d" % (item, value)
+    if event_type == JOURNAL_EVENT_SENSOR_TRIP:
+        text = "Sensor %d %s" % (item, "tripped" if value == SENSOR_STATUS_TRIPPED else "cleared")
+        if loco_num != LOCO_ID_NULL:
+            text += " by loco %d at element %d" % (loco_num, route_element)
+        return text
+    if event_type == JOURNAL_EVENT_ROUTE_ADDED:
+        return "Loco %d route %d (%s) countdown %d sec" % (loco_num, route_element, chr(item), value)
+    if event_type == JOURNAL_EVENT_BLOCK_RESERVED:
+        return "Block %d %s reserved for loco %d" % (item, "BE" if value == BE else "BW", loco_num)
+    if event_type == JOURNAL_EVENT_BLOCK_RELEASED:
+        return "Block %d released" % item
+    if event_type == JOURNAL_EVENT_TURNOUT_THROWN:
+        return "Turnout %d %s" % (item, chr(value & 0xFF))
+    if event_type == JOURNAL_EVENT_LEGACY_CMD:
+        return "Legacy dev %d cmd %d parm %d" % (loco_num, item, value)
+    return "Event %d loco %d elem %d item %d value %d" % (event_type, loco_num, route_element, item, value)
+
+
+def decode(image, levels, last):
+    # Returns the timeline as a list of lines, oldest first.
+    header_addr = journal_address(levels)
+    header_size = struct.calcsize(HEADER_FORMAT)
+    record_size = struct.calcsize(RECORD_FORMAT)
+    journal_recs = (FRAM_BYTES_MAS_LOG_FILE - header_size) // record_size
+    if len(image) < header_addr + FRAM_BYTES_MAS_LOG_FILE:
+        sys.exit("Image is only %d bytes; the journal ends at %d." % (len(image), header_addr + FRAM_BYTES_MAS_LOG_FILE))
+    signature, records_written = struct.unpack_from(HEADER_FORMAT, image, header_addr)
+    if signature != JOURNAL_SIGNATURE:
+        sys.exit("No journal at %d (signature 0x%04X.)  Wrong --levels, or this FRAM never held a journal?" %
+                 (header_addr, signature))
+    first_rec_num = max(records_written - journal_recs, 0)
+    if last is not None:
+        first_rec_num = max(first_rec_num, records_written - last)
+    lines = ["EVENT JOURNAL: %d of %d records." % (records_written - first_rec_num, records_written)]
+    for rec_num in range(first_rec_num, records_written):
+        addr = header_addr + header_size + (rec_num % journal_recs) * record_size
+        timestamp, module, event_type, loco_num, item, route_element, value = struct.unpack_from(RECORD_FORMAT, image, addr)
+        module_name = ARDUINO_NAMES[module] if module < len(ARDUINO_NAMES) else "???"
+        lines.append("%7d.%03d %s %s" % (timestamp // 1000, timestamp % 1000, module_name,
+                                         describe(event_type, loco_num, item, route_element, value)))
+    lines.append("END OF JOURNAL.")
+    return lines
+
+
+def main(argv):
+    parser = argparse.ArgumentParser(description="Print the Event_Journal timeline from a FRAM image.")
+    parser.add_argument("image", help="FRAM image file saved by FRAM_Image.py")
+    parser.add_argument("--levels", type=int, default=1, help="LAYOUT_LEVELS the module was built with (default 1)")
+    parser.add_argument("--last", type=int, default=None, help="only the most recent N records")
+    args = parser.parse_args(argv[1:])
+    with open(args.image, "rb") as f:
+        image = f.read()
+    for line in decode(image, args.levels, args.last):
+        print(line)
+
+
+if __name__ == "__main__":
+    main(sys.argv)
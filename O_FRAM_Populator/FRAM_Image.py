@@ -0,0 +1,182 @@
+# FRAM_IMAGE.PY Rev: 10/19/26.
+# Builds a whole 512KB FRAM image on the PC, and is the PC side of O_FRAM_Populator's FRAM_IMAGE_SERIAL mode, which saves a FRAM
+# to a file or loads a file into a FRAM in one session over the Mega's USB serial port.  Requires Python 3, and pyserial for the
+# commands that talk to a Mega (pip install pyserial.)
+#
+#   python FRAM_Image.py build    fram.bin        Build every table from the libraries' populate() data; see FRAM_Tables.py.
+#                                                 Nothing is written if the tables don't cross-check.
+#   python FRAM_Image.py build    fram.bin --host Same, laid out for the libraries compiled on a PC (Host_Test), not the Mega.
+#   python FRAM_Image.py save     COM3 fram.bin   Read the FRAM plugged into the Populator Mega and write it to fram.bin.
+#   python FRAM_Image.py load     COM3 fram.bin   Write fram.bin to the FRAM plugged into the Populator Mega.
+#   python FRAM_Image.py validate COM3            Have the Mega cross-check the tables in its FRAM (text report.)
+#   python FRAM_Image.py check    fram.bin        Check an image file's size and FRAM rev date, without a Mega.
+#
+# Each page is sent as: 'P', page num hi, page num lo, 1024 data bytes, CRC lo, CRC hi.  The receiver replies 'A' or 'N' (re-send.)
+# The CRC is AVR-libc's _crc_ccitt_update() starting from 0xFFFF.
+
+import sys
+import time
+
+import FRAM_Tables
+
+CONSTS = FRAM_Tables.read_consts()
+PAGE_BYTES = 1024             # FRAM_IMAGE_PAGE_BYTES in O_FRAM_Populator.ino
+PAGES = (CONSTS["FRAM_ADDR_TOP"] + 1) // PAGE_BYTES
+SERIAL_SPEED = CONSTS["SERIAL0_SPEED"]
+FRAMVERSION = CONSTS["FRAMVERSION"]
+FRAM_ADDR_REV_DATE = CONSTS["FRAM_ADDR_REV_DATE"]
+RETRIES = 5
+
+
+def crc_ccitt_update(crc, data):
+    # Same as AVR-libc _crc_ccitt_update().
+    data ^= crc & 0xFF
+    data ^= (data << 4) & 0xFF
+    return ((((data << 8) | (crc >> 8)) ^ (data >> 4) ^ (data << 3)) & 0xFFFF)
+
+
+def page_crc(page):
+    crc = 0xFFFF
+    for b in page:
+        crc = crc_ccitt_update(crc, b)
+    return crc
+
+
+def check_image(image):
+    # Returns a list of problems; empty if the image looks okay.
+    problems = []
+    if len(image) != PAGES * PAGE_BYTES:
+        problems.append("Image is %d bytes; expected %d." % (len(image), PAGES * PAGE_BYTES))
+    rev_date = image[FRAM_ADDR_REV_DATE:FRAM_ADDR_REV_DATE + 3]
+    if rev_date != FRAMVERSION:
+        problems.append("FRAM rev date %s does not match FRAMVERSION %s." % (list(rev_date), list(FRAMVERSION)))
+    return problems
+
+
+def open_mega(port):
+    # Opening the port resets the Mega.  Skip everything it prints while populating/testing until it says it's ready.
+    import serial
+    mega = serial.Serial(port, SERIAL_SPEED, timeout=5)
+    deadline = time.time() + 60
+    while time.time() < deadline:
+        line = mega.readline().decode("latin-1").strip()
+        if line:
+            print("Mega: " + line)
+        if line == "FRAM IMAGE READY":
+            return mega
+    sys.exit("Mega never said FRAM IMAGE READY.  Is FRAM_IMAGE_SERIAL defined in O_FRAM_Populator?")
+
+
+def save(port, filename):
+    mega = open_mega(port)
+    mega.write(b"S")
+    image = bytearray(PAGES * PAGE_BYTES)
+    received = 0
+    start = time.time()
+    while received < PAGES:
+        header = mega.read(1)
+        if header == b"E":
+            break
+        if header != b"P":
+            sys.exit("Lost sync with Mega (got %r) after %d pages." % (header, received))
+        frame = mega.read(2 + PAGE_BYTES + 2)
+        if len(frame) != 2 + PAGE_BYTES + 2:
+            mega.write(b"N")
+            continue
+        page_num = (frame[0] << 8) | frame[1]
+        page = frame[2:2 + PAGE_BYTES]
+        crc = frame[2 + PAGE_BYTES] | (frame[3 + PAGE_BYTES] << 8)
+        if (page_num >= PAGES) or (page_crc(page) != crc):
+            mega.write(b"N")
+            continue
+        image[page_num * PAGE_BYTES:(page_num + 1) * PAGE_BYTES] = page
+        mega.write(b"A")
+        received += 1
+        print("\rSaved %d of %d KB" % (received, PAGES), end="")
+    print()
+    if received != PAGES:
+        sys.exit("Only received %d of %d pages; %s not written." % (received, PAGES, filename))
+    with open(filename, "wb") as f:
+        f.write(image)
+    elapsed = max(time.time() - start, 0.001)
+    print("Saved %s in %.1f sec (%.1f KB/s)." % (filename, elapsed, PAGES / elapsed))
+    for problem in check_image(image):
+        print("WARNING: " + problem)
+
+
+def load(port, filename):
+    with open(filename, "rb") as f:
+        image = f.read()
+    problems = check_image(image)
+    if problems:
+        for problem in problems:
+            print("ERROR: " + problem)
+        sys.exit("Not loading %s." % filename)
+    mega = open_mega(port)
+    mega.write(b"L")
+    start = time.time()
+    for page_num in range(PAGES):
+        page = image[page_num * PAGE_BYTES:(page_num + 1) * PAGE_BYTES]
+        crc = page_crc(page)
+        frame = bytes([ord("P"), page_num >> 8, page_num & 0xFF]) + page + bytes([crc & 0xFF, crc >> 8])
+        for attempt in range(RETRIES):
+            mega.write(frame)
+            reply = mega.read(1)
+            if reply == b"A":
+                break
+        else:
+            sys.exit("Mega did not accept page %d." % page_num)
+        print("\rLoaded %d of %d KB" % (page_num + 1, PAGES), end="")
+    mega.write(b"E")
+    print()
+    elapsed = max(time.time() - start, 0.001)
+    print("Loaded %s in %.1f sec (%.1f KB/s)." % (filename, elapsed, PAGES / elapsed))
+
+
+def build(filename, host):
+    tables = FRAM_Tables.FRAMTables(host=host)
+    for line in tables.report():
+        print(line)
+    for problem in tables.problems:
+        print("ERROR: " + problem)
+    if tables.problems:
+        sys.exit("%d problems; %s not written." % (len(tables.problems), filename))
+    with open(filename, "wb") as f:
+        f.write(tables.image())
+    print("Built %s%s." % (filename, " (host layout; don't load it into a FRAM)" if host else ""))
+
+
+def validate(port):
+    mega = open_mega(port)
+    mega.write(b"V")
+    while True:
+        line = mega.readline().decode("latin-1").strip()
+        if not line:
+            sys.exit("Mega stopped responding.")
+        print(line)
+        if line.startswith("VALIDATE:"):
+            break
+
+
+def main(argv):
+    if (len(argv) in (3, 4)) and (argv[1] == "build") and (argv[3:] in ([], ["--host"])):
+        build(argv[2], len(argv) == 4)
+    elif (len(argv) == 4) and (argv[1] == "save"):
+        save(argv[2], argv[3])
+    elif (len(argv) == 4) and (argv[1] == "load"):
+        load(argv[2], argv[3])
+    elif (len(argv) == 3) and (argv[1] == "validate"):
+        validate(argv[2])
+    elif (len(argv) == 3) and (argv[1] == "check"):
+        with open(argv[2], "rb") as f:
+            problems = check_image(f.read())
+        for problem in problems:
+            print("ERROR: " + problem)
+        if not problems:
+            print("%s looks okay." % argv[2])
+    else:
+        sys.exit("Usage: FRAM_Image.py build FILE [--host], save|load PORT FILE, validate PORT, or check FILE")
+
+
+if __name__ == "__main__":
+    main(sys.argv)
@@ -0,0 +1,432 @@
+# FRAM_TABLES.PY Rev: 10/19/26.
+# Builds a complete FRAM image on the PC from the same source data the populate() utilities use, so a new FRAM no longer means
+# flashing O_FRAM_Populator and re-running populate() once per table (and once per GROUP for Route Reference.)  Used by
+# FRAM_Image.py build; see there.  Nothing here is copied by hand from the sketches or libraries:
+#   * Constants (FRAM addresses and sizes, FRAMVERSION, BE/BW/ER..., LOCO_SPEED_xxx, TOTAL_xxx) come from Train_Consts_Global.h.
+#   * Each table's record layout comes from its struct in the library's .h file.
+#   * The records come from the initializers in each library's populate(), with every GROUP of Route Reference included.
+#     Turnout Reservation's populate() is a loop rather than data, so turnout_records() below says what it writes.
+# Records are packed the way avr-gcc lays them out (2-byte int, no padding.)  With host=True they're packed like gcc on a 64-bit
+# PC instead (4-byte int, natural alignment), which is the layout the libraries expect when Host_Test runs them; Host_Test's
+# FRAM_Image test reads such an image through the libraries and compares it with what the real populate() functions write.
+# The Sensor-Block Xref is derived from Block Reservation's sensors and must agree with Sensor_Block's populate() data.  Route
+# bitmaps aren't stored in FRAM; Route_Reference::buildRouteBitmaps() makes them at run time.
+# The Event_Journal area is left zeroed, so the first Event_Journal::begin() starts an empty journal.
+
+import os
+import re
+import struct
+
+REPO = os.path.dirname(os.path.dirname(os.path.abspath(__file__)))
+LIBRARIES = os.path.join(REPO, "libraries")
+
+# Struct member types we know how to pack, as (avr-gcc, host gcc) struct module codes.
+C_TYPES = {
+    "byte": ("B", "B"),
+    "uint8_t": ("B", "B"),
+    "char": ("c", "c"),
+    "bool": ("?", "?"),
+    "int": ("h", "i"),
+    "unsigned int": ("H", "I"),
+    "long": ("i", "l"),
+    "unsigned long": ("I", "L"),
+}
+
+
+class FRAMTableError(Exception):
+    pass
+
+
+def read_source(path):
+    with open(path, encoding="latin-1") as f:
+        return f.read().replace("\r\n", "\n")
+
+
+def strip_comments(text):
+    # Removes // and /* */ comments, leaving char and string literals alone.
+    out = []
+    i = 0
+    while i < len(text):
+        c = text[i]
+        if text.startswith("//", i):
+            i = text.find("\n", i)
+            if i < 0:
+                break
+        elif text.startswith("/*", i):
+            i = text.find("*/", i) + 2
+        elif c in "'\"":
+            end = i + 1
+            while text[end] != c:
+                end += 2 if text[end] == "\\" else 1
+            out.append(text[i:end + 1])
+            i = end + 1
+        else:
+            out.append(c)
+            i += 1
+    return "".join(out)
+
+
+def c_value(token, consts):
+    # Value of one C initializer or constant expression: a number (octal if it has a leading 0, as in C), a char literal, true or
+    # false, a constant name, or arithmetic on those.
+    token = token.strip()
+    if re.match(r"^'(\\.|[^'])'$", token):
+        return token[1:-1].encode("latin-1").decode("unicode_escape")
+    if token in ("true", "false"):
+        return token == "true"
+    expr = re.sub(r"\b(\d+)[uUlL]*\b", lambda m: str(int(m.group(1), 8 if len(m.group(1)) > 1 and m.group(1)[0] == "0" else 10)),
+                  token)
+    expr = expr.replace("/", "//")
+    try:
+        return eval(expr, {"__builtins__": {}}, consts)
+    except Exception:
+        raise FRAMTableError("Can't evaluate %r." % token)
+
+
+def read_consts(levels=None):
+    # Every "const <type> NAME = value;" in Train_Consts_Global.h that we can evaluate, plus LAYOUT_LEVELS and FRAMVERSION.
+    text = strip_comments(read_source(os.path.join(LIBRARIES, "Train_Consts_Global", "Train_Consts_Global.h")))
+    consts = {}
+    m = re.search(r"^\s*#define\s+LAYOUT_LEVELS\s+(\d+)", text, re.M)
+    consts["LAYOUT_LEVELS"] = levels if levels else int(m.group(1))
+    for m in re.finditer(r"\bconst\s+(?:(?:unsigned|long|int|byte|char|bool|uint8_t)\s+)+(\w+)\s*=\s*([^;]+);", text):
+        try:
+            consts[m.group(1)] = c_value(m.group(2), consts)
+        except FRAMTableError:
+            pass  # Something we don't need, such as a sizeof().
+    m = re.search(r"\bFRAMVERSION\s*\[\s*3\s*\]\s*=?\s*\{([^}]*)\}", text)
+    consts["FRAMVERSION"] = bytes(c_value(v, consts) for v in m.group(1).split(","))
+    return consts
+
+
+def struct_members(text, struct_name):
+    # [(C type, member name, array length or None)] for "struct struct_name { ... };" in text (comments already stripped.)
+    m = re.search(r"\bstruct\s+%s\s*\{([^}]*)\}" % struct_name, text)
+    if not m:
+        raise FRAMTableError("No struct %s." % struct_name)
+    members = []
+    for decl in m.group(1).split(";"):
+        decl = " ".join(decl.split())
+        if not decl:
+            continue
+        dm = re.match(r"^(.*?)\s*\b(\w+)\s*(?:\[\s*(\w+)\s*\])?$", decl)
+        members.append((dm.group(1), dm.group(2), dm.group(3)))
+    return members
+
+
+class Layout:
+    # The flattened scalar fields of a struct, in order, with the struct module format for avr-gcc or host gcc.
+
+    def __init__(self, header_text, struct_name, consts, host):
+        self.struct_name = struct_name
+        self.fields = []  # [(name, code)], i.e. ("route[3].routeRecVal", "B")
+        self.host = host
+        self._add(header_text, struct_name, "", consts)
+        self.format = ("@" if host else "<") + "".join(code for name, code in self.fields)
+        self.size = struct.calcsize(self.format)
+        if host:  # Round up to the struct's alignment, as gcc does, so the next record in an array starts where the library expects.
+            align = max(struct.calcsize("@" + code) for name, code in self.fields)
+            self.size = (self.size + align - 1) // align * align
+
+    def _add(self, header_text, struct_name, prefix, consts):
+        global_text = strip_comments(read_source(os.path.join(LIBRARIES, "Train_Consts_Global", "Train_Consts_Global.h")))
+        for c_type, name, count in struct_members(header_text, struct_name):
+            names = [prefix + name] if count is None else ["%s%s[%d]" % (prefix, name, i) for i in range(c_value(count, consts))]
+            for field in names:
+                if c_type in C_TYPES:
+                    self.fields.append((field, C_TYPES[c_type][1 if self.host else 0]))
+                else:  # A struct such as routeElement, defined in Train_Consts_Global.h
+                    self._add(global_text, c_type, field + ".", consts)
+
+    def pack(self, values):
+        coded = []
+        for (name, code), value in zip(self.fields, values):
+            if code == "c":
+                value = bytes([value]) if isinstance(value, int) else value.encode("latin-1")
+            elif isinstance(value, str):
+                value = ord(value)
+            coded.append(value)
+        return struct.pack(self.format, *coded).ljust(self.size, b"\0")
+
+
+def split_top_level(text):
+    # Splits "a, {b, c}, d" at commas outside braces.
+    parts, depth, start = [], 0, 0
+    for i, c in enumerate(text):
+        if c == "{":
+            depth += 1
+        elif c == "}":
+            depth -= 1
+        elif (c == ",") and (depth == 0):
+            parts.append(text[start:i])
+            start = i + 1
+    parts.append(text[start:])
+    return [p.strip() for p in parts if p.strip()]
+
+
+def populate_records(class_name, consts):
+    # [(array index, [values])] from the brace initializers in class_name::populate().  Handles both styles used:
+    #   type name[N] = { {..}, {..} };   and   name[i] = { .. };
+    # Preprocessor lines are dropped, so every #ifdef GROUP_n block of Route_Reference::populate() is included.
+    text = strip_comments(read_source(os.path.join(LIBRARIES, class_name, class_name + ".cpp")))
+    owner = "Deadlock_Reference" if class_name == "Deadlock" else class_name
+    start = text.find("%s::populate()" % owner)
+    if start < 0:
+        raise FRAMTableError("No %s::populate()." % owner)
+    start = text.find("{", start)
+    depth, end = 0, start
+    for end in range(start, len(text)):
+        depth += {"{": 1, "}": -1}.get(text[end], 0)
+        if depth == 0:
+            break
+    body = "\n".join(line for line in text[start + 1:end].split("\n") if not line.strip().startswith("#"))
+    records = []
+    for m in re.finditer(r"([\w\s]*?)\b(\w+)\s*\[\s*([^\]]+?)\s*\]\s*=\s*\{", body):
+        depth, i = 1, m.end()
+        while depth:
+            depth += {"{": 1, "}": -1}.get(body[i], 0)
+            i += 1
+        inner = body[m.end():i - 1]
+        if m.group(1).strip():  # A declaration: one {..} per record
+            for index, group in enumerate(split_top_level(inner)):
+                records.append((index, [c_value(v, consts) for v in split_top_level(group.strip("{} \n"))]))
+        else:
+            values = [c_value(v, consts) for v in split_top_level(inner.replace("{", "").replace("}", ""))]
+            records.append((c_value(m.group(3), consts), values))
+    return records
+
+
+def turnout_records(consts):
+    # What Turnout_Reservation::populate() writes: every turnout Normal and unreserved.
+    return [(n - 1, [n, consts["TURNOUT_DIR_NORMAL"], consts["LOCO_ID_NULL"]]) for n in range(1, consts["TOTAL_TURNOUTS"] + 1)]
+
+
+class Table:
+    # One FRAM table.  key_field holds the number the library turns into the record's address; first_key is that number for
+    # the first record (block 1, but Route Ref rec 0.)  by_index means populate() writes array element i as record i, so the key
+    # must agree with the array index; otherwise (Route Reference) populate() writes each record wherever its key says.
+
+    def __init__(self, title, class_name, struct_name, addr, limit, count, key_field, first_key=1, by_index=True):
+        self.title = title
+        self.class_name = class_name
+        self.struct_name = struct_name
+        self.addr = addr
+        self.limit = limit
+        self.count = count
+        self.key_field = key_field
+        self.first_key = first_key
+        self.by_index = by_index
+
+
+TABLES = [
+    Table("Turnout Reservation", "Turnout_Reservation", "turnoutReservationStruct", "FRAM_ADDR_TURNOUT_RESN",
+          "FRAM_BYTES_TURNOUT_RESN", "TOTAL_TURNOUTS", "turnoutNum"),
+    Table("Sensor-Block Xref", "Sensor_Block", "sensorBlockStruct", "FRAM_ADDR_SNS_BLK_XREF",
+          "FRAM_BYTES_SNS_BLK_XREF", "TOTAL_SENSORS", "sensorNum"),
+    Table("Block Reservation", "Block_Reservation", "blockReservationStruct", "FRAM_ADDR_BLOCK_RESN",
+          "FRAM_BYTES_BLOCK_RESN", "TOTAL_BLOCKS", "blockNum"),
+    Table("Deadlock", "Deadlock", "deadlockStruct", "FRAM_ADDR_DEADLOCK",
+          "FRAM_BYTES_DEADLOCK", "FRAM_RECS_DEADLOCK", "deadlockNum"),
+    Table("Loco Reference", "Loco_Reference", "locoReferenceStruct", "FRAM_ADDR_LOCO_REF",
+          "FRAM_BYTES_LOCO_REF", "TOTAL_TRAINS", "locoNum"),
+    Table("Route Reference", "Route_Reference", "routeReferenceStruct", "FRAM_ADDR_ROUTE_REF",
+          "FRAM_BYTES_ROUTE_REF", "FRAM_RECS_ROUTE_TOTAL", "recNum", first_key=0, by_index=False),
+]
+
+
+class FRAMTables:
+    # Every table's records, as {table title: [record dict by record number]}, checked against each other.
+
+    def __init__(self, host=False, levels=None):
+        self.consts = read_consts(levels)
+        self.host = host
+        self.layouts = {}
+        self.records = {}
+        self.problems = []
+        for table in TABLES:
+            header = strip_comments(read_source(os.path.join(LIBRARIES, table.class_name, table.class_name + ".h")))
+            layout = Layout(header, table.struct_name, self.consts, host)
+            self.layouts[table.title] = layout
+            if table.class_name == "Turnout_Reservation":
+                raw = turnout_records(self.consts)
+            else:
+                raw = populate_records(table.class_name, self.consts)
+            self.records[table.title] = self._place(table, layout, raw)
+        self._derive_sensor_block()
+        self._check()
+
+    def _place(self, table, layout, raw):
+        count = self.consts[table.count]
+        records = [None] * count
+        names = [name for name, code in layout.fields]
+        for index, values in raw:
+            if len(values) > len(names):
+                self.problems.append("%s element %d has %d values; %s has %d fields." %
+                                     (table.title, index, len(values), layout.struct_name, len(names)))
+                continue
+            values = values + [0] * (len(names) - len(values))  # As in C, members without an initializer are zero.
+            rec = dict(zip(names, values))
+            key = rec[table.key_field]
+            if table.by_index and (key != index + table.first_key):
+                self.problems.append("%s element %d has %s %d; expected %d." %
+                                     (table.title, index, table.key_field, key, index + table.first_key))
+            recNum = key - table.first_key
+            if not 0 <= recNum < count:
+                self.problems.append("%s %s %d is outside 0..%d." % (table.title, table.key_field, key, count - 1))
+            elif records[recNum] is not None:
+                self.problems.append("%s %s %d appears twice." % (table.title, table.key_field, key))
+            else:
+                records[recNum] = rec
+        for recNum, rec in enumerate(records):
+            if rec is None:
+                self.problems.append("%s has no record for %s %d." % (table.title, table.key_field, recNum + table.first_key))
+        return records
+
+    def _derive_sensor_block(self):
+        # The Sensor-Block Xref is the inverse of Block Reservation's west/east sensors.  Build it from there, and make sure
+        # Sensor_Block's own populate() data says the same thing.
+        c = self.consts
+        derived = {}
+        for rec in self.records["Block Reservation"]:
+            if rec is None:
+                continue
+            for field, end in (("westSensor", c["SENSOR_END_WEST"]), ("eastSensor", c["SENSOR_END_EAST"])):
+                sensorNum = rec[field]
+                if not 1 <= sensorNum <= c["TOTAL_SENSORS"]:
+                    self.problems.append("Block %d %s %d is not a sensor." % (rec["blockNum"], field, sensorNum))
+                elif sensorNum in derived:
+                    self.problems.append("Sensor %d is in blocks %d and %d." % (sensorNum, derived[sensorNum][0],
+                                                                                rec["blockNum"]))
+                else:
+                    derived[sensorNum] = (rec["blockNum"], end)
+        sensors = self.records["Sensor-Block Xref"]
+        for recNum in range(c["TOTAL_SENSORS"]):
+            sensorNum = recNum + 1
+            if sensorNum not in derived:
+                self.problems.append("Sensor %d isn't at either end of any block." % sensorNum)
+                continue
+            blockNum, end = derived[sensorNum]
+            rec = sensors[recNum]
+            if (rec is not None) and ((rec["blockNum"], rec["whichEnd"]) != (blockNum, end)):
+                self.problems.append("Sensor_Block says sensor %d is block %d %s end; Block Reservation says block %d %s end." %
+                                     (sensorNum, rec["blockNum"], rec["whichEnd"], blockNum, end))
+            status = rec["status"] if rec is not None else c["SENSOR_STATUS_CLEARED"]
+            sensors[recNum] = {"sensorNum": sensorNum, "blockNum": blockNum, "whichEnd": end, "status": status}
+
+    def _check(self):
+        c = self.consts
+        self._check_fit()
+        block_types = (c["BE"], c["BW"])
+        speeds = range(c["LOCO_SPEED_STOP"], c["LOCO_SPEED_HIGH"] + 1)
+        for rec in self.records["Block Reservation"]:
+            if (rec is not None) and ((rec["westboundSpeed"] not in speeds) or (rec["eastboundSpeed"] not in speeds)):
+                self.problems.append("Block %d has a speed outside LOCO_SPEED_STOP..LOCO_SPEED_HIGH." % rec["blockNum"])
+        self._check_routes()
+        for rec in self.records["Deadlock"]:
+            if rec is None:
+                continue
+            if not self._element_ok(rec["destination.routeRecType"], rec["destination.routeRecVal"], block_types):
+                self.problems.append("Deadlock %d destination isn't a block." % rec["deadlockNum"])
+            for i in range(c["FRAM_FIELDS_DEADLOCK"]):
+                rtype, rval = rec["threatList[%d].routeRecType" % i], rec["threatList[%d].routeRecVal" % i]
+                if (rtype != c["ER"]) and not self._element_ok(rtype, rval, (c["BX"], c["BE"], c["BW"])):
+                    self.problems.append("Deadlock %d threat %d isn't a block." % (rec["deadlockNum"], i + 1))
+        destinations = [(r["destination.routeRecType"], r["destination.routeRecVal"]) for r in self.records["Deadlock"] if r]
+        for dest in set(d for d in destinations if destinations.count(d) > 1):
+            self.problems.append("Deadlock table lists destination %s more than once." % self.element_name(*dest))
+        locos = self.records["Loco Reference"]
+        for rec in locos:
+            if (rec is not None) and rec["active"] and (rec["opCarLocoNum"] != c["LOCO_ID_NULL"]):
+                op = rec["opCarLocoNum"]
+                if not ((1 <= op <= len(locos)) and locos[op - 1] and locos[op - 1]["active"]):
+                    self.problems.append("Loco %d op car %d isn't an active loco." % (rec["locoNum"], op))
+
+    def _check_fit(self):
+        # Same as each class's static_assert, plus the tables must be in address order without overlapping.
+        c = self.consts
+        previous_end, previous = 0, "FRAM rev date"
+        for table in TABLES:
+            addr, size = c[table.addr], self.layouts[table.title].size * c[table.count]
+            if size > c[table.limit]:
+                self.problems.append("%s is %d bytes; only %s = %d are reserved." % (table.title, size, table.limit,
+                                                                                    c[table.limit]))
+            if addr < previous_end:
+                self.problems.append("%s at %d overlaps %s." % (table.title, addr, previous))
+            previous_end, previous = addr + size, table.title
+        if c["FRAM_ADDR_MAS_LOG_FILE"] + c["FRAM_BYTES_MAS_LOG_FILE"] - 1 > c["FRAM_ADDR_TOP"]:
+            self.problems.append("Event_Journal runs past FRAM_ADDR_TOP.")
+
+    def _element_ok(self, rtype, rval, types):
+        c = self.consts
+        limits = {c["BE"]: c["TOTAL_BLOCKS"], c["BW"]: c["TOTAL_BLOCKS"], c["BX"]: c["TOTAL_BLOCKS"],
+                  c["SN"]: c["TOTAL_SENSORS"], c["TN"]: c["TOTAL_TURNOUTS"], c["TR"]: c["TOTAL_TURNOUTS"]}
+        return (rtype in types) and (1 <= rval <= limits[rtype])
+
+    def element_name(self, rtype, rval):
+        names = dict((self.consts[n], n) for n in ("ER", "SN", "BE", "BW", "TN", "TR", "FD", "RD", "VL", "TD", "BX"))
+        return "%s%02d" % (names.get(rtype, "?%d" % rtype), rval)
+
+    def _check_routes(self):
+        # Same element checks as validateFRAM() in O_FRAM_Populator, plus the things the sort order and Train Progress rely on:
+        # routes sorted by Origin + Priority + Destination, EB origins first, FRAM_RECS_ROUTE_EAST of them, and each route's
+        # first element is its origin and its last block is its destination.
+        c = self.consts
+        routes = self.records["Route Reference"]
+        value_ok = {c["SN"]: range(1, c["TOTAL_SENSORS"] + 1), c["BE"]: range(1, c["TOTAL_BLOCKS"] + 1),
+                    c["BW"]: range(1, c["TOTAL_BLOCKS"] + 1), c["TN"]: range(1, c["TOTAL_TURNOUTS"] + 1),
+                    c["TR"]: range(1, c["TOTAL_TURNOUTS"] + 1), c["VL"]: range(c["LOCO_SPEED_HIGH"] + 1),
+                    c["FD"]: range(256), c["RD"]: range(256), c["TD"]: range(256)}
+        previous_key = None
+        for recNum, rec in enumerate(routes):
+            if rec is None:
+                continue
+            origin = (rec["origin.routeRecType"], rec["origin.routeRecVal"])
+            dest = (rec["destination.routeRecType"], rec["destination.routeRecVal"])
+            label = "Route rec %d (Route ID %d)" % (recNum, rec["routeID"])
+            elements, found_er = [], False
+            for i in range(c["FRAM_SEGMENTS_ROUTE_REF"]):
+                element = (rec["route[%d].routeRecType" % i], rec["route[%d].routeRecVal" % i])
+                if element[0] == c["ER"]:
+                    found_er = True
+                    break
+                if (element[0] not in value_ok) or (element[1] not in value_ok[element[0]]):
+                    self.problems.append("%s element %d is bad: %d,%d." % (label, i, element[0], element[1]))
+                elements.append(element)
+            if not found_er:
+                self.problems.append("%s has no ER." % label)
+            blocks = [e for e in elements if e[0] in (c["BE"], c["BW"])]
+            if not elements or (elements[0] != origin):
+                self.problems.append("%s doesn't start at its origin %s." % (label, self.element_name(*origin)))
+            if not blocks or (blocks[-1] != dest):
+                self.problems.append("%s doesn't end at its destination %s." % (label, self.element_name(*dest)))
+            key = (origin, rec["priority"], dest)
+            if (previous_key is not None) and (key < previous_key):
+                self.problems.append("%s is out of Origin + Priority + Destination order." % label)
+            previous_key = key
+        east = sum(1 for rec in routes if rec and rec["origin.routeRecType"] == c["BE"])
+        if east != c["FRAM_RECS_ROUTE_EAST"]:
+            self.problems.append("%d routes have EB origins; FRAM_RECS_ROUTE_EAST is %d." % (east, c["FRAM_RECS_ROUTE_EAST"]))
+
+    def image(self):
+        # The whole FRAM, FRAM_ADDR_TOP + 1 bytes.
+        c = self.consts
+        image = bytearray(c["FRAM_ADDR_TOP"] + 1)
+        image[c["FRAM_ADDR_REV_DATE"]:c["FRAM_ADDR_REV_DATE"] + 3] = c["FRAMVERSION"]
+        for table in TABLES:
+            layout = self.layouts[table.title]
+            for recNum, rec in enumerate(self.records[table.title]):
+                if rec is not None:
+                    addr = c[table.addr] + recNum * layout.size
+                    image[addr:addr + layout.size] = layout.pack([rec[name] for name, code in layout.fields])
+        return bytes(image)
+
+    def report(self):
+        # One line per table.  "struct" lines are read by Host_Test's FRAM_Image test to check our sizes against sizeof().
+        c = self.consts
+        lines = []
+        for table in TABLES:
+            layout = self.layouts[table.title]
+            lines.append("struct %s %d  # %s: %d records at %d, %d of %d bytes" %
+                         (layout.struct_name, layout.size, table.title, c[table.count], c[table.addr],
+                          layout.size * c[table.count], c[table.limit]))
+        return lines
@@ -1,4 +1,9 @@
-// POPULATOR.INO Rev: 02/17/24.  FINISHED AND TESTED.
+// POPULATOR.INO Rev: 10/19/26.  FINISHED AND TESTED.
+// 10/19/26: A complete image can now be built on the PC (FRAM_Image.py build), from the same populate() data, and loaded with
+//           FRAM_IMAGE_SERIAL, so the populate() runs below are no longer needed to make a FRAM.
+// 10/19/26: Added FRAM_IMAGE_SERIAL: after populating/testing, serve the whole 512KB FRAM image over Serial so FRAM_Image.py on
+//           the PC can save it to a file, or bulk-load a saved image (1KB pages, each CRC checked and acknowledged.)  Also added
+//           validateFRAM(), which cross-checks Sensor_Block, Block Res'n, Route Ref, and Loco Ref against each other.
 // 02/27/23: Define all global pointers to nullptr at top so we can test for null in class begin().
 // 02/09/23: Added and tested Turout Res'n, Sensor Block, Block Res'n, Loco Ref, Route Ref, and Deadlocks.
 
@@ -41,8 +46,18 @@
 //#define ROUTE_REFERENCE_TEST      // Will fail until all GROUPs (i.e. all Routes) have been populated.
 //#define DEADLOCK_TEST
 
+//#define FRAM_VALIDATE             // Cross-check tables against each other; see validateFRAM().
+
+// Rather than running the populate() groups, build the image on the PC and load it into any FRAM in one session:
+//   python FRAM_Image.py build fram.bin   and   python FRAM_Image.py load COM3 fram.bin
+// build reads every table's populate() data (all Route Reference GROUPs at once), cross-checks the tables, and writes FRAMVERSION.
+// save COM3 fram.bin still copies an existing FRAM to a file.
+// Comment out all of the _POPULATE and _TEST #defines above when loading an image, so we don't change FRAM before it's loaded.
+//#define FRAM_IMAGE_SERIAL
+
 #include <Train_Consts_Global.h>
 #include <Train_Functions.h>
+#include <util/crc16.h>  // AVR-libc _crc_ccitt_update(), for FRAM_IMAGE_SERIAL
 const byte THIS_MODULE = ARDUINO_NUL;  // Global just needs to be defined for use by Train_Functions.cpp and Message.cpp.
 char lcdString[LCD_WIDTH + 1] = "POP 03/06/23";  // Global array holds 20-char string + null, sent to Digole 2004 LCD.
 
@@ -89,6 +104,14 @@ Route_Reference* pRoute = nullptr;
 #include <Deadlock.h>
 Deadlock_Reference* pDeadlock = nullptr;
 
+// *** FRAM IMAGE SERIAL TRANSFER ***
+// Every page is sent as: 'P', page num hi, page num lo, FRAM_IMAGE_PAGE_BYTES data bytes, CRC lo, CRC hi.  The receiver replies
+// 'A' (ack) or 'N' (nak: bad CRC or timeout; sender re-sends the page.)  Same format in both directions.
+const unsigned int  FRAM_IMAGE_PAGE_BYTES = 1024;
+const unsigned int  FRAM_IMAGE_PAGES      =  512;   // 512KB MB85RS4MT
+const unsigned long FRAM_IMAGE_TIMEOUT_MS = 2000;   // Give up on a partial page after this long with no data
+const byte          FRAM_IMAGE_RETRIES    =    5;   // Pages we send are re-sent this many times before we give up
+
 
 // *****************************************************************************************
 // **************************************  S E T U P  **************************************
@@ -125,6 +148,7 @@ void setup() {
   //pStorage->testFRAM();         while (true) { }  // Writes then reads random data to entire FRAM.
   //pStorage->testSRAM();         while (true) { }  // Test 4K of SRAM just for comparison.
   //pStorage->testQuadRAM(56647); while (true) { }  // (unsigned long t_numBytesToTest); max about 56,647 testable bytes.
+  //pStorage->testFRAMSpeed(1024); while (true) { }  // Time 8192-byte reads/writes by chunk size and SPI clock.
 
   // *** INITIALIZE TURNOUT RESERVATION CLASS AND OBJECT ***  (Heap uses 9 bytes)
   pTurnoutReservation = new Turnout_Reservation;  // C++ quirk: no parens in ctor call if no parms; else thinks it's fn decl'n.
@@ -144,7 +168,7 @@ void setup() {
 
   // *** INITIALIZE BLOCK RESERVATION CLASS AND OBJECT *** (Heap uses 26 bytes)
   pBlockReservation = new Block_Reservation;  // C++ quirk: no parens in ctor call if no parms; else thinks it's fn decl'n.
-  pBlockReservation->begin(pStorage);
+  pBlockReservation->begin(pStorage, nullptr);  // No Event_Journal
   #ifdef BLOCK_RESERVATION_POPULATE
     sprintf(lcdString, "POP Block Res'n"); pLCD2004->println(lcdString); Serial.println(lcdString);
     pBlockReservation->populate();  // Populate FRAM Block Reservation table.
@@ -179,6 +203,10 @@ void setup() {
   // There is no need to "populate" Train Progress or Delayed Action as those are heap files that contain no static data.
   sprintf(lcdString, "POP Complete!"); pLCD2004->println(lcdString); Serial.println(lcdString);
 
+  #ifdef FRAM_IMAGE_SERIAL
+    framImageServer();  // Never returns
+  #endif
+
 
 }
 
@@ -212,6 +240,10 @@ void loop() {
     unitTestDeadlock();
   #endif
 
+  #ifdef FRAM_VALIDATE
+    validateFRAM();
+  #endif
+
   sprintf(lcdString, "Test(s) complete!"); pLCD2004->println(lcdString); Serial.println(lcdString);
 
   while (true) {}
@@ -561,3 +593,219 @@ void unitTestDeadlock() {
 
   return;
 }
+
+unsigned int validateFRAM() {
+  // Rev: 10/19/26.
+  // Cross-check the populated tables against each other and against FRAMVERSION, and report every problem found (rather than
+  // stopping at the first one.)  Returns the number of problems.
+  Serial.println(F("Validating FRAM..."));
+  unsigned int errors = 0;
+
+  // FRAM rev date must match FRAMVERSION in Train_Consts_Global.h.
+  byte revDate[3];
+  pStorage->read(FRAM_ADDR_REV_DATE, sizeof(revDate), revDate);
+  if ((revDate[0] != FRAMVERSION[0]) || (revDate[1] != FRAMVERSION[1]) || (revDate[2] != FRAMVERSION[2])) {
+    Serial.println(F("FRAM rev date does not match FRAMVERSION."));
+    errors++;
+  }
+
+  // Every sensor must belong to a real block, and that block must list this sensor at the same end.
+  for (byte sensorNum = 1; sensorNum <= TOTAL_SENSORS; sensorNum++) {
+    byte blockNum = pSensorBlock->whichBlock(sensorNum);
+    char whichEnd = pSensorBlock->whichEnd(sensorNum);
+    if (pSensorBlock->getSensorNumber(sensorNum) != sensorNum) {
+      Serial.print(F("Sensor_Block rec ")); Serial.print(sensorNum); Serial.println(F(" has wrong sensor number."));
+      errors++;
+    }
+    if ((blockNum < 1) || (blockNum > TOTAL_BLOCKS)) {
+      Serial.print(F("Sensor ")); Serial.print(sensorNum); Serial.print(F(" bad block ")); Serial.println(blockNum);
+      errors++;
+    } else if (((whichEnd == SENSOR_END_WEST) && (pBlockReservation->westSensor(blockNum) != sensorNum)) ||
+               ((whichEnd == SENSOR_END_EAST) && (pBlockReservation->eastSensor(blockNum) != sensorNum)) ||
+               ((whichEnd != SENSOR_END_WEST) && (whichEnd != SENSOR_END_EAST))) {
+      Serial.print(F("Sensor ")); Serial.print(sensorNum); Serial.print(F(" end ")); Serial.print(whichEnd);
+      Serial.print(F(" doesn't match Block Res'n block ")); Serial.println(blockNum);
+      errors++;
+    }
+  }
+
+  // Every block's sensors must be real sensors that Sensor_Block says belong to this block.
+  for (byte blockNum = 1; blockNum <= TOTAL_BLOCKS; blockNum++) {
+    byte westSensor = pBlockReservation->westSensor(blockNum);
+    byte eastSensor = pBlockReservation->eastSensor(blockNum);
+    if ((westSensor < 1) || (westSensor > TOTAL_SENSORS) || (pSensorBlock->whichBlock(westSensor) != blockNum) ||
+        (eastSensor < 1) || (eastSensor > TOTAL_SENSORS) || (pSensorBlock->whichBlock(eastSensor) != blockNum)) {
+      Serial.print(F("Block ")); Serial.print(blockNum); Serial.print(F(" sensors ")); Serial.print(westSensor);
+      Serial.print(F("/")); Serial.print(eastSensor); Serial.println(F(" don't match Sensor_Block."));
+      errors++;
+    }
+  }
+
+  // Every Route element must refer to a real block, sensor, or turnout, and every route must end with ER.
+  for (unsigned int routeRecNum = 0; routeRecNum < FRAM_RECS_ROUTE_TOTAL; routeRecNum++) {
+    bool foundER = false;
+    for (byte elementNum = 0; elementNum < FRAM_SEGMENTS_ROUTE_REF; elementNum++) {
+      routeElement element = pRoute->getElement(routeRecNum, elementNum);
+      bool elementOkay = true;
+      switch (element.routeRecType) {
+        case ER: foundER = true; break;
+        case SN: elementOkay = ((element.routeRecVal >= 1) && (element.routeRecVal <= TOTAL_SENSORS)); break;
+        case BE:
+        case BW: elementOkay = ((element.routeRecVal >= 1) && (element.routeRecVal <= TOTAL_BLOCKS)); break;
+        case TN:
+        case TR: elementOkay = ((element.routeRecVal >= 1) && (element.routeRecVal <= TOTAL_TURNOUTS)); break;
+        case VL: elementOkay = (element.routeRecVal <= LOCO_SPEED_HIGH); break;
+        case FD:
+        case RD:
+        case TD: break;
+        default: elementOkay = false; break;
+      }
+      if (!elementOkay) {
+        Serial.print(F("Route rec ")); Serial.print(routeRecNum); Serial.print(F(" element ")); Serial.print(elementNum);
+        Serial.print(F(" bad: ")); Serial.print(element.routeRecType); Serial.print(F(",")); Serial.println(element.routeRecVal);
+        errors++;
+      }
+      if (foundER) {
+        break;
+      }
+    }
+    if (!foundER) {
+      Serial.print(F("Route rec ")); Serial.print(routeRecNum); Serial.println(F(" has no ER."));
+      errors++;
+    }
+  }
+
+  // Any op car (i.e. StationSounds diner) a loco points to must itself be an active Loco Ref record.
+  for (byte locoNum = 1; locoNum <= TOTAL_TRAINS; locoNum++) {
+    if (pLoco->active(locoNum)) {
+      byte opCarLocoNum = pLoco->opCarLocoNum(locoNum);
+      if ((opCarLocoNum != LOCO_ID_NULL) &&
+          ((opCarLocoNum > TOTAL_TRAINS) || !pLoco->active(opCarLocoNum))) {
+        Serial.print(F("Loco ")); Serial.print(locoNum); Serial.print(F(" op car ")); Serial.print(opCarLocoNum);
+        Serial.println(F(" not active."));
+        errors++;
+      }
+    }
+  }
+
+  sprintf(lcdString, "VALIDATE: %u ERRORS", errors); pLCD2004->println(lcdString); Serial.println(lcdString);
+  return errors;
+}
+
+void framImageServer() {
+  // Rev: 10/19/26.
+  // Wait for single-character commands from FRAM_Image.py on the PC:
+  //   'S' = Send (save) the whole FRAM image to the PC.
+  //   'L' = Load a whole FRAM image from the PC.
+  //   'V' = Validate tables (text report.)
+  // Nothing else may be sent to Serial during a transfer, so progress goes to the LCD only.
+  Serial.setTimeout(FRAM_IMAGE_TIMEOUT_MS);  // For Serial.readBytes() in framImageReceive()
+  sprintf(lcdString, "FRAM IMAGE READY"); pLCD2004->println(lcdString); Serial.println(lcdString);
+  while (true) {
+    if (Serial.available()) {
+      char command = Serial.read();
+      if (command == 'S') {
+        framImageSend();
+      } else if (command == 'L') {
+        framImageReceive();
+      } else if (command == 'V') {
+        validateFRAM();
+      }
+    }
+  }
+}
+
+void framImageSend() {
+  // Rev: 10/19/26.
+  byte pageBuffer[FRAM_IMAGE_PAGE_BYTES];
+  sprintf(lcdString, "Sending image..."); pLCD2004->println(lcdString);
+  unsigned long startTime = millis();
+  for (unsigned int pageNum = 0; pageNum < FRAM_IMAGE_PAGES; pageNum++) {
+    pStorage->readStream((unsigned long)pageNum * FRAM_IMAGE_PAGE_BYTES, FRAM_IMAGE_PAGE_BYTES, pageBuffer);
+    unsigned int crc = framImageCRC(pageBuffer);
+    byte tries = 0;
+    int reply = 0;
+    do {
+      Serial.write('P');
+      Serial.write(highByte(pageNum));
+      Serial.write(lowByte(pageNum));
+      Serial.write(pageBuffer, FRAM_IMAGE_PAGE_BYTES);
+      Serial.write(lowByte(crc));
+      Serial.write(highByte(crc));
+      reply = framImageReadByte();
+      tries++;
+    } while ((reply != 'A') && (tries < FRAM_IMAGE_RETRIES));
+    if (reply != 'A') {
+      sprintf(lcdString, "SEND FAIL PAGE %u", pageNum); pLCD2004->println(lcdString);
+      return;
+    }
+  }
+  Serial.write('E');
+  sprintf(lcdString, "SENT %lu sec", (millis() - startTime) / 1000); pLCD2004->println(lcdString);
+  return;
+}
+
+void framImageReceive() {
+  // Rev: 10/19/26.
+  // The PC sends pages in order; we write each one as soon as its CRC checks out, then ack so the PC sends the next.  We don't
+  // write anything for a page until its CRC is good, so an aborted load leaves whole pages, old or new, never partial ones.
+  byte pageBuffer[FRAM_IMAGE_PAGE_BYTES];
+  sprintf(lcdString, "Loading image..."); pLCD2004->println(lcdString);
+  unsigned long startTime = millis();
+  unsigned int pagesLoaded = 0;
+  while (true) {
+    int header = framImageReadByte();
+    if (header == 'E') {  // End of image
+      break;
+    }
+    if (header != 'P') {
+      if (header < 0) {  // PC has gone away
+        sprintf(lcdString, "LOAD TIMEOUT"); pLCD2004->println(lcdString);
+        return;
+      }
+      continue;  // Skip noise until the next page header
+    }
+    int pageHi = framImageReadByte();
+    int pageLo = framImageReadByte();
+    unsigned int bytesRead = Serial.readBytes(pageBuffer, FRAM_IMAGE_PAGE_BYTES);  // Honors Serial.setTimeout()
+    int crcLo = framImageReadByte();
+    int crcHi = framImageReadByte();
+    unsigned int pageNum = word((byte)pageHi, (byte)pageLo);
+    if ((pageHi < 0) || (pageLo < 0) || (crcLo < 0) || (crcHi < 0) || (bytesRead != FRAM_IMAGE_PAGE_BYTES) ||
+        (pageNum >= FRAM_IMAGE_PAGES) || (framImageCRC(pageBuffer) != word((byte)crcHi, (byte)crcLo))) {
+      while (Serial.available()) {
+        Serial.read();  // Flush whatever is left of the bad page
+      }
+      Serial.write('N');
+      continue;
+    }
+    pStorage->writeStream((unsigned long)pageNum * FRAM_IMAGE_PAGE_BYTES, FRAM_IMAGE_PAGE_BYTES, pageBuffer);
+    Serial.write('A');
+    pagesLoaded++;
+  }
+  sprintf(lcdString, "LOADED %u PAGES", pagesLoaded); pLCD2004->println(lcdString);
+  sprintf(lcdString, "in %lu sec", (millis() - startTime) / 1000); pLCD2004->println(lcdString);
+  return;
+}
+
+int framImageReadByte() {
+  // Rev: 10/19/26.
+  // Returns the next byte from the PC, or -1 if nothing arrives within FRAM_IMAGE_TIMEOUT_MS.
+  unsigned long startTime = millis();
+  while (!Serial.available()) {
+    if ((millis() - startTime) > FRAM_IMAGE_TIMEOUT_MS) {
+      return -1;
+    }
+  }
+  return Serial.read();
+}
+
+unsigned int framImageCRC(const byte t_page[]) {
+  // Rev: 10/19/26.
+  // CRC-CCITT (AVR-libc flavor, initial value 0xFFFF) of one FRAM_IMAGE_PAGE_BYTES page.  FRAM_Image.py computes the same thing.
+  unsigned int crc = 0xFFFF;
+  for (unsigned int i = 0; i < FRAM_IMAGE_PAGE_BYTES; i++) {
+    crc = _crc_ccitt_update(crc, t_page[i]);
+  }
+  return crc;
+}
@@ -1,4 +1,13 @@
-// O_LED.INO Rev: 06/22/24.  Finished but not tested.
+// O_LED.INO Rev: 10/19/26.  Finished but not tested.
+// 10/19/26: paintControlPanel() keeps a shadow image of the four 16-bit Centipede ports and only calls portWrite() for ports
+//   that have changed, rather than rewriting all 64 LEDs every time.  Solid/blinking LED masks are only rebuilt when a turnout or
+//   mode/state changes, and blinking is a single XOR per port.  Painting is now cheap enough to do every time through loop().
+// 10/19/26: Every TURNOUT_ACTIVATION_MS we now take up to TURNOUTS_TO_FIRE_AT_ONCE turnout commands, so the green LEDs keep up
+//   with SWT firing that many solenoids at once.  LEDPortWritesSkipped only counts ports that didn't need writing when the panel
+//   image actually changed (masks rebuilt or blink toggled), rather than all four ports on every pass through loop().
+// 10/19/26: turnoutDirStatus[] and turnoutLEDStatus[] are cleared in setup() rather than by a 32/64-value initializer, so every
+//   element starts blank/dark whatever TOTAL_TURNOUTS is.
+// 10/19/26: Turnout command buffer moved to the Turnout_Cmd_Buf class (shared with SWT), which coalesces superseded commands.
 // LED paints the GREEN LEDs on the control panel, which indicate turnout orientation.
 // LED listens for RS485 incoming commands (addressed to SWT) to know how turnouts are set, and illuminates turnout LEDs
 // accordingly (mode/state permitting.)
@@ -18,7 +27,7 @@
 #include <Train_Consts_Global.h>
 #include <Train_Functions.h>
 const byte THIS_MODULE = ARDUINO_LED;  // Global needed by Train_Functions.cpp and Message.cpp functions.
-char lcdString[LCD_WIDTH + 1] = "LED 06/22/24";  // Global array holds 20-char string + null, sent to Digole 2004 LCD.
+char lcdString[LCD_WIDTH + 1] = "LED 10/19/26";  // Global array holds 20-char string + null, sent to Digole 2004 LCD.
 
 // *** SERIAL LCD DISPLAY CLASS ***
 // #include <Display_2004.h> is already in <Train_Functions.h> so not needed here.
@@ -42,13 +51,6 @@ byte stateCurrent   = STATE_UNDEFINED;
 byte turnoutNum = 0;    // 1..30
 char turnoutDir = ' ';  // 'N'ormal or 'R'everse.
 
-// Set MAX_TURNOUTS_TO_BUF to be the maximum number of turnout commands that will potentially pile up coming from MAS RS485
-// i.e. could be several routes being assigned in rapid succession when Auto mode is started.  Longest "regular" route has 8
-// turnouts, so conceivable we could get routes for maybe 10 trains = 80 records to buffer, maximum ever conceivable.
-// If we overflow the buffer, we can easily increase the size by increasing this variable.
-// The reason we need to buffer is because we take a (relatively) long time to throw each turnout, whereas the RS485 messages
-// can flood in very quickly.
-const byte MAX_TURNOUTS_TO_BUF            =  80;  // How many turnout commands might pile up before they can be executed?
 const unsigned long TURNOUT_ACTIVATION_MS = 110;  // We'll check for LED changes exactly as often as turnouts are thrown in SWT.
 unsigned long turnoutUpdateTime = millis();       // Keeps track of *when* a turnout coil was energized
 
@@ -58,24 +60,17 @@ const byte LED_GREEN_SOLID                =   1;  // Green turnout indicator LED
 const byte LED_GREEN_BLINKING             =   2;  // Green turnout indicator LED lit blinking
 const unsigned long LED_FLASH_MS          = 500;  // Toggle "conflicted" LEDs every 1/2 second
 
-// IMPORTANT: LARGE AMOUNTS OF THIS CODE ARE IDENTIAL IN SWT/LED, SO ALWAYS UPDATE ONE WHEN WE MAKE CHANGES TO THE OTHER, IF NEEDED.
-
 // *** TURNOUT COMMAND BUFFER...
-// Create a circular buffer to store incoming RS485 "set turnout" commands from A-MAS.
-byte turnoutCmdBufHead = 0;    // Next array element to be written.
-byte turnoutCmdBufTail = 0;    // Next array element to be removed.
-byte turnoutCmdBufCount = 0;   // Num active elements in buffer.  Max is MAX_TURNOUTS_TO_BUF.
-struct turnoutCmdBufStruct {
-  byte turnoutNum;             // 1..TOTAL_TURNOUTS
-  char turnoutDir;             // 'N' for Normal, 'R' for Reverse
-};
-turnoutCmdBufStruct turnoutCmdBuf[MAX_TURNOUTS_TO_BUF];
+// Circular buffer to store incoming RS485 "set turnout" commands from A-MAS, shared with SWT.  Coalesces superseded commands.
+#include <Turnout_Cmd_Buf.h>
+Turnout_Cmd_Buf* pTurnoutCmdBuf = nullptr;
 
 // *** TURNOUT DIRECTION CURRENT STATUS...
 // 10/25/16: LED only.  Populated with current turnout positions/orientations.
 // Record corresponds to [turnout number - 1] = (0..31).  I.e. turnout #1 at array position zero.
 // turnoutDirStatus[[0..29] = 'N', 'R', or blank if unknown (at init).  We will give it 32 elements for future expansion.
-char turnoutDirStatus[TOTAL_TURNOUTS] = {' ',' ',' ',' ',' ',' ',' ',' ',' ',' ',' ',' ',' ',' ',' ',' ',' ',' ',' ',' ',' ',' ',' ',' ',' ',' ',' ',' ',' ',' ',' ',' '};
+// Set to all blanks in setup().
+char turnoutDirStatus[TOTAL_TURNOUTS];
 
 // *** TURNOUT LED DESIRED STATUS...
 // 10/25/16: LED only.  Populated with what the status of each green LED *should* be, based on above turnout positions.
@@ -88,8 +83,21 @@ char turnoutDirStatus[TOTAL_TURNOUTS] = {' ',' ',' ',' ',' ',' ',' ',' ',' ',' '
 // const byte LED_DARK = 0;                  // LED off
 // const byte LED_GREEN_SOLID = 1;           // Green turnout indicator LED lit solid
 // const byte LED_GREEN_BLINKING = 2;        // Green turnout indicator LED lit blinking
-// The following zeroes should really be {LED_DARK, LED_DARK, LED_DARK, ... } but just use zeroes here for convenience
-byte turnoutLEDStatus[TOTAL_TURNOUTS * 2] = {0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0};
+// Set to all LED_DARK in setup().
+byte turnoutLEDStatus[TOTAL_TURNOUTS * 2];
+
+// *** CONTROL PANEL SHADOW IMAGE...
+// 10/19/26: Rather than figure out and write every LED every time we paint, we keep two masks for each of the four 16-bit
+// Centipede ports (chips): which LEDs should be lit solid, and which should be blinking.  These are only rebuilt (from
+// turnoutLEDStatus[], modeCurrent, and stateCurrent) when LEDPortMasksStale is set.  We also remember what we last wrote to each
+// port, and only write a port that has changed.  initializePinsForOutput() in setup() sets all outputs HIGH (all LEDs off.)
+const byte LED_PORTS = 4;                 // Four 16-bit chips = 64 outputs, enough for TOTAL_TURNOUTS * 2 LEDs.
+unsigned LEDPortSolidMask[LED_PORTS];     // Bit set = LED should be lit solid
+unsigned LEDPortBlinkMask[LED_PORTS];     // Bit set = LED should be blinking
+unsigned LEDPortWritten[LED_PORTS] = {65535, 65535, 65535, 65535};  // What's currently on each port; bit LOW = LED lit.
+bool LEDPortMasksStale = true;            // Set whenever turnoutLEDStatus[], modeCurrent, or stateCurrent changes.
+unsigned long LEDPortWrites = 0;          // How many times we actually called portWrite()
+unsigned long LEDPortWritesSkipped = 0;   // When the panel image changed, how many ports didn't need writing anyway
 
 // *** TURNOUT LED SHIFT REGISTER PIN NUMBERS...
 // 10/25/16: LED only.  Cross-reference array that gives us a Centipede shift register bit number 0..63 for a corresponding
@@ -147,6 +155,10 @@ void setup() {
   pMessage = new Message;  // C++ quirk: no parens in ctor call if no parms; else thinks it's fn decl'n.
   pMessage->begin(&Serial2, SERIAL2_SPEED);
 
+  // *** INITIALIZE TURNOUT COMMAND BUFFER CLASS AND OBJECT ***
+  pTurnoutCmdBuf = new Turnout_Cmd_Buf;  // C++ quirk: no parens in ctor call if no parms; else thinks it's fn decl'n.
+  pTurnoutCmdBuf->begin();
+
   // *** INITIALIZE CENTIPEDE SHIFT REGISTER ***
   // WARNING: Instantiating Centipede class hangs the system if hardware is not connected.
   Wire.begin();                               // Join the I2C bus as a master for Centipede shift register.
@@ -154,6 +166,10 @@ void setup() {
   pShiftRegister->begin();                    // Set all registers to default.
   pShiftRegister->initializePinsForOutput();  // Set all Centipede shift register pins to OUTPUT for Turnout LEDs
 
+  // *** ALL TURNOUTS UNKNOWN, ALL GREEN LEDS DARK ***
+  memset(turnoutDirStatus, ' ', sizeof(turnoutDirStatus));
+  memset(turnoutLEDStatus, LED_DARK, sizeof(turnoutLEDStatus));
+
 }  // End of setup()
 
 // *****************************************************************************************
@@ -199,12 +215,18 @@ void loop() {
         pMessage->getMAStoALLModeState(&modeCurrent, &stateCurrent);
         // Just calling the function updates modeCurrent and modeState ;-)
         sprintf(lcdString, "M %i S %i", modeCurrent, stateCurrent); Serial.println(lcdString);
+        LEDPortMasksStale = true;  // Mode/state determines whether LEDs may be lit at all
+        if (stateCurrent == STATE_STOPPED) {
+          pTurnoutCmdBuf->displayStats();
+          Serial.print(F("LED port writes: ")); Serial.print(LEDPortWrites);
+          Serial.print(F(", skipped: ")); Serial.println(LEDPortWritesSkipped);
+        }
         break;
       case 'T' :  // New Turnout message in incoming RS485 buffer.
         pMessage->getMAStoALLTurnout(&turnoutNum, &turnoutDir);
         sprintf(lcdString, "Rec'd: %i %c", turnoutNum, turnoutDir); pLCD2004->println(lcdString); Serial.println(lcdString);
         // Add the turnout command to the circular buffer for later processing...
-        turnoutCmdBufEnqueue(turnoutNum, turnoutDir);
+        pTurnoutCmdBuf->enqueue(turnoutNum, turnoutDir);
         break;
       default:
         sprintf(lcdString, "MSG TYPE ERROR!");
@@ -219,66 +241,29 @@ void loop() {
 
   if ((millis() - turnoutUpdateTime) > TURNOUT_ACTIVATION_MS) {   // Don't retrieve turnout buffers too quickly, for effect only.
     // About every 110ms.
-    // turnoutCmdBufProcess() only takes about 2ms!  It updates "desired LED state" array for MAXIMUM ONE LED ONLY.
-    // Pull a turnout command from the buffer, if any, and update the turnoutDirStatus[] and turnoutLEDStatus[] arrays.
-    turnoutCmdBufProcess();
-    // paintControlPanel() takes about 50ms, so we don't want to call it continuously.  It blinks LEDs at 500ms intervals.
-    // Since this loop is begin called every TURNOUT_ACTIVATION_MS (110ms), that's plenty to blink the lights every 1/2 second,
-    // and also ensure that the control panel LEDs are "painted" at least every time a turnout is thrown (turnoutCmdBufProcess(), above.)
-    paintControlPanel();  // Refresh the green LEDs on the control panel
-
+    // turnoutCmdBufProcess() only takes about 2ms!  It updates "desired LED state" array for MAXIMUM ONE TURNOUT ONLY.
+    // Pull up to TURNOUTS_TO_FIRE_AT_ONCE turnout commands from the buffer, the same number SWT fires together, and update the
+    // turnoutDirStatus[] and turnoutLEDStatus[] arrays.
+    for (byte i = 0; i < TURNOUTS_TO_FIRE_AT_ONCE; i++) {
+      if (!turnoutCmdBufProcess()) {
+        break;  // Buffer is empty
+      }
+    }
     turnoutUpdateTime = millis();  // refresh timer for delay between checking for "throws"
   }
 
+  // paintControlPanel() used to take about 50ms, so we only called it every 110ms.  Now it only talks to the Centipede when a
+  // port has actually changed (a turnout was thrown, mode/state changed, or blinking LEDs toggled), so call it every time.
+  paintControlPanel();  // Refresh the green LEDs on the control panel
+
 }  // End of loop()
 
 // *****************************************************************************************
 // ************************ F U N C T I O N   D E F I N I T I O N S ************************
 // *****************************************************************************************
 
-bool turnoutCmdBufIsEmpty() {
-  return (turnoutCmdBufCount == 0);
-}
-
-bool turnoutCmdBufIsFull() {
-  return (turnoutCmdBufCount == MAX_TURNOUTS_TO_BUF);
-}
-
-void turnoutCmdBufEnqueue(const byte t_turnoutNum, const char t_turnoutDir) {
-  // Insert a record at the head of the turnout command buffer, then increment head and count.
-  // If the buffer is already full, trigger a fatal error and terminate.
-  if (!turnoutCmdBufIsFull()) {
-    turnoutCmdBuf[turnoutCmdBufHead].turnoutNum = t_turnoutNum;  // Store the turnout number 1..TOTAL_TURNOUTS
-    turnoutCmdBuf[turnoutCmdBufHead].turnoutDir = t_turnoutDir;  // Store the orientation Normal or Reverse
-    turnoutCmdBufHead = (turnoutCmdBufHead + 1) % MAX_TURNOUTS_TO_BUF;
-    turnoutCmdBufCount++;
-  } else {
-    sprintf(lcdString, "Turnout buf ovflow!");
-    pLCD2004->println(lcdString);
-    Serial.println(lcdString);
-    endWithFlashingLED(3);
-  }
-  return;
-}
-
-bool turnoutCmdBufDequeue(byte * t_turnoutNum, char * t_turnoutDir) {
-  // Retrieve a record, if any, from the turnout command buffer.
-  // If the turnout command buffer is not empty, retrieves a record from the buffer, clears it, and puts the
-  // retrieved data into the called parameters.
-  // Returns 'false' if buffer is empty, and the passed parameters remain undefined.  Not fatal.
-  // Data will be at tail, then tail will be incremented (modulo size), and count will be decremented.
-  if (!turnoutCmdBufIsEmpty()) {
-    * t_turnoutNum = turnoutCmdBuf[turnoutCmdBufTail].turnoutNum;
-    * t_turnoutDir = turnoutCmdBuf[turnoutCmdBufTail].turnoutDir;
-    turnoutCmdBufTail = (turnoutCmdBufTail + 1) % MAX_TURNOUTS_TO_BUF;
-    turnoutCmdBufCount--;
-    return true;
-  } else {
-    return false;  // Turnout command buffer is empty
-  }
-}
-
-void turnoutCmdBufProcess() {   // Special version for LED, not the same as used by SWT
+bool turnoutCmdBufProcess() {   // Special version for LED, not the same as used by SWT
+  // Rev: 10/19/26.  Returns true if there was a turnout command in the buffer, so loop() can take several per pass.
   // Rev: 10/26/16.  If a turnout has been thrown, update the turnoutDirStatus[[0..31] array with 'R' or 'N'.
   // AND IF turnoutDirStatus[[] IS UPDATED HERE, then we must also update the turnoutLEDStatus[0..63] array with 0, 1, or 2,
   // which indicates if each LED should be off, on, or blinking.
@@ -290,7 +275,7 @@ void turnoutCmdBufProcess() {   // Special version for LED, not the same as used
   byte t_turnoutNum = 0;
   char t_turnoutDir = ' ';
 
-  if  (turnoutCmdBufDequeue(&t_turnoutNum, &t_turnoutDir)) {
+  if  (pTurnoutCmdBuf->dequeue(&t_turnoutNum, &t_turnoutDir)) {
     // If we get here, we have a new turnout to "throw".
     // Each time we have a new turnout to throw, we need to update TWO arrays:
     // 1: Update turnoutDirStatus[[0..31] (N|R|' ') for the turnout that was just "thrown."  So we have a list of all current positions.
@@ -444,67 +429,80 @@ void turnoutCmdBufProcess() {   // Special version for LED, not the same as used
       turnoutLEDStatus[42] = LED_GREEN_BLINKING;
       turnoutLEDStatus[59] = LED_GREEN_BLINKING;
     }
+    LEDPortMasksStale = true;  // So paintControlPanel() will pick up the new turnoutLEDStatus[]
+    return true;
   }
-  return;
+  return false;
 }
 
 void paintControlPanel() {
+  // Rev 10/19/26: Only write Centipede ports that have changed since we last wrote them; see "CONTROL PANEL SHADOW IMAGE" above.
   // Rev 10/19/20: Based on the array of current turnout status, update every green turnout-indicator LED on the control panel.
   // Note that although there are not actually two LEDs for every turnout - since facing turnouts share an LED - we have 60
   // outputs wired, so we can code as if there are 60 LEDs (for 30 turnouts, as of Oct 2020.)
   // Any facing turnouts THAT ARE NOT IN SYNC will have their shared LED blinking.  Otherwise, just turn each green LED on or
   // off, as appropriate.
   // This routine should be called at least every 1/2 second to keep up with LEDs blinking, but also any time a turnout is thrown.
-  // So we call it about every 110ms, each time we call the above turnoutCmdBufProcess() function, although the two functions are
-  // not co-dependent.
+  // Since it only does I2C writes when something has changed, we can simply call it every time through loop().
 
   // At this point, we should already have: turnoutLEDStatus[0..63] = 0 (off), 1 (on), or 2 (blinking)
   // So now just update the physical LEDs on the control panel.
-  
+
   // We have a timer to track the flashing LEDs to toggle on/off only every 1/2 second or so.
   // From above: LED_FLASH_MS = 500ms: Toggle "conflicted" LEDs every 1/2 second
   static unsigned long LEDFlashProcessed = millis();   // Delay between toggling flashing LEDs on control panel i.e. 1/2 second.
   static bool LEDsOn = false;    // Toggle this variable to know when conflict LEDs should be on versus off.
 
   // Each time through this function, decide if flashing LEDs will be on or off at this time...
+  bool frameChanged = LEDPortMasksStale;  // Nothing to do unless the masks or the blink phase changed
   if ((millis() - LEDFlashProcessed) > LED_FLASH_MS) {
     LEDFlashProcessed = millis();   // Reset flash timer (about every 1/2 second)
     LEDsOn = !LEDsOn;    // Invert flash toggle
+    frameChanged = true;
+  }
+  if (!frameChanged) {
+    return;
   }
 
-  // Write a ZERO (LOW) to a bit to turn ON the LED, write a ONE (HIGH) to a bit to turn OFF the LED.
-  // THIS IS OPPOSITE of our turnoutLEDStatus[] array.
-  // Create a 16-bit integer for each of the four 16-bit "chips" on each Centipede.  We'll use these for portWrite().
-  // Initialize to 0b1111111111111111, which means "all LEDs off", although they should all get set in this loop.
-  unsigned centipedeChip[4] = {65535, 65535, 65535, 65535};
-  for (int chipNum = 0; chipNum <= 3; chipNum++) {  // For each chip on the Arduino, right to left: 0..3
-    for (int bitNum = 0; bitNum <= 15; bitNum++) {  // For each bit on this chip, right to left: 0..15
-      int arrayBit = (chipNum * 16) + bitNum;  // arrayBit will be 0 through 63
-      if (arrayBit < (TOTAL_TURNOUTS * 2)) {  // Don't overrun the array bounds; only 60 elements, not 64.
-        // If we are *either* in REGISTER Mode in any State, or at STOPPED State in any Mode: Darken all green LEDs.
-        if ((modeCurrent == MODE_REGISTER) || (stateCurrent == STATE_STOPPED)) {
-          centipedeChip[chipNum] = setBit(centipedeChip[chipNum], bitNum);  // Set bit HIGH, which turns OFF the LED
-        } else {   // Mode is not REGISTER, and State is either RUNNING or STOPPING: OK to illuminate LEDs.
-          if (turnoutLEDStatus[arrayBit] == LED_DARK) {   // LED should be off
-            centipedeChip[chipNum] = setBit(centipedeChip[chipNum], bitNum);  // Set bit HIGH, which turns OFF the LED
-          } else if (turnoutLEDStatus[arrayBit] == LED_GREEN_SOLID) {   // LED should be on
-            centipedeChip[chipNum] = clearBit(centipedeChip[chipNum], bitNum);  // Set bit LOW, which turns ON the LED
-          } else {                          // Must be 2 = LED_GREEN_BLINKING
-            if (LEDsOn) {
-              centipedeChip[chipNum] = clearBit(centipedeChip[chipNum], bitNum);  // Set bit LOW, which turns ON the LED
-            } else {
-              centipedeChip[chipNum] = setBit(centipedeChip[chipNum], bitNum);  // Set bit HIGH, which turns OFF the LED
-            }
+  // If turnoutLEDStatus[] (or mode/state) has changed, rebuild the solid and blink masks for each port.
+  if (LEDPortMasksStale) {
+    for (byte chipNum = 0; chipNum < LED_PORTS; chipNum++) {  // For each chip on the Arduino, right to left: 0..3
+      LEDPortSolidMask[chipNum] = 0;
+      LEDPortBlinkMask[chipNum] = 0;
+      // If we are *either* in REGISTER Mode in any State, or at STOPPED State in any Mode: Darken all green LEDs.
+      if ((modeCurrent == MODE_REGISTER) || (stateCurrent == STATE_STOPPED)) {
+        continue;
+      }
+      // Mode is not REGISTER, and State is either RUNNING or STOPPING: OK to illuminate LEDs.
+      for (byte bitNum = 0; bitNum <= 15; bitNum++) {  // For each bit on this chip, right to left: 0..15
+        byte arrayBit = (chipNum * 16) + bitNum;  // arrayBit will be 0 through 63
+        if (arrayBit < (TOTAL_TURNOUTS * 2)) {  // Don't overrun the array bounds
+          if (turnoutLEDStatus[arrayBit] == LED_GREEN_SOLID) {   // LED should be on
+            LEDPortSolidMask[chipNum] = setBit(LEDPortSolidMask[chipNum], bitNum);
+          } else if (turnoutLEDStatus[arrayBit] == LED_GREEN_BLINKING) {
+            LEDPortBlinkMask[chipNum] = setBit(LEDPortBlinkMask[chipNum], bitNum);
           }
         }
       }
     }
+    LEDPortMasksStale = false;
   }
 
-  // Okay, now we have populated the centipedeChip[] array with bits set appropriately for all four 16-bit chips/elements.
-  // All we have to do now is write those 16-bit ints to each Centipede using portWrite.
-  for (int chipNum = 0; chipNum <= 3; chipNum++) {  // For each chip on the Arduino, right to left: 0..3
-    pShiftRegister->portWrite(chipNum, centipedeChip[chipNum]);
+  // Write a ZERO (LOW) to a bit to turn ON the LED, write a ONE (HIGH) to a bit to turn OFF the LED.
+  // THIS IS OPPOSITE of our masks.  With blinking LEDs off, a port is just the inverse of its solid mask (and blinking bits are
+  // HIGH = off), and when blinking LEDs are on we XOR the blink mask to bring those bits LOW.
+  for (byte chipNum = 0; chipNum < LED_PORTS; chipNum++) {  // For each chip on the Arduino, right to left: 0..3
+    unsigned portValue = ~LEDPortSolidMask[chipNum];
+    if (LEDsOn) {
+      portValue = portValue ^ LEDPortBlinkMask[chipNum];
+    }
+    if (portValue != LEDPortWritten[chipNum]) {  // Only talk to the Centipede if this port has changed
+      pShiftRegister->portWrite(chipNum, portValue);
+      LEDPortWritten[chipNum] = portValue;
+      LEDPortWrites++;
+    } else {
+      LEDPortWritesSkipped++;
+    }
   }
   return;
 }
@@ -1,4 +1,16 @@
-// O_LEG.INO Rev: 09/16/24.
+// O_LEG.INO Rev: 10/19/26.
+// 10/19/26: LCD output is queued during Auto/Park (see Display_2004::setQueued()) and sent a few chars per pass by service(), so
+//           status messages no longer stall the loop for several milliseconds of delay().
+// 10/19/26: Train Progress, Delayed Action, Engineer and Loop_Profiler tables come from the QuadRAM arena (see arenaAllocate()); the memory map is sent to Serial at
+//           the end of setup().
+// 10/19/26: Auto/Park loop stages are timed by a Loop_Profiler; the timings are displayed when Auto/Park mode stops, or type 'P'
+//           in the Serial monitor while STOPPED to see the last session's again.
+// 10/19/26: Type 'M' in the Serial monitor while STOPPED for a memory report: stack and heap high-water marks, heap by object.
+// 10/19/26: Keep an Event_Journal in FRAM (mode changes, routes received, sensor trips, block res'ns, Legacy commands.)  Type 'J'
+//           in the Serial monitor while STOPPED to dump it as a timeline, or 'X' to clear it.
+// 10/19/26: Auto/Park no longer scans all 50 locos every pass to see if a stopped loco should start; Conductor is told when a
+//           Route is added or a sensor is tripped and hands back only locos that are ready to start.
+// 10/19/26: Display Engineer Legacy Command Buffer stats when Auto/Park mode stops.
 // LEG controls physical trains via the Train Progress and Delayed Action tables, and also controls accessories.
 // LEG also monitors the control panel track-power toggle switches, to turn the four PowerMasters on and off at any time.
 // 04/02/24: LEG Conductor/Engineer and Train Progress will always assume that Turnouts are being thrown elsewhere and won't worry
@@ -56,7 +68,7 @@
 #include <Train_Consts_Global.h>
 #include <Train_Functions.h>
 const byte THIS_MODULE = ARDUINO_LEG;  // Global needed by Train_Functions.cpp and Message.cpp functions.
-char lcdString[LCD_WIDTH + 1] = "LEG 09/16/24";  // Global array holds 20-char string + null, sent to Digole 2004 LCD.
+char lcdString[LCD_WIDTH + 1] = "LEG 10/19/26";  // Global array holds 20-char string + null, sent to Digole 2004 LCD.
 
 // *** SERIAL LCD DISPLAY CLASS ***
 // #include <Display_2004.h> is already in <Train_Functions.h> so not needed here.
@@ -66,6 +78,10 @@ Display_2004* pLCD2004 = nullptr;  // pLCD2004 is #included in Train_Functions.h
 #include <FRAM.h>
 FRAM* pStorage = nullptr;
 
+// *** EVENT JOURNAL IN FRAM ***
+#include <Event_Journal.h>
+Event_Journal* pJournal = nullptr;
+
 // *** RS485/DIGITAL MESSAGE CLASS ***
 #include <Message.h>
 Message* pMessage = nullptr;
@@ -114,6 +130,10 @@ Engineer* pEngineer = nullptr;
 #include <Conductor.h>
 Conductor* pConductor = nullptr;
 
+// *** MAIN LOOP TIMING ***
+#include <Loop_Profiler.h>
+Loop_Profiler* pProfiler = nullptr;
+
 // *** MISC CONSTANTS AND GLOBALS NEEDED BY LEG ***
 
 // Variables that come with new Route messages
@@ -145,6 +165,7 @@ void setup() {
 
   // *** QUADRAM HEAP MEMORY MODULE ***
   initializeQuadRAM();  // Add-on memory board provides 56,832 bytes for heap
+  paintFreeMemory();    // So memoryReport() can tell us the stack and heap high-water marks; must be before any "new".
 
   // *** INITIALIZE SERIAL PORTS ***
   // For LEG, we are going to connect BOTH the PC's Serial port *and* the Mini Thermal Printer to Serial 0.
@@ -164,6 +185,7 @@ void setup() {
   // We must pass parms to the constructor (vs begin) because needed by parent DigoleSerialDisp.
   pLCD2004 = new Display_2004(&Serial1, SERIAL1_SPEED);  // Instantiate the object and assign the global pointer.
   pLCD2004->begin();  // 20-char x 4-line LCD display via Serial 1.
+  noteHeapUsed(F("Display_2004"));
   pLCD2004->println(lcdString);  // Display app version, defined above.
   Serial.println(lcdString);
 
@@ -172,6 +194,9 @@ void setup() {
   // MB85RS4MT is 512KB (4Mb) SPI FRAM.  Our original FRAM was only 8KB SPI.
   pStorage = new FRAM(MB85RS4MT, PIN_IO_FRAM_CS);  // Instantiate the object and assign the global pointer
   pStorage->begin();  // Will crash on its own if there is any problem with the FRAM
+  pJournal = new Event_Journal;  // C++ quirk: no parens in ctor call if no parms; else thinks it's fn decl'n.
+  pJournal->begin(pStorage);     // Appends a BOOT record to the journal left by our previous run.
+  noteHeapUsed(F("FRAM + Event_Journal"));
   //pStorage->setFRAMRevDate(6, 18, 60);  // Available function for testing only.
   //pStorage->checkFRAMRevDate();  // Terminate with error if FRAM rev date does not match date in Train_Consts_Global.h
   //pStorage->testFRAM();         while (true) {}  // Writes then reads random data to entire FRAM.
@@ -182,6 +207,7 @@ void setup() {
   // WARNING: Instantiating Message class hangs the system if hardware is not connected.
   pMessage = new Message;  // C++ quirk: no parens in ctor call if no parms; else thinks it's fn decl'n.
   pMessage->begin(&Serial2, SERIAL2_SPEED);
+  noteHeapUsed(F("Message"));
 
   // *** INITIALIZE CENTIPEDE SHIFT REGISTER ***
   // WARNING: Instantiating Centipede class hangs the system if hardware is not connected.
@@ -189,46 +215,65 @@ void setup() {
   pShiftRegister = new Centipede;             // C++ quirk: no parens in ctor call if no parms; else thinks it's fn decl'n.
   pShiftRegister->begin();                    // Set all registers to default.
   pShiftRegister->initializePinsForOutput();  // Set all Centipede shift register pins to OUTPUT for Accessories.
+  noteHeapUsed(F("Centipede"));
 
   // *** INITIALIZE TURNOUT RESERVATION CLASS AND OBJECT ***  (Heap uses 9 bytes)
   pTurnoutReservation = new Turnout_Reservation;  // C++ quirk: no parens in ctor call if no parms; else thinks it's fn decl'n.
   pTurnoutReservation->begin(pStorage);
+  noteHeapUsed(F("Turnout_Reservation"));
 
   // *** INITIALIZE SENSOR-BLOCK CROSS REFERENCE CLASS AND OBJECT *** (Heap uses 9 bytes)
   pSensorBlock = new Sensor_Block;  // C++ quirk: no parens in ctor call if no parms; else thinks it's fn decl'n.
   pSensorBlock->begin(pStorage);
+  noteHeapUsed(F("Sensor_Block"));
 
   // *** INITIALIZE BLOCK RESERVATION CLASS AND OBJECT *** (Heap uses 26 bytes)
   pBlockReservation = new Block_Reservation;  // C++ quirk: no parens in ctor call if no parms; else thinks it's fn decl'n.
-  pBlockReservation->begin(pStorage);
+  pBlockReservation->begin(pStorage, pJournal);
+  noteHeapUsed(F("Block_Reservation"));
 
   // *** INITIALIZE LOCOMOTIVE REFERENCE TABLE CLASS AND OBJECT *** (Heap uses 81 bytes)
   pLoco = new Loco_Reference;  // C++ quirk: no parens in ctor call if no parms; else thinks it's fn decl'n.
   pLoco->begin(pStorage);
+  noteHeapUsed(F("Loco_Reference"));
 
   // *** INITIALIZE ROUTE REFERENCE CLASS AND OBJECT ***  (Heap uses 177 bytes)
   pRoute = new Route_Reference;  // C++ quirk: no parens in ctor call if no parms; else thinks it's fn decl'n.
   pRoute->begin(pStorage);  // Assuming we'll need a pointer to the Block Reservation class
+  noteHeapUsed(F("Route_Reference"));
 
-  // *** INITIALIZE TRAIN PROGRESS CLASS AND OBJECT ***  (Heap uses 14,552 bytes)
+  // *** INITIALIZE TRAIN PROGRESS CLASS AND OBJECT ***  (QuadRAM arena uses about 14.5K)
   // WARNING: TRAIN PROGRESS MUST BE INSTANTIATED *AFTER* BLOCK RESERVATION AND ROUTE REFERENCE.
   pTrainProgress = new Train_Progress;  // C++ quirk: no parens in ctor call if no parms; else thinks it's fn decl'n.
   pTrainProgress->begin(pBlockReservation, pRoute);
+  noteHeapUsed(F("Train_Progress"));
 
-  // *** INITIALIZE DELAYED ACTION CLASS AND OBJECT ***  (Heap uses ??? bytes)
+  // *** INITIALIZE DELAYED ACTION CLASS AND OBJECT ***  (QuadRAM arena uses about 10K)
   // WARNING: DELAYED ACTION MUST BE INSTANTIATED *AFTER* LOCO REF AND TRAIN PROGRESS.
   pDelayedAction = new Delayed_Action;  // C++ quirk: no parens in ctor call if no parms; else thinks it's fn decl'n.
   pDelayedAction->begin(pLoco, pTrainProgress);
+  noteHeapUsed(F("Delayed_Action"));
 
   // *** INITIALIZE ENGINEER CLASS AND OBJECT ***
   // WARNING: ENGINEER MUST BE INSTANTIATED *AFTER* LOCO REF, TRAIN PROGRESS, AND DELAYED ACTION.
   pEngineer = new Engineer;  // C++ quirk: no parens in ctor call if no parms; else thinks it's fn decl'n.
-  pEngineer->begin(pLoco, pTrainProgress, pDelayedAction);
+  pEngineer->begin(pLoco, pTrainProgress, pDelayedAction, pJournal);
+  noteHeapUsed(F("Engineer"));
 
   // *** INITIALIZE CONDUCTOR CLASS AND OBJECT ***  We may not need this class; may handle it in the main LEG loop... **************************************
   // CONDUCTOR MUST BE INSTANTIATED *AFTER* BLOCK RES'N, LOCO REF, ROUTE REF, TRAIN PROGRESS, DELAYED ACTION, AND ENGINEER.
   pConductor = new Conductor;  // C++ quirk: no parens in ctor call if no parms; else thinks it's fn decl'n.
-  pConductor->begin(pStorage, pBlockReservation, pDelayedAction, pEngineer);
+  pConductor->begin(pStorage, pBlockReservation, pTrainProgress, pDelayedAction, pEngineer);
+  noteHeapUsed(F("Conductor"));
+
+  // *** INITIALIZE LOOP PROFILER CLASS AND OBJECT ***  (QuadRAM arena uses 800 bytes)
+  // WARNING: LOOP PROFILER MUST BE INSTANTIATED *AFTER* ENGINEER.
+  pProfiler = new Loop_Profiler;  // C++ quirk: no parens in ctor call if no parms; else thinks it's fn decl'n.
+  pProfiler->begin();
+  pEngineer->setProfiler(pProfiler);  // Engineer times its own Delayed Action and Legacy send work.
+  noteHeapUsed(F("Loop_Profiler"));
+
+  memoryMap();  // Where everything ended up in internal SRAM and QuadRAM; warns if QuadRAM is nearly full.
 
 }  // End of setup()
 
@@ -249,6 +294,22 @@ void loop() {
   // Legacy command buffer could include PowerMaster on/off commands, or commands still remaining after completion of Registration
   // mode, i.e. slow start-up and blowing horns etc.  So just keep checking until operator selects a new mode to start.
 
+  // While STOPPED, the operator can type J in the Serial monitor to dump the Event Journal, X to clear it, M for a memory report,
+  // or P for the last Auto/Park session's loop timings.
+  if (Serial.available()) {
+    char serialCommand = Serial.read();
+    if ((serialCommand == 'J') || (serialCommand == 'j')) {
+      pJournal->dump();
+    } else if ((serialCommand == 'X') || (serialCommand == 'x')) {
+      pJournal->reset();
+      Serial.println(F("Event Journal cleared."));
+    } else if ((serialCommand == 'M') || (serialCommand == 'm')) {
+      memoryReport();
+    } else if ((serialCommand == 'P') || (serialCommand == 'p')) {
+      pProfiler->display();
+    }
+  }
+
   // **************************************************************
   // ***** SUMMARY OF MESSAGES RECEIVED & SENT BY THIS MODULE *****
   // ***** REV: 03/10/23                                      *****
@@ -304,6 +365,7 @@ void loop() {
     case 'M':  // New mode/state message in incoming RS485 buffer *** VALID IN ANY MODE ***
     {
       pMessage->getMAStoALLModeState(&modeCurrent, &stateCurrent);
+      pJournal->log(JOURNAL_EVENT_MODE_STATE, LOCO_ID_NULL, 0, modeCurrent, stateCurrent);
 
       if ((modeCurrent == MODE_MANUAL) && (stateCurrent == STATE_RUNNING)) {
 
@@ -714,42 +776,68 @@ void LEGAutoParkMode() {
 
 
 
+  pConductor->resetEvents();  // Conductor will only look at locos we tell it about via postEvent()
+  pProfiler->reset();  // Timings are per Auto/Park session
+  pLCD2004->setQueued(true);  // println() only queues lines now; service() below sends them to the LCD a few chars at a time
+
   do {  // Operate in Auto/Park until mode == STOPPED
 
+    Loop_Timer passTimer(pProfiler, LOOP_STAGE_PASS);  // Times this whole pass, until the end of the do { } block.
     haltIfHaltPinPulledLow();  // If someone has pulled the Halt pin low, release relays and send e-stop to Legacy
-    pEngineer->executeConductorCommand();  // Run oldest ripe command in Legacy command buffer, if possible.
+    {
+      Loop_Timer timer(pProfiler, LOOP_STAGE_DISPLAY);
+      pLCD2004->service();  // Send the next few changed chars to the LCD, if any; never waits
+    }
+    pEngineer->executeConductorCommand();  // Run oldest ripe command in Legacy command buffer, if possible.  Times itself.
 
     // SPECIAL CONSIDERATION: Check to see if a stopped loco should start moving.  If a loco is stopped, by definition we can only
     // received an Extension route (for a stopped loco.)  The loco could be freshly Registered (sitting in the initial block), or
     // stopped following completion of a previous Route.  In either case, the new Route will have a countDown ms to delay before
     // starting the loco moving.  Thus, after the Route has been added to Train Progress, we'll need to periodically call
-    // pTrainProgress->timeToStartLoco(locoNum) which returns true or false.
+    // pTrainProgress->timeToStartLoco(locoNum) which returns true or false.  (Conductor::locoReadyToStart() now does that for us.)
     // NOTE: When a train is Registered, timeToStartLoco is set to > 1 day, so will only set a "sooner" time to start after we have
     // assigned a new Route (no need to confirm that there is a Route ahead of a train that has reached it's time to start.)
 // HOWEVER, when a train finishes a route (stops) then we need to always reset timetostart to be 99999999 again.
     // TO START A STOPPED LOCO:
-    //   1. isActive() and isStopped() and timeToStartLoco(locoNum) must all be true, AND SIGNIFICANTLY
+    //   1. isActive() and isStopped() must be true and timeToStart must have arrived, AND SIGNIFICANTLY
     //   2. There must be a Route ahead of the train: pTrainProgress->atEndOfRoute(locoNum) should be false
     // This is the ONLY way to get a stopped train moving!
-    for (locoNum = 1; locoNum <= TOTAL_TRAINS; locoNum++) {
-      if ((pTrainProgress->isActive(locoNum)) &&               // We are active
-          (pTrainProgress->isStopped(locoNum)) &&              // We are stopped
-          (pTrainProgress->atEndOfRoute(locoNum) == false) &&  // We are NOT at the end of the route (there is route ahead)
-          (pTrainProgress->timeToStart(locoNum))) {            // We can start any time now
-        // locoNum is stopped but ready to start moving on it's route!
-        // We will NO LONGER be sitting on the nextToTripPtr sensor as it will have been advanced when new route was added.
-        // Don't forget to also blow the horn, make an announcement, etc.
-
-
-// ADD CODE HERE...MAYBE SAME LOGIC AS WHEN WE TRIP A SENSOR???  I.e. FD00/RD00, VLxx through the next sensor...
-
-
-      }  // End of "we have started a stopped train"
-    }  // End of "for each locoNum"
+    // 10/19/26: Conductor keeps track of which locos are waiting to start (from the Route and Sensor events we post to it below)
+    // so we no longer need to check every loco every time through this loop.
+    while ((locoNum = pConductor->locoReadyToStart()) != 0) {
+      // locoNum is stopped but ready to start moving on it's route!
+      // We will NO LONGER be sitting on the nextToTripPtr sensor as it will have been advanced when new route was added.
+      // addExtensionRoute() overlaid the old route's final VL00 with the new route's FD00/RD00, so the elements between the sensor
+      // we're sitting on (lastTrippedPtr) and nextToTripPtr are the new route's direction and starting speed(s.)  Same logic as
+      // when we trip a sensor, below: hand each FD/RD/VL to Delayed Action, but after a departure whistle/horn.
+      Loop_Timer timer(pProfiler, LOOP_STAGE_DELAYED_ACTION);
+      pDelayedAction->populateLocoWhistleHorn(millis(), locoNum, LEGACY_PATTERN_DEPARTING);  // L-L: releasing brakes
+      unsigned long departTime = millis() + 2000;  // Give the whistle/horn a moment before we start moving
+      byte tempTPPointer = pTrainProgress->lastTrippedPtr(locoNum);
+      routeElement tempTPElement;
+      while ((tempTPPointer = pTrainProgress->incrementTrainProgressPtr(tempTPPointer)) != pTrainProgress->nextToTripPtr(locoNum)) {
+        tempTPElement = pTrainProgress->peek(locoNum, tempTPPointer);
+        if (tempTPElement.routeRecType == FD) {
+          pDelayedAction->populateLocoCommand(departTime, locoNum, LEGACY_ACTION_FORWARD, 0, 0);
+        } else if (tempTPElement.routeRecType == RD) {
+          pDelayedAction->populateLocoCommand(departTime, locoNum, LEGACY_ACTION_REVERSE, 0, 0);
+        } else if ((tempTPElement.routeRecType == VL) && (tempTPElement.routeRecVal > 0)) {
+          // Starting from a stop, so use the loco's medium momentum, as for any speed change other than slowing to Crawl/Stop.
+          pDelayedAction->populateLocoSpeedChange(departTime, locoNum, pLoco->medSpeedSteps(locoNum),
+                                                  pLoco->medMsStepDelay(locoNum), tempTPElement.routeRecVal);
+        }
+      }
+      // We're isStopped() until Engineer actually sends a non-zero speed, so push timeToStart out again or Conductor would hand
+      // us this loco a second time before it gets rolling.
+      pTrainProgress->setTimeToStart(locoNum, 99999999);
+    }  // End of "while Conductor has a loco ready to start" i.e. we have started a stopped train
     // Okay, if there were any stopped trains that needed to be started, we've got them moving (via Delayed Action records.)
 
     // See if there is an incoming message for us...could be ' ', Sensor, Route, or Mode message (others ignored)
-    msgType = pMessage->available();  // msgType ' ' (blank) indicates no message
+    {
+      Loop_Timer timer(pProfiler, LOOP_STAGE_MESSAGES);
+      msgType = pMessage->available();  // msgType ' ' (blank) indicates no message
+    }
 
     if (msgType == 'R') {  // We've got a new Route to add to Train Progress.  Could be Continuation or Extension.
 
@@ -758,23 +846,33 @@ void LEGAutoParkMode() {
 
       // First, get the incoming Route message which we know is waiting for us...
       pMessage->getMAStoALLRoute(&locoNum, &extOrCont, &routeRecNum, &countdown);
+      pJournal->log(JOURNAL_EVENT_ROUTE_ADDED, locoNum, routeRecNum, extOrCont, countdown);
 
       // Debug code to dump Train Progress for locoNum, before adding the Extension or Continuation route
-      sprintf(lcdString, "T.P. loco %i BEFORE", locoNum); Serial.println(lcdString);
-      pTrainProgress->display(locoNum);
+      {
+        Loop_Timer timer(pProfiler, LOOP_STAGE_DISPLAY);
+        sprintf(lcdString, "T.P. loco %i BEFORE", locoNum); Serial.println(lcdString);
+        pTrainProgress->display(locoNum);
+      }
 
       //   Add elements of the new Route to Train Progress
       if (extOrCont == ROUTE_TYPE_EXTENSION) {
         // Add this extension route to Train Progress (our train is currently stopped.)
-        pTrainProgress->addExtensionRoute(locoNum, routeRecNum, countdown);
+        Loop_Timer timer(pProfiler, LOOP_STAGE_TRAIN_PROGRESS);
+        pTrainProgress->addExtensionRoute(locoNum, routeRecNum, (unsigned long)countdown * 1000UL);  // Message carries seconds
+        pConductor->postEvent(CONDUCTOR_EVENT_ROUTE_ADDED, locoNum);  // So Conductor will start it when timeToStart arrives
       } else if (extOrCont == ROUTE_TYPE_CONTINUATION) {
         // Add this continuation route to Train Progress (our train is currently moving.)
+        Loop_Timer timer(pProfiler, LOOP_STAGE_TRAIN_PROGRESS);
         pTrainProgress->addContinuationRoute(locoNum, routeRecNum);
       }
 
       // Debug code to dump Train Progress for locoNum, after adding the Extension or Continuation route
-      sprintf(lcdString, "T.P. loco %i AFTER", locoNum); Serial.println(lcdString);
-      pTrainProgress->display(locoNum);
+      {
+        Loop_Timer timer(pProfiler, LOOP_STAGE_DISPLAY);
+        sprintf(lcdString, "T.P. loco %i AFTER", locoNum); Serial.println(lcdString);
+        pTrainProgress->display(locoNum);
+      }
 
     }  // End of "we received a new Route" message
 
@@ -786,7 +884,12 @@ void LEGAutoParkMode() {
       if (trippedOrCleared == SENSOR_STATUS_TRIPPED) {  // This is where the excitement happens!
 
         // Which loco tripped the sensor?
-        locoNum = pTrainProgress->locoThatTrippedSensor(sensorNum);  // Will also update lastTrippedPtr to this sensor
+        {
+          Loop_Timer timer(pProfiler, LOOP_STAGE_TRAIN_PROGRESS);
+          locoNum = pTrainProgress->locoThatTrippedSensor(sensorNum);  // Will also update lastTrippedPtr to this sensor
+        }
+        pJournal->log(JOURNAL_EVENT_SENSOR_TRIP, locoNum, pTrainProgress->lastTrippedPtr(locoNum), sensorNum, trippedOrCleared);
+        pConductor->postEvent(CONDUCTOR_EVENT_SENSOR_TRIPPED, locoNum);
 
 // NOTE: If we've just tripped the CRAWL sensor, call pTrainProgress->currentSpeed(locoNum) and confirm that the current speed is equal to what we
 // think our current speed should be -- which will be equal to the most recent VL## command which should be equal to exactly our
@@ -802,8 +905,11 @@ void LEGAutoParkMode() {
         // and reverse direction and crawl to the Stop sensor, but won't exceed Crawl speed once we slow down and it seems like the
         // appropriate place to make an arrival (i.e. station) announcement.
         // Note that we should also turn on the bell at this point.
-        pDelayedAction->populateLocoCommand(millis(), locoNum, LEGACY_DIALOGUE, LEGACY_DIALOGUE_E2T_ARRIVING , 0);
-        pDelayedAction->populateLocoCommand(millis() + 3000, locoNum, LEGACY_SOUND_BELL_ON, 0 , 0);
+        {
+          Loop_Timer timer(pProfiler, LOOP_STAGE_DELAYED_ACTION);
+          pDelayedAction->populateLocoCommand(millis(), locoNum, LEGACY_DIALOGUE, LEGACY_DIALOGUE_E2T_ARRIVING , 0);
+          pDelayedAction->populateLocoCommand(millis() + 3000, locoNum, LEGACY_SOUND_BELL_ON, 0 , 0);
+        }
 
 
 
@@ -833,6 +939,8 @@ void LEGAutoParkMode() {
 
         // First check if we're at the end of the Route (i.e. just tripped the STOP sensor) in which case we can't advance.
         if ((pTrainProgress->atEndOfRoute(locoNum) == false)) {  // If we didn't just trip the route's Stop sensor
+          // Includes populating Delayed Action with whatever we find along the way.
+          Loop_Timer timer(pProfiler, LOOP_STAGE_TRAIN_PROGRESS);
           byte tempTPPointer = pTrainProgress->nextToTripPtr(locoNum);  // Element number, not a sensor number, just tripped
           routeElement tempTPElement;  // Working/scratch Train Progress element
           do {
@@ -939,6 +1047,9 @@ void LEGAutoParkMode() {
       }
       // Okay they want to STOP Auto/Park mode.  It must mean all locos are stopped.
       // We will just fall out of the loop below since stateCurrent is now STATE_STOPPED
+      pEngineer->displayStats();  // Legacy Command Buffer coalescing counts for this session.
+      pConductor->displayStats();
+      pProfiler->display();  // Loop stage timings for this session.
     }
 
     else if (msgType != ' ') {  // AT this point, the only other valid response from pMessage->available() is BLANK (no message.)
@@ -948,6 +1059,8 @@ void LEGAutoParkMode() {
 
   } while (stateCurrent != STATE_STOPPED);
 
+  pLCD2004->setQueued(false);  // Waits for any queued lines to be shown, then println() writes directly again
+
   return;
 }
 
@@ -1,6 +1,20 @@
-// O_MAS.INO Rev: 07/30/24.
+// O_MAS.INO Rev: 10/19/26.
 // MAS is the master controller; everyone else is a slave.
 
+// 10/19/26: Auto/Park loop stages are timed by a Loop_Profiler, as in LEG and OCC; the timings are displayed when Auto/Park mode
+//           stops, or type 'P' in the Serial monitor while STOPPED to see the last session's again.
+// 10/19/26: LCD output is queued during Auto/Park (see Display_2004::setQueued()), as in LEG and OCC, so Dispatcher's status
+//           messages don't stall the loop for several milliseconds of delay() while trains are tripping sensors.
+// 10/19/26: MASAutoParkMode() now runs Auto/Park: follows sensor trips/clears in Train Progress (releasing reservations behind
+//           each train), and calls Dispatcher::dispatch() every pass to assign routes, which are sent to OCC and LEG.
+// 10/19/26: Train Progress tables come from the QuadRAM arena (see arenaAllocate()); the memory map is sent to Serial at
+//           the end of setup().
+// 10/19/26: Type 'M' in the Serial monitor while STOPPED for a memory report: stack and heap high-water marks, heap by object.
+// 10/19/26: Display RS485 bus health report (statistics from every module) each time a mode is stopped.
+// 10/19/26: Keep an Event_Journal in FRAM (mode changes, sensor changes, turnouts thrown, block res'ns.)  Type 'J' in the
+//           Serial monitor while STOPPED to dump it as a timeline, or 'X' to clear it.
+// 10/19/26: Enabled FRAM write-back cache; flushed every FRAM_CACHE_FLUSH_MS, on every mode change, and on halt.
+
 // 03/03/24: No more Dispatch Board object.
 // 02/19/24: Eliminate support for POV mode; not worth the effort until I'm ready.  If selected by user, just ignore.  Thus, I
 // don't need to include ANY other logic to handle if Mode == MODE_POV.
@@ -66,6 +80,10 @@ Display_2004* pLCD2004 = nullptr;  // pLCD2004 is #included in Train_Functions.h
 #include <FRAM.h>
 FRAM* pStorage = nullptr;
 
+// *** EVENT JOURNAL IN FRAM ***
+#include <Event_Journal.h>
+Event_Journal* pJournal = nullptr;
+
 // *** RS485/DIGITAL MESSAGE CLASS ***
 #include <Message.h>
 Message* pMessage = nullptr;
@@ -106,6 +124,10 @@ Train_Progress* pTrainProgress = nullptr;
 #include <Dispatcher.h>  // Called to operate in Auto/Park mode
 Dispatcher* pDispatcher = nullptr;
 
+// *** MAIN LOOP TIMING ***
+#include <Loop_Profiler.h>
+Loop_Profiler* pProfiler = nullptr;
+
 // *** MISC CONSTANTS AND GLOBALS NEEDED BY MAS ***
 
 // Variables that come with new Route messages
@@ -136,6 +158,7 @@ void setup() {
 
   // *** QUADRAM HEAP MEMORY MODULE ***
   initializeQuadRAM();  // Add-on memory board provides 56,832 bytes for heap
+  paintFreeMemory();    // So memoryReport() can tell us the stack and heap high-water marks; must be before any "new".
 
   // *** INITIALIZE SERIAL PORTS ***
   Serial.begin(SERIAL0_SPEED);   // PC serial monitor window 115200.  Change if using thermal mini printer.
@@ -146,6 +169,7 @@ void setup() {
   // We must pass parms to the constructor (vs begin) because needed by parent DigoleSerialDisp.
   pLCD2004 = new Display_2004(&Serial1, SERIAL1_SPEED);  // Instantiate the object and assign the global pointer.
   pLCD2004->begin();  // 20-char x 4-line LCD display via Serial 1.
+  noteHeapUsed(F("Display_2004"));
   pLCD2004->println(lcdString);  // Display app version, defined above.
   Serial.println(lcdString);
 
@@ -154,56 +178,76 @@ void setup() {
   // MB85RS4MT is 512KB (4Mb) SPI FRAM.  Our original FRAM was only 8KB SPI.
   pStorage = new FRAM(MB85RS4MT, PIN_IO_FRAM_CS);  // Instantiate the object and assign the global pointer
   pStorage->begin();  // Will crash on its own if there is any problem with the FRAM
+  pStorage->enableWriteCache(FRAM_CACHE_FLUSH_MS);  // Absorb repeated small Block/Turnout Res'n writes; see FRAM.h.
+  pJournal = new Event_Journal;  // C++ quirk: no parens in ctor call if no parms; else thinks it's fn decl'n.
+  pJournal->begin(pStorage);     // Appends a BOOT record to the journal left by our previous run.
+  noteHeapUsed(F("FRAM + Event_Journal"));
   //pStorage->setFRAMRevDate(6, 18, 60);  // Available function for testing only.
   //pStorage->checkFRAMRevDate();  // Terminate with error if FRAM rev date does not match date in Train_Consts_Global.h
   //pStorage->testFRAM();         while (true) {}  // Writes then reads random data to entire FRAM.
   //pStorage->testSRAM();         while (true) {}  // Test 4K of SRAM just for comparison.
   //pStorage->testQuadRAM(56647); while (true) {}  // (unsigned long t_numBytesToTest); max about 56,647 testable bytes.
+  //pStorage->testFRAMSpeed(1024); while (true) {}  // Time 8192-byte reads/writes by chunk size and SPI clock; not destructive.
 
   // *** INITIALIZE RS485 MESSAGE CLASS AND OBJECT *** (Heap uses 30 bytes)
   // WARNING: Instantiating Message class hangs the system if hardware is not connected.
   pMessage = new Message;  // C++ quirk: no parens in ctor call if no parms; else thinks it's fn decl'n.
   pMessage->begin(&Serial2, SERIAL2_SPEED);
+  noteHeapUsed(F("Message"));
 //  delay(1000);  // O_MAS-only delay gives the slaves a chance to get ready to receive data.
 
   // *** INITIALIZE CONTROL PANEL MODE DIAL CLASS AND OBJECT *** (Heap uses 31 bytes)
   pModeSelector = new Mode_Dial;  //  C++ quirk: no parens in ctor call if no parms; else thinks it's fn decl'n.
   pModeSelector->begin(&modeCurrent, &stateCurrent);  // Sets (RETRIEVES from function) Mode = MANUAL, State = STOPPED
+  noteHeapUsed(F("Mode_Dial"));
 
   // *** INITIALIZE TURNOUT RESERVATION CLASS AND OBJECT ***  (Heap uses 9 bytes)
   pTurnoutReservation = new Turnout_Reservation;  // C++ quirk: no parens in ctor call if no parms; else thinks it's fn decl'n.
   pTurnoutReservation->begin(pStorage);
+  noteHeapUsed(F("Turnout_Reservation"));
 
   // *** INITIALIZE SENSOR-BLOCK CROSS REFERENCE CLASS AND OBJECT *** (Heap uses 9 bytes)
   pSensorBlock = new Sensor_Block;  // C++ quirk: no parens in ctor call if no parms; else thinks it's fn decl'n.
   pSensorBlock->begin(pStorage);
+  noteHeapUsed(F("Sensor_Block"));
 
   // *** INITIALIZE BLOCK RESERVATION CLASS AND OBJECT *** (Heap uses 26 bytes)
   pBlockReservation = new Block_Reservation;  // C++ quirk: no parens in ctor call if no parms; else thinks it's fn decl'n.
-  pBlockReservation->begin(pStorage);
+  pBlockReservation->begin(pStorage, pJournal);
+  noteHeapUsed(F("Block_Reservation"));
 
   // *** INITIALIZE LOCOMOTIVE REFERENCE TABLE CLASS AND OBJECT *** (Heap uses 81 bytes)
   pLoco = new Loco_Reference;  // C++ quirk: no parens in ctor call if no parms; else thinks it's fn decl'n.
   pLoco->begin(pStorage);
+  noteHeapUsed(F("Loco_Reference"));
 
   // *** INITIALIZE ROUTE REFERENCE CLASS AND OBJECT ***  (Heap uses 177 bytes)
   pRoute = new Route_Reference;  // C++ quirk: no parens in ctor call if no parms; else thinks it's fn decl'n.
   pRoute->begin(pStorage);
+  noteHeapUsed(F("Route_Reference"));
 
   // *** INITIALIZE DEADLOCK LOOKUP CLASS AND OBJECT ***  (Heap uses 32 bytes)
   // WARNING: DEADLOCK MUST BE INSTANTIATED *AFTER* BLOCK RESERVATION AND LOCO REFERENCE.
   pDeadlock = new Deadlock_Reference;  // C++ quirk: no parens in ctor call if no parms; else thinks it's fn decl'n.
   pDeadlock->begin(pStorage, pBlockReservation, pLoco);
+  noteHeapUsed(F("Deadlock_Reference"));
 
-  // *** INITIALIZE TRAIN PROGRESS CLASS AND OBJECT ***  (Heap uses 14,552 bytes)
+  // *** INITIALIZE TRAIN PROGRESS CLASS AND OBJECT ***  (QuadRAM arena uses about 14.5K)
   // WARNING: TRAIN PROGRESS MUST BE INSTANTIATED *AFTER* BLOCK RESERVATION AND ROUTE REFERENCE.
   pTrainProgress = new Train_Progress;  // C++ quirk: no parens in ctor call if no parms; else thinks it's fn decl'n.
   pTrainProgress->begin(pBlockReservation, pRoute);
+  noteHeapUsed(F("Train_Progress"));
 
   // *** INITIALIZE DISPATCHER CLASS AND OBJECT ***
   // WARNING: DISPATCHER MUST BE INSTANTIATED *AFTER* ALMOST ALL OTHER CLASSES.
   pDispatcher = new Dispatcher;  //  C++ quirk: no parens in ctor call if no parms; else thinks it's fn decl'n.
   pDispatcher->begin(pMessage, pLoco, pBlockReservation, pTurnoutReservation, pSensorBlock, pRoute, pDeadlock, pTrainProgress, pModeSelector);
+  noteHeapUsed(F("Dispatcher"));
+
+  // *** INITIALIZE LOOP PROFILER CLASS AND OBJECT ***  (QuadRAM arena uses 800 bytes)
+  pProfiler = new Loop_Profiler;  // C++ quirk: no parens in ctor call if no parms; else thinks it's fn decl'n.
+  pProfiler->begin();
+  noteHeapUsed(F("Loop_Profiler"));
 
   // *** STARTUP HOUSEKEEPING: TURNOUTS, SENSORS, ETC. ***
   pMessage->sendMAStoALLModeState(modeCurrent, stateCurrent); // MODE_MANUAL, STATE_STOPPED.
@@ -212,6 +256,8 @@ void setup() {
   // *** QUICK CHECK OF TURNOUT 17 RESERVATION DUE TO UNEXPLAINED PROBLEMS ON 12/12/20 ***
   checkForTurnout17Problem();
 
+  memoryMap();  // Where everything ended up in internal SRAM and QuadRAM; warns if QuadRAM is nearly full.
+
 }  // End of setup()
 
 // *****************************************************************************************
@@ -221,6 +267,23 @@ void setup() {
 void loop() {
 
   haltIfHaltPinPulledLow();  // If someone has pulled the Halt pin low, release relays and just stop
+  pStorage->serviceWriteCache();  // Write any changed cached FRAM bytes if FRAM_CACHE_FLUSH_MS has elapsed
+
+  // While STOPPED, the operator can type J in the Serial monitor to dump the Event Journal, X to clear it, M for a memory report,
+  // or P for the last Auto/Park session's loop timings.
+  if (Serial.available()) {
+    char serialCommand = Serial.read();
+    if ((serialCommand == 'J') || (serialCommand == 'j')) {
+      pJournal->dump();
+    } else if ((serialCommand == 'X') || (serialCommand == 'x')) {
+      pJournal->reset();
+      Serial.println(F("Event Journal cleared."));
+    } else if ((serialCommand == 'M') || (serialCommand == 'm')) {
+      memoryReport();
+    } else if ((serialCommand == 'P') || (serialCommand == 'p')) {
+      pProfiler->display();
+    }
+  }
 
   // **************************************************************
   // ***** SUMMARY OF MESSAGES RECEIVED & SENT BY THIS MODULE *****
@@ -287,6 +350,8 @@ void loop() {
     // mode if we did not previously complete Registration mode.
     // modeCurrent and stateCurrent will now be populated with the newly-started Mode and State selected by the operator.
     pMessage->sendMAStoALLModeState(modeCurrent, stateCurrent);  // Broadcast the new MODE and STATE.
+    pJournal->log(JOURNAL_EVENT_MODE_STATE, LOCO_ID_NULL, 0, modeCurrent, stateCurrent);
+    pStorage->flush();  // Everything the previous mode wrote to FRAM is now actually in FRAM.
     // We are now in a new Mode (Manual, Register, Auto, or Park) and State is RUNNING.
 
     if ((modeCurrent == MODE_MANUAL) && (stateCurrent == STATE_RUNNING)) {
@@ -319,6 +384,11 @@ void loop() {
 
     }  // *** AUTO/PARK MODE COMPLETE! ***
 
+    // Everyone is now STOPPED, so it's safe for MAS to hold the bus while it collects statistics from every module.
+    pMessage->displayBusHealthReport();
+    pStorage->flush();
+    pStorage->displayCacheStats();
+
   }
 }  // End of loop()
 
@@ -375,10 +445,12 @@ void MASManualMode() {  // CLEAN THIS UP SO THAT MAS/OCC/LEG ARE MORE CONSISTENT
   // * Mode update (via Control Panel "Stop" button press), in which case we're done and return to the main loop.
   do {
     haltIfHaltPinPulledLow();  // If someone has pulled the Halt pin low, release relays and just stop
+    pStorage->serviceWriteCache();
     msgType = pMessage->available();  // Blank = no message; else call appropriate "pMessage->get" function to retrieve data.
     if (msgType == 'S') {  // Sensor status from SNS
       // This will be the result of SNS independently wanting to send us a change that it detected; not a request from us.
       pMessage->getSNStoALLSensorStatus(&sensorNum, &trippedOrCleared);
+      pJournal->log(JOURNAL_EVENT_SENSOR_TRIP, LOCO_ID_NULL, 0, sensorNum, trippedOrCleared);
       if (trippedOrCleared == SENSOR_STATUS_TRIPPED) {
         sprintf(lcdString, "Sensor %i Tripped", sensorNum); pLCD2004->println(lcdString); Serial.println(lcdString);
       } else {
@@ -400,6 +472,7 @@ void MASManualMode() {  // CLEAN THIS UP SO THAT MAS/OCC/LEG ARE MORE CONSISTENT
       }
       // Send 'T'urnout message to SWT to throw turnout, also seen by LED to update green LED on control panel
       pMessage->sendMAStoALLTurnout(buttonNum, position);  // setting = N|R
+      pJournal->log(JOURNAL_EVENT_TURNOUT_THROWN, LOCO_ID_NULL, 0, buttonNum, position);
       // Save new (opposite) position of turnout in Turnout_Reservation.  This is *not* reserving the turnout.
       pTurnoutReservation->setLastOrientation(buttonNum, position);  // Set "last-known" orientation to 'N'ormal or 'R'everse
     } else if (msgType != ' ') {  // If it's not Button, Sensor, or blank, we have a bug!
@@ -415,6 +488,7 @@ void MASManualMode() {  // CLEAN THIS UP SO THAT MAS/OCC/LEG ARE MORE CONSISTENT
   }
   // Let everyone know what we are in Manual mode, Stopped...
   pMessage->sendMAStoALLModeState(modeCurrent, stateCurrent);  // Broadcast MODE (Manual) and STATE (Stopped.)
+  pJournal->log(JOURNAL_EVENT_MODE_STATE, LOCO_ID_NULL, 0, modeCurrent, stateCurrent);
   return;
 }
 
@@ -549,6 +623,7 @@ void MASRegistrationMode() {
   // Now that Registration mode is done, update stateCurrent to reflect that.  modeCurrent remains unchanged.
   pModeSelector->setStateToSTOPPED(modeCurrent, &stateCurrent);  // Will change stateCurrent to STOPPED, update mode LEDs
   pMessage->sendMAStoALLModeState(modeCurrent, stateCurrent);  // Broadcast that we are in REGISTRATION STOPPED
+  pJournal->log(JOURNAL_EVENT_MODE_STATE, LOCO_ID_NULL, 0, modeCurrent, stateCurrent);
   return;
 }
 
@@ -586,10 +661,112 @@ void MASAutoParkMode() {
   // Upon entry here, modeCurrent == AUTO or PARK, and stateCurrent == RUNNING.
   // Mode may change from AUTO to PARK, and state may change from RUNNING to STOPPING; it's all handled here.
 
+  // 10/19/26: Each pass: watch the Halt pin, bring Train Progress up to date with any Sensor change (the only message we receive
+  // in Auto/Park), then let Dispatcher spend a few ms looking for routes.  Dispatcher watches the Stop button and decides when
+  // we're STOPPED; we broadcast every state change it makes.
+  pModeSelector->paintModeLEDs(modeCurrent, stateCurrent);
+  pDispatcher->startDispatching(modeCurrent);
+  pLCD2004->setQueued(true);  // println() only queues lines now; service() below sends them to the LCD a few chars at a time
+  pProfiler->reset();  // Timings are per Auto/Park session
+
+  do {
+    Loop_Timer passTimer(pProfiler, LOOP_STAGE_PASS);  // Times this whole pass, until the end of the do { } block.
     haltIfHaltPinPulledLow();  // If someone has pulled the Halt pin low, just stop
+    pStorage->serviceWriteCache();
+    {
+      Loop_Timer timer(pProfiler, LOOP_STAGE_DISPLAY);
+      pLCD2004->service();  // Send the next few changed chars to the LCD, if any; never waits
+    }
 
+    {
+      Loop_Timer timer(pProfiler, LOOP_STAGE_MESSAGES);
+      msgType = pMessage->available();  // msgType ' ' (blank) indicates no message
+    }
+    if (msgType == 'S') {
+      Loop_Timer timer(pProfiler, LOOP_STAGE_TRAIN_PROGRESS);  // Includes throwing turnouts up to the next sensor
+      pMessage->getSNStoALLSensorStatus(&sensorNum, &trippedOrCleared);
+      pSensorBlock->setSensorStatus(sensorNum, trippedOrCleared);
+      if (trippedOrCleared == SENSOR_STATUS_TRIPPED) {
+        MASSensorTripped(sensorNum);
+      } else {
+        MASSensorCleared(sensorNum);
+      }
+    } else if (msgType != ' ') {  // The only message we should ever receive in Auto/Park mode is a Sensor change.
+      sprintf(lcdString, "AUTO MSG ERR %c", msgType); pLCD2004->println(lcdString); Serial.println(lcdString); endWithFlashingLED(1);
+    }
+
+    byte statePrevious = stateCurrent;
+    {
+      Loop_Timer timer(pProfiler, LOOP_STAGE_DISPATCH);  // Includes sending new Routes to OCC and LEG
+      pDispatcher->dispatch(modeCurrent, &stateCurrent);  // Assign routes; may change state to STOPPING or STOPPED
+    }
+    if (stateCurrent != statePrevious) {
+      pMessage->sendMAStoALLModeState(modeCurrent, stateCurrent);
+      pJournal->log(JOURNAL_EVENT_MODE_STATE, LOCO_ID_NULL, 0, modeCurrent, stateCurrent);
+    }
+  } while (stateCurrent != STATE_STOPPED);
+  pLCD2004->setQueued(false);  // Waits for any queued lines to be shown, then println() writes directly again
 
+  pDispatcher->displayStats();  // Route selection statistics for this session.
+  pProfiler->display();  // Loop stage timings for this session.
+  return;
+}
+
+void MASSensorTripped(const byte t_sensorNum) {
+  // Rev: 10/19/26.
+  // Same Train Progress bookkeeping as OCC and LEG do on a trip, plus MAS throws the turnouts up to the train's next sensor.
+  // Dispatcher will notice on its own if this was a Continuation sensor (needs a Continuation route) or the Stop sensor (needs an
+  // Extension route, or we're Parked.)
+  locoNum = pTrainProgress->locoThatTrippedSensor(t_sensorNum);  // Also updates lastTrippedPtr to this sensor
+  pJournal->log(JOURNAL_EVENT_SENSOR_TRIP, locoNum, pTrainProgress->lastTrippedPtr(locoNum), t_sensorNum, SENSOR_STATUS_TRIPPED);
+  if (pTrainProgress->lastTrippedPtr(locoNum) == pTrainProgress->stopPtr(locoNum)) {
+    return;  // Nothing ahead of us until Dispatcher adds an Extension route
+  }
+  // Advance Next-To-Trip to the next sensor in the route.  There is always one since this wasn't the Stop sensor.
+  byte tempTPPointer = pTrainProgress->lastTrippedPtr(locoNum);
+  routeElement tempTPElement;
+  do {
+    tempTPPointer = pTrainProgress->incrementTrainProgressPtr(tempTPPointer);
+    tempTPElement = pTrainProgress->peek(locoNum, tempTPPointer);
+  } while (tempTPElement.routeRecType != SN);
+  pTrainProgress->setNextToTripPtr(locoNum, tempTPPointer);
+  pTrainProgress->setParked(locoNum, false);
+  pDispatcher->throwTurnoutsToNextSensor(locoNum);
+  return;
+}
 
+void MASSensorCleared(const byte t_sensorNum) {
+  // Rev: 10/19/26.
+  // Same as OCC, except MAS also releases Turnout reservations.  Releasing Blocks and Turnouts behind the train is what lets
+  // Dispatcher find routes for other trains through them.
+  locoNum = pTrainProgress->locoThatClearedSensor(t_sensorNum);
+  pJournal->log(JOURNAL_EVENT_SENSOR_TRIP, locoNum, pTrainProgress->nextToClearPtr(locoNum), t_sensorNum, SENSOR_STATUS_CLEARED);
+  byte tempTPPointer = pTrainProgress->tailPtr(locoNum);  // Element number, not a sensor number
+  routeElement tempTPElement;
+  do {  // Starting at the tail and working forward towards the sensor that was just cleared...
+    tempTPPointer = pTrainProgress->incrementTrainProgressPtr(tempTPPointer);
+    tempTPElement = pTrainProgress->peek(locoNum, tempTPPointer);
+    if ((tempTPElement.routeRecType == BE) || (tempTPElement.routeRecType == BW)) {
+      if (pTrainProgress->blockOccursAgainInRoute(locoNum, tempTPElement.routeRecVal, tempTPPointer) == false) {
+        pBlockReservation->releaseBlock(tempTPElement.routeRecVal);
+      }
+    } else if ((tempTPElement.routeRecType == TN) || (tempTPElement.routeRecType == TR)) {
+      if (pTrainProgress->turnoutOccursAgainInRoute(locoNum, tempTPElement.routeRecVal, tempTPPointer) == false) {
+        pTurnoutReservation->release(tempTPElement.routeRecVal);
+      }
+    }
+  } while (tempTPElement.routeRecType != SN);
+  if (tempTPPointer != pTrainProgress->nextToClearPtr(locoNum)) {  // Fatal error
+    sprintf(lcdString, "NTC POINTER ERR!"); pLCD2004->println(lcdString); Serial.println(lcdString); endWithFlashingLED(1);
+  }
+  // New Tail is the old Next-To-Clear; new Next-To-Clear is the next sensor ahead of it.
+  pTrainProgress->setTailPtr(locoNum, pTrainProgress->nextToClearPtr(locoNum));
+  tempTPPointer = pTrainProgress->tailPtr(locoNum);
+  do {
+    tempTPPointer = pTrainProgress->incrementTrainProgressPtr(tempTPPointer);
+    tempTPElement = pTrainProgress->peek(locoNum, tempTPPointer);
+  } while (tempTPElement.routeRecType != SN);
+  pTrainProgress->setNextToClearPtr(locoNum, tempTPPointer);
   return;
 }
 
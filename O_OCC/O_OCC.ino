@@ -1,4 +1,13 @@
-// O_OCC.INO Rev: 09/27/24.
+// O_OCC.INO Rev: 10/19/26.
+// 10/19/26: LCD output is queued during Auto/Park (see Display_2004::setQueued()) and sent a few chars per pass by service(), so
+//           status messages no longer stall the loop for several milliseconds of delay().
+// 10/19/26: Train Progress and Loop_Profiler tables come from the QuadRAM arena (see arenaAllocate()); the memory map is sent to Serial at
+//           the end of setup().
+// 10/19/26: Auto/Park loop stages are timed by a Loop_Profiler; the timings are displayed when Auto/Park mode stops, or type 'P'
+//           in the Serial monitor while STOPPED to see the last session's again.
+// 10/19/26: Type 'M' in the Serial monitor while STOPPED for a memory report: stack and heap high-water marks, heap by object.
+// 10/19/26: paintAllBlockOccupancyLEDs() now only re-scans Train Progress for locos whose pointers changed, so calling it on every
+//           sensor change and route no longer costs a scan of every train's route.
 // OCC paints the WHITE Occupancy Sensor LEDs and RED/BLUE Block Occupancy LEDs on the Control Panel.
 // In Registration mode, OCC also prompts operator for initial data, using the Control Panel's Rotary Encoder and 8-Char display.
 // In Auto/Park modes, OCC also autonomously sends arrival and departure announcements to various stations around the layout.
@@ -77,7 +86,7 @@
 #include <Train_Consts_Global.h>
 #include <Train_Functions.h>
 const byte THIS_MODULE = ARDUINO_OCC;  // Global needed by Train_Functions.cpp and Message.cpp functions.
-char lcdString[LCD_WIDTH + 1] = "OCC 09/27/24";  // Global array holds 20-char string + null, sent to Digole 2004 LCD.
+char lcdString[LCD_WIDTH + 1] = "OCC 10/19/26";  // Global array holds 20-char string + null, sent to Digole 2004 LCD.
 
 // *** SERIAL LCD DISPLAY CLASS ***
 // #include <Display_2004.h> is already in <Train_Functions.h> so not needed here.
@@ -134,6 +143,10 @@ Rotary_Prompt* pRotaryEncoderPrompter = nullptr;
 #include <Occupancy_LEDs.h>
 Occupancy_LEDs* pOccupancyLEDs = nullptr;
 
+// *** MAIN LOOP TIMING ***
+#include <Loop_Profiler.h>
+Loop_Profiler* pProfiler = nullptr;
+
 // *** MISC CONSTANTS AND GLOBALS NEEDED BY OCC ***
 
 // Variables that come with new Route messages
@@ -172,6 +185,7 @@ void setup() {
 
   // *** QUADRAM HEAP MEMORY MODULE ***
   initializeQuadRAM();  // Add-on memory board provides 56,832 bytes for heap
+  paintFreeMemory();    // So memoryReport() can tell us the stack and heap high-water marks; must be before any "new".
 
   // *** INITIALIZE SERIAL PORTS ***
   Serial.begin(SERIAL0_SPEED);   // PC serial monitor window 115200.  Change if using thermal mini printer.
@@ -183,6 +197,7 @@ void setup() {
   // We must pass parms to the constructor (vs begin) because needed by parent DigoleSerialDisp.
   pLCD2004 = new Display_2004(&Serial1, SERIAL1_SPEED);  // Instantiate the object and assign the global pointer.
   pLCD2004->begin();  // 20-char x 4-line LCD display via Serial 1.
+  noteHeapUsed(F("Display_2004"));
   pLCD2004->println(lcdString);  // Display app version, defined above.
   Serial.println(lcdString);
 
@@ -191,6 +206,7 @@ void setup() {
   // MB85RS4MT is 512KB (4Mb) SPI FRAM.  Our original FRAM was only 8KB SPI.
   pStorage = new FRAM(MB85RS4MT, PIN_IO_FRAM_CS);  // Instantiate the object and assign the global pointer
   pStorage->begin();  // Will crash on its own if there is any problem with the FRAM
+  noteHeapUsed(F("FRAM"));
   //pStorage->setFRAMRevDate(6, 18, 60);  // Available function for testing only.
   //pStorage->checkFRAMRevDate();  // Terminate with error if FRAM rev date does not match date in Train_Consts_Global.h
   //pStorage->testFRAM();         while (true) {}  // Writes then reads random data to entire FRAM.
@@ -201,6 +217,7 @@ void setup() {
   // WARNING: Instantiating Message class hangs the system if hardware is not connected.
   pMessage = new Message;  // C++ quirk: no parens in ctor call if no parms; else thinks it's fn decl'n.
   pMessage->begin(&Serial2, SERIAL2_SPEED);
+  noteHeapUsed(F("Message"));
 
   // *** INITIALIZE CENTIPEDE SHIFT REGISTER ***
   // WARNING: Instantiating Centipede class hangs the system if hardware is not connected.
@@ -208,31 +225,38 @@ void setup() {
   pShiftRegister = new Centipede;             // C++ quirk: no parens in ctor call if no parms; else thinks it's fn decl'n.
   pShiftRegister->begin();                    // Set all registers to default.
   pShiftRegister->initializePinsForOutput();  // Set all Centipede shift register pins to OUTPUT for Occupancy LEDs
+  noteHeapUsed(F("Centipede"));
   
   // *** INITIALIZE TURNOUT RESERVATION CLASS AND OBJECT ***  (Heap uses 9 bytes)
    pTurnoutReservation = new Turnout_Reservation;  // C++ quirk: no parens in ctor call if no parms; else thinks it's fn decl'n.
    pTurnoutReservation->begin(pStorage);
+   noteHeapUsed(F("Turnout_Reservation"));
 
   // *** INITIALIZE SENSOR-BLOCK CROSS REFERENCE CLASS AND OBJECT *** (Heap uses 9 bytes)
   pSensorBlock = new Sensor_Block;  // C++ quirk: no parens in ctor call if no parms; else thinks it's fn decl'n.
   pSensorBlock->begin(pStorage);
+  noteHeapUsed(F("Sensor_Block"));
 
   // *** INITIALIZE BLOCK RESERVATION CLASS AND OBJECT *** (Heap uses 26 bytes)
   pBlockReservation = new Block_Reservation;  // C++ quirk: no parens in ctor call if no parms; else thinks it's fn decl'n.
-  pBlockReservation->begin(pStorage);
+  pBlockReservation->begin(pStorage, nullptr);  // OCC doesn't keep an Event_Journal
+  noteHeapUsed(F("Block_Reservation"));
 
   // *** INITIALIZE LOCOMOTIVE REFERENCE TABLE CLASS AND OBJECT *** (Heap uses 81 bytes)
   pLoco = new Loco_Reference;  // C++ quirk: no parens in ctor call if no parms; else thinks it's fn decl'n.
   pLoco->begin(pStorage);
+  noteHeapUsed(F("Loco_Reference"));
 
   // *** INITIALIZE ROUTE REFERENCE CLASS AND OBJECT ***  (Heap uses 177 bytes)
   pRoute = new Route_Reference;  // C++ quirk: no parens in ctor call if no parms; else thinks it's fn decl'n.
   pRoute->begin(pStorage);
+  noteHeapUsed(F("Route_Reference"));
 
-  // *** INITIALIZE TRAIN PROGRESS CLASS AND OBJECT ***  (Heap uses 14,552 bytes)
+  // *** INITIALIZE TRAIN PROGRESS CLASS AND OBJECT ***  (QuadRAM arena uses about 14.5K)
   // WARNING: TRAIN PROGRESS MUST BE INSTANTIATED *AFTER* BLOCK RESERVATION AND ROUTE REFERENCE.
   pTrainProgress = new Train_Progress;  // C++ quirk: no parens in ctor call if no parms; else thinks it's fn decl'n.
   pTrainProgress->begin(pBlockReservation, pRoute);
+  noteHeapUsed(F("Train_Progress"));
 
   // *** INITIALIZE 8-CHAR ALPHANUMERIC LED DISPLAY CLASS AND OBJECT ***
   pAlphaNumDisplay = new QuadAlphaNum;
@@ -243,16 +267,26 @@ void setup() {
   pAlphaNumDisplay->writeToBackpack(alphaString); delay(1000);  // Test message at startup for just one second
   sprintf(alphaString, "        ");
   pAlphaNumDisplay->writeToBackpack(alphaString);  // Clear 8-char a/n LED display
+  noteHeapUsed(F("QuadAlphaNum"));
 
   // *** INITIALIZE ROTARY PROMPT CLASS THAT INCLUDES THE ROTARY ENCODER AND USES THE 8-CHAR ALPHA DISPLAY ***
   pRotaryEncoderPrompter = new Rotary_Prompt;
   pRotaryEncoderPrompter->begin(pAlphaNumDisplay);  // Pass this class a pointer to the 8-char alphanumeric LED display.
+  noteHeapUsed(F("Rotary_Prompt"));
   // begin() inits our Static Block array, Sensor Status array, and Block Status arrays.
 
   // *** INITIALIZE OCCUPANY LED CLASS FOR WHITE AND RED/BLUE CONTROL PANEL LEDs ***
   // WARNING: OCCUPANCY LED MUST BE INSTANTIATED *AFTER* TRAIN PROGRESS
   pOccupancyLEDs = new Occupancy_LEDs;
   pOccupancyLEDs->begin(pTrainProgress);
+  noteHeapUsed(F("Occupancy_LEDs"));
+
+  // *** INITIALIZE LOOP PROFILER CLASS AND OBJECT ***  (QuadRAM arena uses 800 bytes)
+  pProfiler = new Loop_Profiler;  // C++ quirk: no parens in ctor call if no parms; else thinks it's fn decl'n.
+  pProfiler->begin();
+  noteHeapUsed(F("Loop_Profiler"));
+
+  memoryMap();  // Where everything ended up in internal SRAM and QuadRAM; warns if QuadRAM is nearly full.
 
 }  // End of setup()
 
@@ -264,6 +298,17 @@ void loop() {
 
     haltIfHaltPinPulledLow();  // If someone has pulled the Halt pin low, just stop
 
+  // While STOPPED, the operator can type M in the Serial monitor for a memory report, or P for the last Auto/Park session's loop
+  // timings.
+  if (Serial.available()) {
+    char serialCommand = Serial.read();
+    if ((serialCommand == 'M') || (serialCommand == 'm')) {
+      memoryReport();
+    } else if ((serialCommand == 'P') || (serialCommand == 'p')) {
+      pProfiler->display();
+    }
+  }
+
   // **************************************************************
   // ***** SUMMARY OF MESSAGES RECEIVED & SENT BY THIS MODULE *****
   // ***** REV: 02/22/24                                      *****
@@ -849,21 +894,38 @@ void OCCAutoParkMode() {
   // OCC: Upon starting Auto/Park, all white and red/blue LEDs will be dark, so paint them now to reflect what we know from Reg'n:
   pOccupancyLEDs->paintAllOccupancySensorLEDs(modeCurrent, stateCurrent);
   pOccupancyLEDs->paintAllBlockOccupancyLEDs();
+  pProfiler->reset();  // Timings are per Auto/Park session
+  pLCD2004->setQueued(true);  // println() only queues lines now; service() below sends them to the LCD a few chars at a time
 
   do {  // Operate in Auto/Park until mode == STOPPED
 
+    Loop_Timer passTimer(pProfiler, LOOP_STAGE_PASS);  // Times this whole pass, until the end of the do { } block.
+
     // Perform any tasks that must be done REGULARLY, *outside* of specific Message commands (Route, Sensor, Mode):
 
     // ALL: If someone has pulled the Halt pin low, just stop
     haltIfHaltPinPulledLow();
 
+    // ALL: Send the next few changed chars to the LCD, if any; never waits
+    {
+      Loop_Timer timer(pProfiler, LOOP_STAGE_DISPLAY);
+      pLCD2004->service();
+    }
+
     // See if there is an incoming message for us...could be ' ', Sensor, Route, or Mode message (others ignored)
-    msgType = pMessage->available();  // msgType ' ' (blank) indicates no message
+    {
+      Loop_Timer timer(pProfiler, LOOP_STAGE_MESSAGES);
+      msgType = pMessage->available();  // msgType ' ' (blank) indicates no message
+    }
 
     // ***** ROUTE MESSAGE *****
 
     if (msgType == 'R') {  // Rev: 09-08-24.  We've got a new Route to add to Train Progress!
 
+      // Everything we do with the Route counts as Train Progress time, *including* the Serial dumps and LED painting, which are
+      // also timed on their own.
+      Loop_Timer routeTimer(pProfiler, LOOP_STAGE_TRAIN_PROGRESS);
+
 // Test with a new route that begins in Reverse as well as with a Continuation route that should change the penultimate VL (VL01)
 // command to the block's default speed for that direction, and adds records and updates the pointers as expected. *****************************************************
 
@@ -874,21 +936,27 @@ void OCCAutoParkMode() {
       byte tempTPPointer = pTrainProgress->stopPtr(locoNum);  // Element number, not a sensor number
 
       // Debug code to dump Train Progress for locoNum, before adding the Extension or Continuation route
-      sprintf(lcdString, "T.P. loco %i BEFORE", locoNum); Serial.println(lcdString);
-      pTrainProgress->display(locoNum);
+      {
+        Loop_Timer timer(pProfiler, LOOP_STAGE_DISPLAY);
+        sprintf(lcdString, "T.P. loco %i BEFORE", locoNum); Serial.println(lcdString);
+        pTrainProgress->display(locoNum);
+      }
 
       //   Add elements of the new Route to Train Progress.  Also updates pointers, isParked, timeToStart (but not isParked)
       if (extOrCont == ROUTE_TYPE_EXTENSION) {
         // Add this extension route to Train Progress (our train is currently stopped.)
-        pTrainProgress->addExtensionRoute(locoNum, routeRecNum, countdown);
+        pTrainProgress->addExtensionRoute(locoNum, routeRecNum, (unsigned long)countdown * 1000UL);  // Message carries seconds
       } else if (extOrCont == ROUTE_TYPE_CONTINUATION) {
         // Add this continuation route to Train Progress (our train is currently moving.)
         pTrainProgress->addContinuationRoute(locoNum, routeRecNum);
       }
 
       // Debug code to dump Train Progress for locoNum, after adding the Extension or Continuation route
-      sprintf(lcdString, "T.P. loco %i AFTER", locoNum); Serial.println(lcdString);
-      pTrainProgress->display(locoNum);
+      {
+        Loop_Timer timer(pProfiler, LOOP_STAGE_DISPLAY);
+        sprintf(lcdString, "T.P. loco %i AFTER", locoNum); Serial.println(lcdString);
+        pTrainProgress->display(locoNum);
+      }
 
       // Point to first element beyond the OLD stopPtr (glad we saved that at the top of this block of code!)
       tempTPPointer = pTrainProgress->incrementTrainProgressPtr(tempTPPointer);
@@ -930,7 +998,10 @@ void OCCAutoParkMode() {
       // OCC: Re-paint Control Panel RED/BLUE BLOCK OCCUPANCY LEDs to include the new Blocks as RED/Reserved (unless Occupied.)
       //   RED = RESERVED, BLUE = OCCUPIED.
       //   No need to re-paint the white occupancy sensor LEDs when a new Route is received as they won't have changed.
-      pOccupancyLEDs->paintAllBlockOccupancyLEDs();  // Note that this re-paints all Block LEDs, not just for this loco.
+      {
+        Loop_Timer timer(pProfiler, LOOP_STAGE_LEDS);
+        pOccupancyLEDs->paintAllBlockOccupancyLEDs();  // Only re-scans this loco's Train Progress, but re-paints all Block LEDs.
+      }
 
     }  // End of "we received a new Route" message
 
@@ -938,6 +1009,9 @@ void OCCAutoParkMode() {
 
     else if (msgType == 'S') {  // Rev: 09-08-24.  We got a Sensor-change message in Auto/Park mode
 
+      // As with Routes, the LED painting below is timed on its own *and* counts as Train Progress time.
+      Loop_Timer sensorTimer(pProfiler, LOOP_STAGE_TRAIN_PROGRESS);
+
       // Get the Sensor Trip/Clear sensorNum and Tripped/Cleared.
       pMessage->getSNStoALLSensorStatus(&sensorNum, &trippedOrCleared);
 
@@ -1205,7 +1279,8 @@ void OCCAutoParkMode() {
 // code above (same for LEG.)  Don't want duplicate comments above and in the code. ********************************************************************************
 
         // We *could* have tracked all blocks between the old Next-To-Trip and the new Next-To-Trip and changed from Reserved to
-        // Occuped, but instead we'll let paintAllBlockOccupancyLEDs() do that by scanning the whole table.
+        // Occuped, but instead we'll let paintAllBlockOccupancyLEDs() do that by re-scanning this loco's table (setNextToTripPtr()
+        // flags it as changed.)
         // Similarly, MAS *could* have thrown turnouts between the old Next-To-Trip and the new Next-To-Trip, but again, I think it
         // might be easier just to scan the whole Train Progress table for this loco and throw as needed.
 
@@ -1279,10 +1354,13 @@ void OCCAutoParkMode() {
       //   *** EITHER TRIP OR CLEAR ***  Rev: 09-06-24.
       // OCC: Update our internal Occupancy LED array that keeps track of sensor status (OCC ONLY.)
       pOccupancyLEDs->updateSensorStatus(sensorNum, trippedOrCleared);  // Does not illuminate any LEDs, just tracks status.
-      // Regardless of Tripped or Cleared, re-paint the Control Panel WHITE OCCUPANCY SENSOR LEDs
-      pOccupancyLEDs->paintAllOccupancySensorLEDs(modeCurrent, stateCurrent);
-      // Regardless of Tripped or Cleared, re-paint the Control Panel RED/BLUE BLOCK OCCUPANCY LEDs.
-      pOccupancyLEDs->paintAllBlockOccupancyLEDs();
+      {
+        Loop_Timer timer(pProfiler, LOOP_STAGE_LEDS);
+        // Regardless of Tripped or Cleared, re-paint the Control Panel WHITE OCCUPANCY SENSOR LEDs
+        pOccupancyLEDs->paintAllOccupancySensorLEDs(modeCurrent, stateCurrent);
+        // Regardless of Tripped or Cleared, re-paint the Control Panel RED/BLUE BLOCK OCCUPANCY LEDs.
+        pOccupancyLEDs->paintAllBlockOccupancyLEDs();
+      }
 
     }  // End of "we received a Senor tripped or cleared" message
 
@@ -1310,6 +1388,9 @@ void OCCAutoParkMode() {
 
   // Perform any tasks that must be done ONCE, *after* our main Auto/Park loop...
 
+  pProfiler->display();  // Loop stage timings for this session.
+  pLCD2004->setQueued(false);  // Waits for any queued lines to be shown, then println() writes directly again
+
   // OCC: Turn off all WHITE, RED, and BLUE control panel LEDs.
   pOccupancyLEDs->darkenAllOccupancySensorLEDs();  // Turn off all WHITE LEDs
   pOccupancyLEDs->paintOneBlockOccupancyLED(0);    // Sending 0 will turn off all RED/BLUE LEDs
@@ -280,7 +280,7 @@ void setup() {
 
   // *** INITIALIZE BLOCK RESERVATION CLASS AND OBJECT *** (Heap uses 26 bytes)
   pBlockReservation = new Block_Reservation;  // C++ quirk: no parens in ctor call if no parms; else thinks it's fn decl'n.
-  pBlockReservation->begin(pStorage);
+  pBlockReservation->begin(pStorage, nullptr);  // No Event_Journal
 
   // *** INITIALIZE LOCOMOTIVE REFERENCE TABLE CLASS AND OBJECT *** (Heap version saves 73 bytes SRAM)
   // Quirk about C++: NO PARENTHESES in the constructor call if there are no params; else thinks it's a function declaration!
@@ -303,7 +303,7 @@ void setup() {
 
   // *** INITIALIZE ENGINEER CLASS AND OBJECT ***
   pEngineer = new Engineer;  // Create the instance of this class.  NO PARENS SINCE NO PARMS!
-  pEngineer->begin(pLoco, pTrainProgress, pDelayedAction);
+  pEngineer->begin(pLoco, pTrainProgress, pDelayedAction, nullptr);  // No Event_Journal
 
   // *** SET THE TIMER INTERRUPT TO FIRE EVERY 1ms ***
   // We'll be using TimerOne 1ms interrupts to count the number of quarter revs of the roller bearing during our decel tests.
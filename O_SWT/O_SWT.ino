@@ -1,5 +1,12 @@
-// O_SWT.INO Rev: 06/22/24.  Finished but not tested.
+// O_SWT.INO Rev: 10/19/26.  Finished but not tested.
 // SWT receives Set Turnout messages from MAS to throw turnout solenoids, regardless of Mode or State.
+// 10/19/26: Turnout command buffer moved to the Turnout_Cmd_Buf class (shared with LED), which coalesces superseded commands.
+// 10/19/26: Fire up to TURNOUTS_TO_FIRE_AT_ONCE turnout solenoids simultaneously, rather than one at a time.  A 12-turnout route
+//   used to take 12 x 110ms = 1.3 seconds to line; with 3 at once it's about 0.45 seconds.  Each solenoid is released on its own
+//   after TURNOUT_ACTIVATION_MS.  Commands are still started in the order received, and a command for a turnout whose solenoid is
+//   still energized waits until it has been released, so commands for the same turnout stay in order and we never energize both
+//   the Normal and Reverse coils of one turnout.  Displays how long each batch of turnout commands took to complete.  Since SWT
+//   doesn't watch for mode changes, the buffer stats and slowest batch so far go to the Serial monitor after every batch.
 // NOTE regarding turnout numbers: Turnout numbers 1..32 correspond to Centipede pins 0..31.
 // All modules (other than SWT and BTN internally) refer to Turnout numbers and Button numbers starting at 1, not 0.
 
@@ -19,7 +26,7 @@
 #include <Train_Consts_Global.h>
 #include <Train_Functions.h>
 const byte THIS_MODULE = ARDUINO_SWT;  // Global needed by Train_Functions.cpp and Message.cpp functions.
-char lcdString[LCD_WIDTH + 1] = "SWT 06/22/24";  // Global array holds 20-char string + null, sent to Digole 2004 LCD.
+char lcdString[LCD_WIDTH + 1] = "SWT 10/19/26";  // Global array holds 20-char string + null, sent to Digole 2004 LCD.
 
 // *** SERIAL LCD DISPLAY CLASS ***
 // #include <Display_2004.h> is already in <Train_Functions.h> so not needed here.
@@ -39,70 +46,32 @@ Centipede* pShiftRegister = nullptr;  // Only need ONE object for one or two Cen
 byte turnoutNum = 0;
 char turnoutDir = ' ';  // 'N'ormal or 'R'everse.  Derived from cmdType.
 
-// Set MAX_TURNOUTS_TO_BUF to be the maximum number of turnout commands that will potentially pile up coming from MAS RS485
-// i.e. could be several routes being assigned in rapid succession when Auto mode is started.  Longest "regular" route has 8
-// turnouts, so conceivable we could get routes for maybe 10 trains = 80 records to buffer, maximum ever conceivable.
-// If we overflow the buffer, we can easily increase the size by increasing this variable.
-// The reason we need to buffer is because we take a (relatively) long time to throw each turnout, whereas the RS485 messages
-// can flood in very quickly.
-const byte MAX_TURNOUTS_TO_BUF            =  80;  // How many turnout commands might pile up before they can be executed?
 const unsigned long TURNOUT_ACTIVATION_MS = 110;  // How many milliseconds to hold turnout solenoids before releasing.
+// TURNOUTS_TO_FIRE_AT_ONCE (Train_Consts_Global.h, shared with LED) must not exceed the number of solenoids our turnout power
+// supply can hold at once.  Set it to 1 to return to the original one-at-a-time behavior.
 #include <avr/wdt.h>     // Required to call wdt_reset() for watchdog timer for turnout solenoids
 
-// ******************************************************************************************************************
-// ************* PROBABLY MOVE THIS INTO ITS OWN CLASS, BUT THIS IS FROM THE ORIGINAL CODE THAT WORKS ***************
-// ******************************************************************************************************************
-
-// DESCRIPTION OF CIRCULAR BUFFERS Rev: 9/5/17.  See also OneNote "Circular Buffers 8/20/17."
-// Each element is two bytes: byte turnoutNum and char turnoutDir.
-// We use CLOCKWISE circular buffers, and track HEAD, TAIL, and COUNT.
-// COUNT is needed for checking if the buffer is empty or full, and must be updated by both ENQUEUE and DEQUEUE.  The advantage of
-// this method is that we can use all available elements of the buffer, and the math (modulo) is simpler than having just two
-// variables, but we must maintain the third COUNT variable.
-// Here is an example of a buffer showing storage of Data and Junk.
-// HEAD always points to the unused cell where the next new element will be enqueued, UNLESS THE BUFFER IS FULL, in which case HEAD
-// points to TAIL and data cannot be added.
-// TAIL always points to the last active element, UNLESS THE BUFFER IS FULL.
-// HEAD == TAIL both when the buffer is FULL *and* when it is EMPTY.
-// We must examine COUNT to determine whether the buffer is FULL or EMPTY.
-// New elements are added at the HEAD, which then moves to the right.
-// Old elements are read from the TAIL, which also then moves to the right.
-// HEAD, TAIL, and COUNT are initialized to zero.
-
-//    0     1     2     3     4     5
-//  ----- ----- ----- ----- ----- -----
-// |  D  |  D  |  J  |  J  |  D  |  D  |
-//  ----- ----- ----- ----- ----- -----
-//                ^           ^
-//                HEAD        TAIL
-
-// HEAD always points to the UNUSED cell where the next new element will be inserted (enqueued), UNLESS the queue is full,
-// in which case head points to tail and new data cannot be added until the tail data is dequeued.
-// TAIL always points to the last active element, UNLESS the queue is empty, in which case it points to garbage.
-// COUNT is the total number of active elements, which can range from zero to the size of the buffer.
-// Initialize head, tail, and count to zero.
-// To enqueue an element, if array is not full, insert data at HEAD, then increment both HEAD and COUNT.
-// To dequeue an element, if array is not empty, read data at TAIL, then increment TAIL and decrement COUNT.
-// Always incrment HEAD and TAIL pointers using MODULO addition, based on the size of the array.
-// Note that HEAD == TAIL *both* when the buffer is empty and when full, so we use COUNT as the test for full/empty status.
-// IsEmpty = (COUNT == 0)
-// IsFull  = (COUNT == SIZE)
-
-// IMPORTANT: LARGE AMOUNTS OF THIS CODE ARE IDENTIAL IN SWT/LED, SO ALWAYS UPDATE ONE WHEN WE MAKE CHANGES TO THE OTHER, IF NEEDED.
-
 // *** TURNOUT COMMAND BUFFER...
-// Create a circular buffer to store incoming RS485 "set turnout" commands from A-MAS.
-byte turnoutCmdBufHead = 0;    // Next array element to be written.
-byte turnoutCmdBufTail = 0;    // Next array element to be removed.
-byte turnoutCmdBufCount = 0;   // Num active elements in buffer.  Max is MAX_TURNOUTS_TO_BUF.
-struct turnoutCmdBufStruct {
-  byte turnoutNum;             // 1..TOTAL_TURNOUTS
-  char turnoutDir;             // 'N' = TURNOUT_DIR_NORMAL for Normal, 'R' = TURNOUT_DIR_REVERSE for Reverse
+// Circular buffer to store incoming RS485 "set turnout" commands from A-MAS, shared with LED.  Coalesces superseded commands.
+#include <Turnout_Cmd_Buf.h>
+Turnout_Cmd_Buf* pTurnoutCmdBuf = nullptr;
+
+// *** TURNOUT FIRING SLOTS...
+// One slot for each solenoid that may be energized at the same time.  turnoutNum == 0 means the slot is idle.
+struct turnoutFiringStruct {
+  byte turnoutNum;               // 1..TOTAL_TURNOUTS, or 0 if this slot isn't energizing a solenoid
+  byte relayBit;                 // Centipede bit that is energizing it, so we can release just that one relay
+  unsigned long activationTime;  // Keeps track of *when* the turnout coil was energized
 };
-turnoutCmdBufStruct turnoutCmdBuf[MAX_TURNOUTS_TO_BUF];
+turnoutFiringStruct turnoutFiring[TURNOUTS_TO_FIRE_AT_ONCE];
 
-bool turnoutClosed  = false;  // Keeps track if relay coil is currently energized, so we know to check if it should be released
-unsigned long turnoutActivationTime = millis();  // Keeps track of *when* a turnout coil was energized
+// *** ROUTE SETUP TIMING...
+// A "batch" begins when a turnout command arrives while SWT is idle, and ends when the buffer is empty and all solenoids have
+// been released.  That's how long MAS's route took to be lined, which is what we're trying to reduce.
+bool          turnoutBatchActive    = false;
+unsigned long turnoutBatchStartTime = 0;
+byte          turnoutBatchCount     = 0;  // Number of turnouts thrown in this batch
+unsigned long turnoutBatchWorstMs   = 0;  // Slowest batch since reset, reported on Serial after each batch
 
 // *** TURNOUT CROSS REFERENCE...
 // 10/25/16: Unique to A-SWT is a cross-reference array that gives a Centipede shift register bit number 0..127 for a corresponding
@@ -143,6 +112,10 @@ void setup() {
   pMessage = new Message;  // C++ quirk: no parens in ctor call if no parms; else thinks it's fn decl'n.
   pMessage->begin(&Serial2, SERIAL2_SPEED);
 
+  // *** INITIALIZE TURNOUT COMMAND BUFFER CLASS AND OBJECT ***
+  pTurnoutCmdBuf = new Turnout_Cmd_Buf;  // C++ quirk: no parens in ctor call if no parms; else thinks it's fn decl'n.
+  pTurnoutCmdBuf->begin();
+
   // *** INITIALIZE CENTIPEDE SHIFT REGISTER ***
   // WARNING: Instantiating Centipede class hangs the system if hardware is not connected.
   Wire.begin();                               // Join the I2C bus as a master for Centipede shift register.
@@ -150,6 +123,10 @@ void setup() {
   pShiftRegister->begin();                    // Set all registers to default.
   pShiftRegister->initializePinsForOutput();  // Set all Centipede shift register pins to OUTPUT for Turnout Solenoids.
 
+  for (byte i = 0; i < TURNOUTS_TO_FIRE_AT_ONCE; i++) {
+    turnoutFiring[i].turnoutNum = 0;  // All firing slots are idle
+  }
+
   // *** INITIALIZE WATCHDOG TIMER ***
   wdtSetup();                                 // Set up the watchdog timer to prevent solenoids from burning out
 
@@ -197,7 +174,12 @@ void loop() {
         pMessage->getMAStoALLTurnout(&turnoutNum, &turnoutDir);
         sprintf(lcdString, "Rec'd: %i %c", turnoutNum, turnoutDir); pLCD2004->println(lcdString); Serial.println(lcdString);
         // Add the turnout command to the circular buffer for later processing...
-        turnoutCmdBufEnqueue(turnoutNum, turnoutDir);
+        pTurnoutCmdBuf->enqueue(turnoutNum, turnoutDir);
+        if (!turnoutBatchActive) {  // First command since we were last idle, so start timing a new batch
+          turnoutBatchActive = true;
+          turnoutBatchStartTime = millis();
+          turnoutBatchCount = 0;
+        }
         break;
       default:
         sprintf(lcdString, "MSG TYPE ERROR!"); pLCD2004->println(lcdString); Serial.println(lcdString); endWithFlashingLED(1);
@@ -207,29 +189,27 @@ void loop() {
 
   // We have handled any incoming message.
 
-  // Continuously check the Turnout Command Buffer to see if a turnout needs to be thrown, but once one is thrown, don't throw
-  // another until the first one has been released.  Having a command buffer allows us to accept Turnout commands from MAS faster
-  // than we can throw them.
-  // So we throw the first turnout immediately, but each successive turnout throws one at a time.
-  // Depending on whether or not a turnout solenoid is currently being activated, we want to either:
-  //   1. If a relay is currently energized, see if it's time to release it yet, or
-  //   2. Check if there is a new turnout to throw (from the turnout command buffer) and, if so, close a new relay.
-
-  if (turnoutClosed) {  // A solenoid is being energized -- see if it's been long enough that we can release it
-    // Keep the above and below "if" statements separate (not joined by &&), so we only do "else" if an energized solenoid gets
-    // released.
-    if ((millis() - turnoutActivationTime) > TURNOUT_ACTIVATION_MS) {   // Long enough, we can release it!
-      pShiftRegister->initializePinsForOutput();  // Just release all relays, no need to identify the one that's activated.
-      turnoutClosed = false;  // No longer energized, happy days.
-    }
-  } else {   // Only if relays are all open can we check for a new turnout command and potentially close a new relay.
-    if (turnoutCmdBufProcess()) {    // Return of true means that we found a new turnout command in the buffer, and just energized a relay/solenoid...
-      turnoutClosed = true;
-      turnoutActivationTime = millis();
+  // Continuously check the Turnout Command Buffer to see if a turnout needs to be thrown.  Having a command buffer allows us to
+  // accept Turnout commands from MAS faster than we can throw them.
+  // We can have up to TURNOUTS_TO_FIRE_AT_ONCE solenoids energized at once, each in its own firing slot.  Each time through:
+  //   1. Release any energized relay that has been held for TURNOUT_ACTIVATION_MS, freeing its slot, and then
+  //   2. Start throwing new turnouts from the turnout command buffer for as long as there are free slots.
+  turnoutFiringRelease();
+  while (turnoutCmdBufProcess()) {}  // Returns false when there are no free slots, nothing to throw, or next must wait.
+
+  // If the buffer is empty and nothing is energized, the batch of turnout commands is complete.
+  if (turnoutBatchActive && pTurnoutCmdBuf->isEmpty() && turnoutFiringIsIdle()) {
+    turnoutBatchActive = false;
+    unsigned long batchMs = millis() - turnoutBatchStartTime;
+    if (batchMs > turnoutBatchWorstMs) {
+      turnoutBatchWorstMs = batchMs;
     }
+    sprintf(lcdString, "Set %i %lums", turnoutBatchCount, batchMs); pLCD2004->println(lcdString); Serial.println(lcdString);
+    pTurnoutCmdBuf->displayStats();
+    Serial.print(F("Slowest turnout batch: ")); Serial.print(turnoutBatchWorstMs); Serial.println(F("ms"));
   }
 
-  // We know that if we get here, we just checked that if a turnout was closed, it was released if sufficient time has elapsed.
+  // We know that if we get here, we just checked that any closed turnout was released if sufficient time has elapsed.
   // So this is a safe place to reset the watchdog counter.
   wdt_reset();
 
@@ -239,54 +219,25 @@ void loop() {
 // ************************ F U N C T I O N   D E F I N I T I O N S ************************
 // *****************************************************************************************
 
-bool turnoutCmdBufIsEmpty() {
-  return (turnoutCmdBufCount == 0);
-}
-
-bool turnoutCmdBufIsFull() {
-  return (turnoutCmdBufCount == MAX_TURNOUTS_TO_BUF);
-}
-
-void turnoutCmdBufEnqueue(const byte t_turnoutNum, const char t_turnoutDir) {
-  // Insert a record at the head of the turnout command buffer, then increment head and count.
-  // If the buffer is already full, trigger a fatal error and terminate.
-  if (!turnoutCmdBufIsFull()) {
-    turnoutCmdBuf[turnoutCmdBufHead].turnoutNum = t_turnoutNum;  // Store the turnout number 1..TOTAL_TURNOUTS
-    turnoutCmdBuf[turnoutCmdBufHead].turnoutDir = t_turnoutDir;  // Store the orientation Normal or Reverse
-    turnoutCmdBufHead = (turnoutCmdBufHead + 1) % MAX_TURNOUTS_TO_BUF;
-    turnoutCmdBufCount++;
-  } else {
-    sprintf(lcdString, "Turnout buf ovflow!");
-    pLCD2004->println(lcdString);
-    Serial.println(lcdString);
-    endWithFlashingLED(3);
-  }
-  return;
-}
-
-bool turnoutCmdBufDequeue(byte * t_turnoutNum, char * t_turnoutDir) {
-  // Retrieve a record, if any, from the turnout command buffer.
-  // If the turnout command buffer is not empty, retrieves a record from the buffer, clears it, and puts the
-  // retrieved data into the called parameters.
-  // Returns 'false' if buffer is empty, and the passed parameters remain undefined.  Not fatal.
-  // Data will be at tail, then tail will be incremented (modulo size), and count will be decremented.
-  if (!turnoutCmdBufIsEmpty()) {
-    * t_turnoutNum = turnoutCmdBuf[turnoutCmdBufTail].turnoutNum;
-    * t_turnoutDir = turnoutCmdBuf[turnoutCmdBufTail].turnoutDir;
-    turnoutCmdBufTail = (turnoutCmdBufTail + 1) % MAX_TURNOUTS_TO_BUF;
-    turnoutCmdBufCount--;
-    return true;
-  } else {
-    return false;  // Turnout command buffer is empty
-  }
-}
-
 bool turnoutCmdBufProcess() {   // Special version for SWT, not the same as used by LED.
-  // See if there is a record in the turnout command buffer, and if so, retrieve it and activate the relay/solenoid.
+  // Rev: 10/19/26.  Fire into a free firing slot rather than assuming nothing else is energized.
+  // See if there is a free firing slot and a record in the turnout command buffer, and if so, retrieve it and activate the
+  // relay/solenoid.  If the next command is for a turnout that is already being energized, leave it in the buffer until that
+  // turnout's solenoid has been released; we don't look past it so commands are always started in the order received.
   // Only closes relay; does not release.  Returns true if a relay was energized, false if no action taken.
   byte t_turnoutNum = 0;
   char t_turnoutDir = ' ';
-  if (turnoutCmdBufDequeue(&t_turnoutNum, &t_turnoutDir)) {   // Nothing previously activated, is there one to throw now?
+  byte slot = turnoutFiringFreeSlot();
+  if (slot == TURNOUTS_TO_FIRE_AT_ONCE) {  // All slots are busy
+    return false;
+  }
+  if (!pTurnoutCmdBuf->peek(&t_turnoutNum, &t_turnoutDir)) {  // Nothing to throw
+    return false;
+  }
+  if (turnoutFiringIsBusy(t_turnoutNum)) {  // Wait until this turnout's previous throw is complete
+    return false;
+  }
+  if (pTurnoutCmdBuf->dequeue(&t_turnoutNum, &t_turnoutDir)) {   // We know there is one to throw now.
     // If function returned true, we have a new turnout to throw!
     int bitToWrite = 0;
     // Activate the turnout solenoid by turning on the relay coil connected to the Centipede shift register.
@@ -311,12 +262,62 @@ bool turnoutCmdBufProcess() {   // Special version for SWT, not the same as used
       endWithFlashingLED(3);   // error!
     }
     pShiftRegister->digitalWrite(bitToWrite, LOW);  // turn on the relay
-    return true;    // So we will know that we need to turn it off
+    turnoutFiring[slot].turnoutNum = t_turnoutNum;  // So we will know that we need to turn it off
+    turnoutFiring[slot].relayBit = bitToWrite;
+    turnoutFiring[slot].activationTime = millis();
+    turnoutBatchCount++;
+    return true;
   } else {   // We did not retrieve a new turnout throw command and thus did not activate a relay
     return false;
   }
 }
 
+byte turnoutFiringFreeSlot() {
+  // Rev: 10/19/26.
+  // Returns the index of an idle firing slot, or TURNOUTS_TO_FIRE_AT_ONCE if all are busy.
+  for (byte i = 0; i < TURNOUTS_TO_FIRE_AT_ONCE; i++) {
+    if (turnoutFiring[i].turnoutNum == 0) {
+      return i;
+    }
+  }
+  return TURNOUTS_TO_FIRE_AT_ONCE;
+}
+
+bool turnoutFiringIsBusy(const byte t_turnoutNum) {
+  // Rev: 10/19/26.
+  // Returns true if either solenoid of this turnout is currently energized.
+  for (byte i = 0; i < TURNOUTS_TO_FIRE_AT_ONCE; i++) {
+    if (turnoutFiring[i].turnoutNum == t_turnoutNum) {
+      return true;
+    }
+  }
+  return false;
+}
+
+bool turnoutFiringIsIdle() {
+  // Rev: 10/19/26.
+  // Returns true if no solenoids are energized.
+  for (byte i = 0; i < TURNOUTS_TO_FIRE_AT_ONCE; i++) {
+    if (turnoutFiring[i].turnoutNum != 0) {
+      return false;
+    }
+  }
+  return true;
+}
+
+void turnoutFiringRelease() {
+  // Rev: 10/19/26.
+  // Release each energized relay that has been held long enough, and free its slot.  Since other solenoids may still be
+  // energized, we release just this relay rather than calling initializePinsForOutput() (which releases them all.)
+  for (byte i = 0; i < TURNOUTS_TO_FIRE_AT_ONCE; i++) {
+    if ((turnoutFiring[i].turnoutNum != 0) && ((millis() - turnoutFiring[i].activationTime) > TURNOUT_ACTIVATION_MS)) {
+      pShiftRegister->digitalWrite(turnoutFiring[i].relayBit, HIGH);  // turn off the relay
+      turnoutFiring[i].turnoutNum = 0;  // No longer energized, happy days.
+    }
+  }
+  return;
+}
+
 void wdtSetup() {
   // A watchdog timer is a hardware timer that automatically generates a system reset if the main program neglects to periodically
   // service it.  We use the function wdt_reset() at the end of every loop() to reset the timer.  If somehow we don't make it all
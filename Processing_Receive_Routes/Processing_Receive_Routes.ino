@@ -1,4 +1,6 @@
-// Rev: 08/31/19.  RECEIVE ROUTES FROM PROCESSING AND POPULATE FRAM vis PC Serial/USB
+// Rev: 10/19/26.  RECEIVE ROUTES FROM PC AND POPULATE FRAM vis PC Serial/USB
+// 10/19/26: Replaced the ASCII comma/CR parser with CRC-checked binary frames of whole route records, acked in a sliding window,
+//           and each batch written to FRAM in one burst.  PC side is Send_Routes.py, which reads the route spreadsheet CSV export.
 // DON'T FORGET to write the number of Route Reference records into the control block after they have all been received and written to FRAM! **********************
 const byte FRAM1Version[3]    = {  8, 29, 19 };  // Date will be placed in FRAM1 control block as the first three bytes
       byte FRAM1GotVersion[3] = {  0,  0,  0 };  // This will hold the version retrieved from FRAM1, to confirm matches version above.
@@ -15,8 +17,14 @@ const byte FRAM1Version[3]    = {  8, 29, 19 };  // Date will be placed in FRAM1
 
 const byte MAX_TRAINS = 10; // This is defined in an include, for regular modules.
 
-const byte COMMA  = 44;  // ASCII field separator in serial transmission
-const byte RETURN = 13;  // Carriage Return; ASCII record separator in serial transmission
+// ROUTE FRAME format, PC to Arduino: 'R', seq, numRecs, firstRec lo, firstRec hi, numRecs * sizeof(routeReference) bytes, CRC lo, CRC hi.
+// The CRC is AVR-libc's _crc_ccitt_update() starting from 0xFFFF, over everything after the 'R' up to the CRC.
+// Records are the routeReference struct exactly as laid out in Arduino memory (little-endian, no padding.)
+// numRecs == 0 is the end-of-transmission frame, and then firstRec holds the total number of records sent.
+// Arduino replies 'A', seq when a frame is accepted, or 'N', seq-we-want once when a frame is bad or out of order.
+#include <util/crc16.h>
+const byte          ROUTE_BATCH_RECS       =    4;  // Max route records per frame; must match BATCH_RECS in Send_Routes.py
+const unsigned long ROUTE_FRAME_TIMEOUT_MS = 2000;  // Give up on a partial frame after this long and wait for the PC to re-send
 
 // Route STEPS can be: CM=Comment (comment lines not actually copied to FRAM from the spreadsheet, but also used to pad unused steps),
 //                     Locomotive direction commands: FD=Forward Direction, RD=Reverse Direction,
@@ -115,6 +123,7 @@ struct routeReference {  // Each element is 83 bytes, 310 routes = 25,730 bytes
   routeStep step[FRAM1_ROUTE_MAX_STEPS];  // .step[n]: block/turnout/direction cmd, block or turnout number.  Using a max of 37 as of 8/27/19, so room for expansion.
 };
 routeReference route;    // Use this to hold individual routes when retrieved.
+byte routeBatch[ROUTE_BATCH_RECS * sizeof(routeReference)];  // Holds the records from one received frame
 
 // LAST KNOWN TURNOUT POSITION TABLE.  Stored in FRAM1 control buffer at address FRAM1_ADDR_TURNOUTS (currently address 3.)
 // Only four bytes = 64 bits.  0 = Normal, 1 = Reverse.  We use only 30 bits (30 turnouts) as of 8/19.
@@ -165,70 +174,49 @@ void setup()
 
 #ifdef RECEIVE_ROUTES
 
-  Serial.setTimeout(60000);  // Start this listening program first, then wait up to one minute for Processing program to begin transmitting.
-  // First empty any junk in the incoming serial buffer...
+  // Routes arrive as binary frames from Send_Routes.py (see ROUTE FRAME notes at top.)  The PC keeps up to ROUTE_WINDOW frames in
+  // flight; we ack each good frame in order, and on a bad or out-of-order frame send a single NAK with the sequence number we still
+  // need, then quietly discard frames until that one shows up again.  No LCD updates until the end: sendToLCD() takes long enough
+  // that the 64-byte serial input buffer would overflow while the PC is streaming.
   sprintf(lcdString, "Serial receive mode."); sendToLCD(lcdString);
   while (Serial.available()) { Serial.read(); }
   sprintf(lcdString, "In buf clear."); sendToLCD(lcdString);
+  Serial.setTimeout(ROUTE_FRAME_TIMEOUT_MS);
+  Serial.println("ROUTES READY");
   unsigned int recordNum = 0;  // This will keep track of Route Reference record number, NOT the same as the route number.
-  // Now that we've emptied it, wait until we have a 3-digit ASCII integer followed by a comma...
-  while (Serial.available() < 4) { }  // Wait for first three-digit ROUTE NUMBER plus comma delimiter
-  unsigned int routeNum = Serial.parseInt();
-  sprintf(lcdString, "Got route %03i.", routeNum); sendToLCD(lcdString);
-  byte b[sizeof(routeReference)];  // Will hold char array same as route
-
-  while (routeNum > 0) {  // Receive records until Processing sends route number = 0 to signal end of table.
-    if (Serial.read() != COMMA) { sprintf(lcdString, "Missing comma 1!"); sendToLCD(lcdString); while (true) { } }
-    route.number = routeNum;
-    while (Serial.available() < 5) { }  // Wait until a full step ORIGIN sub-record is in the serial input buffer.  I.e. "BE01,BW13"+c/r
-    // Convert each set of 4 bytes i.e. "BE01" to a 2-byte "step"...
-    char stepType[2];  // Will hold serial-incoming ASCII representation of the step type i.e. "BW"
-    char stepVal[2];   // Will hold serial-incoming ASCII representation of the step value i.e. "03"
-    Serial.readBytes(stepType, 2);  // i.e. "BW"
-    Serial.readBytes(stepVal, 2);   // i.e. "03"
-    route.origin.type = convertCharsToType(stepType);  // type will be i.e. 3 if "BE"
-    route.origin.val = convertCharsToVal(stepVal);     // val will be a byte value of the number i.e. 1 if "01"
-    if (Serial.read() != COMMA) { sprintf(lcdString, "Missing comma 2!"); sendToLCD(lcdString); while (true) { } }
-    while (Serial.available() < 5) { }  // Wait until a full step DESTINATION sub-record is in the serial input buffer.  I.e. "BE01,BW13"+c/r
-    Serial.readBytes(stepType, 2);  // i.e. "BW"
-    Serial.readBytes(stepVal, 2);   // i.e. "03"
-    route.dest.type = convertCharsToType(stepType);
-    route.dest.val = convertCharsToVal(stepVal);
-    if (Serial.read() != COMMA) { sprintf(lcdString, "Missing comma 3!"); sendToLCD(lcdString); while (true) { } }
-    while (Serial.available() < 2) { }  // Wait until a one-digit LEVEL (1 or 2), plus comma, is received.
-    route.levels = (Serial.read() - '0');  // Will be ASCII '1' or '2'
-    if ((route.levels < 1) || (route.levels > 2)) { sprintf(lcdString, "Levels isn't 1 or 2!"); sendToLCD(lcdString); while (true) { } }
-    if (Serial.read() != COMMA) { sprintf(lcdString, "Missing comma 4!"); sendToLCD(lcdString); while (true) { } }
-    while (Serial.available() < 3) { }  // Wait for 2-char priority i.e. "A1", plus comma.  Stored as char + byte, not char + char
-    route.type = Serial.read();  // This will be a char; 'A' or 'P'
-    route.priority = (Serial.read() - '0');  // Received as a char; convert to a byte 1..5
-    // Now read the rest of the route steps.  We already know the first step, which is the origin
-    route.step[0].type = route.origin.type;
-    route.step[0].val = route.origin.val;
-    for (int i = 1; i < (FRAM1_ROUTE_MAX_STEPS); i++) {
-      if (Serial.read() != COMMA) { sprintf(lcdString, "Missing comma 5!"); sendToLCD(lcdString); sprintf(lcdString, "Route %i", routeNum); sendToLCD(lcdString); while (true) { } }
-      while (Serial.available() < 5) { }  // Wait until a full step DESTINATION sub-record is in the serial input buffer.  I.e. "BE01,BW13"+c/r
-      Serial.readBytes(stepType, 2);  // i.e. "BW"
-      Serial.readBytes(stepVal, 2);   // i.e. "03"
-      route.step[i].type = convertCharsToType(stepType);  // type will be i.e. 3 if "BE"
-      route.step[i].val = convertCharsToVal(stepVal);     // val will be a byte value of the number i.e. 1 if "01"
+  byte expectedSeq = 0;        // Sequence number of the next frame we will accept
+  bool nakSent = false;        // Only NAK once per error, else every frame already in flight would rewind the PC again
+  unsigned long startTime = millis();
+  while (true) {
+    byte frameSeq = 0;
+    byte frameRecs = 0;
+    unsigned int frameFirstRec = 0;
+    bool frameOK = receiveRouteFrame(&frameSeq, &frameRecs, &frameFirstRec);
+    if (frameOK && (frameSeq == expectedSeq) && (frameFirstRec == recordNum)) {
+      expectedSeq++;
+      nakSent = false;
+      if (frameRecs == 0) {  // End-of-transmission frame; frameFirstRec is the PC's total record count, which we just matched.
+        Serial.write('A'); Serial.write(frameSeq);
+        break;
+      }
+      // Write the whole batch in one burst; records are contiguous in FRAM so no need to go record by record.
+      unsigned long FRAMAddress = FRAM1_ADDR_ROUTE_START + ((unsigned long)recordNum * FRAM1_ROUTE_REC_LEN);
+      if (FRAM1.writeFerroStream(FRAMAddress, frameRecs * FRAM1_ROUTE_REC_LEN, routeBatch) != ferroOK) {
+        sprintf(lcdString, "FRAM write error!"); sendToLCD(lcdString); while (true) { }
+      }
+      recordNum = recordNum + frameRecs;
+      Serial.write('A'); Serial.write(frameSeq);
+    } else if (!nakSent) {
+      Serial.write('N'); Serial.write(expectedSeq);
+      nakSent = true;
     }
-    // All done receiving a route (or just a route number, if route=0 which is end-of-transmission; the next byte better be a c/r
-    if (Serial.read() != RETURN) { sprintf(lcdString, "Missing C/R!"); sendToLCD(lcdString); while (true) { } }
-    // All done receiving a single route record ("route"); write it to FRAM.
-    unsigned long FRAMAddress = FRAM1_ADDR_ROUTE_START + (recordNum * FRAM1_ROUTE_REC_LEN);
-    memcpy(b, &route, FRAM1_ROUTE_REC_LEN);  // Copy all bytes in the route record
-    FRAM1.write(FRAMAddress, FRAM1_ROUTE_REC_LEN, b);  // (address, number_of_bytes_to_write, data  **** CAN WE JUST WRITE route INSTEAD OF b??? **********************************************
-    // Now get next route number...will be zero if end-of-transmission, else continue ablve
-    while (Serial.available() < 4) { }  // Wait for first three-digit ROUTE NUMBER plus comma delimiter
-    routeNum = Serial.parseInt();
-    sprintf(lcdString, "Got route %03i.", routeNum); sendToLCD(lcdString);
-    recordNum++;
   }
-  // We just received a routeNum = 0, which is how Processing tells us it's done sending data.
-  // We just incremented recordNum, which now would point to the first unused record in FRAM.  But remember, we started with record 0,
-  //   so the (just-incremented) value in recordNum does in fact reflect the final number of records inserted.  I.e. 0..324 -> 325 records.
-  // Since we are updating FRAM with routes (received from Processing), write fresh control block.
+  unsigned long elapsed = millis() - startTime;
+  sprintf(lcdString, "Rcvd in %lu ms.", elapsed); sendToLCD(lcdString);
+  // We just received the end frame, which is how Send_Routes.py tells us it's done sending data.
+  // recordNum now points to the first unused record in FRAM.  But remember, we started with record 0,
+  //   so recordNum does in fact reflect the final number of records inserted.  I.e. 0..324 -> 325 records.
+  // Since we are updating FRAM with routes (received from the PC), write fresh control block.
   for (byte i = 0; i < FRAM1CtrlBlockSize; i++) {
     FRAM1CtrlBuf[i] = 0;
   }
@@ -473,30 +461,29 @@ void initializeFRAM1() {
   return;
 }
 
-byte convertCharsToType(char s[]) {
-  // CM, FD, etc. are defined as CONST BYTE at top of code.  See that for explanation/key to meanings.
-  if ((s[0] == 'C') && (s[1] == 'M')) {         // Comment
-    return CM;  // CM = 0
-  } else if ((s[0] == 'F') && (s[1] == 'D')) {  // Forward Direction
-    return FD;  // FD = 1
-  } else if ((s[0] == 'R') && (s[1] == 'D')) {  // Reverse Direction
-    return RD;  // RD = 2
-  } else if ((s[0] == 'B') && (s[1] == 'E')) {  // Block Eastbound
-    return BE;  // BE = 3
-  } else if ((s[0] == 'B') && (s[1] == 'W')) {  // Block Westbound
-    return BW;  // BW = 4
-  } else if ((s[0] == 'C') && (s[1] == 'N')) {  // Converging Normal turnout
-    return CN;  // CN = 5
-  } else if ((s[0] == 'C') && (s[1] == 'R')) {  // Converging Reverse turnout
-    return CR;  // CR = 6
-  } else if ((s[0] == 'D') && (s[1] == 'N')) {  // Diverging Normal turnout
-    return DN;  // DN = 7
-  } else if ((s[0] == 'D') && (s[1] == 'R')) {  // Diverging Reverse turnout
-    return DR;  // DR = 8
+bool receiveRouteFrame(byte* t_seq, byte* t_numRecs, unsigned int* t_firstRec) {
+  // Rev: 10/19/26.  Wait (forever) for the next 'R' from the PC, then read the rest of the frame into routeBatch[].
+  // Returns false if the frame timed out, was too long, or failed its CRC check.
+  while (true) {
+    while (!Serial.available()) { }
+    if (Serial.read() == 'R') break;  // Anything else is left over from a frame we already gave up on
   }
-  return 0;  // else, error or comment
-}
-
-byte convertCharsToVal(char s[]) {
-  return (((s[0] - '0') * 10) + (s[1] - '0'));
+  byte header[4];
+  if (Serial.readBytes(header, 4) != 4) return false;
+  *t_seq = header[0];
+  *t_numRecs = header[1];
+  *t_firstRec = header[2] + (header[3] << 8);
+  if (*t_numRecs > ROUTE_BATCH_RECS) return false;
+  unsigned int dataLen = *t_numRecs * FRAM1_ROUTE_REC_LEN;
+  if (Serial.readBytes(routeBatch, dataLen) != dataLen) return false;
+  byte crcBytes[2];
+  if (Serial.readBytes(crcBytes, 2) != 2) return false;
+  unsigned int crc = 0xFFFF;
+  for (byte i = 0; i < 4; i++) {
+    crc = _crc_ccitt_update(crc, header[i]);
+  }
+  for (unsigned int i = 0; i < dataLen; i++) {
+    crc = _crc_ccitt_update(crc, routeBatch[i]);
+  }
+  return (crc == (crcBytes[0] + (crcBytes[1] << 8)));
 }
@@ -0,0 +1,171 @@
+# SEND_ROUTES.PY Rev: 10/19/26.
+# PC side of Processing_Receive_Routes (with RECEIVE_ROUTES defined.)  Reads the Route Reference spreadsheet saved as CSV, packs
+# each row into the Arduino's routeReference struct, and streams the records to the Mega over USB serial.
+# Requires Python 3 and pyserial (pip install pyserial).
+#
+#   python Send_Routes.py send  COM3 routes.csv   Send every route in routes.csv to the Mega, which writes them to FRAM.
+#   python Send_Routes.py check routes.csv        Parse routes.csv and report problems, without a Mega.
+#
+# CSV columns, one route per row: route num, origin i.e. BE01, destination i.e. BW13, levels 1|2, type+priority i.e. A1, then up to
+# 39 more route steps i.e. BW13, CN05, FD00 (origin is always step 0.)  Missing steps are padded with CM00.  Rows whose first column
+# is not a number (headings, blank lines) are skipped.
+#
+# Each frame is: 'R', seq, numRecs, firstRec lo, firstRec hi, numRecs records, CRC lo, CRC hi.  The CRC is AVR-libc's
+# _crc_ccitt_update() starting from 0xFFFF, over everything after the 'R'.  numRecs == 0 ends the upload, with firstRec = total.
+# Up to WINDOW frames are sent before waiting for an ack.  The Mega replies 'A', seq for each accepted frame, or 'N', seq to ask
+# us to go back and re-send from that frame.
+
+import csv
+import struct
+import sys
+import time
+
+SERIAL_SPEED = 115200         # Serial.begin() in Processing_Receive_Routes
+MAX_STEPS = 40                # FRAM1_ROUTE_MAX_STEPS
+BATCH_RECS = 4                # ROUTE_BATCH_RECS
+WINDOW = 4                    # Frames in flight before we wait for an ack
+ACK_TIMEOUT = 3               # Seconds; a bit longer than ROUTE_FRAME_TIMEOUT_MS so the Mega gives up on a partial frame first
+RETRIES = 5
+
+STEP_TYPES = {"CM": 0, "FD": 1, "RD": 2, "BE": 3, "BW": 4, "CN": 5, "CR": 6, "DN": 7, "DR": 8}
+ROUTE_FORMAT = "<H2B2BBcB%dB" % (MAX_STEPS * 2)  # routeReference; AVR ints are 2 bytes and structs have no padding
+ROUTE_REC_LEN = struct.calcsize(ROUTE_FORMAT)    # 89
+
+
+def crc_ccitt_update(crc, data):
+    # Same as AVR-libc _crc_ccitt_update().
+    data ^= crc & 0xFF
+    data ^= (data << 4) & 0xFF
+    return ((((data << 8) | (crc >> 8)) ^ (data >> 4) ^ (data << 3)) & 0xFFFF)
+
+
+def frame_crc(data):
+    crc = 0xFFFF
+    for b in data:
+        crc = crc_ccitt_update(crc, b)
+    return crc
+
+
+def parse_step(text, row_num):
+    # "BE01" -> (3, 1).  Same as the old convertCharsToType() and convertCharsToVal() on the Arduino.
+    text = text.strip().upper()
+    if text == "":
+        return (STEP_TYPES["CM"], 0)
+    if (len(text) != 4) or (text[0:2] not in STEP_TYPES) or (not text[2:4].isdigit()):
+        raise ValueError("Row %d: bad route step %r." % (row_num, text))
+    return (STEP_TYPES[text[0:2]], int(text[2:4]))
+
+
+def parse_route(row, row_num):
+    if len(row) < 5:
+        raise ValueError("Row %d: only %d columns." % (row_num, len(row)))
+    number = int(row[0])
+    origin = parse_step(row[1], row_num)
+    dest = parse_step(row[2], row_num)
+    levels = int(row[3])
+    if levels not in (1, 2):
+        raise ValueError("Row %d: levels isn't 1 or 2." % row_num)
+    type_priority = row[4].strip().upper()
+    if (len(type_priority) != 2) or (type_priority[0] not in "AP") or (type_priority[1] not in "12345"):
+        raise ValueError("Row %d: bad type/priority %r." % (row_num, row[4]))
+    steps = [origin] + [parse_step(text, row_num) for text in row[5:]]
+    while (len(steps) > 1) and (steps[-1] == (0, 0)):  # Trailing empty spreadsheet cells
+        steps.pop()
+    if len(steps) > MAX_STEPS:
+        raise ValueError("Row %d: %d route steps; max is %d." % (row_num, len(steps), MAX_STEPS))
+    steps += [(0, 0)] * (MAX_STEPS - len(steps))
+    flat_steps = [b for step in steps for b in step]
+    return struct.pack(ROUTE_FORMAT, number, origin[0], origin[1], dest[0], dest[1], levels,
+                       type_priority[0].encode("ascii"), int(type_priority[1]), *flat_steps)
+
+
+def read_routes(filename):
+    records = []
+    with open(filename, newline="") as f:
+        for row_num, row in enumerate(csv.reader(f), 1):
+            if (not row) or (not row[0].strip().isdigit()):
+                continue
+            records.append(parse_route(row, row_num))
+    return records
+
+
+def build_frames(records):
+    frames = []
+    for first in range(0, len(records), BATCH_RECS):
+        batch = records[first:first + BATCH_RECS]
+        frames.append((len(frames) & 0xFF, len(batch), first, b"".join(batch)))
+    frames.append((len(frames) & 0xFF, 0, len(records), b""))  # End-of-transmission frame
+    packed = []
+    for seq, num_recs, first, data in frames:
+        body = bytes([seq, num_recs, first & 0xFF, first >> 8]) + data
+        crc = frame_crc(body)
+        packed.append(b"R" + body + bytes([crc & 0xFF, crc >> 8]))
+    return packed
+
+
+def open_mega(port):
+    # Opening the port resets the Mega.  Skip everything it prints during startup until it says it's ready.
+    import serial
+    mega = serial.Serial(port, SERIAL_SPEED, timeout=ACK_TIMEOUT)
+    deadline = time.time() + 60
+    while time.time() < deadline:
+        line = mega.readline().decode("latin-1").strip()
+        if line:
+            print("Mega: " + line)
+        if line == "ROUTES READY":
+            return mega
+    sys.exit("Mega never said ROUTES READY.  Is RECEIVE_ROUTES defined in Processing_Receive_Routes?")
+
+
+def send(port, filename):
+    records = read_routes(filename)
+    frames = build_frames(records)
+    mega = open_mega(port)
+    start = time.time()
+    base = 0         # Oldest frame not yet acked
+    next_frame = 0   # Next frame to send
+    retries = 0
+    while base < len(frames):
+        while (next_frame < len(frames)) and (next_frame < base + WINDOW):
+            mega.write(frames[next_frame])
+            next_frame += 1
+        reply = mega.read(2)
+        if len(reply) != 2:  # Timed out; re-send everything not yet acked
+            retries += 1
+            if retries > RETRIES:
+                sys.exit("Mega stopped acking at frame %d." % base)
+            next_frame = base
+            continue
+        # seq wraps at 256 but WINDOW is small, so it's unambiguous within the frames in flight.
+        offset = (reply[1] - base) & 0xFF
+        if (reply[0:1] == b"A") and (offset < next_frame - base):
+            base += offset + 1
+            retries = 0
+            print("\rSent %d of %d records" % (min(base * BATCH_RECS, len(records)), len(records)), end="")
+        elif (reply[0:1] == b"N") and (offset < next_frame - base):
+            base += offset
+            next_frame = base
+            retries += 1
+            if retries > RETRIES:
+                sys.exit("Mega rejected frame %d too many times." % base)
+    print()
+    elapsed = max(time.time() - start, 0.001)
+    print("Sent %d routes (%d bytes) in %.1f sec (%.1f KB/s)." %
+          (len(records), len(records) * ROUTE_REC_LEN, elapsed, len(records) * ROUTE_REC_LEN / 1024 / elapsed))
+
+
+def main(argv):
+    if (len(argv) == 4) and (argv[1] == "send"):
+        send(argv[2], argv[3])
+    elif (len(argv) == 3) and (argv[1] == "check"):
+        try:
+            records = read_routes(argv[2])
+        except ValueError as e:
+            sys.exit("ERROR: %s" % e)
+        print("%s: %d routes, %d bytes in FRAM." % (argv[2], len(records), len(records) * ROUTE_REC_LEN))
+    else:
+        sys.exit("Usage: Send_Routes.py send PORT FILE, or check FILE")
+
+
+if __name__ == "__main__":
+    main(sys.argv)
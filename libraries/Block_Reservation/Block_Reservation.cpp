@@ -1,5 +1,8 @@
-// BLOCK_RESERVATION.CPP Rev: 02/27/23.  TESTED AND WORKING.
+// BLOCK_RESERVATION.CPP Rev: 10/19/26.  TESTED AND WORKING.
 // A set of functions to read and update the Block Reservation table, which is stored in FRAM.
+// 10/19/26: reservedBits() returns a blockBitmap.
+// 10/19/26: Added reservedBits().
+// 10/19/26: Reservations and releases are logged to the Event_Journal, if any.
 // 02/09/23: Eliminated possibility of having ER as optional direction; must always be either BE or BW even if not reserved.
 // 01/17/23: Rearranging/updating some of the structure fields, updated block lengths for 1st level (2nd level unknown.)
 // 11/27/22: Added default Eastbound and Westbound block speeds for use by Train Progress when needed for final block of a Cont'n
@@ -30,8 +33,8 @@ Block_Reservation::Block_Reservation() {  // Constructor
   return;
 }
 
-void Block_Reservation::begin(FRAM* t_pStorage) {
-  // Rev: 01/22/23.
+void Block_Reservation::begin(FRAM* t_pStorage, Event_Journal* t_pJournal) {
+  // Rev: 10/19/26.
   // We do NOT call releaseAllBlocks() yet as we may want to preserve reservedForTrain for Registrar to read and use as the default
   // location as trains are registered (though as of 3/3/23, it looks like we'll use Loco Ref to store each loco's last-known loc.)
   // Regardless, Registrar must call releaseAllBlocks() when it's ready to do so.
@@ -39,6 +42,7 @@ void Block_Reservation::begin(FRAM* t_pStorage) {
   if (m_pStorage == nullptr) {
     sprintf(lcdString, "UN-INIT'd BR PTR"); pLCD2004->println(lcdString); Serial.println(lcdString); endWithFlashingLED(5);
   }
+  m_pJournal = t_pJournal;  // Okay to be nullptr
   return;
 }
 
@@ -47,7 +51,8 @@ void Block_Reservation::begin(FRAM* t_pStorage) {
 // All of the following expect t_blockNum, t_locoNum, sensorNum, etc. to start at 1 not 0.  No checking of input ranges!
 
 void Block_Reservation::reserveBlock(const byte t_blockNum, const byte t_direction, const byte t_locoNum) {
-  // Rev: 07/30/24.  Just updated comments to note it's possible (but wrong) to have both ends of a block occupied during Reg'n.
+  // Rev: 10/19/26.  Journal the reservation.
+  // 07/30/24: Just updated comments to note it's possible (but wrong) to have both ends of a block occupied during Reg'n.
   // IMPORTANT: If the block is already reserved for LOCO_ID_STATIC, this function will allow the block to be reserved for a loco.
   //   We need to allow this during REGISTRATION, since all occupied blocks are first reserved for STATIC, and then actual locos
   //   get block reservations as they are registered.  The only problem with this, during Registration, is that if a block happens
@@ -87,15 +92,22 @@ void Block_Reservation::reserveBlock(const byte t_blockNum, const byte t_directi
   m_blockReservation.reservedForTrain = t_locoNum;
   m_blockReservation.reservedForDirection = t_direction;  // BE or BW
   Block_Reservation::setBlockReservation(t_blockNum);
+  if (m_pJournal != nullptr) {
+    m_pJournal->log(JOURNAL_EVENT_BLOCK_RESERVED, t_locoNum, 0, t_blockNum, t_direction);
+  }
   return;
 }
 
 void Block_Reservation::releaseBlock(const byte t_blockNum) {  // Could return bool if want to confirm it was previously reserved.
-  // Rev: 01/17/23.
+  // Rev: 10/19/26.
   // Retrieve entire Block Reservation record if not already loaded, update the two fields, then write back to FRAM.
+  // Only journal it if it was actually reserved, so releaseAllBlocks() doesn't fill the journal with no-ops.
   if (t_blockNum != m_blockReservation.blockNum) {
     Block_Reservation::getBlockReservation(t_blockNum);
   }
+  if ((m_pJournal != nullptr) && (m_blockReservation.reservedForTrain != LOCO_ID_NULL)) {
+    m_pJournal->log(JOURNAL_EVENT_BLOCK_RELEASED, m_blockReservation.reservedForTrain, 0, t_blockNum, 0);
+  }
   m_blockReservation.reservedForTrain = LOCO_ID_NULL;
   m_blockReservation.reservedForDirection = BW;  // Doesn't matter which direction but MUST be BE or BW.
   Block_Reservation::setBlockReservation(t_blockNum);
@@ -124,6 +136,21 @@ byte Block_Reservation::reservedForTrain(const byte t_blockNum) {
   return m_blockReservation.reservedForTrain;
 }
 
+blockBitmap Block_Reservation::reservedBits(const byte t_exceptLocoNum) {
+  // Rev: 10/19/26.
+  // Returns a bitmap with Block n set for every block that is reserved for any train (including STATIC) other than
+  // t_exceptLocoNum.  Pass LOCO_ID_NULL to get every reserved block.  Reads all TOTAL_BLOCKS records, so call it once and then
+  // compare against as many Route_Reference::blockBits() as you like.
+  blockBitmap reserved;
+  for (byte blockNum = 1; blockNum <= TOTAL_BLOCKS; blockNum++) {
+    const byte locoNum = Block_Reservation::reservedForTrain(blockNum);
+    if ((locoNum != LOCO_ID_NULL) && (locoNum != t_exceptLocoNum)) {
+      reserved.set(blockNum);
+    }
+  }
+  return reserved;
+}
+
 byte Block_Reservation::reservedDirection(const byte t_blockNum) {  // Returns const BE or BW if reserved, else undefined.
   // Rev: 01/17/23.
   // Note: Returns the contents of the "Reserved Direction" field whether the block is actually reserved or not.
@@ -1,6 +1,10 @@
-// BLOCK_RESERVATION.H Rev: 01/24/23.  TESTED AND WORKING.
+// BLOCK_RESERVATION.H Rev: 10/19/26.  TESTED AND WORKING.
 // A set of functions to read and update the Block Reservation table, which is stored in FRAM.
 
+// 10/19/26: reservedBits() returns a blockBitmap, so it isn't limited to 32 blocks.
+// 10/19/26: begin() takes an optional Event_Journal*; block reservations and releases are journaled if it isn't nullptr.
+// 10/19/26: Added reservedBits() so Dispatcher can check a whole route against all reservations with Route_Reference bitmaps.
+
 // 01/25/23: Changed order of parms in reserveBlock() to more intuitive Block + Direction + LocoNum
 // 01/17/23: Rearranging/updating some of the struct fields, updated block lengths for 1st level (2nd level unknown.)
 //           Modified spreadsheet Block Res'n data to match.
@@ -19,13 +23,14 @@
 #include <Train_Functions.h>
 #include <Display_2004.h>
 #include <FRAM.h>
+#include <Event_Journal.h>
 
 class Block_Reservation {
 
   public:
 
     Block_Reservation();  // Constructor must be called above setup() so the object will be global to the module.
-    void begin(FRAM* t_pStorage);  // Initialized FRAM pointer and un-reserves all blocks.
+    void begin(FRAM* t_pStorage, Event_Journal* t_pJournal);  // t_pJournal may be nullptr if this module keeps no journal.
 
     // These functions expect blockNum to start at 1!  And return train nums starting at 1 (except "unreserved" train 0.)
 
@@ -35,6 +40,7 @@ class Block_Reservation {
 
     byte reservedForTrain(const byte t_blockNum);   // 1..n
     byte reservedDirection(const byte t_blockNum);  // BE/BW
+    blockBitmap reservedBits(const byte t_exceptLocoNum);  // Block n is set if it's reserved for anyone but this loco.
     byte westSensor(const byte t_blockNum);         // 1..n
     byte eastSensor(const byte t_blockNum);         // 1..n
     byte westboundSpeed(const byte t_blockNum);     // 0..4
@@ -80,8 +86,11 @@ class Block_Reservation {
       //        Which direction is going up?  Not currently used since Route dictates speed.
     };
     blockReservationStruct m_blockReservation;  // Could save 15 bytes (less 2 for ptr) if made this into ptr to heap.
+    static_assert(TOTAL_BLOCKS * sizeof(blockReservationStruct) <= FRAM_BYTES_BLOCK_RESN,
+                  "Block Reservation table overruns FRAM_BYTES_BLOCK_RESN.");
 
     FRAM* m_pStorage;           // Pointer to the FRAM memory module.
+    Event_Journal* m_pJournal;  // nullptr if this module doesn't keep a journal.
 
 };
 
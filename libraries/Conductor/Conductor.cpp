@@ -1,5 +1,7 @@
-// CONDUCTOR.CPP Rev: 02/27/23.
+// CONDUCTOR.CPP Rev: 10/19/26.
 // Part of O_LEG.
+// 10/19/26: Added event queue (postEvent(), locoReadyToStart()) so only the loco affected by a Route, sensor trip, or expired
+//           start timer is evaluated, rather than scanning all locos every pass through LEG's Auto/Park loop.
 
 #include "Conductor.h"
 
@@ -7,18 +9,20 @@ Conductor::Conductor() {  // Constructor
   return;
 }
 
-void Conductor::begin(FRAM * t_pStorage, Block_Reservation * t_pBlockReservation, Delayed_Action* t_pDelayedAction,
-                      Engineer* t_pEngineer) {
+void Conductor::begin(FRAM * t_pStorage, Block_Reservation * t_pBlockReservation, Train_Progress* t_pTrainProgress,
+                      Delayed_Action* t_pDelayedAction, Engineer* t_pEngineer) {
 
   m_pStorage = t_pStorage;  // Pointer to FRAM
   m_pBlockReservation = t_pBlockReservation;  // Pointer to Block Reservation table
+  m_pTrainProgress = t_pTrainProgress;  // So we can tell when a stopped loco is ready to start its Route
   m_pDelayedAction = t_pDelayedAction;  // So at Registration we can call Delayed_Action::initialize()
   m_pEngineer = t_pEngineer;            // So at Registration we can call Engineer::legacyCommandBufInit() and accessoryRelayInit()
 
-  if ((m_pStorage == nullptr) || (m_pBlockReservation == nullptr) || (m_pDelayedAction == nullptr) || (m_pEngineer == nullptr)) {
+  if ((m_pStorage == nullptr) || (m_pBlockReservation == nullptr) || (m_pTrainProgress == nullptr) ||
+      (m_pDelayedAction == nullptr) || (m_pEngineer == nullptr)) {
     sprintf(lcdString, "UN-INIT'd CD PTR"); pLCD2004->println(lcdString); Serial.println(lcdString); endWithFlashingLED(5);
   }
-
+  resetEvents();
   return;
 }
 
@@ -26,3 +30,151 @@ void Conductor::conduct(const byte t_mode, byte* t_state) {  // Manage Train Pro
 
   return;
 }
+
+void Conductor::resetEvents() {
+  // Rev: 10/19/26.
+  // Call each time Auto/Park mode starts.  Any Route added from here on will post its own CONDUCTOR_EVENT_ROUTE_ADDED.
+  m_eventHead = 0;
+  m_eventCount = 0;
+  m_rescanLoco = 0;
+  for (byte i = 0; i < ((TOTAL_TRAINS + 7) / 8); i++) {
+    m_startPending[i] = 0;
+  }
+  m_startPendingCount = 0;
+  m_nextWakeTime = 0;
+  m_eventsPosted = 0;
+  m_eventsOverflowed = 0;
+  m_locosEvaluated = 0;
+  return;
+}
+
+void Conductor::postEvent(const byte t_eventType, const byte t_locoNum) {
+  // Rev: 10/19/26.
+  // LEG calls this with CONDUCTOR_EVENT_ROUTE_ADDED after adding an Extension Route to Train Progress, and with
+  // CONDUCTOR_EVENT_SENSOR_TRIPPED after it determines which loco tripped a sensor.  We post CONDUCTOR_EVENT_START_TIMER ourselves.
+  // If the queue is full we don't want to lose the event, so we note that every loco must be evaluated once instead.
+  if ((t_locoNum < 1) || (t_locoNum > TOTAL_TRAINS)) {
+    sprintf(lcdString, "CD EVENT LOCO %i", t_locoNum); pLCD2004->println(lcdString); Serial.println(lcdString);
+    endWithFlashingLED(5);
+  }
+  if (m_eventCount == CONDUCTOR_EVENT_RECS) {
+    m_eventsOverflowed++;
+    m_rescanLoco = 1;
+    return;
+  }
+  byte tail = (m_eventHead + m_eventCount) % CONDUCTOR_EVENT_RECS;
+  m_eventQueue[tail].eventType = t_eventType;
+  m_eventQueue[tail].locoNum = t_locoNum;
+  m_eventCount++;
+  m_eventsPosted++;
+  return;
+}
+
+byte Conductor::locoReadyToStart() {
+  // Rev: 10/19/26.
+  // TO START A STOPPED LOCO:
+  //   1. isActive() and isStopped() must be true and timeToStart must have arrived, AND SIGNIFICANTLY
+  //   2. There must be a Route ahead of the train: pTrainProgress->atEndOfRoute(locoNum) should be false
+  // Rather than test every loco on every call, we only evaluate locos named in a posted event.  Returns the first loco found
+  // that is ready to start, so the caller should keep calling until we return 0 (no more events waiting.)
+  checkStartTimers();
+  while (m_rescanLoco != 0) {  // Event queue overflowed at some point; look at every loco once
+    byte locoNum = m_rescanLoco;
+    if (m_rescanLoco == TOTAL_TRAINS) {
+      m_rescanLoco = 0;
+    } else {
+      m_rescanLoco++;
+    }
+    if (evaluateLoco(CONDUCTOR_EVENT_ROUTE_ADDED, locoNum)) {
+      return locoNum;
+    }
+  }
+  while (m_eventCount > 0) {
+    byte eventType = m_eventQueue[m_eventHead].eventType;
+    byte locoNum = m_eventQueue[m_eventHead].locoNum;
+    m_eventHead = (m_eventHead + 1) % CONDUCTOR_EVENT_RECS;
+    m_eventCount--;
+    if (evaluateLoco(eventType, locoNum)) {
+      return locoNum;
+    }
+  }
+  return 0;
+}
+
+void Conductor::displayStats() {
+  // Rev: 10/19/26.
+  Serial.print(F("Conductor events posted: ")); Serial.println(m_eventsPosted);
+  Serial.print(F("Conductor events overflowed: ")); Serial.println(m_eventsOverflowed);
+  Serial.print(F("Conductor locos evaluated: ")); Serial.println(m_locosEvaluated);
+  Serial.print(F("Conductor locos waiting to start: ")); Serial.println(m_startPendingCount);
+  return;
+}
+
+bool Conductor::evaluateLoco(const byte t_eventType, const byte t_locoNum) {
+  // Rev: 10/19/26.
+  // Returns true if t_locoNum is stopped with a Route ahead and its timeToStart has arrived.  Otherwise, if it will be ready at
+  // some future time, arm a start timer so we look at it again then (and not before.)
+  m_locosEvaluated++;
+  if ((m_pTrainProgress->isActive(t_locoNum) == false) || (m_pTrainProgress->atEndOfRoute(t_locoNum))) {
+    clearStartTimer(t_locoNum);  // Nothing to start
+    return false;
+  }
+  if (m_pTrainProgress->isStopped(t_locoNum)) {
+    if (m_pTrainProgress->timeToStartLoco(t_locoNum)) {
+      clearStartTimer(t_locoNum);
+      return true;
+    }
+    armStartTimer(t_locoNum, m_pTrainProgress->timeToStart(t_locoNum));
+    return false;
+  }
+  // Loco is still moving.  If it just tripped a sensor that's normal and there's nothing for us to do.  But if it was just given
+  // an Extension Route (or was already waiting) then it must still be coming to a stop, so check again shortly.
+  if (t_eventType != CONDUCTOR_EVENT_SENSOR_TRIPPED) {
+    armStartTimer(t_locoNum, millis() + CONDUCTOR_RECHECK_MS);
+  }
+  return false;
+}
+
+void Conductor::armStartTimer(const byte t_locoNum, const unsigned long t_wakeTime) {
+  // Rev: 10/19/26.
+  byte byteNum = (t_locoNum - 1) / 8;
+  byte bitNum = (t_locoNum - 1) % 8;
+  if (bitRead(m_startPending[byteNum], bitNum) == 0) {
+    bitSet(m_startPending[byteNum], bitNum);
+    m_startPendingCount++;
+  }
+  if ((m_startPendingCount == 1) || ((long)(t_wakeTime - m_nextWakeTime) < 0)) {
+    m_nextWakeTime = t_wakeTime;
+  }
+  return;
+}
+
+void Conductor::clearStartTimer(const byte t_locoNum) {
+  // Rev: 10/19/26.
+  byte byteNum = (t_locoNum - 1) / 8;
+  byte bitNum = (t_locoNum - 1) % 8;
+  if (bitRead(m_startPending[byteNum], bitNum) == 1) {
+    bitClear(m_startPending[byteNum], bitNum);
+    m_startPendingCount--;
+  }
+  return;
+}
+
+void Conductor::checkStartTimers() {
+  // Rev: 10/19/26.
+  // When the earliest start timer expires, post a CONDUCTOR_EVENT_START_TIMER for every loco that was waiting.  evaluateLoco()
+  // will re-arm any that still aren't ready, which also recalculates m_nextWakeTime.
+  if ((m_startPendingCount == 0) || ((long)(millis() - m_nextWakeTime) < 0)) {
+    return;
+  }
+  for (byte locoNum = 1; locoNum <= TOTAL_TRAINS; locoNum++) {
+    byte byteNum = (locoNum - 1) / 8;
+    byte bitNum = (locoNum - 1) % 8;
+    if (bitRead(m_startPending[byteNum], bitNum) == 1) {
+      bitClear(m_startPending[byteNum], bitNum);
+      postEvent(CONDUCTOR_EVENT_START_TIMER, locoNum);
+    }
+  }
+  m_startPendingCount = 0;
+  return;
+}
@@ -1,5 +1,9 @@
-// CONDUCTOR.H Rev: 03/03/23.b
+// CONDUCTOR.H Rev: 10/19/26.
 // Part of O_LEG.
+// 10/19/26: Added an event queue so LEG no longer polls isActive/isStopped/atEndOfRoute/timeToStart for all 50 locos on every
+//           pass through the Auto/Park loop.  LEG posts an event when a Route is added or a sensor is tripped; Conductor keeps a
+//           list of locos waiting for their timeToStart and posts its own event when the earliest one expires.  Only the loco
+//           named in each event is evaluated, so loop time no longer grows with the number of registered trains.
 // LEG Conductor receives routes from MAS Dispatcher and uses that data to populate LEG's Train Progress and Delayed Action tables.
 // Conductor does NOT know the details of how to populate Delayed Action; it sends high-level requests to Delayed Action to do so.
 // Conductor does NOT know how to track Train Progress; it sends high-level requests to Train Progress to provide that information.
@@ -203,25 +207,64 @@
 // Conductor or whoever calls Conductor will need to call Delayed_Action::initialize() to clear the whole Delayed Action table
 // whenever Registration mode (re)starts.
 
+// Conductor event types, posted via postEvent().  Each event names the single loco that may need attention.
+const byte CONDUCTOR_EVENT_ROUTE_ADDED    = 1;  // LEG added an Extension Route to Train Progress for this loco
+const byte CONDUCTOR_EVENT_SENSOR_TRIPPED = 2;  // This loco just tripped a sensor
+const byte CONDUCTOR_EVENT_START_TIMER    = 3;  // Posted by Conductor itself when this loco's timeToStart has arrived
+
+const byte CONDUCTOR_EVENT_RECS           = 16;   // Size of the event queue; if it ever fills we fall back to one full scan.
+const unsigned long CONDUCTOR_RECHECK_MS  = 250;  // If a loco with a new Route isn't stopped yet, look again this often.
+
 class Conductor {
 
   public:
 
     Conductor();  // Constructor must be called above setup() so the object will be global to the module.
 
-    void begin(FRAM* t_pStorage, Block_Reservation* t_pBlockReservation, Delayed_Action* t_pDelayedAction, Engineer* t_pEngineer);
+    void begin(FRAM* t_pStorage, Block_Reservation* t_pBlockReservation, Train_Progress* t_pTrainProgress,
+               Delayed_Action* t_pDelayedAction, Engineer* t_pEngineer);
 
     void conduct(const byte t_mode, byte* t_state);  // Manage Train Progress and Delayed Action tables
 
+    void resetEvents();  // Call when Auto/Park mode starts; clears the event queue and any pending start timers.
+    void postEvent(const byte t_eventType, const byte t_locoNum);  // CONDUCTOR_EVENT_xxx for loco 1..TOTAL_TRAINS
+    byte locoReadyToStart();  // Returns locoNum of a stopped loco whose Route may start now, else 0.  Call until it returns 0.
+    void displayStats();
+
   private:
 
 //    routeElement m_routeElement;  not needed yet as of 2/17/23 since I haven't written any real code yet
 
     FRAM*              m_pStorage;           // Pointer to the FRAM memory module
     Block_Reservation* m_pBlockReservation;
+    Train_Progress*    m_pTrainProgress;
     Delayed_Action*    m_pDelayedAction;     // So at Reg'n we can call Delayed_Action::initialize()
     Engineer*          m_pEngineer;          // So at Reg'n we can call Engineer::legacyCommandBufInit() and accessoryRelayInit()
 
+    bool evaluateLoco(const byte t_eventType, const byte t_locoNum);  // True if loco should start now; else arms/clears its timer
+    void armStartTimer(const byte t_locoNum, const unsigned long t_wakeTime);
+    void clearStartTimer(const byte t_locoNum);
+    void checkStartTimers();                  // Posts CONDUCTOR_EVENT_START_TIMER for each expired start timer
+
+    struct conductorEventStruct {
+      byte eventType;  // CONDUCTOR_EVENT_xxx
+      byte locoNum;    // 1..TOTAL_TRAINS
+    };
+    conductorEventStruct m_eventQueue[CONDUCTOR_EVENT_RECS];  // Circular buffer
+    byte m_eventHead;   // Next event to remove
+    byte m_eventCount;  // Number of events waiting
+    byte m_rescanLoco;  // If the event queue overflowed, next loco to evaluate in a one-time scan of all locos; else 0
+
+    // Locos with a new Route that are waiting for timeToStart (or to finish stopping.)  One bit per loco; bit 0 of byte 0 = loco 1.
+    // There will rarely be more than a few, so when m_nextWakeTime arrives we simply re-evaluate all of them.
+    byte m_startPending[(TOTAL_TRAINS + 7) / 8];
+    byte m_startPendingCount;
+    unsigned long m_nextWakeTime;  // Earliest time any pending loco may be ready to start
+
+    unsigned long m_eventsPosted;
+    unsigned long m_eventsOverflowed;
+    unsigned long m_locosEvaluated;
+
 };
 
 #endif
@@ -1,5 +1,6 @@
-// DEADLOCK.H Rev: 01/27/23.
+// DEADLOCK.H Rev: 10/19/26.
 // Part of O_MAS.
+// 10/19/26: Table size is checked against FRAM_BYTES_DEADLOCK at compile time.
 // Determine if a proposed next-route's destination could create a Deadlock condition for a given train.
 // deadlockExists() assumes that it's being passed a valid t_candidateDestination and t_locoNum; no error checking on those.
 // 01/26/23: IMPORTANT NOTE REGARDING IF TRAIN IS TOO LONG, OR FORBIDDEN TYPE (i.e. Pass/Frt) FOR A GIVEN SIDING.
@@ -59,6 +60,8 @@ class Deadlock_Reference {
       routeElement threatList[FRAM_FIELDS_DEADLOCK];  // i.e. BE02, BE03, ER00...
     };
     deadlockStruct m_deadlock;  // Could save 25 bytes (less 2 bytes for pointer) if I make this a pointer to heap
+    static_assert(FRAM_RECS_DEADLOCK * sizeof(deadlockStruct) <= FRAM_BYTES_DEADLOCK,
+                  "Deadlock table overruns FRAM_BYTES_DEADLOCK.");
 
     FRAM* m_pStorage;           // Pointer to the FRAM memory module
     Loco_Reference* m_pLoco;
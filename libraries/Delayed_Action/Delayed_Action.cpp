@@ -1,18 +1,21 @@
-// DELAYED_ACTION.CPP Rev: 09/30/24.  TESTED AND WORKING with a few exceptions such as PowerMasters and Accessory activation.
+// DELAYED_ACTION.CPP Rev: 10/19/26.  TESTED AND WORKING with a few exceptions such as PowerMasters and Accessory activation.
 // Part of O_LEG (Conductor and Engineer.)
 // One set of functions POPULATES the Delayed Action table (for Conductor)
 // Another set of functions DE-POPULATES the Delayed Action table (for Engineer)
 // ALL DEVICES INCLUDING ACCESSORIES START AT 1, not 0.
+// 10/19/26: Delayed Action table comes from the QuadRAM arena.
 // 09/30/24: Updated whistle/horn sequences to work with locos 2, 4, 5, 8, and 14.
 // 06/30/24: Added debug switch.
 
 #include "Delayed_Action.h"
 
 Delayed_Action::Delayed_Action() {   // Constructor
-  // Rev: 02/21/23.
+  // Rev: 10/19/26.
   // HEAP STORAGE: We want the PRIVATE 1000-element delayedAction[] structure array to reside on the HEAP.  We will allocate
   // the memory (about 10K) using "new" in the constructor, and point our private pointer at it.
-  m_pDelayedAction = new delayedActionStruct[HEAP_RECS_DELAYED_ACTION];
+  // 10/19/26: Now allocated from the QuadRAM arena, so this 10K block sits above the heap and never fragments it.
+  m_pDelayedAction = (delayedActionStruct*)arenaAllocate(F("Delayed Action"),
+                                                         sizeof(delayedActionStruct) * HEAP_RECS_DELAYED_ACTION, ARENA_QUADRAM);
   // SINCE THE DELAYED ACTION OBJECT CREATED IN THE CALLING .INO PROGRAM IS CREATED ON THE HEAP (VIA "NEW"), WE COULD SET UP OUR
   // m_pDelayedAction[] ARRAY IN THIS CLASS USING REGULAR SRAM, AND WOULD NOT CONSUME ANY MORE SRAM SINCE IT WOULD BE ON THE HEAP.
   // I proved this using tests on 2/21/23:
@@ -1,7 +1,8 @@
-// DELAYED_ACTION.H Rev: 08/05/24.  HEAP STORAGE.  TESTED AND WORKING with a few exceptions such as Accessory activation.
+// DELAYED_ACTION.H Rev: 10/19/26.  HEAP STORAGE.  TESTED AND WORKING with a few exceptions such as Accessory activation.
 // Part of O_LEG (Conductor and Engineer.)
 // Delayed Action table is used ONLY by LEG.  Populated by LEG Conductor and de-populated by LEG Engineer.
 // Uses about 10K on HEAP.
+// 10/19/26: The table is now allocated from the QuadRAM arena (see arenaAllocate() in Train_Functions.h), not the heap.
 // 08/05/24: Removed expected stop time field and functions as it's easily calculated via speedChangeTime() function.
 // 06/30/24: Added debug switch.
 // 02/15/23: populateLocoCommand() no longer needs to send devType as a parm.  Uses ptr to Loco Ref to just lookup.
@@ -1,6 +1,9 @@
-// DISPATCHER.CPP Rev: 02/09/21.
+// DISPATCHER.CPP Rev: 10/19/26.
 // Part of O_MAS.
 // Run the layout in Auto or Park mode.
+// 10/19/26: begin() builds Route_Reference's route bitmaps, which are no longer built for every module.
+// 10/19/26: dispatch() is one pass of MAS's Auto/Park loop; startDispatching() does the once-per-session setup.
+// 10/19/26: Added route selection engine (selectRoutes() and friends) and implemented trainPermittedInSiding().
 
 #include <Dispatcher.h>
 
@@ -20,6 +23,17 @@ void Dispatcher::begin(Message* t_pMessage, Loco_Reference* t_pLoco, Block_Reser
   m_pDeadlock = t_pDeadlock;
   m_pTrainProgress = t_pTrainProgress;
   m_pModeSelector = t_pModeSelector;
+  if ((m_pMessage == nullptr) || (m_pLoco == nullptr) || (m_pBlockReservation == nullptr) || (m_pTurnoutReservation == nullptr) ||
+      (m_pSensorBlock == nullptr) || (m_pRoute == nullptr) || (m_pDeadlock == nullptr) || (m_pTrainProgress == nullptr) ||
+      (m_pModeSelector == nullptr)) {
+    sprintf(lcdString, "UN-INIT'd DS PTR"); pLCD2004->println(lcdString); Serial.println(lcdString); endWithFlashingLED(5);
+  }
+  m_pRoute->buildRouteBitmaps();  // We're the only module that uses them; one pass through Route Reference in FRAM.
+  m_searchLocoNum = LOCO_ID_NULL;
+  m_nextLocoToCheck = 1;
+  for (byte i = 0; i < TOTAL_TRAINS; i++) {
+    m_retryTime[i] = 0;
+  }
   return;
 }
 
@@ -46,7 +60,9 @@ void Dispatcher::begin(Message* t_pMessage, Loco_Reference* t_pLoco, Block_Reser
 // When in AUTO or PARK mode, STOPPING state, the flashing red STOP button will disregard presses.  Operator must Halt to stop.
 
 
-void Dispatcher::dispatch(const byte t_mode, byte* t_state) {  // Operate the layout in Auto or Park mode.
+void Dispatcher::startDispatching(const byte t_mode) {
+  // Rev: 10/19/26.
+  // Called once by MAS when Auto/Park mode starts, before the first call to dispatch().
 
   // Since Train_Progress will have 50 possible trains, need an easy way to only examine active Locos and not look at all 50. *********************************
   // Need an small array we can scan of each train that includes Registered T/F, and a flag to indicate if the train is stopped
@@ -102,8 +118,20 @@ void Dispatcher::dispatch(const byte t_mode, byte* t_state) {  // Operate the la
   // Sensor-Block table will reflect last-known status of each sensor, ready for constant updates each time sensor status changes.
   // Route and Deadlock tables are ready for lookups.
 
-  bool allTrainsAreStopped = true;  // Set to false as soon as we start moving; set true when stopped in STOPPING mode
-
+  // Reset route selection state and statistics for this run.
+  m_searchLocoNum = LOCO_ID_NULL;
+  m_nextLocoToCheck = 1;
+  for (byte i = 0; i < TOTAL_TRAINS; i++) {
+    m_retryTime[i] = millis();
+  }
+  m_statsStartMillis = millis();
+  m_candidatesEvaluated = 0;
+  m_decisionsMade = 0;
+  m_routesAssigned = 0;
+  m_worstDecisionMicros = 0;
+  m_worstPassMicros = 0;
+  m_maxActiveTrains = 0;
+  Dispatcher::noteActiveTrains();
 
   // Get last-known turnout positions, and throw them all, one at a time.
   // Sending 'T'urnout messages to SWT will also be seen by LED to update green control panel LEDs.
@@ -127,52 +155,370 @@ void Dispatcher::dispatch(const byte t_mode, byte* t_state) {  // Operate the la
 //    m_pModeSelector->setStateToSTOPPING(t_mode, t_state);
   }
 
-  // So long as we are RUNNING or STOPPING (not STOPPED), we'll zoom around this big loop.  Then we're done.
-  while (*t_state != STATE_STOPPED) {
-    // If RUNNING in either AUTO or PARK, see if operator wants to transition into STOPPING.
-    if (*t_state == STATE_RUNNING) {
-      // Note: t_state is *already* a pointer, so don't need to use an asterisk when calling from here.
-      m_pModeSelector->stopButtonIsPressed(t_mode, t_state);  // Changes t_state to STOPPING if operator pressed Stop button
-    }
-    // If STOPPING, we must paint Stop button LED at least every 500ms so it blinks
-    if (*t_state == STATE_STOPPING) {  // No harm done to paint it in any mode, but no point unless STOPPING
-      // Note: paintModeLEDs expects const state, not a pointer, so we must use asterisk here.
-      m_pModeSelector->paintModeLEDs(t_mode, *t_state);
-    }
-    // Now we are in either AUTO or PARK, RUNNING or STOPPING.
-
-    // Check for incoming SENSOR_CHANGE message.  This is the *only* incoming message we will receive, and drives our actions.
-
-
+  return;
+}
 
-    // If a train is MOVING and has just tripped it's Train Progress penultimate exit sensor, *and* we are not stopping, try to
-    // find a "next" route for this train.  Note that we could also be in Park mode, which is always "stopping", but we might not
-    // yet have a Destination for our train that is part of a Park-type route -- in which case we may still need to schedule
-    // another route.
+void Dispatcher::dispatch(const byte t_mode, byte* t_state) {  // Operate the layout in Auto or Park mode.
+  // Rev: 10/19/26.
+  // One pass; MAS calls this every time through its Auto/Park loop, after handling any incoming sensor change, until t_state
+  // becomes STATE_STOPPED.  MAS broadcasts any change we make to t_state.  Returns within about DISPATCH_BUDGET_MICROS.
+  // If RUNNING in either AUTO or PARK, see if operator wants to transition into STOPPING.
+  if (*t_state == STATE_RUNNING) {
+    // Note: t_state is *already* a pointer, so don't need to use an asterisk when calling from here.
+    m_pModeSelector->stopButtonIsPressed(t_mode, t_state);  // Changes t_state to STOPPING if operator pressed Stop button
+  }
+  // If STOPPING, we must paint Stop button LED at least every 500ms so it blinks
+  if (*t_state == STATE_STOPPING) {  // No harm done to paint it in any mode, but no point unless STOPPING
+    // Note: paintModeLEDs expects const state, not a pointer, so we must use asterisk here.
+    m_pModeSelector->paintModeLEDs(t_mode, *t_state);
+  }
+  // Now we are in either AUTO or PARK, RUNNING or STOPPING.
+
+  // If a train is MOVING and has just tripped it's Train Progress continuation sensor, *and* we are not stopping, try to find a
+  // "next" route for this train.  Note that we could also be in Park mode, which is always "stopping", but we might not yet have
+  // a Destination for our train that is part of a Park-type route -- in which case we may still need to schedule another route.
+  // If a train is STOPPED, and we are either 1) in AUTO RUNNING mode, or 2) in PARK STOPPING mode *but* not yet in a "parking"
+  // block, then let's see if we can find a new route (taking into account if we're looking for a Parking block, etc.)
+  // selectRoutes() handles both the stopped (Extension) and continuation-sensor (Continuation) cases, and never spends more than
+  // DISPATCH_BUDGET_MICROS per pass; a search that isn't finished simply resumes on the next pass.
+  // MAS has already advanced Train Progress for any sensor change that came in this pass, so what we see here is current.
+  Dispatcher::selectRoutes(t_mode, *t_state);
+
+  if ((*t_state == STATE_STOPPING) && (Dispatcher::allTrainsAreStopped(t_mode))) {  // In PARK mode, trains must also be parked
+    m_pModeSelector->setStateToSTOPPED(t_mode, t_state);  // MAS will see STATE_STOPPED and fall out of its Auto/Park loop
+  }
+  return;
+}
 
+bool Dispatcher::trainPermittedInSiding(const byte t_locoNum, const routeElement t_blockNum) {
+  // Rev: 10/19/26.
+  // See if candidate destination is appropriate for this loco based on siding type, length, type (pass/frt) and station type.
+  // Same length and forbidden-type rules that Deadlock_Reference::deadlockExists() applies to threat sidings, but without all of
+  // the Serial debug output since we call this for every candidate route.
+  // NOTE: Dispatcher will call trainPermittedInSiding to see if a candidate destination is even an option, but then must call
+  // Deadlock_Reference::deadlockExists(destination, locoNum);
+  const byte blockNum = t_blockNum.routeRecVal;
+  if (m_pBlockReservation->sidingType(blockNum) == SIDING_NOT_A_SIDING) {
+    return false;  // Can't end a route in a block that isn't a siding
+  }
+  if (m_pLoco->length(t_locoNum) > m_pBlockReservation->length(blockNum)) {
+    return false;  // Train too long for this siding
+  }
+  //   m_pLoco->passOrFreight(t_locoNum) = P/p/F/f/M (M.O.W.)
+  //   m_pBlockReservation->forbidden(t_blockNum) = P/F/L/T = Pass, Freight, Local, Through
+  const char trainType = m_pLoco->passOrFreight(t_locoNum);
+  const char forbidden = m_pBlockReservation->forbidden(blockNum);
+  if ((((trainType == 'P') || (trainType == 'F')) && (forbidden == FORBIDDEN_THROUGH)) ||
+      (((trainType == 'p') || (trainType == 'f')) && (forbidden == FORBIDDEN_LOCAL)) ||
+      (((trainType == 'p') || (trainType == 'P')) && (forbidden == FORBIDDEN_PASSENGER)) ||
+      (((trainType == 'f') || (trainType == 'F')) && (forbidden == FORBIDDEN_FREIGHT))) {
+    return false;  // This type of train is forbidden in this siding
+  }
+  // A Passenger-only station won't accept a freight, and vice versa.  STATION_NOT_A_STATION just means we won't make a station
+  // stop (announcements etc.) there, so it doesn't restrict which trains may use the siding.
+  const char stationType = m_pBlockReservation->stationType(blockNum);
+  if ((((trainType == 'f') || (trainType == 'F')) && (stationType == STATION_PASSENGER)) ||
+      (((trainType == 'p') || (trainType == 'P')) && (stationType == STATION_FREIGHT))) {
+    return false;
+  }
+  return true;
+}
 
+void Dispatcher::displayStats() {
+  // Rev: 10/19/26.
+  // Send route selection statistics to the Serial monitor.  O_MAS calls this at the end of MASAutoParkMode(), after dispatch()
+  // has returned, but it can be called any time.  Candidates/sec is based on time actually spent evaluating, not wall-clock time since we started dispatching.
+  unsigned long elapsedMs = millis() - m_statsStartMillis;
+  Serial.println(F("======== DISPATCHER ROUTE SELECTION ========"));
+  Serial.print(F("Max active trains:      ")); Serial.println(m_maxActiveTrains);
+  Serial.print(F("Elapsed ms:             ")); Serial.println(elapsedMs);
+  Serial.print(F("Candidates evaluated:   ")); Serial.println(m_candidatesEvaluated);
+  Serial.print(F("Candidates/sec:         "));
+  if (elapsedMs > 0) {
+    Serial.println((m_candidatesEvaluated * 1000) / elapsedMs);
+  } else {
+    Serial.println(0);
+  }
+  Serial.print(F("Decisions made:         ")); Serial.println(m_decisionsMade);
+  Serial.print(F("Routes assigned:        ")); Serial.println(m_routesAssigned);
+  Serial.print(F("Worst decision (us):    ")); Serial.println(m_worstDecisionMicros);
+  Serial.print(F("Worst pass (us):        ")); Serial.println(m_worstPassMicros);
+  Serial.print(F("Budget per pass (us):   ")); Serial.println(DISPATCH_BUDGET_MICROS);
+  Serial.println(F("============================================"));
+  return;
+}
 
+// *** ROUTE SELECTION ENGINE ***
+
+void Dispatcher::selectRoutes(const byte t_mode, const byte t_state) {
+  // Rev: 10/19/26.
+  // Evaluate candidate routes until we either run out of trains that need a route, or use up DISPATCH_BUDGET_MICROS.  We only
+  // check the clock between candidates, so a single slow candidate (i.e. one that needs a Deadlock check) can overrun the budget
+  // a bit; m_worstPassMicros will tell us by how much.
+  // In AUTO mode we stop assigning routes as soon as the operator presses Stop (STOPPING.)  PARK mode is always STOPPING, but
+  // trains that aren't yet in a Parking siding still need routes.
+  if ((t_mode == MODE_AUTO) && (t_state != STATE_RUNNING)) {
+    return;
+  }
+  const unsigned long passStartMicros = micros();
+  do {
+    if (m_searchLocoNum == LOCO_ID_NULL) {
+      if (!Dispatcher::startNextSearch(t_mode)) {
+        break;  // No train needs a route right now
+      }
+    }
+    if (Dispatcher::evaluateNextCandidate(t_mode)) {
+      Dispatcher::finishSearch();
+    }
+  } while ((micros() - passStartMicros) < DISPATCH_BUDGET_MICROS);
+  const unsigned long passMicros = micros() - passStartMicros;
+  if (passMicros > m_worstPassMicros) {
+    m_worstPassMicros = passMicros;
+  }
+  return;
+}
 
+bool Dispatcher::startNextSearch(const byte t_mode) {
+  // Rev: 10/19/26.
+  // Look at each train once, round-robin starting where we left off last time, and begin a search for the first one that needs a
+  // route.  Returns false if no train currently needs one.  Train_Progress is on the heap so this scan is cheap.
+  for (byte i = 0; i < TOTAL_TRAINS; i++) {
+    byte locoNum = m_nextLocoToCheck;
+    m_nextLocoToCheck++;
+    if (m_nextLocoToCheck > TOTAL_TRAINS) {
+      m_nextLocoToCheck = 1;
+    }
+    if (!m_pTrainProgress->isActive(locoNum)) {
+      continue;
+    }
+    if ((long)(millis() - m_retryTime[locoNum - 1]) < 0) {  // Safe across millis() rollover
+      continue;  // Didn't find a route for this train recently; give it a rest
+    }
+    char routeType = Dispatcher::routeTypeNeeded(locoNum, t_mode);
+    if (routeType == ROUTE_TYPE_NULL) {
+      continue;
+    }
+    m_searchLocoNum = locoNum;
+    m_searchRouteType = routeType;
+    m_searchOrigin = Dispatcher::currentDestination(locoNum);
+    m_searchRecNum = m_pRoute->getFirstMatchingOrigin(m_searchOrigin);  // Fatal error if there is no matching route
+    m_searchBlockBits = m_pBlockReservation->reservedBits(locoNum);
+    m_searchTurnoutBits = m_pTurnoutReservation->reservedBits(locoNum);
+    m_searchDone = false;
+    m_bestScore = 255;
+    m_searchStartMicros = micros();
+    return true;
+  }
+  return false;
+}
 
-    // If a train is STOPPED, and we are either 1) in AUTO RUNNING mode, or 2) in PARK STOPPING mode *but* not yet in a "parking"
-    // block, then let's see if we can find a new route (taking into account if we're looking for a Parking block, etc.)
-    // Even if there is more than one train stopped, we will only schedule a route for one train at a time, in order to keep the
-    // loop running as quickly as possible (to re-paint the red Stop LED, check for another sensor change, etc.)
+bool Dispatcher::evaluateNextCandidate(const byte t_mode) {
+  // Rev: 10/19/26.
+  // Evaluate one candidate route (m_searchRecNum) for m_searchLocoNum, cheapest tests first, and advance to the next candidate.
+  // Returns true when the search is complete: either no more routes with our Origin, or we know we can't do any better.
+  if (m_searchDone) {
+    return true;
+  }
+  const unsigned int recNum = m_searchRecNum;
+  m_candidatesEvaluated++;
+  // Advance to next candidate now, so we don't have to worry about it below.  getNextMatchingOrigin() returns 0 when done.
+  m_searchRecNum = m_pRoute->getNextMatchingOrigin(m_searchOrigin, recNum);
+  if (m_searchRecNum == 0) {
+    m_searchDone = true;
+  }
 
+  // Cheapest test first: are any of this route's blocks or turnouts reserved for another train?  No FRAM access.
+  if (!m_pRoute->routeIsClear(recNum, m_searchBlockBits, m_searchTurnoutBits)) {
+    return m_searchDone;
+  }
+  byte score = m_pRoute->getPriority(recNum);
+  if ((t_mode == MODE_PARK) && (!m_pRoute->getPark(recNum))) {
+    score = score + DISPATCH_PARK_PENALTY;  // Use a non-Park route in PARK mode only if there isn't any Park route
+  }
+  if (score >= m_bestScore) {
+    return m_searchDone;  // Can't beat what we already have, so don't bother with the expensive tests
+  }
+  const routeElement destination = m_pRoute->getDest(recNum);
+  if (!Dispatcher::trainPermittedInSiding(m_searchLocoNum, destination)) {
+    return m_searchDone;
+  }
+  if (m_pDeadlock->deadlockExists(destination, m_searchLocoNum)) {
+    return m_searchDone;
+  }
+  // We have a new best candidate!
+  m_bestRecNum = recNum;
+  m_bestScore = score;
+  // Routes are sorted by Origin + Priority, so once we have a candidate without a Park penalty, nothing later can beat it.
+  if (score < DISPATCH_PARK_PENALTY) {
+    m_searchDone = true;
+  }
+  return m_searchDone;
+}
 
+void Dispatcher::finishSearch() {
+  // Rev: 10/19/26.
+  // Assign the winning route (if any) to m_searchLocoNum, update statistics, and clear the search so we can start another.
+  const byte locoNum = m_searchLocoNum;
+  if (m_bestScore < 255) {
+    Dispatcher::reserveRoute(locoNum, m_bestRecNum);
+    if (m_searchRouteType == ROUTE_TYPE_EXTENSION) {
+      m_pTrainProgress->addExtensionRoute(locoNum, m_bestRecNum, DISPATCH_EXTENSION_DELAY_MS);
+      // Route message countdown is in SECONDS, not ms.
+      m_pMessage->sendMAStoALLRoute(locoNum, ROUTE_TYPE_EXTENSION, m_bestRecNum, DISPATCH_EXTENSION_DELAY_MS / 1000);
+      // The train is sitting on its old Stop sensor, so it won't trip anything before it crosses the turnouts ahead of it.
+      Dispatcher::throwTurnoutsToNextSensor(locoNum);
+    } else {
+      m_pTrainProgress->addContinuationRoute(locoNum, m_bestRecNum);
+      m_pMessage->sendMAStoALLRoute(locoNum, ROUTE_TYPE_CONTINUATION, m_bestRecNum, 0);
+    }
+    m_routesAssigned++;
+    sprintf(lcdString, "L%2i %c RTE %3i", locoNum, m_searchRouteType, m_pRoute->getRouteID(m_bestRecNum));
+    pLCD2004->println(lcdString); Serial.println(lcdString);
+  } else {
+    m_retryTime[locoNum - 1] = millis() + DISPATCH_RETRY_MS;
+  }
+  const unsigned long decisionMicros = micros() - m_searchStartMicros;
+  if (decisionMicros > m_worstDecisionMicros) {
+    m_worstDecisionMicros = decisionMicros;
+  }
+  m_decisionsMade++;
+  m_searchLocoNum = LOCO_ID_NULL;
+  return;
+}
 
-    if ((*t_state == STATE_STOPPING) && (allTrainsAreStopped)) {  // In either AUTO or PARK mode, but park mode trains must also be parked, so add this code ***************************
-       m_pModeSelector->setStateToSTOPPED(t_mode, t_state);  // This will cause us to exit this "dispatch" function
+char Dispatcher::routeTypeNeeded(const byte t_locoNum, const byte t_mode) {
+  // Rev: 10/19/26.
+  // Returns ROUTE_TYPE_EXTENSION if the train is stopped at the end of its route, ROUTE_TYPE_CONTINUATION if it has tripped its
+  // Continuation sensor (but not yet its Station sensor), else ROUTE_TYPE_NULL.
+  // Never a Continuation into/through a single-ended siding; we always stop there.
+  // In PARK mode, a train that has reached a Parking siding is flagged as Parked and never gets another route.
+  // setInitialRoute() also flags a train Registered in a Parking siding as Parked, but in AUTO mode it must still get routes.
+  if (!m_pTrainProgress->isActive(t_locoNum)) {
+    return ROUTE_TYPE_NULL;
+  }
+  if ((t_mode == MODE_PARK) && (m_pTrainProgress->isParked(t_locoNum))) {
+    return ROUTE_TYPE_NULL;
+  }
+  const byte destBlockNum = Dispatcher::currentDestination(t_locoNum).routeRecVal;
+  const bool inParkingSiding = ((t_mode == MODE_PARK) && (m_pBlockReservation->isParkingSiding(destBlockNum)));
+  if (m_pTrainProgress->atEndOfRoute(t_locoNum)) {
+    if (inParkingSiding) {
+      m_pTrainProgress->setParked(t_locoNum, true);
+      return ROUTE_TYPE_NULL;
     }
+    m_pTrainProgress->setParked(t_locoNum, false);  // Leaving; so a later PARK mode doesn't think it's still Parked
+    return ROUTE_TYPE_EXTENSION;
+  }
+  if ((m_pTrainProgress->lastTrippedPtr(t_locoNum) == m_pTrainProgress->contPtr(t_locoNum)) &&
+      (m_pTrainProgress->contPtr(t_locoNum) != m_pTrainProgress->stationPtr(t_locoNum)) &&
+      (m_pBlockReservation->sidingType(destBlockNum) != SIDING_SINGLE_ENDED) &&
+      (!inParkingSiding)) {
+    return ROUTE_TYPE_CONTINUATION;
+  }
+  return ROUTE_TYPE_NULL;
+}
 
-  } // End-of-While-Loop
+routeElement Dispatcher::currentDestination(const byte t_locoNum) {
+  // Rev: 10/19/26.
+  // The train's current Destination is the last block element before its stop sensor, i.e. BW03.  This is also the Origin of
+  // any route we might add.  Walk backwards from stopPtr to find it; it will only be a few elements back.
+  byte elementNum = m_pTrainProgress->stopPtr(t_locoNum);
+  const byte tailPtr = m_pTrainProgress->tailPtr(t_locoNum);
+  while (true) {
+    m_routeElement = m_pTrainProgress->peek(t_locoNum, elementNum);
+    if ((m_routeElement.routeRecType == BE) || (m_routeElement.routeRecType == BW)) {
+      return m_routeElement;
+    }
+    if (elementNum == tailPtr) {  // Whoops, ran off the end of the route without finding a block
+      sprintf(lcdString, "NO DEST LOCO %i", t_locoNum); pLCD2004->println(lcdString); Serial.println(lcdString); endWithFlashingLED(5);
+    }
+    elementNum = m_pTrainProgress->decrementTrainProgressPtr(elementNum);
+  }
+}
 
+void Dispatcher::reserveRoute(const byte t_locoNum, const unsigned int t_routeRecNum) {
+  // Rev: 10/19/26.
+  // Reserve every block and turnout in the route for this loco.  Route_Reference::routeIsClear() has already confirmed nothing
+  // is reserved for anyone else.  Block_Reservation::reserveBlock() treats re-reserving our own block as fatal, so skip those.
+  for (byte elementNum = 0; elementNum < FRAM_SEGMENTS_ROUTE_REF; elementNum++) {
+    m_routeElement = m_pRoute->getElement(t_routeRecNum, elementNum);
+    if (m_routeElement.routeRecType == ER) {
+      return;
+    }
+    if ((m_routeElement.routeRecType == BE) || (m_routeElement.routeRecType == BW)) {
+      if (m_pBlockReservation->reservedForTrain(m_routeElement.routeRecVal) != t_locoNum) {
+        m_pBlockReservation->reserveBlock(m_routeElement.routeRecVal, m_routeElement.routeRecType, t_locoNum);
+      }
+    } else if ((m_routeElement.routeRecType == TN) || (m_routeElement.routeRecType == TR)) {
+      m_pTurnoutReservation->reserveTurnout(m_routeElement.routeRecVal, t_locoNum);  // Okay if already reserved for us
+    }
+  }
   return;
 }
 
-bool Dispatcher::trainPermittedInSiding(const byte t_locoNum, const routeElement t_blockNum) {
+void Dispatcher::throwTurnoutsToNextSensor(const byte t_locoNum) {
+  // Rev: 10/19/26.
+  // Throw every turnout from the element after t_locoNum's last-tripped sensor through its next sensor.  MAS calls this each time
+  // a train trips any sensor but its Stop sensor, and we call it when a stopped train gets an Extension route, so turnouts are
+  // thrown just ahead of the train and never under it.  All of them were reserved for this train when the route was assigned.
+  // Sending 'T'urnout messages to SWT will also be seen by LED to update green control panel LEDs.
+  byte elementNum = m_pTrainProgress->lastTrippedPtr(t_locoNum);
+  const byte headPtr = m_pTrainProgress->headPtr(t_locoNum);
+  while (true) {
+    elementNum = m_pTrainProgress->incrementTrainProgressPtr(elementNum);
+    if (elementNum == headPtr) {
+      return;  // End of the route; nothing more to throw
+    }
+    m_routeElement = m_pTrainProgress->peek(t_locoNum, elementNum);
+    if (m_routeElement.routeRecType == SN) {
+      return;
+    }
+    if ((m_routeElement.routeRecType == TN) || (m_routeElement.routeRecType == TR)) {
+      char turnoutDir = TURNOUT_DIR_NORMAL;
+      if (m_routeElement.routeRecType == TR) {
+        turnoutDir = TURNOUT_DIR_REVERSE;
+      }
+      if (m_pTurnoutReservation->reservedForTrain(m_routeElement.routeRecVal) != t_locoNum) {
+        sprintf(lcdString, "TURNOUT %i NOT RES", m_routeElement.routeRecVal); pLCD2004->println(lcdString); Serial.println(lcdString); endWithFlashingLED(5);
+      }
+      m_pMessage->sendMAStoALLTurnout(m_routeElement.routeRecVal, turnoutDir);
+      m_pTurnoutReservation->setLastOrientation(m_routeElement.routeRecVal, turnoutDir);
+    }
+  }
+}
 
-  return false;
+bool Dispatcher::allTrainsAreStopped(const byte t_mode) {
+  // Rev: 10/19/26.
+  // True if every active train has reached the end of its route (and, in PARK mode, has been flagged as Parked.)
+  for (byte locoNum = 1; locoNum <= TOTAL_TRAINS; locoNum++) {
+    if (!m_pTrainProgress->isActive(locoNum)) {
+      continue;
+    }
+    if (!m_pTrainProgress->atEndOfRoute(locoNum)) {
+      return false;
+    }
+    if ((t_mode == MODE_PARK) && (!m_pTrainProgress->isParked(locoNum))) {
+      return false;
+    }
+  }
+  return true;
+}
+
+void Dispatcher::noteActiveTrains() {
+  // Rev: 10/19/26.
+  // Train_Progress::setActive() is only called during Registration, so the active-train count can only change between Auto/Park
+  // sessions.  Called by startDispatching(), rather than counting as a side effect of startNextSearch() (which stops looking as
+  // soon as it finds a train that needs a route, and so would under-count.)
+  byte activeTrains = 0;
+  for (byte locoNum = 1; locoNum <= TOTAL_TRAINS; locoNum++) {
+    if (m_pTrainProgress->isActive(locoNum)) {
+      activeTrains++;
+    }
+  }
+  if (activeTrains > m_maxActiveTrains) {
+    m_maxActiveTrains = activeTrains;
+  }
+  return;
 }
 
 /*
@@ -215,4 +561,4 @@ bool Dispatcher::trainPermittedInSiding(const byte t_locoNum, const routeElement
 
 
 }
-*/
\ No newline at end of file
+*/
@@ -1,7 +1,26 @@
-// DISPATCHER.H Rev: 02/09/21.
+// DISPATCHER.H Rev: 10/19/26.
 // Part of O_MAS.
 // Run the layout in Auto or Park mode.
 
+// 10/19/26: dispatch() is now one pass, called from every pass of MAS's Auto/Park loop (which also handles incoming sensor
+//           changes), instead of a loop of its own that never looked at sensors.  Call startDispatching() once first.
+//           Dispatcher also throws each route's turnouts, from the train's last-tripped sensor through its next sensor.
+// 10/19/26: Search reservation masks are now blockBitmap/turnoutBitmap (see Train_Consts_Global.h.)
+// 10/19/26: Added the route selection engine.  Each pass through dispatch() calls selectRoutes(), which spends at most
+//           DISPATCH_BUDGET_MICROS evaluating candidate routes and then returns so we can get back to the Stop button, incoming
+//           messages, etc.  A search for a given train can span as many passes as needed; we remember where we left off.
+//           For each train that needs a route (stopped at the end of its route, or has just tripped its Continuation sensor):
+//           1. Walk every Route_Reference record whose Origin matches the train's current destination block.
+//           2. Reject routes whose Destination the train is not permitted in (trainPermittedInSiding(): length/forbidden/station.)
+//           3. Reject routes with any block or turnout reserved for another train (or STATIC.)
+//           4. Reject routes whose Destination would create a Deadlock (Deadlock_Reference::deadlockExists(); most expensive.)
+//           5. Score survivors by Priority (1 = best); in PARK mode a non-Park route is only used if no Park route is found.
+//           Since Routes are sorted by Origin + Priority + Destination, in AUTO mode the first survivor is the winner and we can
+//           stop looking.  Statistics (candidates per second, worst-case decision latency) via displayStats().
+//           Block and turnout reservations are checked with Route_Reference's precomputed bitmaps: we read the reservation tables
+//           once at the start of each search, and then each candidate costs just two ANDs.  Reservations can only be added by
+//           Dispatcher (after a search finishes), so the snapshot can't go stale in the unsafe direction during a search.
+
 // 03/27/23: DISPATCHER calls a function in Train Progress to know if it can assign a new route or not, for a given train.
 //           Will only call the function if the train is not Parked in Park mode, maybe also other factors.
 // Function returns const char: ROUTE_TYPE_NULL ('N'), ROUTE_TYPE_EXTENSION ('E'), or ROUTE_TYPE_CONTINUATION ('C')
@@ -87,17 +106,60 @@ class Dispatcher {
     void begin(Message* t_pMessage, Loco_Reference* t_pLoco, Block_Reservation* t_pBlockReservation,
                Turnout_Reservation* t_pTurnoutReservation, Sensor_Block* t_pSensorBlock, Route_Reference* t_pRoute,
                Deadlock_Reference* t_pDeadlock, Train_Progress* t_pTrainProgress, Mode_Dial* t_pModeSelector);
-    void dispatch(const byte t_mode, byte* t_state);  // Run the layout in Auto or Park mode
+    void startDispatching(const byte t_mode);  // Call once when Auto/Park starts; resets searches and statistics.
+    void dispatch(const byte t_mode, byte* t_state);  // One pass of Auto/Park route selection; may change t_state.
+    void throwTurnoutsToNextSensor(const byte t_locoNum);  // From lastTrippedPtr through the next SN element in Train Progress.
 
     // See if candidate destination is appropriate for this loco based on type (pass/frt) and length.
     bool trainPermittedInSiding(const byte t_locoNum, const routeElement t_blockNum);
     // NOTE: Dispatcher will call trainPermittedInSiding to see if a candidate destination is even an option, but then must call
     // Deadlock_Reference::deadlockExists(destination, locoNum);
 
+    void displayStats();  // Send route selection statistics (candidates/sec, worst-case decision latency) to the Serial monitor.
+
   private:
 
+    // Evaluate candidate routes for up to DISPATCH_BUDGET_MICROS, then return.  Assigns a route when a search completes.
+    void selectRoutes(const byte t_mode, const byte t_state);
+    bool startNextSearch(const byte t_mode);  // Find the next train that needs a route; returns false if none.
+    bool evaluateNextCandidate(const byte t_mode);  // Returns true when the current search is complete.
+    void finishSearch();  // Assign the best route found (if any) and record statistics.
+    char routeTypeNeeded(const byte t_locoNum, const byte t_mode);  // ROUTE_TYPE_NULL, _EXTENSION, or _CONTINUATION
+    routeElement currentDestination(const byte t_locoNum);  // Last BE/BW block in this loco's Train Progress i.e. BW03
+    void reserveRoute(const byte t_locoNum, const unsigned int t_routeRecNum);  // Reserve all blocks and turnouts in a route
+    bool allTrainsAreStopped(const byte t_mode);  // True if every active train is at the end of its route (and Parked if PARK.)
+    void noteActiveTrains();  // Update m_maxActiveTrains from Train Progress.
+
+    const unsigned long DISPATCH_BUDGET_MICROS      = 5000;  // Max time per pass of dispatch() spent evaluating candidate routes.
+    const unsigned long DISPATCH_RETRY_MS           = 2000;  // Wait this long before re-trying a train that found no route.
+    const unsigned int  DISPATCH_EXTENSION_DELAY_MS = 3000;  // Stopped trains wait this long before departing on a new route.
+    const byte          DISPATCH_PARK_PENALTY       =   10;  // Added to Priority of non-Park routes in PARK mode.
+
     routeElement m_routeElement;
 
+    // Search-in-progress state, so a search can be spread across several passes of dispatch().
+    byte          m_searchLocoNum;       // LOCO_ID_NULL if no search in progress, else 1..TOTAL_TRAINS
+    char          m_searchRouteType;     // ROUTE_TYPE_EXTENSION or ROUTE_TYPE_CONTINUATION
+    routeElement  m_searchOrigin;        // i.e. BW03; Origin of candidate routes = current Destination of this train
+    unsigned int  m_searchRecNum;        // Next Route Reference rec num to evaluate
+    blockBitmap   m_searchBlockBits;     // Blocks reserved for other trains when the search started
+    turnoutBitmap m_searchTurnoutBits;   // Turnouts reserved for other trains when the search started
+    bool          m_searchDone;          // True when there are no more candidates with a matching Origin
+    unsigned int  m_bestRecNum;          // Best candidate found so far (only valid if m_bestScore < 255)
+    byte          m_bestScore;           // Priority 1..5 (plus DISPATCH_PARK_PENALTY); 255 = no candidate found yet
+    unsigned long m_searchStartMicros;   // When the current search began, for decision latency
+    byte          m_nextLocoToCheck;     // Round-robin starting point so every train gets a fair shot at a route
+    unsigned long m_retryTime[TOTAL_TRAINS];  // millis() before which we won't search again for a train that found no route
+
+    // Statistics reported by displayStats().
+    unsigned long m_statsStartMillis;    // When we started counting (start of dispatch())
+    unsigned long m_candidatesEvaluated; // Total candidate routes examined
+    unsigned long m_decisionsMade;       // Total searches completed, whether or not a route was found
+    unsigned long m_routesAssigned;      // Total searches that resulted in a route being assigned
+    unsigned long m_worstDecisionMicros; // Longest wall-clock time from start of a search to its decision
+    unsigned long m_worstPassMicros;     // Longest time spent in a single call to selectRoutes()
+    byte          m_maxActiveTrains;     // Most active trains seen while dispatching, so we know what the stats represent
+
     Message* m_pMessage;
     Loco_Reference* m_pLoco;
     Block_Reservation* m_pBlockReservation;
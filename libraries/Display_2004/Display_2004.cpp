@@ -1,18 +1,22 @@
-// DISPLAY_2004.CPP Rev: 12/06/20.
+// DISPLAY_2004.CPP Rev: 10/19/26.
+// 10/19/26: Added queued mode (setQueued(), service(), flush()); rows are now m_line[0..3] rather than lineA..lineD.
+// 10/19/26: Queued mode's ring and shown[] are allocated by the first setQueued(true), not in every module.
 #include "Display_2004.h"
 
 Display_2004::Display_2004(HardwareSerial * t_hdwrSerial, long unsigned int t_baud):DigoleSerialDisp(t_hdwrSerial, t_baud) {
   // Constructor
   // DigoleSerialDisp is the name of the class in DigoleSerial.h/.cpp.  This is what talks directly to the LCD.
+  m_pSerial = t_hdwrSerial;
+  m_pQueue = nullptr;
+  m_queued = false;
   return;
 }
 
 void Display_2004::begin() {
-  // Remember LCD_WIDTH = 20.  Each "lineX" array is LCD_WIDTH + 1 = 21 bytes.  Set byte 21 (offset 20) to null.
-  memset(lineA, ' ', LCD_WIDTH); lineA[LCD_WIDTH] = '\0';
-  memset(lineB, ' ', LCD_WIDTH); lineB[LCD_WIDTH] = '\0';
-  memset(lineC, ' ', LCD_WIDTH); lineC[LCD_WIDTH] = '\0';
-  memset(lineD, ' ', LCD_WIDTH); lineD[LCD_WIDTH] = '\0';
+  // Remember LCD_WIDTH = 20.  Each m_line[] array is LCD_WIDTH + 1 = 21 bytes.  Set byte 21 (offset 20) to null.
+  for (byte row = 0; row < LCD_ROWS; row++) {
+    memset(m_line[row], ' ', LCD_WIDTH); m_line[row][LCD_WIDTH] = '\0';  // Which is what clearScreen() leaves us with
+  }
   DigoleSerialDisp::digoleBegin();               // Required to initialize LCD (renamed Digole's "begin" to not duplicate our LCD wrapper class "begin")
   DigoleSerialDisp::setLCDColRow(LCD_WIDTH, 4);  // Maps starting RAM address on LCD (if other than 1602)
   DigoleSerialDisp::disableCursor();             // We don't need to see a cursor on the LCD
@@ -24,6 +28,7 @@ void Display_2004::begin() {
 }
 
 void Display_2004::println(const char t_nextLine[]) {
+  // Rev: 10/19/26.
   // println() scrolls the bottom 3 (of 4) lines up one line, and inserts the passed text into the bottom line of the LCD.
   // t_nextLine[] is a 20-byte max character string with a null terminator.
   // Sample calls:
@@ -34,36 +39,29 @@ void Display_2004::println(const char t_nextLine[]) {
   //   int a = 7; unsigned long t = millis(); char c = 'R';
   //   sprintf(lcdString, "I %3i T %6lu C %3c", a, t, c);  // Will also crash if longer than 20 chars!
   //   LCD.println(lcdString);            // i.e. "I...7.T...3149.C...R"
+  // In queued mode we only copy the line into the ring, which takes a few microseconds; service() will display it.  If the ring
+  // is full, we drop the oldest waiting line to make room, so the LCD stays current, and count it so service() can say so.
 
   // If the incoming char array (string) is longer than the 21-byte array (20 chars plus null), then we will
   // have stepped on memory and must declare a fatal programming error.
   if ((t_nextLine == (char *)NULL) || (strlen(t_nextLine) > LCD_WIDTH)) endWithFlashingLED(2);
-  // Scroll all lines up to make room for the new bottom line.
-  strcpy(lineA, lineB);
-  strcpy(lineB, lineC);
-  strcpy(lineC, lineD);
-  strncpy(lineD, t_nextLine, LCD_WIDTH);         // Copy the new bottom line into lineD, padded to 20 chars with nulls.
-  int newLineLen = strlen(lineD);    // Get the length of the new bottom line (to the first null char.)
-  // Pad the new bottom line with trailing spaces as needed.
-  while (newLineLen < LCD_WIDTH) lineD[newLineLen++] = ' ';  // Last byte not touched; always remains "null."
-  // Update the display.  Updated 10/28/16 by TimMe to add delays to fix rare random chars on display.
-  DigoleSerialDisp::setPrintPos(0, 0);
-  DigoleSerialDisp::print(lineA);
-  delay(1);
-  DigoleSerialDisp::setPrintPos(0, 1);
-  DigoleSerialDisp::print(lineB);
-  delay(2);
-  DigoleSerialDisp::setPrintPos(0, 2);
-  DigoleSerialDisp::print(lineC);
-  delay(3);
-  DigoleSerialDisp::setPrintPos(0, 3);
-  DigoleSerialDisp::print(lineD);
-  delay(1);
+  if (!m_queued) {
+    scrollIn(t_nextLine);
+    paintAllRows();
+    return;
+  }
+  if (m_pQueue->count == LCD_QUEUE_LINES) {
+    m_pQueue->head = (m_pQueue->head + 1) % LCD_QUEUE_LINES;
+    m_pQueue->count--;
+    m_pQueue->droppedLines++;
+  }
+  strcpy(m_pQueue->lines[(m_pQueue->head + m_pQueue->count) % LCD_QUEUE_LINES], t_nextLine);
+  m_pQueue->count++;
   return;
 }
 
 void Display_2004::printRowCol(const byte row, const byte col, const char t_nextLine[]) {
-  // Rev: 06-30-24.
+  // Rev: 10/19/26.
   // Row 1..4, Col 1..20.
   // Prints char(s) of text at a specific row and column, rather than scrolling up lines 2..4 and printing on row 4, col 1.
   // If the incoming char array (string) is longer than the 21-byte array (20 chars plus null), then we will
@@ -73,27 +71,167 @@ void Display_2004::printRowCol(const byte row, const byte col, const char t_next
       ((strlen(t_nextLine) + col - 1) > LCD_WIDTH)) {
       endWithFlashingLED(2);
   }
+  // In queued mode, any lines still waiting in the ring were printed before this, so scroll them in first (without sending) to
+  // keep things in order.  service() will send whatever has changed.
+  if (m_queued) {
+    while (m_pQueue->count > 0) {
+      scrollIn(m_pQueue->lines[m_pQueue->head]);
+      m_pQueue->head = (m_pQueue->head + 1) % LCD_QUEUE_LINES;
+      m_pQueue->count--;
+    }
+  }
   // We are assured via above test that our new string at it's position won't exceed the width of the LCD.
-  if (row == 1) {
-    memcpy(lineA + col - 1, t_nextLine, strlen(t_nextLine));  // Drop the new text into the line.
-    DigoleSerialDisp::setPrintPos(0, 0);
-    DigoleSerialDisp::print(lineA);
-  } else if (row == 2) {
-    memcpy(lineB + col - 1, t_nextLine, strlen(t_nextLine));  // Drop the new text into the line.
-    DigoleSerialDisp::setPrintPos(0, 1);
-    DigoleSerialDisp::print(lineB);
-  } else if (row == 3) {
-    memcpy(lineC + col - 1, t_nextLine, strlen(t_nextLine));  // Drop the new text into the line.
-    DigoleSerialDisp::setPrintPos(0, 2);
-    DigoleSerialDisp::print(lineC);
-  } else if (row == 4) {
-    memcpy(lineD + col - 1, t_nextLine, strlen(t_nextLine));  // Drop the new text into the line.
-    DigoleSerialDisp::setPrintPos(0, 3);
-    DigoleSerialDisp::print(lineD);
+  memcpy(m_line[row - 1] + col - 1, t_nextLine, strlen(t_nextLine));  // Drop the new text into the line.
+  if (!m_queued) {
+    DigoleSerialDisp::setPrintPos(0, row - 1);
+    DigoleSerialDisp::print(m_line[row - 1]);
   }
   return;
 }
 
+void Display_2004::setQueued(const bool t_queued) {
+  // Rev: 10/19/26.
+  // Turning queued mode off waits for everything already queued to be shown, so println() can go back to writing directly.
+  // The ring is allocated the first time we're queued, and kept.  Outside queued mode the LCD always shows m_line[], so that's
+  // what we start from each time.
+  if (!t_queued) {
+    flush();
+    m_queued = false;
+    return;
+  }
+  if (m_queued) {
+    return;
+  }
+  if (m_pQueue == nullptr) {
+    m_pQueue = new queueStruct;
+    if (m_pQueue == nullptr) {
+      endWithFlashingLED(2);
+    }
+  }
+  for (byte row = 0; row < LCD_ROWS; row++) {
+    memcpy(m_pQueue->shown[row], m_line[row], LCD_WIDTH);
+  }
+  m_pQueue->head = 0;
+  m_pQueue->count = 0;
+  m_pQueue->droppedLines = 0;
+  m_pQueue->lastSendUs = micros() - LCD_SEND_GAP_US;
+  m_queued = true;
+  return;
+}
+
+void Display_2004::service() {
+  // Rev: 10/19/26.
+  // When the LCD has caught up with m_line[], scroll in the next waiting line (or the dropped-line count, which goes where the
+  // dropped lines would have been.)  Then send one run of changed chars, but only as much as fits in Serial1's transmit buffer
+  // so write() never has to wait for room.  A newly scrolled-in screen takes four passes (one row per pass) to send.
+  if (!m_queued || ((micros() - m_pQueue->lastSendUs) < LCD_SEND_GAP_US)) {
+    return;
+  }
+  byte row;
+  byte col;
+  if (!findChange(&row, &col)) {
+    if (m_pQueue->droppedLines > 0) {
+      char droppedLine[LCD_WIDTH + 1];
+      sprintf(droppedLine, "LCD DROPPED %u", m_pQueue->droppedLines);
+      m_pQueue->droppedLines = 0;
+      scrollIn(droppedLine);
+    } else if (m_pQueue->count > 0) {
+      scrollIn(m_pQueue->lines[m_pQueue->head]);
+      m_pQueue->head = (m_pQueue->head + 1) % LCD_QUEUE_LINES;
+      m_pQueue->count--;
+    }
+    if (!findChange(&row, &col)) {
+      return;  // Nothing waiting, or the new screen looks just like the old one
+    }
+  }
+  // The run ends at the last changed char in this row, bridging any unchanged chars that are cheaper to re-send than to skip.
+  byte runEnd = col;
+  for (byte c = col + 1; c < LCD_WIDTH; c++) {
+    if (m_line[row][c] != m_pQueue->shown[row][c]) {
+      if ((c - runEnd - 1) > LCD_RUN_OVERHEAD) {
+        break;
+      }
+      runEnd = c;
+    }
+  }
+  int runLen = runEnd - col + 1;
+  int room = m_pSerial->availableForWrite() - LCD_RUN_OVERHEAD;
+  if (room < 1) {
+    return;  // Still sending the last run; try again next pass
+  }
+  if (runLen > room) {
+    runLen = room;
+  }
+  char run[LCD_WIDTH + 1];
+  memcpy(run, &m_line[row][col], runLen);
+  run[runLen] = '\0';
+  DigoleSerialDisp::setPrintPos(col, row);
+  DigoleSerialDisp::print(run);
+  memcpy(&m_pQueue->shown[row][col], run, runLen);
+  m_pQueue->lastSendUs = micros();
+  return;
+}
+
+void Display_2004::flush() {
+  // Rev: 10/19/26.
+  // Blocks until the LCD shows everything we've been asked to print.  Does nothing if we aren't in queued mode.
+  if (!m_queued) {
+    return;
+  }
+  byte row;
+  byte col;
+  while ((m_pQueue->count > 0) || (m_pQueue->droppedLines > 0) || findChange(&row, &col)) {
+    service();
+  }
+  return;
+}
+
+void Display_2004::scrollIn(const char t_nextLine[]) {
+  // Rev: 10/19/26.
+  // Scroll all lines up to make room for the new bottom line.
+  for (byte row = 0; row < (LCD_ROWS - 1); row++) {
+    strcpy(m_line[row], m_line[row + 1]);
+  }
+  char* bottomLine = m_line[LCD_ROWS - 1];
+  strncpy(bottomLine, t_nextLine, LCD_WIDTH);  // Copy the new bottom line, padded to 20 chars with nulls.
+  int newLineLen = strlen(bottomLine);         // Get the length of the new bottom line (to the first null char.)
+  // Pad the new bottom line with trailing spaces as needed.
+  while (newLineLen < LCD_WIDTH) bottomLine[newLineLen++] = ' ';  // Last byte not touched; always remains "null."
+  return;
+}
+
+void Display_2004::paintAllRows() {
+  // Rev: 10/19/26.
+  // Update the display.  Updated 10/28/16 by TimMe to add delays to fix rare random chars on display.
+  DigoleSerialDisp::setPrintPos(0, 0);
+  DigoleSerialDisp::print(m_line[0]);
+  delay(1);
+  DigoleSerialDisp::setPrintPos(0, 1);
+  DigoleSerialDisp::print(m_line[1]);
+  delay(2);
+  DigoleSerialDisp::setPrintPos(0, 2);
+  DigoleSerialDisp::print(m_line[2]);
+  delay(3);
+  DigoleSerialDisp::setPrintPos(0, 3);
+  DigoleSerialDisp::print(m_line[3]);
+  delay(1);
+  return;
+}
+
+bool Display_2004::findChange(byte* t_row, byte* t_col) {
+  // Rev: 10/19/26.  Queued mode only.
+  for (byte row = 0; row < LCD_ROWS; row++) {
+    for (byte col = 0; col < LCD_WIDTH; col++) {
+      if (m_line[row][col] != m_pQueue->shown[row][col]) {
+        *t_row = row;
+        *t_col = col;
+        return true;
+      }
+    }
+  }
+  return false;
+}
+
 // *****************************************************************
 // *************** OLD NOTES JUST KEPT FOR REFERENCE ***************
 // *****************************************************************
@@ -1,8 +1,12 @@
-// DISPLAY_2004.H Rev: 06-30-24.
+// DISPLAY_2004.H Rev: 10/19/26.
 // Handles display of messages from the modules to the 20-char, 4-line (2004) Digole LCD display.
 // It simplifies use of the LCD display by encapsulating all of the initialization and scrolling logic within the class.
 // Display_2004 is a child class of parent DigoleSerialDisp, in order to be able to make both of them static, via a
 // single instantiation from the main program.
+// 10/19/26: Added queued mode for Auto/Park loops: println() just adds the line to a small ring, and service(), called once per
+//           pass, scrolls it in and sends only the changed characters to the LCD, without delay().  If the ring fills, the
+//           oldest waiting lines are dropped and "LCD DROPPED n" is shown in their place.  The ring and the copy of what's on
+//           the LCD (~260 bytes) are only allocated the first time setQueued(true) is called, so SNS, BTN, SWT and LED never pay.
 // 06-30-24: Added printRowCol() function to print char(s) at specific row 1..4 and col 1..20.
 // 12/06/20: SAVED 84 BYTES SRAM!  Re-wrote to put the four 21-char arrays on the heap.
 
@@ -26,14 +30,38 @@ class Display_2004 : private DigoleSerialDisp {
     void println(const char t_nextLine[]);  // Scroll rows 2..4 up to rows 1..3, and display new line at row 4.
     void printRowCol(const byte row, const byte col, const char t_nextLine[]);  // Row 1..4, Col 1..20
 
+    void setQueued(const bool t_queued);  // true when Auto/Park starts; false when it ends (waits for the LCD to catch up.)
+    void service();  // Call once per pass of the Auto/Park loop when queued.  Sends at most one short run of chars; never waits.
+    void flush();    // Wait until every queued line has been shown.  Called by endWithFlashingLED() so the error is visible.
+
   protected:
 
   private:
 
-    char lineA[LCD_WIDTH + 1];  // 20 characters plus null terminator (required!)
-    char lineB[LCD_WIDTH + 1];  // Confirmed these buffers are stored on the HEAP not the stack 12/6/20.
-    char lineC[LCD_WIDTH + 1];
-    char lineD[LCD_WIDTH + 1];
+    static const byte LCD_ROWS = 4;
+    static const byte LCD_QUEUE_LINES = 8;      // Lines println() can get ahead of the LCD in queued mode; 21 bytes each.
+    static const byte LCD_RUN_OVERHEAD = 7;     // "TP" x y before a run of chars, "TT" before it and a null after it.
+    static const unsigned int LCD_SEND_GAP_US = 2000;  // Let the Digole digest each run; replaces the old delay()s between rows.
+
+    void scrollIn(const char t_nextLine[]);     // Scroll m_line[] up and put t_nextLine on the bottom row; doesn't send.
+    void paintAllRows();                        // Blocking rewrite of all four rows, as println() has always done.
+    bool findChange(byte* t_row, byte* t_col);  // First char of m_line[] that's not yet on the LCD, if any.
+
+    HardwareSerial* m_pSerial;  // Same port as DigoleSerialDisp's, so service() can see how much room is left to send.
+
+    char m_line[LCD_ROWS][LCD_WIDTH + 1];  // What should be on the LCD: 20 characters plus null terminator (required!)
+                                           // Confirmed these buffers are stored on the HEAP not the stack 12/6/20.
+
+    struct queueStruct {                   // Queued mode only; see header.
+      char shown[LCD_ROWS][LCD_WIDTH];     // What we've actually sent to the LCD.
+      char lines[LCD_QUEUE_LINES][LCD_WIDTH + 1];  // Ring of lines waiting to be scrolled in by service()
+      byte head;                           // Oldest waiting line
+      byte count;
+      unsigned int droppedLines;           // Waiting lines pushed out of a full ring, not yet reported on the LCD.
+      unsigned long lastSendUs;            // micros(), not millis(), so the gap is never less than LCD_SEND_GAP_US.
+    };
+    queueStruct* m_pQueue;                 // nullptr until setQueued(true) is first called.
+    bool m_queued;
 
 };
 
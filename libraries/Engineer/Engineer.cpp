@@ -1,5 +1,12 @@
-// ENGINEER.CPP Rev: 09/02/24.
+// ENGINEER.CPP Rev: 10/19/26.
 // Part of O_LEG.
+// 10/19/26: Legacy Command Buffer comes from the QuadRAM arena, and the small, hot urgent buffer from the internal SRAM arena.
+// 10/19/26: executeConductorCommand() times its two halves via setProfiler()'s Loop_Profiler, if any.
+// 10/19/26: Commands retrieved from Delayed Action are logged to the Event_Journal, if any.
+// 10/19/26: translateToLegacy() and translateToTMCC() are now driven by PROGMEM encoding tables rather than a switch per command.
+//           Also fixes TMCC_DIALOGUE falling through into the "TMCC BAD CMD" default and halting.
+// 10/19/26: Urgent lane for Stop Immed/Emergency Stop/PowerMasters; pace at LEGACY_CMD_SPACING (25ms) rather than a fixed 30ms.
+// 10/19/26: Coalesce superseded Abs Speed commands in commandBufEnqueue(); added displayStats().
 // 09/02/24: Removed various update T.P. header currentSpeed etc. from getDelayedActionCommand().  Instead we do this the moment
 //           we send speed commands to the Legacy Base from the Legacy Command Buffer.
 // 07/01/24: Moved "Update Train Progress loco speed" from getDelayedActionCommand() into sendCommandToTrain().  The problem was
@@ -30,9 +37,14 @@
 // UPDATE 6/22: Confirmed that monitoring WiFi serial commands originated from the CAB-2 controller, I don't see any commands ever
 // being duplicated.  So this must all be happening behind the scenes by the Legacy base and I don't need to worry about it.
 
-// Minimum time of LEGACY_CMD_DELAY (30ms) must have passed since the last 3-/6-/9-byte instruction was sent to the Legacy Base.
+// 10/19/26: Commands now start LEGACY_CMD_SPACING (25ms, the minimum found below) apart rather than 30ms, or the command's wire
+// time at SERIAL3_SPEED (~1.04ms/byte at 9600 baud) if that were ever longer.  So the base gets about 22ms of quiet after a
+// 3-byte command and 16ms after a 9-byte one, and we can send 20% more commands per second.  Stop Immed, Emergency Stop and
+// PowerMaster commands use a separate urgent buffer that is always emptied first, so they wait at most for the one command
+// already on the wire.
+// LEGACY_CMD_SPACING must have passed since the last 3-/6-/9-byte instruction started going out to the Legacy Base.
 // This is due to a limitation of the Legacy Base, which will ignore commands sent less than about 25ms apart.  The Delayed Action
-// class will still remove from the Delayed Action table as soon as they are ripe; the Engineer is responsible for the 30ms
+// class will still remove from the Delayed Action table as soon as they are ripe; the Engineer is responsible for the
 // separation.  Engineer can assume that if it's given a command from Delayed Action, it should be executed as quickly as possible.
 // PER PROF. CHAOS, if  you are sending multiple 3-byte commands, you have to wait ~ 30 milliseconds between sets of 3/6/9 byte
 // commands or the Base will ignore them. The approach I take is to deposit TMCC commands into a circular buffer.  Then every pass
@@ -45,20 +57,28 @@
 Engineer::Engineer() {  // Constructor
   // HEAP STORAGE: We want the PRIVATE 200 (or whatever) element nine-byte buffer (struct) array to reside on the HEAP.  We will
   // allocate the memory using "new" in the constructor, and point our private pointer at it.
-  m_pLegacyCommandBuf = new legacyCommandStruct[LEGACY_CMD_HEAP_RECS];
+  // 10/19/26: Both buffers now come from arenaAllocate().  The urgent buffer is only 90 bytes and is checked on every pass
+  // through loop(), so it goes in internal SRAM.
+  m_pLegacyCommandBuf = (legacyCommandStruct*)arenaAllocate(F("Legacy Command Buf"),
+                                                            sizeof(legacyCommandStruct) * LEGACY_CMD_HEAP_RECS, ARENA_QUADRAM);
+  m_pLegacyUrgentBuf = (legacyCommandStruct*)arenaAllocate(F("Legacy Urgent Buf"),
+                                                           sizeof(legacyCommandStruct) * LEGACY_CMD_URGENT_RECS, ARENA_INTERNAL);
   return;
 }
 
-void Engineer::begin(Loco_Reference* t_pLoco, Train_Progress* t_pTrainProgress, Delayed_Action* t_pDelayedAction) {
-  // Rev: 02/17/23.  We'll call this when we initialize the Engineer object right after calling the constructor, but we should ALSO
+void Engineer::begin(Loco_Reference* t_pLoco, Train_Progress* t_pTrainProgress, Delayed_Action* t_pDelayedAction,
+                     Event_Journal* t_pJournal) {
+  // Rev: 10/19/26.  We'll call this when we initialize the Engineer object right after calling the constructor, but we should ALSO
   // call this function each time Registration begins, to properly reset the Legacy Cmd Buf release Accessory Relays.
   // SHIFT REGISTER LOGIC WILL CRASH THE SYSTEM IF CENTIPEDE NOT HOOKED UP.
-  m_legacyLastTransmit = millis();  // Update each time we actually send a command to prevent Lionel Legacy base hardware overflow.
+  m_legacyLastTransmit = micros();  // Update each time we actually send a command to prevent Lionel Legacy base hardware overflow.
+  m_legacyTransmitInterval = 0;     // Nothing on the wire yet.
   // 2/17/23 m_pShiftRegister is NOT NEEDED as pShiftRegister is "extern" in Train_Functions.h
   // m_pShift_Register = t_pShift_Register;  // For accessory relay control.
   m_pLoco          = t_pLoco;           // Where we'll look up device type E/T/N/R/A
   m_pTrainProgress = t_pTrainProgress;  // We'll update Train Progress current loco speed as commands are retrieved.
   m_pDelayedAction = t_pDelayedAction;  // Where we'll retrieve "ripe" commands, to send to Legacy Cmd Buffer, thence loco.
+  m_pJournal       = t_pJournal;        // Okay to be nullptr
   if ((m_pLoco == nullptr) || (m_pTrainProgress == nullptr) || (m_pDelayedAction == nullptr)) {
     sprintf(lcdString, "UN-INIT'd ER PTR"); pLCD2004->println(lcdString); Serial.println(lcdString); endWithFlashingLED(5);
   }
@@ -78,6 +98,15 @@ void Engineer::initLegacyCommandBuf(bool t_debugOn) {  // Size will be LEGACY_CM
   m_legacyCommandBufHead = 0;  // Next array element to be written.
   m_legacyCommandBufTail = 0;  // Next array element to be removed.
   m_legacyCommandBufCount = 0;  // Num active elements in buffer; i.e. LEGACY_CMD_HEAP_RECS
+  m_legacyUrgentBufHead = 0;
+  m_legacyUrgentBufTail = 0;
+  m_legacyUrgentBufCount = 0;
+  m_legacyUrgentSent = 0;
+  m_legacyUrgentWorstWait = 0;
+  m_legacyCommandsCancelled = 0;
+  m_legacyCommandsQueued = 0;
+  m_legacyCommandsCoalesced = 0;
+  m_legacyCommandBufMaxCount = 0;
   // Initializing every element to zero is redundant since it's done every time we populate a command, but what the heck.
   for (int i = 0; i < LEGACY_CMD_HEAP_RECS; i++) {  // LEGACY_CMD_HEAP_RECS i.e. 0..199 for 200 records
     for (byte j = 0; j < LEGACY_CMD_BYTES; j++) {   // Always 9 bytes, 0..8
@@ -98,14 +127,43 @@ void Engineer::initAccessoryRelays() {
 }
 
 void Engineer::executeConductorCommand() {
+  // Rev: 10/19/26.  Times each half with the Loop_Profiler; Legacy cmds now paced at LEGACY_CMD_SPACING with an urgent lane.
   // Rev: 02/12/23.
   // Get a command from the Delayed Action table, if any, and execute a command from the Legacy Command buffer, if any.
   // We call it Execute *Conductor* Cmd because all Delayed Action (and thus Legacy Cmd Buf) commands originate with Conductor.
   // This function should be called as frequently as possible when running in Auto or Park modes.
   // The getDelayedActionCommand() function will ensure that only ripe commands are retrieved.
   // The sendCommandToTrain() function will ensure that Legacy/TMCC cmds are spaced in time as req'd by the Legacy base.
-  Engineer::getDelayedActionCommand();
-  Engineer::sendCommandToTrain();
+  // 10/19/26: Each half is timed separately since either one could be what's making us late.  Loop_Timer ignores nullptr.
+  {
+    Loop_Timer timer(m_pProfiler, LOOP_STAGE_DELAYED_ACTION);
+    Engineer::getDelayedActionCommand();
+  }
+  {
+    Loop_Timer timer(m_pProfiler, LOOP_STAGE_ENGINEER_SEND);
+    Engineer::sendCommandToTrain();
+  }
+  return;
+}
+
+void Engineer::setProfiler(Loop_Profiler* t_pProfiler) {
+  // Rev: 10/19/26.
+  m_pProfiler = t_pProfiler;
+  return;
+}
+
+void Engineer::displayStats() {
+  // Rev: 10/19/26.
+  // Each coalesced command is one less 3-byte transmit slot (LEGACY_CMD_SPACING) that every command queued behind it had to
+  // wait for.
+  const unsigned long slotMicros = LEGACY_CMD_SPACING * 1000UL;
+  Serial.print(F("Legacy cmds queued: ")); Serial.print(m_legacyCommandsQueued);
+  Serial.print(F(", coalesced: ")); Serial.print(m_legacyCommandsCoalesced);
+  Serial.print(F(", max waiting: ")); Serial.print(m_legacyCommandBufMaxCount);
+  Serial.print(F(", ms saved: ")); Serial.println(((unsigned long)m_legacyCommandsCoalesced * slotMicros) / 1000UL);
+  Serial.print(F("Legacy urgent sent: ")); Serial.print(m_legacyUrgentSent);
+  Serial.print(F(", worst wait ms: ")); Serial.print(m_legacyUrgentWorstWait);
+  Serial.print(F(", speeds cancelled: ")); Serial.println(m_legacyCommandsCancelled);
   return;
 }
 
@@ -114,7 +172,7 @@ void Engineer::executeConductorCommand() {
 // *******************************************
 
 void Engineer::getDelayedActionCommand() {
-  // Rev: 05/03/24.
+  // Rev: 10/19/26.
   // Retrieve a ripe record (if any) from the Delayed Action table (human-readable version), then:
   //   a. If the record is an Accessory-control command, then activate or deactivate a relay
   //   b. If the record is a Legacy or TMCC, Engine orTrain command, then:
@@ -138,10 +196,16 @@ void Engineer::getDelayedActionCommand() {
   if (!m_pDelayedAction->getAction(&m_devType, &m_devNum, &m_devCommand, &m_devParm1, &m_devParm2)) {
     return;  // If NOT found, returns false to indicate there wasn't a ripe record and thus nothing to do.
   }
+  if (m_pJournal != nullptr) {
+    m_pJournal->log(JOURNAL_EVENT_LEGACY_CMD, m_devNum, 0, m_devCommand, m_devParm1);
+  }
 
   // Got a Delayed Action record; it could be an Accessory, or a 3/6/9-byte Legacy or TMCC command...
   // t_devType must be [E|T|N|R|A]: Engine (Legacy), or Train (Legacy), eNgine (TMCC), tRain (TMCC), Accessory
   // Note that the PowerMasters are stored as Legacy Engine absolute speed commands (0 = off, 1 = on.)
+  // Stops and PowerMasters are safety-critical, so they go in the urgent buffer ahead of whatever else is waiting.
+  bool urgent = ((m_devCommand == LEGACY_ACTION_STOP_IMMED) || (m_devCommand == LEGACY_ACTION_EMERG_STOP) ||
+                 ((m_devNum >= LOCO_ID_POWERMASTER_1) && (m_devNum <= LOCO_ID_POWERMASTER_4)));
 
   // Is this a LEGACY Engine or Train command?
   if ((m_devType == DEV_TYPE_LEGACY_ENGINE) || (m_devType == DEV_TYPE_LEGACY_TRAIN)) {
@@ -152,7 +216,7 @@ void Engineer::getDelayedActionCommand() {
     // First we must translate the Delayed Action data into a 3-, 6-, or 9-byte Legacy command.
     m_legacyCommandRecord = translateToLegacy(m_devNum, m_devCommand, m_devParm1, m_devParm2);
     // Then we'll enqueue it into the Legacy/TMCC command buffer (to be executed within milliseconds, we presume.)
-    commandBufEnqueue(m_legacyCommandRecord);  // Insert Legacy command into the circular buffer.
+    commandBufEnqueue(m_legacyCommandRecord, urgent);  // Insert Legacy command into the circular buffer.
     return;  // If LEGACY_ENGINE or LEGACY_TRAIN command, we're done.
   }
 
@@ -165,7 +229,7 @@ void Engineer::getDelayedActionCommand() {
     // First we must translate the Delayed Action data into a 3- or 6-byte TMCC command.
     m_legacyCommandRecord = translateToTMCC(m_devNum, m_devCommand, m_devParm1, m_devParm2);
     // Then we'll enqueue it into the Legacy/TMCC command buffer (to be executed within milliseconds, we presume.)
-    commandBufEnqueue(m_legacyCommandRecord);  // Insert TMCC command into the circular buffer.
+    commandBufEnqueue(m_legacyCommandRecord, urgent);  // Insert TMCC command into the circular buffer.
     return;  // If TMCC_ENGINE or TMCC_TRAIN command, we're done.
   }
 
@@ -192,7 +256,7 @@ void Engineer::getDelayedActionCommand() {
 void Engineer::sendCommandToTrain() {
   // Rev: 08/05/24.  Has not been tested with a TMCC loco, especially keeping Train Progress speed/time fields up to date **********************************
   // This function must be called as frequently as possible (every time through loop) by Engineer to keep things moving.
-  // Dequeues up to one "plain English" record, if any, from the Legacy/TMCC Command Buffer (not more often than each 30ms).
+  // Dequeues up to one "plain English" record, if any, from the urgent or Legacy/TMCC Command Buffer (paced for the Legacy base.)
   // If a record is found, translate to Legacy/TMCC hex and forward to the Legacy Command Base via the RS-232 interface.
   // We'll use our class global 9-byte struct variable m_legacyCommandRecord to hold our working command.
   // 07/01/24: Updated this function to update Train Progress speed, speed-time, stopped, and time-stopped fields whenever a
@@ -202,7 +266,7 @@ void Engineer::sendCommandToTrain() {
   // will think that our loco has achieved a certain speed slightly before the command has actually been sent to the loco.
 
   // First see if we have a 3/6/9-byte commands in the Legacy circular buffer that can be transmitted...  We'll only get
-  // something if there is a record available *and* it has been at least 30ms since the last command was sent to the Legacy base.
+  // something if there is a record available *and* LEGACY_CMD_SPACING has passed since the last command started.
   // If there is data, it's returned via pointer (m_legacyCommandRecord.)
   bool success = commandBufDequeue(&m_legacyCommandRecord);  // Will return nine zeroes if nothing; else populate command record.
   // If we got a Legacy command from the circular buffer (queue), then send it along to the Legacy base.
@@ -317,38 +381,157 @@ void Engineer::controlAccessoryRelay(byte t_RelayNum, byte t_CloseOrOpen) {
   return;
 }
 
+// 10/19/26: Legacy and TMCC encoding tables.  Rather than a long switch statement per command, translateToLegacy() and
+// translateToTMCC() look up each LEGACY_ACTION_/LEGACY_SOUND_ command (0..43) in a small PROGMEM table that says which byte
+// layout to use, the opcode, and the highest legal Parm 1 (0 = command takes no parm.)  This keeps ~130 bytes of tables in flash
+// rather than ~2K of switch/case code, and adding a new command is a one-line change.
+// Byte layouts ("formats"):
+//   ENC_FMT_NONE          Unsupported command; fatal error.
+//   ENC_FMT_ESTOP         FE FF FF System Halt (we use this for Emergency Stop; turns off PowerMasters too.)
+//   ENC_FMT_LEG_3_ADDR0   F8/F9, (loco * 2) + 0, opcode + parm.  i.e. Abs Speed, Momentum, Stop Immediate.
+//   ENC_FMT_LEG_3_ADDR1   F8/F9, (loco * 2) + 1, opcode + parm.  Most other 3-byte Legacy commands.
+//   ENC_FMT_LEG_9_PARM    9-byte Legacy command where byte 6 (element 5) is Parm 1.  i.e. 0x7C Smoke, 0x72 Dialogue.
+//   ENC_FMT_LEG_9_CMD     9-byte Legacy command where byte 6 (element 5) is the command itself.  i.e. 0x74 Railsounds FX.
+//   ENC_FMT_TMCC_3        FE, address, (loco << 7) + opcode + parm.
+//   ENC_FMT_TMCC_DIALOGUE 3- or 6-byte StationSounds Diner command; see tmccDialogueEncoding[].
+static const byte ENC_FMT_NONE          = 0;
+static const byte ENC_FMT_ESTOP         = 1;
+static const byte ENC_FMT_LEG_3_ADDR0   = 2;
+static const byte ENC_FMT_LEG_3_ADDR1   = 3;
+static const byte ENC_FMT_LEG_9_PARM    = 4;
+static const byte ENC_FMT_LEG_9_CMD     = 5;
+static const byte ENC_FMT_TMCC_3        = 6;
+static const byte ENC_FMT_TMCC_DIALOGUE = 7;
+
+static const byte ENC_TABLE_SIZE = 44;  // One entry for each device command 0..LEGACY_NUMERIC_PRESS (43)
+
+struct encodingStruct {
+  byte format;   // ENC_FMT_xxx
+  byte opcode;   // Third byte (element 2), before adding Parm 1
+  byte parmMax;  // Highest legal Parm 1, or 0 if this command has no parm
+};
+
+static const encodingStruct legacyEncoding[ENC_TABLE_SIZE] PROGMEM = {
+  { ENC_FMT_NONE,        0x00,   0 },  //  0 LEGACY_ACTION_NULL
+  { ENC_FMT_LEG_3_ADDR1, 0xFB,   0 },  //  1 LEGACY_ACTION_STARTUP_SLOW
+  { ENC_FMT_LEG_3_ADDR1, 0xFC,   0 },  //  2 LEGACY_ACTION_STARTUP_FAST
+  { ENC_FMT_LEG_3_ADDR1, 0xFD,   0 },  //  3 LEGACY_ACTION_SHUTDOWN_SLOW
+  { ENC_FMT_LEG_3_ADDR1, 0xFE,   0 },  //  4 LEGACY_ACTION_SHUTDOWN_FAST
+  { ENC_FMT_LEG_9_PARM,  0x7C,   3 },  //  5 LEGACY_ACTION_SET_SMOKE      0x7C Effects Control; Off/Low/Med/High = 0..3
+  { ENC_FMT_ESTOP,       0x00,   0 },  //  6 LEGACY_ACTION_EMERG_STOP
+  { ENC_FMT_LEG_3_ADDR0, 0x00, 199 },  //  7 LEGACY_ACTION_ABS_SPEED      0..199
+  { ENC_FMT_LEG_3_ADDR0, 0xC8,   0 },  //  8 LEGACY_ACTION_MOMENTUM_OFF   Momentum 0..7 would be C8..CF; we only use 0
+  { ENC_FMT_LEG_3_ADDR0, 0xFB,   0 },  //  9 LEGACY_ACTION_STOP_IMMED
+  { ENC_FMT_LEG_3_ADDR1, 0x00,   0 },  // 10 LEGACY_ACTION_FORWARD
+  { ENC_FMT_LEG_3_ADDR1, 0x03,   0 },  // 11 LEGACY_ACTION_REVERSE
+  { ENC_FMT_LEG_3_ADDR1, 0x05,   0 },  // 12 LEGACY_ACTION_FRONT_COUPLER
+  { ENC_FMT_LEG_3_ADDR1, 0x06,   0 },  // 13 LEGACY_ACTION_REAR_COUPLER
+  { ENC_FMT_NONE,        0x00,   0 },  // 14 LEGACY_ACTION_ACCESSORY_ON   Not Legacy; handled by controlAccessoryRelay()
+  { ENC_FMT_NONE,        0x00,   0 },  // 15 LEGACY_ACTION_ACCESSORY_OFF  Not Legacy; handled by controlAccessoryRelay()
+  { ENC_FMT_NONE,        0x00,   0 },  // 16
+  { ENC_FMT_NONE,        0x00,   0 },  // 17
+  { ENC_FMT_NONE,        0x00,   0 },  // 18
+  { ENC_FMT_NONE,        0x00,   0 },  // 19
+  { ENC_FMT_LEG_3_ADDR1, 0x1C,   0 },  // 20 LEGACY_SOUND_HORN_NORMAL
+  { ENC_FMT_LEG_3_ADDR1, 0xE0,  15 },  // 21 LEGACY_SOUND_HORN_QUILLING   Intensity 0..15
+  { ENC_FMT_LEG_3_ADDR1, 0x2D,   0 },  // 22 LEGACY_SOUND_REFUEL
+  { ENC_FMT_LEG_3_ADDR1, 0xA0,   7 },  // 23 LEGACY_SOUND_DIESEL_RPM      0..7
+  { ENC_FMT_LEG_3_ADDR1, 0xA8,   0 },  // 24 LEGACY_SOUND_WATER_INJECT
+  { ENC_FMT_LEG_3_ADDR1, 0xC0,  31 },  // 25 LEGACY_SOUND_ENGINE_LABOR    0..31
+  { ENC_FMT_LEG_3_ADDR1, 0xF4,   0 },  // 26 LEGACY_SOUND_BELL_OFF
+  { ENC_FMT_LEG_3_ADDR1, 0xF5,   0 },  // 27 LEGACY_SOUND_BELL_ON
+  { ENC_FMT_LEG_3_ADDR1, 0xF6,   0 },  // 28 LEGACY_SOUND_BRAKE_SQUEAL
+  { ENC_FMT_LEG_3_ADDR1, 0xF7,   0 },  // 29 LEGACY_SOUND_AUGER
+  { ENC_FMT_LEG_3_ADDR1, 0xF8,   0 },  // 30 LEGACY_SOUND_AIR_RELEASE
+  { ENC_FMT_LEG_3_ADDR1, 0xFA,   0 },  // 31 LEGACY_SOUND_LONG_LETOFF
+  { ENC_FMT_LEG_9_CMD,   0x74,   0 },  // 32 LEGACY_SOUND_MSTR_VOL_UP     0x74 Railsounds FX Triggers...
+  { ENC_FMT_LEG_9_CMD,   0x74,   0 },  // 33 LEGACY_SOUND_MSTR_VOL_DOWN
+  { ENC_FMT_LEG_9_CMD,   0x74,   0 },  // 34 LEGACY_SOUND_BLEND_VOL_UP
+  { ENC_FMT_LEG_9_CMD,   0x74,   0 },  // 35 LEGACY_SOUND_BLEND_VOL_DOWN
+  { ENC_FMT_LEG_9_CMD,   0x74,   0 },  // 36 LEGACY_SOUND_COCK_CLEAR_ON
+  { ENC_FMT_LEG_9_CMD,   0x74,   0 },  // 37 LEGACY_SOUND_COCK_CLEAR_OFF
+  { ENC_FMT_NONE,        0x00,   0 },  // 38
+  { ENC_FMT_NONE,        0x00,   0 },  // 39
+  { ENC_FMT_NONE,        0x00,   0 },  // 40
+  { ENC_FMT_LEG_9_PARM,  0x72, 118 },  // 41 LEGACY_DIALOGUE              0x72 Dialogue; also see outOfRangeLegacyDialogueNum()
+  { ENC_FMT_NONE,        0x00,   0 },  // 42 TMCC_DIALOGUE                TMCC only
+  { ENC_FMT_LEG_3_ADDR1, 0x10,   9 }   // 43 LEGACY_NUMERIC_PRESS         Keypad digit 0..9.  CHANGED 10/19/26: > 9 now fatal
+};
+
+static const encodingStruct tmccEncoding[ENC_TABLE_SIZE] PROGMEM = {
+  { ENC_FMT_NONE,          0x00,  0 },  //  0 LEGACY_ACTION_NULL
+  { ENC_FMT_NONE,          0x00,  0 },  //  1
+  { ENC_FMT_NONE,          0x00,  0 },  //  2
+  { ENC_FMT_NONE,          0x00,  0 },  //  3
+  { ENC_FMT_NONE,          0x00,  0 },  //  4
+  { ENC_FMT_NONE,          0x00,  0 },  //  5
+  { ENC_FMT_ESTOP,         0x00,  0 },  //  6 LEGACY_ACTION_EMERG_STOP
+  { ENC_FMT_TMCC_3,        0x60, 31 },  //  7 LEGACY_ACTION_ABS_SPEED      Command bits 11 + 5-bit speed 0..31
+  { ENC_FMT_NONE,          0x00,  0 },  //  8
+  { ENC_FMT_TMCC_3,        0x60,  0 },  //  9 LEGACY_ACTION_STOP_IMMED     Treated as Abs Speed 0 for TMCC
+  { ENC_FMT_TMCC_3,        0x00,  0 },  // 10 LEGACY_ACTION_FORWARD
+  { ENC_FMT_TMCC_3,        0x03,  0 },  // 11 LEGACY_ACTION_REVERSE
+  { ENC_FMT_TMCC_3,        0x05,  0 },  // 12 LEGACY_ACTION_FRONT_COUPLER
+  { ENC_FMT_TMCC_3,        0x06,  0 },  // 13 LEGACY_ACTION_REAR_COUPLER
+  { ENC_FMT_NONE,          0x00,  0 },  // 14
+  { ENC_FMT_NONE,          0x00,  0 },  // 15
+  { ENC_FMT_NONE,          0x00,  0 },  // 16
+  { ENC_FMT_NONE,          0x00,  0 },  // 17
+  { ENC_FMT_NONE,          0x00,  0 },  // 18
+  { ENC_FMT_NONE,          0x00,  0 },  // 19
+  { ENC_FMT_TMCC_3,        0x1C,  0 },  // 20 LEGACY_SOUND_HORN_NORMAL
+  { ENC_FMT_NONE,          0x00,  0 },  // 21
+  { ENC_FMT_NONE,          0x00,  0 },  // 22
+  { ENC_FMT_NONE,          0x00,  0 },  // 23
+  { ENC_FMT_NONE,          0x00,  0 },  // 24
+  { ENC_FMT_NONE,          0x00,  0 },  // 25
+  { ENC_FMT_TMCC_3,        0x1D,  0 },  // 26 LEGACY_SOUND_BELL_OFF        TMCC only has "Ring Bell"
+  { ENC_FMT_TMCC_3,        0x1D,  0 },  // 27 LEGACY_SOUND_BELL_ON
+  { ENC_FMT_NONE,          0x00,  0 },  // 28
+  { ENC_FMT_NONE,          0x00,  0 },  // 29
+  { ENC_FMT_NONE,          0x00,  0 },  // 30
+  { ENC_FMT_NONE,          0x00,  0 },  // 31
+  { ENC_FMT_NONE,          0x00,  0 },  // 32
+  { ENC_FMT_NONE,          0x00,  0 },  // 33
+  { ENC_FMT_NONE,          0x00,  0 },  // 34
+  { ENC_FMT_NONE,          0x00,  0 },  // 35
+  { ENC_FMT_NONE,          0x00,  0 },  // 36
+  { ENC_FMT_NONE,          0x00,  0 },  // 37
+  { ENC_FMT_NONE,          0x00,  0 },  // 38
+  { ENC_FMT_NONE,          0x00,  0 },  // 39
+  { ENC_FMT_NONE,          0x00,  0 },  // 40
+  { ENC_FMT_NONE,          0x00,  0 },  // 41
+  { ENC_FMT_TMCC_DIALOGUE, 0x00,  0 },  // 42 TMCC_DIALOGUE                StationSounds Diner; parm 1..6.  CHANGED 10/19/26: used to halt
+  { ENC_FMT_NONE,          0x00,  0 }   // 43
+};
+
+// TMCC StationSounds Diner dialogues, indexed by Parm 1 (TMCC_DIALOGUE_xxx = 1..6.)  First key press, and second key press or
+// zero if it's a 3-byte command.  0x09 = Aux1, 0x12 = keypad digit 2, 0x17 = keypad digit 7.
+static const byte tmccDialogueEncoding[7][2] PROGMEM = {
+  { 0x00, 0x00 },  // 0 Not used
+  { 0x09, 0x17 },  // 1 TMCC_DIALOGUE_STATION_ARRIVAL          Aux1 + 7
+  { 0x17, 0x00 },  // 2 TMCC_DIALOGUE_STATION_DEPARTURE        7
+  { 0x09, 0x12 },  // 3 TMCC_DIALOGUE_CONDUCTOR_ARRIVAL        Aux1 + 2
+  { 0x12, 0x00 },  // 4 TMCC_DIALOGUE_CONDUCTOR_DEPARTURE      2
+  { 0x12, 0x00 },  // 5 TMCC_DIALOGUE_CONDUCTOR_TICKETS_DINER  2
+  { 0x09, 0x12 }   // 6 TMCC_DIALOGUE_CONDUCTOR_STOPPING       Aux1 + 2
+};
+
 Engineer::legacyCommandStruct Engineer::translateToTMCC(byte t_devNum, byte t_devCommand, byte t_devParm1, byte t_devParm2) {
-  // Rev: 05/04/24.
+  // Rev: 10/19/26.  Table driven; see tmccEncoding[] above.
   // Populate a Legacy (actually TMCC) command buffer, 3- or 6-bytes long.
   // It's necessary to prefix this return type with "Engineer::" because it's a private struct.
   // Only gets called when t_devType = TMCC Engine or Train; other device types handled by other functions.
   // Translate a Delayed Action "plain English" command into a TMCC 3- or 6-byte command.
   // We'll use our class global 9-byte struct variable m_legacyCommandRecord to hold our calculated TMCC command bytes.
   // Remember, bytes 1..9 are element 0..8!
-  // The following TMCC Engine/Train commands (t_devCommand) are supported:
-  //   * LEGACY_ACTION_EMERG_STOP
-  //   * LEGACY_ACTION_ABS_SPEED
-  //   * LEGACY_ACTION_STOP_IMMED (treated as Abs Speed = 0)
-  //   * LEGACY_ACTION_FORWARD
-  //   * LEGACY_ACTION_REVERSE
-  //   * LEGACY_ACTION_FRONT_COUPLER
-  //   * LEGACY_ACTION_REAR_COUPLER
-  //   * LEGACY_SOUND_HORN_NORMAL
-  //   * LEGACY_SOUND_BELL_ON, LEGACY_SOUND_BELL_OFF: Future.  Not sure how they work as there is only one Bell command in TMCC.
-  //   * TMCC_DIALOGUE, StationSounds Diner dialogue commands specified as t_devParm1:
-  //     * TMCC_DIALOGUE_STATION_ARRIVAL         When STOPPED: PA announcement i.e. "The Daylight is now arriving."
-  //     * TMCC_DIALOGUE_STATION_DEPARTURE       When STOPPED: PA announcement i.e. "The Daylight is now departing."
-  //     * TMCC_DIALOGUE_CONDUCTOR_ARRIVAL       When STOPPED: Conductor says i.e. "Watch your step."
-  //     * TMCC_DIALOGUE_CONDUCTOR_DEPARTURE     When STOPPED: Conductor says i.e. "Watch your step." then "All aboard!"
-  //     * TMCC_DIALOGUE_CONDUCTOR_TICKETS_DINER When MOVING: Conductor says "Welcome aboard/Tickets please/1st seating."
-  //     * TMCC_DIALOGUE_CONDUCTOR_STOPPING      When MOVING: Conductor says "Next stop coming up."
+  // The TMCC Engine/Train commands (t_devCommand) that are supported are those with an entry in tmccEncoding[]:
+  //   EMERG_STOP, ABS_SPEED (0..31), STOP_IMMED (Abs Speed 0), FORWARD, REVERSE, FRONT/REAR_COUPLER, HORN_NORMAL,
+  //   BELL_ON/BELL_OFF (both just "Ring Bell"), and TMCC_DIALOGUE (StationSounds Diner; see tmccDialogueEncoding[].)
   // NOTE: The above commands are LEGACY_* constants because they're just the "plain English" version of the commands, such as
   //       LEGACY_ACTION_ABS_SPEED.  Based on the device type (Legacy vs TMCC) we'll call the appropriate "translateToXXX"
   //       function (here), which by virtue of being called knows what type of device (Legacy vs TMCC, though we'll have to look it
   //       up in Loco Ref in order to differentiate between Engine vs Train.)
-  //       I'm not clear, as of 5/4/24, how TMCC_DIALOGUE will be specified in Delayed Action, because unlike the rest of the above
-  //       commands, the Conductor (whoever populates Delayed Action) would need to know that it's talking to a TMCC device vs a
-  //       Legacy device.  Of course at this point, ALL StationSounds diner cars, and other devices with dialogue, will be TMCC.
   // NOTE: I don't think we need to support the TMCC Momentum commands (Low/Med/High -- there is no "off") because momentum is
   //       handled by the Legacy remote.  I.e. when you set momentum, you see successive speed commands coming from the remote, not
   //       a single speed command sent to loco and then the loco slows down on its own.  Ditto with Legacy Momentum.
@@ -367,6 +550,23 @@ Engineer::legacyCommandStruct Engineer::translateToTMCC(byte t_devNum, byte t_de
     }
   }
 
+  // Look up how to encode this command.
+  byte format = ENC_FMT_NONE;
+  byte opcode = 0;
+  byte parmMax = 0;
+  if (t_devCommand < ENC_TABLE_SIZE) {
+    format  = pgm_read_byte(&tmccEncoding[t_devCommand].format);
+    opcode  = pgm_read_byte(&tmccEncoding[t_devCommand].opcode);
+    parmMax = pgm_read_byte(&tmccEncoding[t_devCommand].parmMax);
+  }
+  if (format == ENC_FMT_NONE) {
+    sprintf(lcdString, "ENG'R TMCC BAD CMD!"); pLCD2004->println(lcdString); Serial.println(lcdString); endWithFlashingLED(5);
+  }
+  if ((parmMax > 0) && (t_devParm1 > parmMax)) {
+    sprintf(lcdString, "ENG'R TMCC PARM %i", t_devCommand); pLCD2004->println(lcdString); Serial.println(lcdString);
+    endWithFlashingLED(5);
+  }
+
   // Clear out all nine bytes...even though TMCC can use at most 6.
   for (byte j = 0; j < LEGACY_CMD_BYTES; j++) {  // Always 9 bytes, 0..8
     m_legacyCommandRecord.legacyCommandByte[j] = 0;
@@ -375,20 +575,20 @@ Engineer::legacyCommandStruct Engineer::translateToTMCC(byte t_devNum, byte t_de
   // We ALWAYS know what byte 0 will be for TMCC:
   m_legacyCommandRecord.legacyCommandByte[0] = 0xFE;  // 254
 
-  // We ALWAYS know what byte 1 (second byte) will be for TMCC (except emergency stop, which we'll override when needed)
-  // 05/05/24: HERE IS AN ALTERNATIVE WAY TO BUILD THE SECOND TMCC COMMAND BYTE:
-  // Byte is combination of device type field and first 7 bit of TMCC address:
-  // If TMCC Engine, binaryDeviceType = 0x00.  If TMCC Train, binaryDeviceType = 0xC8.
-  //   m_legacyCommandRecord.legacyCommandByte[1] = (binaryDeviceType | (t_devNum >> 1));
+  if (format == ENC_FMT_ESTOP) {  // We'll do System Halt which turns off PowerMasters too!
+    m_legacyCommandRecord.legacyCommandByte[1] = 0xFF;
+    m_legacyCommandRecord.legacyCommandByte[2] = 0xFF;
+    return m_legacyCommandRecord;
+  }
+
+  // Byte 1 (second byte) is the device type field and all but the right-most bit of the TMCC address.
   if (t_devType == DEV_TYPE_TMCC_ENGINE) {
     // Bit pattern is 00AA AAAA:
     //   AA AAAA is everything except the right-most bit of the device number.
     m_legacyCommandRecord.legacyCommandByte[1] = (t_devNum >> 1);
   } else {  // Must be TMCC Train
-    // Bit pattern is 1100 1AAA:
-    //   AAA is everything except the right-most bit of the device number.
-    // Hence, it's the same as for a TMCC Engine, except we need to add 1100 1000 which is 0xC8.
-    m_legacyCommandRecord.legacyCommandByte[1] = (0xC8 + (t_devNum >> 1));  // 0xC8 = binary 1100 1000
+    // Bit pattern is 1100 1AAA: same as for a TMCC Engine, except we need to add 1100 1000 which is 0xC8.
+    m_legacyCommandRecord.legacyCommandByte[1] = (0xC8 + (t_devNum >> 1));
   }
 
   // Byte 2 (third byte) of any TMCC command is the same regardless if this is for an Engine or a Train.
@@ -396,173 +596,31 @@ Engineer::legacyCommandStruct Engineer::translateToTMCC(byte t_devNum, byte t_de
   //   A is the right-most bit of the device number (t_locoNum)
   //   CC is the two-bit command category -- usually 00, but 01 for momentum commands and 11 for speed commands.
   //   D DDDD command number, such as 1 1100 for "Blow Horn."
-  // If CC = 00, then add 0x00 = 0000 (all commands except momentum and absolute speed.)
-  // If CC = 01, then add 0x02 = 0010 (momentum commands.)
-  // If CC = 11, then add 0x06 = 0110 (speed commands.)
-  // There are no Command Categories of 10.
-  // 05/05/24: HERE IS AN ALTERNATIVE WAY TO BUILD THE THIRD TMCC COMMAND BYTE (using bitwise OR, rather than addition.)
-  // Byte 3 is last bit of TMCC address, command field (2 bits), plus data field:
-  //   m_legacyCommandRecord.legacyCommandByte[2] = ((t_devNum << 7) | (commandField << 5) | dataField);
-
-  switch (t_devCommand) {
-
-    case LEGACY_ACTION_EMERG_STOP:     //  We'll do System Halt which turns off PowerMasters too!
-    {
-      m_legacyCommandRecord.legacyCommandByte[1] = 0xFF;
-      m_legacyCommandRecord.legacyCommandByte[2] = 0xFF;
-      break;
-    }
-
-    case LEGACY_ACTION_ABS_SPEED:      // Requires Parm1 0..31
-    {
-      // Speed can be 0..31 for TMCC
-      if (outOfRangeLocoSpeed(t_devType, t_devParm1)) {
-        sprintf(lcdString, "ENG'R TMCC SPD ERR!"); pLCD2004->println(lcdString); Serial.println(lcdString); endWithFlashingLED(5);
-      }
-      // First put the right-most bit of t_devNum as the left-most  bit of byte #3: X000 0000
-      m_legacyCommandRecord.legacyCommandByte[2] = (t_devNum << 7);
-      // For speed commands, the command bits are 11: 0110 0000
-      m_legacyCommandRecord.legacyCommandByte[2] += 0x60;  // Adding binary 0110 0000 = 0x60
-      // Plus the 5-bit speed 0..31.
+  // The table's opcode holds CCD DDDD, and for Abs Speed we add the 5-bit speed.
+  if (format == ENC_FMT_TMCC_3) {
+    m_legacyCommandRecord.legacyCommandByte[2] = (t_devNum << 7) + opcode;
+    if (parmMax > 0) {
       m_legacyCommandRecord.legacyCommandByte[2] += t_devParm1;
-      break;
-    }
-
-    case LEGACY_ACTION_STOP_IMMED:      // We'll treat this as Abs Speed 0 for TMCC
-    {
-      // First put the right-most bit of t_devNum as the left-most  bit of byte #3: X000 0000
-      m_legacyCommandRecord.legacyCommandByte[2] = (t_devNum << 7);
-      // For speed commands, the command bits are 11: 0110 0000
-      m_legacyCommandRecord.legacyCommandByte[2] += 0x60;  // Adding binary 0110 0000 = 0x60
-      // Plus the 5-bit speed, which is zero, so we'll skip this step.
-      break;
-    }
-
-    case LEGACY_ACTION_FORWARD:
-    {
-      // First put the right-most bit of t_devNum as the left-most  bit of byte #3: X000 0000
-      m_legacyCommandRecord.legacyCommandByte[2] = (t_devNum << 7);
-      // For Forward, the rest of the third byte is zero, so nothing more to do.
-      break;
     }
-
-    case LEGACY_ACTION_REVERSE:
-    {
-      // First put the right-most bit of t_devNum as the left-most  bit of byte #3: X000 0000
-      m_legacyCommandRecord.legacyCommandByte[2] = (t_devNum << 7);
-      // For Reverse, just add 0x03 to the third byte.
-      m_legacyCommandRecord.legacyCommandByte[2] += 0x03;  // Adding binary 0000 0011 = 0x03
-      break;
-    }
-
-    case LEGACY_ACTION_FRONT_COUPLER:
-    {
-      // First put the right-most bit of t_devNum as the left-most  bit of byte #3: X000 0000
-      m_legacyCommandRecord.legacyCommandByte[2] = (t_devNum << 7);
-      // For Front Coupler, just add 0x05 to the third byte.
-      m_legacyCommandRecord.legacyCommandByte[2] += 0x05;  // Adding binary 0000 0101 = 0x05
-      break;
+  } else {  // ENC_FMT_TMCC_DIALOGUE
+    // For "TMCC_DIALOGUE", which is for StationSounds Diner cars, t_devParm1 must specify which of the six supported dialogues are
+    // wanted.  Some of these are 3 bytes (single keypad numeric key press), and some are 6 bytes (Aux1 + a numeric.)
+    // NOTE: All of my StationSounds Diners are TMCC; no need for Legacy StationSounds support at this time.
+    if (outOfRangeTMCCDialogueNum(t_devParm1)) {  // Must be 1..6
+      sprintf(lcdString, "ENG TMCC BAD DIALOG!"); pLCD2004->println(lcdString); Serial.println(lcdString); endWithFlashingLED(5);
     }
-
-    case LEGACY_ACTION_REAR_COUPLER:
-    {
-      // First put the right-most bit of t_devNum as the left-most  bit of byte #3: X000 0000
-      m_legacyCommandRecord.legacyCommandByte[2] = (t_devNum << 7);
-      // For Rear Coupler, just add 0x06 to the third byte.
-      m_legacyCommandRecord.legacyCommandByte[2] += 0x06;  // Adding binary 0000 0110 = 0x06
-      break;
-    }
-
-    case LEGACY_SOUND_HORN_NORMAL:
-    {
-      // First put the right-most bit of t_devNum as the left-most  bit of byte #3: X000 0000
-      m_legacyCommandRecord.legacyCommandByte[2] = (t_devNum << 7);
-      // For Horn, add 0x1C to the third byte.
-      m_legacyCommandRecord.legacyCommandByte[2] += 0x1C;  // Adding binary 0001 1100 = 0x1C
-      break;
+    byte firstKey  = pgm_read_byte(&tmccDialogueEncoding[t_devParm1][0]);
+    byte secondKey = pgm_read_byte(&tmccDialogueEncoding[t_devParm1][1]);
+    if (firstKey == 0) {  // Bad news if we get here; it means none of the TMCC dialogues was what we passed
+      sprintf(lcdString, "ENG'R TMCC DLG ERR!"); pLCD2004->println(lcdString); Serial.println(lcdString); endWithFlashingLED(5);
     }
-
-    case LEGACY_SOUND_BELL_ON:
-    case LEGACY_SOUND_BELL_OFF:
-    {
-      // Unsupported but not an error.  Not sure what Bell Off would even do.  Treat it as "Ring Bell"
-      // First put the right-most bit of t_devNum as the left-most  bit of byte #3: X000 0000
-      m_legacyCommandRecord.legacyCommandByte[2] = (t_devNum << 7);
-      // For Bell, add 0x1D to the third byte.
-      m_legacyCommandRecord.legacyCommandByte[2] += 0x1D;  // Adding binary 0001 1101 = 0x1D
-        break;
+    m_legacyCommandRecord.legacyCommandByte[2] = (t_devNum << 7) + firstKey;
+    if (secondKey != 0) {  // 6-byte command; bytes 4 and 5 are the same as bytes 1 and 2.
+      m_legacyCommandRecord.legacyCommandByte[3] = m_legacyCommandRecord.legacyCommandByte[0];
+      m_legacyCommandRecord.legacyCommandByte[4] = m_legacyCommandRecord.legacyCommandByte[1];
+      m_legacyCommandRecord.legacyCommandByte[5] = (t_devNum << 7) + secondKey;
     }
-
-    case TMCC_DIALOGUE:
-      {
-        // For "TMCC_DIALOGUE", which is for StationSounds Diner cars, t_devParm1 must specify which of the six supported dialogues are
-        // wanted.  Some of these TMCC StationSounds Diner commands are 3 bytes (single keypad numeric key press), and some are 6 bytes
-        // (combo numberic key press of Alt-1 + a numberic.)
-        // NOTE: All of my StationSounds Diners are TMCC; no need for Legacy StationSounds support at this time.
-        // These are either 3-byte or 6 bytes commands.
-        // TMCC STATIONSOUNDS DINER DIALOGUE COMMANDS specified as Parm1:
-        //   TMCC_DIALOGUE_STATION_ARRIVAL         = 1;  // 6 bytes: Aux1+7. When STOPPED: PA announcement i.e. "The Daylight is now arriving."
-        //   TMCC_DIALOGUE_STATION_DEPARTURE       = 2;  // 3 bytes: 7.      When STOPPED: PA announcement i.e. "The Daylight is now departing."
-        //   TMCC_DIALOGUE_CONDUCTOR_ARRIVAL       = 3;  // 6 bytes: Aux1+2. When STOPPED: Conductor says i.e. "Watch your step."
-        //   TMCC_DIALOGUE_CONDUCTOR_DEPARTURE     = 4;  // 3 bytes: 2.      When STOPPED: Conductor says i.e. "Watch your step." then "All aboard!"
-        //   TMCC_DIALOGUE_CONDUCTOR_TICKETS_DINER = 5;  // 3 bytes: 2.      When MOVING: Conductor says "Welcome aboard/Tickets please/1st seating."
-        //   TMCC_DIALOGUE_CONDUCTOR_STOPPING      = 6;  // 6 bytes: Aux1+2. When MOVING: Conductor says "Next stop coming up."
-        // So there are FOUR unique possible commands.
-        if (outOfRangeTMCCDialogueNum(t_devParm1)) {  // Must be 1..6
-          sprintf(lcdString, "ENG TMCC BAD DIALOG!"); pLCD2004->println(lcdString); Serial.println(lcdString); endWithFlashingLED(5);
-        }
-
-        // Regardless if it's a 3-byte or a 6-byte TMCC command, bytes 1 and 2 (and 4 and 5 if used) will always be the same.
-        // So we could compress this code, but for readability we're going to assign every byte in every switch-case block.
-        switch (t_devParm1) {  // Which of the six dialogues are desired?
-
-          case TMCC_DIALOGUE_STATION_ARRIVAL:  // 2 bytes: Aux1 + 7
-            {
-              m_legacyCommandRecord.legacyCommandByte[2] = (t_devNum << 7) + 0x09;  // Aux button; same for Train vs Engine.
-              // Since this is a 6-byte command, keep going...
-              m_legacyCommandRecord.legacyCommandByte[3] = m_legacyCommandRecord.legacyCommandByte[0];
-              m_legacyCommandRecord.legacyCommandByte[4] = m_legacyCommandRecord.legacyCommandByte[1];
-              m_legacyCommandRecord.legacyCommandByte[5] = (t_devNum << 7) + 0x17;  // 0x17 = digit 7 on keypad
-              break;
-            }
-
-          case TMCC_DIALOGUE_STATION_DEPARTURE:  // 1 byte: 7
-            {
-              m_legacyCommandRecord.legacyCommandByte[2] = (t_devNum << 7) + 0x17;  // 0x17 = digit 7 on keypad
-              break;
-            }
-
-          case TMCC_DIALOGUE_CONDUCTOR_ARRIVAL:   // 2 bytes: Aux1 + 2
-          case TMCC_DIALOGUE_CONDUCTOR_STOPPING:  // 2 bytes: Aux1 + 2
-            {
-              m_legacyCommandRecord.legacyCommandByte[2] = (t_devNum << 7) + 0x09;  // Aux button; same for Train vs Engine.
-              // Since this is a 6-byte command, keep going...
-              m_legacyCommandRecord.legacyCommandByte[3] = m_legacyCommandRecord.legacyCommandByte[0];
-              m_legacyCommandRecord.legacyCommandByte[4] = m_legacyCommandRecord.legacyCommandByte[1];
-              m_legacyCommandRecord.legacyCommandByte[5] = (t_devNum << 7) + 0x12;  // 0x12 = digit 2 on keypad
-              break;
-            }
-
-          case TMCC_DIALOGUE_CONDUCTOR_DEPARTURE:      // 1 byte: 2
-          case TMCC_DIALOGUE_CONDUCTOR_TICKETS_DINER:  // 1 byte: 2
-            {
-              m_legacyCommandRecord.legacyCommandByte[2] = (t_devNum << 7) + 0x12;  // 0x12 = digit 2 on keypad
-              break;
-            }
-
-          default:  // Bad news if we get here; it means none of the TMCC dialogues was what we passed
-            {
-              sprintf(lcdString, "ENG'R TMCC DLG ERR!"); pLCD2004->println(lcdString); Serial.println(lcdString); endWithFlashingLED(5);
-            }
-        }  // End of switch "which of the six TMCC Dialogue commands are we decoding?"
-      }  // End of "it's a TMCC Dialogue command"
-
-    default:  // Uh oh, we didn't recognize the command
-      {
-        sprintf(lcdString, "ENG'R TMCC BAD CMD!"); pLCD2004->println(lcdString); Serial.println(lcdString); endWithFlashingLED(5);
-      }
-
-  }  // End of "which device command were we sent to decode?"
+  }
 
   // Okay, we have populated m_legacyCommandRecord[] with the appropriate TMCC command; either 3 or 6 bytes.
   if (m_debugOn) {
@@ -575,46 +633,15 @@ Engineer::legacyCommandStruct Engineer::translateToTMCC(byte t_devNum, byte t_de
 }
 
 Engineer::legacyCommandStruct Engineer::translateToLegacy(byte t_devNum, byte t_devCommand, byte t_devParm1, byte t_devParm2) {
-  // Rev: 05/24/24.
+  // Rev: 10/19/26.  Table driven; see legacyEncoding[] above.
   // Populate a Legacy command buffer, 3- to 9-bytes long.
   // It's necessary to prefix this return type with "Engineer::" because it's a private struct.
   // Only gets called when t_devType = Legacy Engine or Train; other device types handled by other functions.
   // Translate a Delayed Action "plain English" command into a Legacy 3-, 6-, or 9-byte command.
   // We'll use our class global 9-byte struct variable m_legacyCommandRecord to hold our calculated Legacy command bytes.
   // Remember, bytes 1..9 are element 0..8!
-  // The following Legacy Engine/Train commands (t_devCommand) are supported:
-  //   * LEGACY_ACTION_STARTUP_SLOW
-  //   * LEGACY_ACTION_STARTUP_FAST
-  //   * LEGACY_ACTION_SHUTDOWN_SLOW
-  //   * LEGACY_ACTION_SHUTDOWN_FAST
-  //   * LEGACY_ACTION_SET_SMOKE      (9-byte command)
-  //   * LEGACY_ACTION_EMERG_STOP
-  //   * LEGACY_ACTION_ABS_SPEED (includes support for PowerMaster 91..94 on/off as speed 1/0.)
-  //   * LEGACY_ACTION_MOMENTUM_OFF
-  //   * LEGACY_ACTION_STOP_IMMED
-  //   * LEGACY_ACTION_FORWARD
-  //   * LEGACY_ACTION_REVERSE
-  //   * LEGACY_ACTION_FRONT_COUPLER
-  //   * LEGACY_ACTION_REAR_COUPLER
-  //   * LEGACY_SOUND_HORN_NORMAL
-  //   * LEGACY_SOUND_HORN_QUILLING  Requires intensity 0..15
-  //   * LEGACY_SOUND_REFUEL   With minor dialogue.  Nothing on SP 1440.  Steam only??? *******************
-  //   * LEGACY_SOUND_DIESEL_RPM Diesel only. Requires Parm 0..7
-  //   * LEGACY_SOUND_WATER_INJECT  Steam only.
-  //   * LEGACY_SOUND_ENGINE_LABOR  Diesel only?  Barely discernable on SP 1440. *******************
-  //   * LEGACY_SOUND_BELL_OFF
-  //   * LEGACY_SOUND_BELL_ON
-  //   * LEGACY_SOUND_BRAKE_SQUEAL    Only works when moving.  Short chirp.
-  //   * LEGACY_SOUND_AUGER           Steam only.
-  //   * LEGACY_SOUND_AIR_RELEASE     Can barely hear.  Not sure if it works on steam as well as diesel? **************
-  //   * LEGACY_SOUND_LONG_LETOFF     Diesel and (presumably) steam. Long hiss. *****************
-  //   * LEGACY_SOUND_MSTR_VOL_UP     There are 10 possible volumes (9 excluding "off") i.e. 0..9.
-  //   * LEGACY_SOUND_MSTR_VOL_DOWN   No way to go directly to a master vol level, so we must step up/down as desired.
-  //   * LEGACY_SOUND_BLEND_VOL_UP    Tried this but wasn't able to get any response (same with 9-byte mstr vol up/down)
-  //   * LEGACY_SOUND_BLEND_VOL_DOWN  Tried this but wasn't able to get any response (same with 9-byte mstr vol up/down)
-  //   * LEGACY_SOUND_COCK_CLEAR_ON   Steam only. This is a 9-byte 0x74 Legacy Railsounds FX Trigger
-  //   * LEGACY_SOUND_COCK_CLEAR_OFF  Steam only. This is a 9-byte 0x74 Legacy Railsounds FX Trigger
-  //   * LEGACY_DIALOGUE              Separate function.  For any of 38 Legacy Dialogues, which will be passed as a parm.
+  // The Legacy Engine/Train commands (t_devCommand) that are supported are those with an entry in legacyEncoding[], including
+  // Abs Speed for PowerMasters 91..94 on/off as speed 1/0.  See Train_Consts_Global.h for notes on each command.
 
   // First confirm that we have a valid device type and number...
   byte t_devType;  // Will be Legacy Engine or Train (E/T)
@@ -634,315 +661,81 @@ Engineer::legacyCommandStruct Engineer::translateToLegacy(byte t_devNum, byte t_
     }
   }
 
+  // Look up how to encode this command.
+  byte format = ENC_FMT_NONE;
+  byte opcode = 0;
+  byte parmMax = 0;
+  if (t_devCommand < ENC_TABLE_SIZE) {
+    format  = pgm_read_byte(&legacyEncoding[t_devCommand].format);
+    opcode  = pgm_read_byte(&legacyEncoding[t_devCommand].opcode);
+    parmMax = pgm_read_byte(&legacyEncoding[t_devCommand].parmMax);
+  }
+  if (format == ENC_FMT_NONE) {
+    // If we fall thorough to here, we have an unsupported command type
+    sprintf(lcdString, "ENG'R LEG BAD CMD!"); pLCD2004->println(lcdString); Serial.println(lcdString); endWithFlashingLED(4);
+  }
+  if ((parmMax > 0) && (t_devParm1 > parmMax)) {
+    sprintf(lcdString, "ENG'R LEG PARM %i", t_devCommand); pLCD2004->println(lcdString); Serial.println(lcdString);
+    endWithFlashingLED(5);
+  }
+  if ((t_devCommand == LEGACY_DIALOGUE) && outOfRangeLegacyDialogueNum(t_devParm1)) {  // Valid dialogues aren't contiguous
+    sprintf(lcdString, "ENG LEG DIALOG ERR!"); pLCD2004->println(lcdString); Serial.println(lcdString); endWithFlashingLED(5);
+  }
+
   // Clear out all nine bytes...so we can always check byte 4 (element 3) for 0 to see if it's a 3-byte, and also
   // check byte 7 (element 6) for 0 to see if it's a 6-byte command, else it's a 9-byte command.
   for (byte j = 0; j < LEGACY_CMD_BYTES; j++) {  // Always 9 bytes, 0..8
     m_legacyCommandRecord.legacyCommandByte[j] = 0;
   }
 
-  // We ALWAYS know what byte 0 will be, depending if it's a Legacy Engine vs Train, so we'll do that at the top:
+  if (format == ENC_FMT_ESTOP) {  //  E-stop is actually F8/F9 + FF FF; we'll do System Halt instead turns off PowerMasters too!
+    m_legacyCommandRecord.legacyCommandByte[0] = 0xFE;
+    m_legacyCommandRecord.legacyCommandByte[1] = 0xFF;
+    m_legacyCommandRecord.legacyCommandByte[2] = 0xFF;
+    return m_legacyCommandRecord;
+  }
+
+  // We ALWAYS know what byte 0 will be, depending if it's a Legacy Engine vs Train:
   if (t_devType == DEV_TYPE_LEGACY_ENGINE) {  // Legacy Engine
     m_legacyCommandRecord.legacyCommandByte[0] = 0xF8;
   } else {  // Can only be Legacy Train
     m_legacyCommandRecord.legacyCommandByte[0] = 0xF9;
   }
 
-  switch (t_devCommand) {
-
-    // Let's do the 3-byte Legacy commands first.
-    case LEGACY_ACTION_STARTUP_SLOW:   //
-      {
-        m_legacyCommandRecord.legacyCommandByte[1] = (t_devNum * 2) + 1;  // Shift left one bit, add 1
-        m_legacyCommandRecord.legacyCommandByte[2] = 0xFB;
-        break;
-      }
-
-    case LEGACY_ACTION_STARTUP_FAST:   //
-      {
-        m_legacyCommandRecord.legacyCommandByte[1] = (t_devNum * 2) + 1;  // Shift left one bit, add 1
-        m_legacyCommandRecord.legacyCommandByte[2] = 0xFC;
-        break;
-      }
-
-    case LEGACY_ACTION_SHUTDOWN_SLOW:  //
-      {
-        m_legacyCommandRecord.legacyCommandByte[1] = (t_devNum * 2) + 1;  // Shift left one bit, add 1
-        m_legacyCommandRecord.legacyCommandByte[2] = 0xFD;
-        break;
-      }
-
-    case LEGACY_ACTION_SHUTDOWN_FAST:  //
-      {
-        m_legacyCommandRecord.legacyCommandByte[1] = (t_devNum * 2) + 1;  // Shift left one bit, add 1
-        m_legacyCommandRecord.legacyCommandByte[2] = 0xFE;
-        break;
-      }
-
-    case LEGACY_ACTION_EMERG_STOP:     //  E-stop is actually F8/F9 + FF FF; we'll do System Halt instead turns off PowerMasters too!
-      {
-        m_legacyCommandRecord.legacyCommandByte[0] = 0xFE;
-        m_legacyCommandRecord.legacyCommandByte[1] = 0xFF;
-        m_legacyCommandRecord.legacyCommandByte[2] = 0xFF;
-        break;
-      }
-
-    case LEGACY_ACTION_ABS_SPEED:      // Requires Parm1 0..199
-      {
-        // Speed can be 0..199 for Legacy
-        if (outOfRangeLocoSpeed(t_devType, t_devParm1)) {
-          sprintf(lcdString, "ENG'R LEG SPD ERR!"); pLCD2004->println(lcdString); Serial.println(lcdString); endWithFlashingLED(5);
-        }
-        m_legacyCommandRecord.legacyCommandByte[1] = (t_devNum * 2);      // Shift loco num left one bit, add 0
-        m_legacyCommandRecord.legacyCommandByte[2] = t_devParm1;          // Absolute speed value 0..199
-        break;
-      }
-
-    case LEGACY_ACTION_MOMENTUM_OFF:   // We will never set Momentum to any value but zero.
-      {
-        byte t_momentum = 0;  // We can set momentum from 0..7 but in this case 0 = momentum OFF
-        m_legacyCommandRecord.legacyCommandByte[1] = (t_devNum * 2);      // Shift left one bit, add 0
-        m_legacyCommandRecord.legacyCommandByte[2] = 0xC8 + t_momentum;   // Parm1 better be 0..7
-        break;
-      }
-
-    case LEGACY_ACTION_STOP_IMMED:     // Prefer over Abs Spd 0 b/c overrides momentum if instant stop desired.
-      {
-        m_legacyCommandRecord.legacyCommandByte[1] = (t_devNum * 2);      // Shift left one bit, add 0
-        m_legacyCommandRecord.legacyCommandByte[2] = 0xFB;
-        break;
-      }
-
-    case LEGACY_ACTION_FORWARD:        // Delayed Action table command types
-      {
-        m_legacyCommandRecord.legacyCommandByte[1] = (t_devNum * 2) + 1;  // Shift left one bit, add 1
-        m_legacyCommandRecord.legacyCommandByte[2] = 0x00;
-        break;
-      }
-
-    case LEGACY_ACTION_REVERSE:        //
-      {
-        m_legacyCommandRecord.legacyCommandByte[1] = (t_devNum * 2) + 1;  // Shift left one bit, add 1
-        m_legacyCommandRecord.legacyCommandByte[2] = 0x03;
-        break;
-      }
-
-    case LEGACY_ACTION_FRONT_COUPLER:  //
-      {
-        m_legacyCommandRecord.legacyCommandByte[1] = (t_devNum * 2) + 1;  // Shift left one bit, add 1
-        m_legacyCommandRecord.legacyCommandByte[2] = 0x05;
-        break;
-      }
-
-    case LEGACY_ACTION_REAR_COUPLER:   //
-      {
-        m_legacyCommandRecord.legacyCommandByte[1] = (t_devNum * 2) + 1;  // Shift left one bit, add 1
-        m_legacyCommandRecord.legacyCommandByte[2] = 0x06;
-        break;
-      }
-
-    case LEGACY_NUMERIC_PRESS:
-      {
-        m_legacyCommandRecord.legacyCommandByte[1] = (t_devNum * 2) + 1;  // Shift left one bit, add 1
-        m_legacyCommandRecord.legacyCommandByte[2] = 0x10 + t_devParm1;   // Keypad digit 0..9
-        break;
-      }
-
-    case LEGACY_SOUND_HORN_NORMAL:     //
-      {
-        m_legacyCommandRecord.legacyCommandByte[1] = (t_devNum * 2) + 1;  // Shift left one bit, add 1
-        m_legacyCommandRecord.legacyCommandByte[2] = 0x1C;
-        break;
-      }
-
-    case LEGACY_SOUND_HORN_QUILLING:   // Requires intensity 0..15
-      {
-        if (outOfRangeQuill(t_devParm1)) {
-          sprintf(lcdString, "ENG'R QUILL ERROR!"); pLCD2004->println(lcdString); Serial.println(lcdString); endWithFlashingLED(5);
-        }
-        m_legacyCommandRecord.legacyCommandByte[1] = (t_devNum * 2) + 1;  // Shift left one bit, add 1
-        m_legacyCommandRecord.legacyCommandByte[2] = 0xE0 + t_devParm1;   // Parm1 better be 0..15
-        break;
-      }
-
-    case LEGACY_SOUND_REFUEL:          // With minor dialogue.  Nothing on SP 1440.  Steam only??? *******************
-      {
-        m_legacyCommandRecord.legacyCommandByte[1] = (t_devNum * 2) + 1;  // Shift left one bit, add 1
-        m_legacyCommandRecord.legacyCommandByte[2] = 0x2D;
-        break;
-      }
-
-    case LEGACY_SOUND_DIESEL_RPM:      // Diesel only. Requires Parm 0..7
-      {
-        if (outOfRangeRPM(t_devParm1)) {
-          sprintf(lcdString, "ENG'R RPM ERROR!"); pLCD2004->println(lcdString); Serial.println(lcdString); endWithFlashingLED(5);
-        }
-        m_legacyCommandRecord.legacyCommandByte[1] = (t_devNum * 2) + 1;  // Shift left one bit, add 1
-        m_legacyCommandRecord.legacyCommandByte[2] = 0xA0 + t_devParm1;   // Parm1 better be 0..7
-        break;
-      }
-
-    case LEGACY_SOUND_WATER_INJECT:    // Steam only.
-      {
-        m_legacyCommandRecord.legacyCommandByte[1] = (t_devNum * 2) + 1;  // Shift left one bit, add 1
-        m_legacyCommandRecord.legacyCommandByte[2] = 0xA8;
-        break;
-      }
-
-    case LEGACY_SOUND_ENGINE_LABOR:    // Diesel only?  Barely discernable on SP 1440. *******************
-      {
-        if (outOfRangeLabor(t_devParm1)) {
-          sprintf(lcdString, "ENG LABOR ERROR!"); pLCD2004->println(lcdString); Serial.println(lcdString); endWithFlashingLED(5);
-        }
-        m_legacyCommandRecord.legacyCommandByte[1] = (t_devNum * 2) + 1;  // Shift left one bit, add 1
-        m_legacyCommandRecord.legacyCommandByte[2] = 0xC0 + t_devParm1;   // Parm1 better be 0..31
-        break;
-      }
-
-    case LEGACY_SOUND_BELL_OFF:        //
-      {
-        m_legacyCommandRecord.legacyCommandByte[1] = (t_devNum * 2) + 1;  // Shift left one bit, add 1
-        m_legacyCommandRecord.legacyCommandByte[2] = 0xF4;
-        break;
-      }
-
-    case LEGACY_SOUND_BELL_ON:         //
-      {
-        m_legacyCommandRecord.legacyCommandByte[1] = (t_devNum * 2) + 1;  // Shift left one bit, add 1
-        m_legacyCommandRecord.legacyCommandByte[2] = 0xF5;
-        break;
-      }
-
-    case LEGACY_SOUND_BRAKE_SQUEAL:    // Only works when moving.  Short chirp.
-      {
-        m_legacyCommandRecord.legacyCommandByte[1] = (t_devNum * 2) + 1;  // Shift left one bit, add 1
-        m_legacyCommandRecord.legacyCommandByte[2] = 0xF6;
-        break;
-      }
-
-    case LEGACY_SOUND_AUGER:           // Steam only.
-      {
-        m_legacyCommandRecord.legacyCommandByte[1] = (t_devNum * 2) + 1;  // Shift left one bit, add 1
-        m_legacyCommandRecord.legacyCommandByte[2] = 0xF7;
-        break;
-      }
-
-    case LEGACY_SOUND_AIR_RELEASE:     // Can barely hear.  Not sure if it works on steam as well as diesel? **************
-      {
-        m_legacyCommandRecord.legacyCommandByte[1] = (t_devNum * 2) + 1;  // Shift left one bit, add 1
-        m_legacyCommandRecord.legacyCommandByte[2] = 0xF8;
-        break;
-      }
-
-    case LEGACY_SOUND_LONG_LETOFF:     // Diesel and (presumably) steam. Long hiss. *****************
-      {
-        m_legacyCommandRecord.legacyCommandByte[1] = (t_devNum * 2) + 1;  // Shift left one bit, add 1
-        m_legacyCommandRecord.legacyCommandByte[2] = 0xFA;
-        break;
-      }
-
-    // Now handle all of the 9-byte Legacy commands now...
-
-    case LEGACY_ACTION_SET_SMOKE:      // 0x7C FX Control Trigger requires parm 0x00..0x03 (Off/Low/Med/Hi)
-      {
-        if (outOfRangeSmoke(t_devParm1)) {
-          sprintf(lcdString, "ENG SMOKE ERROR!"); pLCD2004->println(lcdString); Serial.println(lcdString); endWithFlashingLED(5);
-        }
-        // Rev: 06/12/22
-        // Set Legacy loco smoke level to OFF, LOW, MED, or HIGH
-        // level: 0=Smoke OFF, 1=Smoke LOW, 2=Smoke MED, 3=Smoke HIGH
-        // This is a Legacy 9-byte Effects Control 0x7C
-        // *** WORD 1 of 3 ***  Already know m_legacyCommandRecord.legacyCommandByte[0] = 0xF8 or 0xF9
-        m_legacyCommandRecord.legacyCommandByte[1] = (t_devNum * 2) + 1;  // Shift loco num left one bit, add 1
-        m_legacyCommandRecord.legacyCommandByte[2] = 0x7C;  // Word 1 of 3, byte 3 = 0x7C (Effects Controls)
-        // *** WORD 2 of 3 ***
-        m_legacyCommandRecord.legacyCommandByte[3] = 0xFB;  // Legacy 2nd and 3rd set of 3-byte "words" ALWAYS start with FB
-        if (t_devType == 'E') {
-          m_legacyCommandRecord.legacyCommandByte[4] = (t_devNum * 2) + 0;  // Add 0 if we're addressing a Legacy Engine
-        } else {
-          m_legacyCommandRecord.legacyCommandByte[4] = (t_devNum * 2) + 1;  // Add 1 if we're addressing a Legacy Train
-        }
-        m_legacyCommandRecord.legacyCommandByte[5] = t_devParm1;  // Smoke off = 00, smoke Low/Med/High = 01/02/03
-        // *** WORD 3 of 3 ***
-        // For the third 3-byte word, the first two bytes of word 3 are always the same as the first two bytes of word 2
-        m_legacyCommandRecord.legacyCommandByte[6] = m_legacyCommandRecord.legacyCommandByte[3];
-        m_legacyCommandRecord.legacyCommandByte[7] = m_legacyCommandRecord.legacyCommandByte[4];
-        // Last byte is a one's complement checksum of 5 previous bytes: starting at zero: 1, 2, 4, 5, and 7.
-        m_legacyCommandRecord.legacyCommandByte[8] = legacyChecksum(m_legacyCommandRecord.legacyCommandByte[1], 
-                                                                    m_legacyCommandRecord.legacyCommandByte[2],
-                                                                    m_legacyCommandRecord.legacyCommandByte[4],
-                                                                    m_legacyCommandRecord.legacyCommandByte[5],
-                                                                    m_legacyCommandRecord.legacyCommandByte[7]);
-        break;
-      }
-
-    // We'll handle all six of the 0x74 Railsounds FX Triggers in one block, as only 1 byte differs among them...
-    case LEGACY_SOUND_MSTR_VOL_UP:     // 0x74 Railsounds FX Trigger There are 10 poss vols: 0..9.  Can't set specifically and couldn't tell what it affected (not main vol.)
-    case LEGACY_SOUND_MSTR_VOL_DOWN:   // 0x74 Railsounds FX Trigger No way to go directly to a master vol level.
-    case LEGACY_SOUND_BLEND_VOL_UP:    // 0x74 Railsounds FX Trigger.  Tried this but wasn't able to get any response (same with 9-byte mstr vol up/down)
-    case LEGACY_SOUND_BLEND_VOL_DOWN:  // 0x74 Railsounds FX Trigger.  Tried this but wasn't able to get any response (same with 9-byte mstr vol up/down)
-    case LEGACY_SOUND_COCK_CLEAR_ON:   // 0x74 Railsounds FX Trigger.  Steam only. This is a 9-byte 0x74 Legacy Railsounds FX Trigger
-    case LEGACY_SOUND_COCK_CLEAR_OFF:  // 0x74 Railsounds FX Trigger.  Steam only. This is a 9-byte 0x74 Legacy Railsounds FX Trigger
-      {
-        m_legacyCommandRecord.legacyCommandByte[1] = (t_devNum * 2) + 1;  // Shift loco num left one bit, add 1
-        m_legacyCommandRecord.legacyCommandByte[2] = 0x74;  // Word 1 of 3, byte 3 = 0x74 (Railsounds FX Triggers)
-        // *** WORD 2 of 3 ***
-        m_legacyCommandRecord.legacyCommandByte[3] = 0xFB;  // Legacy 2nd and 3rd set of 3-byte "words" ALWAYS start with FB
-        if (t_devType == 'E') {
-          m_legacyCommandRecord.legacyCommandByte[4] = (t_devNum * 2) + 0;  // Add 0 if we're addressing a Legacy Engine
-        } else {
-          m_legacyCommandRecord.legacyCommandByte[4] = (t_devNum * 2) + 1;  // Add 1 if we're addressing a Legacy Train
-        }
-        m_legacyCommandRecord.legacyCommandByte[5] = t_devCommand;  // Command = Legacy hex value of command needed
-        // *** WORD 3 of 3 ***
-        // For the third 3-byte word, the first two bytes of word 3 are always the same as the first two bytes of word 2
-        m_legacyCommandRecord.legacyCommandByte[6] = m_legacyCommandRecord.legacyCommandByte[3];
-        m_legacyCommandRecord.legacyCommandByte[7] = m_legacyCommandRecord.legacyCommandByte[4];
-        // Last byte is a one's complement checksum of 5 previous bytes: starting at zero: 1, 2, 4, 5, and 7.
-        m_legacyCommandRecord.legacyCommandByte[8] = legacyChecksum(m_legacyCommandRecord.legacyCommandByte[1], 
-                                                                    m_legacyCommandRecord.legacyCommandByte[2],
-                                                                    m_legacyCommandRecord.legacyCommandByte[4],
-                                                                    m_legacyCommandRecord.legacyCommandByte[5],
-                                                                    m_legacyCommandRecord.legacyCommandByte[7]);
-        break;
-      }
-
-    // We'll handle all 38 of the 0x72 Railsounds Dialogue Triggers in one block, as only 1 byte differs among them...
-    case LEGACY_DIALOGUE:              // Separate function.  For any of the 38 Legacy Dialogues (9-byte 0x72), which will be passed as a parm.
-      {
-        // Rev: 06/12/22
-        // Dialogue is specified in t_devParm1 as a const, but equals the hex value of the Legacy 0x72 dialogue code
-        if (outOfRangeLegacyDialogueNum(t_devParm1)) {
-          sprintf(lcdString, "ENG LEG DIALOG ERR!"); pLCD2004->println(lcdString); Serial.println(lcdString); endWithFlashingLED(5);
-        }
+  if (format == ENC_FMT_LEG_3_ADDR0) {  // Loco num shifted left one bit, add 0; i.e. Abs Speed, Momentum, Stop Immed
+    m_legacyCommandRecord.legacyCommandByte[1] = (t_devNum * 2);
+  } else {  // All other 3-byte commands, and word 1 of all 9-byte commands: shift left one bit, add 1
+    m_legacyCommandRecord.legacyCommandByte[1] = (t_devNum * 2) + 1;
+  }
+  m_legacyCommandRecord.legacyCommandByte[2] = opcode;  // For 9-byte commands, 0x7C Effects, 0x74 FX Triggers, 0x72 Dialogue
+  if ((parmMax > 0) && ((format == ENC_FMT_LEG_3_ADDR0) || (format == ENC_FMT_LEG_3_ADDR1))) {
+    m_legacyCommandRecord.legacyCommandByte[2] += t_devParm1;  // i.e. Abs Speed, quilling intensity, diesel RPM
+  }
 
-        m_legacyCommandRecord.legacyCommandByte[1] = (t_devNum * 2) + 1;  // Shift loco num left one bit, add 1
-        m_legacyCommandRecord.legacyCommandByte[2] = 0x72;  // Word 1 of 3, byte 3 = 0x72 (Railsounds Dialogue Triggers)
-        // *** WORD 2 of 3 ***
-        m_legacyCommandRecord.legacyCommandByte[3] = 0xFB;  // Legacy 2nd and 3rd set of 3-byte "words" ALWAYS start with FB
-        if (t_devType == 'E') {
-          m_legacyCommandRecord.legacyCommandByte[4] = (t_devNum * 2) + 0;  // Add 0 if we're addressing a Legacy Engine
-        } else {
-          m_legacyCommandRecord.legacyCommandByte[4] = (t_devNum * 2) + 1;  // Add 1 if we're addressing a Legacy Train
-        }
-        m_legacyCommandRecord.legacyCommandByte[5] = t_devParm1;  // Dialogue number i.e. 0x0E is specified in parm1
-        // *** WORD 3 of 3 ***
-        // For the third 3-byte word, the first two bytes of word 3 are always the same as the first two bytes of word 2
-        m_legacyCommandRecord.legacyCommandByte[6] = m_legacyCommandRecord.legacyCommandByte[3];
-        m_legacyCommandRecord.legacyCommandByte[7] = m_legacyCommandRecord.legacyCommandByte[4];
-        // Last byte is a one's complement checksum of 5 previous bytes: starting at zero: 1, 2, 4, 5, and 7.
-        m_legacyCommandRecord.legacyCommandByte[8] = legacyChecksum(m_legacyCommandRecord.legacyCommandByte[1], 
-                                                                    m_legacyCommandRecord.legacyCommandByte[2],
-                                                                    m_legacyCommandRecord.legacyCommandByte[4],
-                                                                    m_legacyCommandRecord.legacyCommandByte[5],
-                                                                    m_legacyCommandRecord.legacyCommandByte[7]);
-        break;
-      }
-    default:
-      {
-        // If we fall thorough to here, we have an unsupported command type
-        sprintf(lcdString, "ENG'R LEG BAD CMD!"); pLCD2004->println(lcdString); Serial.println(lcdString); endWithFlashingLED(4);
-      }
-  }  // End of "switch" which Legacy command are we decoding?
+  if ((format == ENC_FMT_LEG_9_PARM) || (format == ENC_FMT_LEG_9_CMD)) {
+    // *** WORD 2 of 3 ***
+    m_legacyCommandRecord.legacyCommandByte[3] = 0xFB;  // Legacy 2nd and 3rd set of 3-byte "words" ALWAYS start with FB
+    if (t_devType == DEV_TYPE_LEGACY_ENGINE) {
+      m_legacyCommandRecord.legacyCommandByte[4] = (t_devNum * 2) + 0;  // Add 0 if we're addressing a Legacy Engine
+    } else {
+      m_legacyCommandRecord.legacyCommandByte[4] = (t_devNum * 2) + 1;  // Add 1 if we're addressing a Legacy Train
+    }
+    if (format == ENC_FMT_LEG_9_PARM) {
+      m_legacyCommandRecord.legacyCommandByte[5] = t_devParm1;    // Smoke level, or Dialogue number i.e. 0x0E
+    } else {
+      m_legacyCommandRecord.legacyCommandByte[5] = t_devCommand;  // 0x74 Railsounds FX Trigger: command value itself
+    }
+    // *** WORD 3 of 3 ***
+    // For the third 3-byte word, the first two bytes of word 3 are always the same as the first two bytes of word 2
+    m_legacyCommandRecord.legacyCommandByte[6] = m_legacyCommandRecord.legacyCommandByte[3];
+    m_legacyCommandRecord.legacyCommandByte[7] = m_legacyCommandRecord.legacyCommandByte[4];
+    // Last byte is a one's complement checksum of 5 previous bytes: starting at zero: 1, 2, 4, 5, and 7.
+    m_legacyCommandRecord.legacyCommandByte[8] = legacyChecksum(m_legacyCommandRecord.legacyCommandByte[1],
+                                                                m_legacyCommandRecord.legacyCommandByte[2],
+                                                                m_legacyCommandRecord.legacyCommandByte[4],
+                                                                m_legacyCommandRecord.legacyCommandByte[5],
+                                                                m_legacyCommandRecord.legacyCommandByte[7]);
+  }
 
   // Okay, we have populated m_legacyCommandRecord[] with the appropriate Legacy command; either 3, 6, or 9 bytes.
   if (m_debugOn) {
@@ -975,11 +768,25 @@ void Engineer::sendCommandToLegacyBase(legacyCommandStruct t_legacyCommand) {
     Serial3.write(t_legacyCommand.legacyCommandByte[7]);  // Byte 8
     Serial3.write(t_legacyCommand.legacyCommandByte[8]);  // Byte 9
   }
-  // Since we just wrote to the Legacy base, update our "last transmit time" tracker...
-  m_legacyLastTransmit = millis();
+  // Since we just wrote to the Legacy base, update our "last transmit time" tracker, and how long until we can send again:
+  // LEGACY_CMD_SPACING, unless these bytes would take longer than that to go out at SERIAL3_SPEED (10 bits/byte incl. start and
+  // stop bits.)  Serial3.write() only buffers, so the bytes are still going out when we get here.
+  m_legacyLastTransmit = micros();
+  m_legacyTransmitInterval = ((unsigned long)commandLength(t_legacyCommand) * 10UL * 1000000UL) / SERIAL3_SPEED;
+  if (m_legacyTransmitInterval < (LEGACY_CMD_SPACING * 1000UL)) {
+    m_legacyTransmitInterval = LEGACY_CMD_SPACING * 1000UL;
+  }
   return;
 }
 
+byte Engineer::commandLength(const legacyCommandStruct t_legacyCommand) {
+  // Rev: 10/19/26.
+  // Same rule as sendCommandToLegacyBase(): byte 4 non-zero means at least 6 bytes, byte 7 non-zero means 9 bytes.
+  if (t_legacyCommand.legacyCommandByte[6] != 0) return 9;
+  if (t_legacyCommand.legacyCommandByte[3] != 0) return 6;
+  return 3;
+}
+
 // ***************************************************************
 // ***** LEGACY/TMCC COMMAND QUEUE CIRCULAR BUFFER FUNCTIONS *****
 // ***************************************************************
@@ -1017,17 +824,78 @@ void Engineer::sendCommandToLegacyBase(legacyCommandStruct t_legacyCommand) {
 // IsEmpty = (COUNT == 0)
 // IsFull  = (COUNT == SIZE)
 
-void Engineer::commandBufEnqueue(const legacyCommandStruct t_legacyCommand) {
+void Engineer::commandBufEnqueue(const legacyCommandStruct t_legacyCommand, const bool t_urgent) {
+  // Rev: 10/19/26.  Coalesces superseded Abs Speed commands; urgent commands go in their own buffer.
   // Rev: 06/16/22.  Tested overflow 11/12/22 and it works.
-  // Insert a Legacy/TMCC hex record at the head of the Legacy command buffer, then increment head and count.
-  // t_legacyCommand is a 9-byte struct to enqueue.  We have no knowledge of the meaning; it's just Legacy-language bytes.
+  // Insert a Legacy/TMCC hex record at the head of the Legacy command buffer, then increment head and count -- unless it can be
+  // coalesced with a command that's already waiting (see below.)
+  // t_legacyCommand is a 9-byte struct to enqueue.  Apart from recognizing Abs Speed and stop commands, and which loco a command
+  // is for, we don't care what it means; it's just Legacy-language bytes.
   // If returns then it worked. If error such as buf overflow, that will be a fatal error; halt.
+  // COALESCING: If this is an Abs Speed command, look back from the newest waiting command for the first one that may affect the
+  // same loco.  If that's also an Abs Speed, the new speed supersedes it, so just overwrite it in place (counted in
+  // m_legacyCommandsCoalesced) rather than using another element.  This keeps a ramp of speed steps from piling up behind the
+  // Legacy base pacing, and delivers the newest speed sooner.  We stop at any other command for this loco (i.e. a direction
+  // change) so we never re-order a speed around it.
+  m_legacyCommandsQueued++;
+  if (t_urgent) {
+    // 10/19/26: Urgent commands jump ahead of the normal buffer.  A stop (Emergency Stop, Legacy Stop Immed, or TMCC speed 0 which
+    // is how we send TMCC Stop Immed) must cancel any unsent Abs Speed it overtakes, else that older speed would start the loco up
+    // again after the stop.  We cancel an element by zeroing its first byte; commandBufDequeue() skips it.
+    bool emergStop = ((t_legacyCommand.legacyCommandByte[0] == 0xFE) && (t_legacyCommand.legacyCommandByte[1] == 0xFF));
+    bool legacyStop = (((t_legacyCommand.legacyCommandByte[0] == 0xF8) || (t_legacyCommand.legacyCommandByte[0] == 0xF9)) &&
+                       (t_legacyCommand.legacyCommandByte[2] == 0xFB));
+    bool tmccStop = ((t_legacyCommand.legacyCommandByte[0] == 0xFE) && commandIsAbsSpeed(t_legacyCommand) &&
+                     ((t_legacyCommand.legacyCommandByte[2] & 0b00011111) == 0));
+    bool stopCmd = (emergStop || legacyStop || tmccStop);  // PowerMaster on/off doesn't cancel anything.
+    if (stopCmd) {
+      unsigned int bufIndex = m_legacyCommandBufTail;
+      for (unsigned int i = 0; i < m_legacyCommandBufCount; i++) {
+        if (commandIsAbsSpeed(m_pLegacyCommandBuf[bufIndex]) &&
+            (emergStop || commandMayAffectLoco(m_pLegacyCommandBuf[bufIndex], t_legacyCommand))) {
+          m_pLegacyCommandBuf[bufIndex].legacyCommandByte[0] = 0;
+          m_legacyCommandsCancelled++;
+        }
+        bufIndex = (bufIndex + 1) % LEGACY_CMD_HEAP_RECS;
+      }
+    }
+    if (m_legacyUrgentBufCount == LEGACY_CMD_URGENT_RECS) {
+      sprintf(lcdString, "Urgent buf ovflow!"); pLCD2004->println(lcdString); Serial.println(lcdString); endWithFlashingLED(3);
+    }
+    for (byte j = 0; j < LEGACY_CMD_BYTES; j++) {  // Always 9 bytes, 0..8
+      m_pLegacyUrgentBuf[m_legacyUrgentBufHead].legacyCommandByte[j] = t_legacyCommand.legacyCommandByte[j];
+    }
+    m_legacyUrgentTime[m_legacyUrgentBufHead] = millis();
+    m_legacyUrgentBufHead = (m_legacyUrgentBufHead + 1) % LEGACY_CMD_URGENT_RECS;
+    m_legacyUrgentBufCount++;
+    return;
+  }
+  if (commandIsAbsSpeed(t_legacyCommand)) {
+    unsigned int bufIndex = m_legacyCommandBufHead;
+    for (unsigned int i = 0; i < m_legacyCommandBufCount; i++) {
+      bufIndex = (bufIndex + LEGACY_CMD_HEAP_RECS - 1) % LEGACY_CMD_HEAP_RECS;  // Step back one element, newest to oldest
+      if (m_pLegacyCommandBuf[bufIndex].legacyCommandByte[0] == 0) continue;  // Cancelled element
+      if (commandMayAffectLoco(m_pLegacyCommandBuf[bufIndex], t_legacyCommand)) {
+        if (commandIsAbsSpeed(m_pLegacyCommandBuf[bufIndex])) {
+          for (byte j = 0; j < LEGACY_CMD_BYTES; j++) {  // Always 9 bytes, 0..8
+            m_pLegacyCommandBuf[bufIndex].legacyCommandByte[j] = t_legacyCommand.legacyCommandByte[j];
+          }
+          m_legacyCommandsCoalesced++;
+          return;
+        }
+        break;  // Some other command for this loco is waiting, so the new speed must go after it.
+      }
+    }
+  }
   if (!commandBufIsFull()) {
     for (byte j = 0; j < LEGACY_CMD_BYTES; j++) {  // Always 9 bytes, 0..8
       m_pLegacyCommandBuf[m_legacyCommandBufHead].legacyCommandByte[j] = t_legacyCommand.legacyCommandByte[j];
     }
     m_legacyCommandBufHead = (m_legacyCommandBufHead + 1) % LEGACY_CMD_HEAP_RECS;
     m_legacyCommandBufCount++;
+    if (m_legacyCommandBufCount > m_legacyCommandBufMaxCount) {
+      m_legacyCommandBufMaxCount = m_legacyCommandBufCount;
+    }
   } else {
     sprintf(lcdString, "Command buf ovflow!"); pLCD2004->println(lcdString); Serial.println(lcdString); endWithFlashingLED(3);
   }
@@ -1035,28 +903,47 @@ void Engineer::commandBufEnqueue(const legacyCommandStruct t_legacyCommand) {
 }
 
 bool Engineer::commandBufDequeue(legacyCommandStruct* t_legacyCommand) {
-  // Rev: 06/16/22.
-  // If it's been at least 30ms since the last command was sent to the Legacy base, then see if there is a new command waiting in
-  // the Legacy command circular buffer.  If so, grab it and put it in our pointed-to legacyCommandStruct variable t_legacyCommand.
+  // Rev: 10/19/26.  Urgent buffer first; pace at LEGACY_CMD_SPACING (or wire time if longer); skip cancelled elements.
+  // If the previous command has had time to go out and the Legacy base's gap has passed, then see if there is a new command
+  // waiting in the urgent buffer, or else the Legacy command circular buffer.  If so, grab it and put it in our pointed-to
+  // legacyCommandStruct variable t_legacyCommand.
   // We aren't sending any data to the Legacy base; we just return a 9-byte command via pointer if a command is ready to send.
   // The data is just a 9-byte hex struct to dequeue.  We have no knowledge of the meaning as it's Legacy/TMCC-language bytes.
   // Returns true if we were able to get a new command, else false (not fatal.)
-  if ((millis() - m_legacyLastTransmit) < LEGACY_CMD_DELAY) {
-    return false;  // If we transmitted less than 30ms ago, nothing to do even if something might be in the command buffer
+  if ((micros() - m_legacyLastTransmit) < m_legacyTransmitInterval) {
+    return false;  // Previous command still on the wire or within the base's gap; nothing to do even if commands are waiting.
   }
-  // Since it's been at least 30ms, see if we have a command in the Legacy Command buffer
-  // Data will be at TAIL, then TAIL will be incremented (modulo size), and COUNT will be decremented.
-  if (!commandBufIsEmpty()) {
+  // Urgent commands always go first.
+  if (m_legacyUrgentBufCount > 0) {
     for (byte j = 0; j < LEGACY_CMD_BYTES; j++) {  // Always 9 bytes, 0..8
-      // Passing the Legacy Command struct by pointer requires use of arrow operator here...
-      t_legacyCommand->legacyCommandByte[j] = m_pLegacyCommandBuf[m_legacyCommandBufTail].legacyCommandByte[j];
+      t_legacyCommand->legacyCommandByte[j] = m_pLegacyUrgentBuf[m_legacyUrgentBufTail].legacyCommandByte[j];
+    }
+    unsigned long urgentWait = millis() - m_legacyUrgentTime[m_legacyUrgentBufTail];
+    if (urgentWait > m_legacyUrgentWorstWait) {
+      m_legacyUrgentWorstWait = urgentWait;
+    }
+    m_legacyUrgentBufTail = (m_legacyUrgentBufTail + 1) % LEGACY_CMD_URGENT_RECS;
+    m_legacyUrgentBufCount--;
+    m_legacyUrgentSent++;
+    return true;
+  }
+  // See if we have a command in the Legacy Command buffer.  Data will be at TAIL, then TAIL will be incremented (modulo size), and
+  // COUNT will be decremented.  Elements cancelled by an urgent stop (first byte zero) are just discarded.
+  while (!commandBufIsEmpty()) {
+    bool cancelled = (m_pLegacyCommandBuf[m_legacyCommandBufTail].legacyCommandByte[0] == 0);
+    if (!cancelled) {
+      for (byte j = 0; j < LEGACY_CMD_BYTES; j++) {  // Always 9 bytes, 0..8
+        // Passing the Legacy Command struct by pointer requires use of arrow operator here...
+        t_legacyCommand->legacyCommandByte[j] = m_pLegacyCommandBuf[m_legacyCommandBufTail].legacyCommandByte[j];
+      }
     }
     m_legacyCommandBufTail = (m_legacyCommandBufTail + 1) % LEGACY_CMD_HEAP_RECS;
     m_legacyCommandBufCount--;
-    return true;  // And t_legacyCommand will be returned to the caller via pointer
-  } else {
-    return false;  // Legacy command buffer is empty
+    if (!cancelled) {
+      return true;  // And t_legacyCommand will be returned to the caller via pointer
+    }
   }
+  return false;  // Legacy command buffer is empty
 }
 
 bool Engineer::commandBufIsEmpty() {
@@ -1067,6 +954,41 @@ bool Engineer::commandBufIsFull() {
   return (m_legacyCommandBufCount == LEGACY_CMD_HEAP_RECS);
 }
 
+bool Engineer::commandIsAbsSpeed(const legacyCommandStruct t_legacyCommand) {
+  // Rev: 10/19/26.
+  // Same decoding as sendCommandToTrain(), but only 3-byte commands qualify.
+  // Legacy Engine/Train (0xF8/0xF9): right-most bit of byte 2 is 0 and byte 3 is 0..199 (0xFB would be Stop Immed.)
+  // TMCC (0xFE, but not 0xFE 0xFF Emergency Stop): command bits of byte 3 are 11.  TMCC Stop Immed is just Abs Speed 0.
+  if (t_legacyCommand.legacyCommandByte[3] != 0) return false;  // 6- or 9-byte command
+  if ((t_legacyCommand.legacyCommandByte[0] == 0xF8) || (t_legacyCommand.legacyCommandByte[0] == 0xF9)) {
+    return (((t_legacyCommand.legacyCommandByte[1] & 0b00000001) == 0) && (t_legacyCommand.legacyCommandByte[2] <= 0xC7));
+  }
+  if ((t_legacyCommand.legacyCommandByte[0] == 0xFE) && (t_legacyCommand.legacyCommandByte[1] != 0xFF)) {
+    return ((t_legacyCommand.legacyCommandByte[2] & 0b01100000) == 0b01100000);
+  }
+  return false;
+}
+
+bool Engineer::commandMayAffectLoco(const legacyCommandStruct t_legacyCommand, const legacyCommandStruct t_absSpeedCommand) {
+  // Rev: 10/19/26.
+  // t_absSpeedCommand is known to be a 3-byte Legacy or TMCC Abs Speed command.  When in doubt, return true.
+  byte cmdType = t_legacyCommand.legacyCommandByte[0];
+  byte spdType = t_absSpeedCommand.legacyCommandByte[0];
+  if ((cmdType == 0xF8) || (cmdType == 0xF9)) {  // Legacy 3-byte Engine or Train
+    if ((spdType != 0xF8) && (spdType != 0xF9)) return false;  // Legacy vs TMCC address, different devices
+    if (cmdType != spdType) return true;  // Legacy Engine vs Train; the Train may include the Engine, so play it safe
+    // Address is the left-most 7 bits of byte 2 for both Engines and Trains.
+    return ((t_legacyCommand.legacyCommandByte[1] >> 1) == (t_absSpeedCommand.legacyCommandByte[1] >> 1));
+  }
+  if ((cmdType == 0xFE) && (t_legacyCommand.legacyCommandByte[1] != 0xFF)) {  // TMCC, but not Emergency Stop
+    if (spdType != 0xFE) return false;
+    // Address is byte 2 (including Engine/Train bits) plus the left-most bit of byte 3.
+    return ((t_legacyCommand.legacyCommandByte[1] == t_absSpeedCommand.legacyCommandByte[1]) &&
+            ((t_legacyCommand.legacyCommandByte[2] & 0b10000000) == (t_absSpeedCommand.legacyCommandByte[2] & 0b10000000)));
+  }
+  return true;  // Emergency Stop, 9-byte Legacy, or anything else we don't decode
+}
+
 // ***************************************************************************
 // ***** LEGACY COMMAND CHECKSUM and LEGACY/TMCC FUNCTION RANGE CHECKING *****
 // ***************************************************************************
@@ -1126,52 +1048,6 @@ bool Engineer::outOfRangeTMCCDialogueNum(byte t_devParm1) {  // Must be 1..6
   }
 }
 
-bool Engineer::outOfRangeLocoSpeed(char t_devType, byte t_devParm1) {
-  if ((t_devType == DEV_TYPE_TMCC_ENGINE) || (t_devType == DEV_TYPE_TMCC_TRAIN)) {  // TMCC 'N' Engine or 'R' Train can be 0..31
-    if ((t_devParm1 < 0) || (t_devParm1 > 31)) {
-      return true;  // true means it's out of range
-    }
-  }
-  // Anything else can have speed 0..1999
-  if ((t_devParm1 < 0) || (t_devParm1 > 199)) {  // Only 0..199 are valid
-    return true;  // true means it's out of range
-  } else {
-    return false;
-  }
-}
-
-bool Engineer::outOfRangeQuill(byte t_devParm1) {
-  if ((t_devParm1 < 0) || (t_devParm1 > 15)) {  // Only 0..15 are valid
-    return true;  // true means it's out of range
-  } else {
-    return false;
-  }
-}
-
-bool Engineer::outOfRangeRPM(byte t_devParm1) {
-  if ((t_devParm1 < 0) || (t_devParm1 > 7)) {  // Only 0..7 are valid
-    return true;  // true means it's out of range
-  } else {
-    return false;
-  }
-}
-
-bool Engineer::outOfRangeLabor(byte t_devParm1) {
-  if ((t_devParm1 < 0) || (t_devParm1 > 31)) {  // Only 0..31 are valid
-    return true;  // true means it's out of range
-  } else {
-    return false;
-  }
-}
-
-bool Engineer::outOfRangeSmoke(byte t_devParm1) {
-  if ((t_devParm1 < 0) || (t_devParm1 > 3)) {  // Only 0..3 are valid
-    return true;  // true means it's out of range
-  } else {
-    return false;
-  }
-}
-
 bool Engineer::outOfRangeLegacyDialogueNum(byte t_devParm1) {
   // Rev: 06/12/22
   // Legacy Railsounds Dialogue Triggers (0x72)
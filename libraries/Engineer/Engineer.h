@@ -1,5 +1,17 @@
-// ENGINEER.H Rev: 07/01/24. COMPLETE AND SEEMS TO WORK BUT NEEDS RIGOROUS TESTING.
+// ENGINEER.H Rev: 10/19/26. COMPLETE AND SEEMS TO WORK BUT NEEDS RIGOROUS TESTING.
 // Part of O_LEG.
+// 10/19/26: Added setProfiler(); executeConductorCommand() times its Delayed Action and Legacy send halves (if given a profiler.)
+// 10/19/26: begin() takes an Event_Journal*; every command retrieved from Delayed Action is journaled (if not nullptr.)
+// 10/19/26: Legacy/TMCC encoding is table driven (see Engineer.cpp); removed per-parm outOfRangeXxx() helpers now in the tables.
+//           Output is byte-for-byte the same as before (Host_Test/Test_Engineer_Encoding.cpp) except for two behavior changes:
+//           TMCC_DIALOGUE used to fall into the "TMCC BAD CMD" default and halt; it now sends the StationSounds Diner keys.
+//           LEGACY_NUMERIC_PRESS used to send 0x10 + any parm (a different command above 9); it now halts on digits above 9.
+// 10/19/26: commandBufEnqueue() now coalesces a new ABS_SPEED with an unsent ABS_SPEED for the same loco, if that is the newest
+//           command waiting for the loco.  During multi-train ramps stale speed steps were delaying fresh ones by hundreds of ms.
+//           Added displayStats() to report commands queued, coalesced, and the Legacy Base time saved.
+// 10/19/26: Added an urgent lane for Stop Immed, Emergency Stop and PowerMaster commands, which is always sent before anything in
+//           the normal buffer.  Commands now start LEGACY_CMD_SPACING (25ms) apart, or their wire time at SERIAL3_SPEED if that
+//           were longer, rather than a fixed 30ms.
 // 07/01/24: Moved "Update Train Progress loco speed" from getDelayedActionCommand() into sendCommandToTrain().
 // 06/30/24: Added debug switch
 // 03/02/23: Complete and generally works but needs more rigorous testing, including Accessories.
@@ -36,6 +48,8 @@
 #include <Loco_Reference.h>  // So we can look up loco type i.e. E/T/N/R/A
 #include <Train_Progress.h>  // Needed to update loco's latest speed/time as commands are sent to Legacy buffer.
 #include <Delayed_Action.h>  // This is where we retrieve "ripe" commands to be sent to the Legacy command buffer/Legacy base.
+#include <Event_Journal.h>   // Optional log of every command we retrieve.
+#include <Loop_Profiler.h>   // Optional timing of executeConductorCommand().
 
 class Engineer {
 
@@ -43,7 +57,8 @@ class Engineer {
 
     Engineer();  // Constructor must be called above setup() so the object will be global to the module.
 
-    void begin(Loco_Reference* t_pLoco, Train_Progress* t_pTrainProgress, Delayed_Action* t_pDelayedAction);
+    void begin(Loco_Reference* t_pLoco, Train_Progress* t_pTrainProgress, Delayed_Action* t_pDelayedAction,
+               Event_Journal* t_pJournal);  // t_pJournal may be nullptr.
     // We'll call Engineer::begin() when we initialize the Engineer object right after calling the constructor.
     // WE MUST ALSO CALL THIS FUNCTION each time Reg'n begins, to properly reset the Legacy Cmd Buf and release Accessory relays.
     // Since Engineer is also responsible for keeping Train_Progress::currentSpeed up to date, each loco's speed should also be set
@@ -64,6 +79,12 @@ class Engineer {
     // Calls both getDelayedActionCommand() and sendCommandToTrain(); both ultimately commands from Conductor to Engineer.
     // Should be called as frequently as possible, when running in Auto or Park mode.
 
+    void setProfiler(Loop_Profiler* t_pProfiler);
+    // Charge executeConductorCommand()'s time to LOOP_STAGE_DELAYED_ACTION and LOOP_STAGE_ENGINEER_SEND.  nullptr to stop.
+
+    void displayStats();
+    // Send Legacy Command Buffer counts (queued, coalesced, max waiting) and the transmit time saved by coalescing to Serial.
+
   private:
 
     // ENGINEER Legacy/TMCC command structure.  This struct is only known inside the Engineer class.
@@ -89,7 +110,7 @@ class Engineer {
     void sendCommandToTrain();
     // This function must be called as frequently as possible (every time through loop) by Engineer to keep loco commands that
     // are waiting in the Legacy Command Buffer streaming out via the Legacy Base to the locos.
-    // Dequeues a 9-byte record (if any) from the Legacy Command Buffer (not more often than each 30ms).
+    // Dequeues a 9-byte record (if any) from the urgent or Legacy Command Buffer (paced at LEGACY_CMD_SPACING.)
     // At this point, we're just feeding a 3/6/9-byte command to Legacy as quickly as possible, with no knowledge of what the
     // command is or does, except to know that it's a Legacy (or TMCC) command, and not i.e. an Accessory command.
     // If a record is found, forward to the Legacy Command Base via the RS-232 interface.
@@ -107,18 +128,32 @@ class Engineer {
 
     bool commandBufIsFull();
 
-    void commandBufEnqueue(legacyCommandStruct t_legacyCommand);
-    // Insert a 3-, 6-, or 9-byte Legacy/TMCC command into the circular Legacy buffer.
+    void commandBufEnqueue(legacyCommandStruct t_legacyCommand, const bool t_urgent);
+    // Insert a 3-, 6-, or 9-byte Legacy/TMCC command into the circular Legacy buffer, or the urgent buffer if t_urgent.
+    // An urgent Stop Immed cancels any unsent Abs Speed for the same loco in the normal buffer (else the older speed would be sent
+    // after the stop and start it up again); an urgent Emergency Stop cancels every unsent Abs Speed.
+    // If it's an Abs Speed command and the newest command already waiting for the same loco is also an Abs Speed, overwrite that
+    // one in place rather than adding a new element.
     // If returns then it worked. If error such as buf overflow, that will be a fatal error; halt.
     // Called by Engineer::getDelayedActionCommand().
 
+    bool commandIsAbsSpeed(const legacyCommandStruct t_legacyCommand);
+    // True if this is a 3-byte Legacy or TMCC Engine/Train Abs Speed command (not Stop Immed or Emergency Stop.)
+
+    bool commandMayAffectLoco(const legacyCommandStruct t_legacyCommand, const legacyCommandStruct t_absSpeedCommand);
+    // True if t_legacyCommand is addressed to the same loco as t_absSpeedCommand, or if we can't tell (i.e. 9-byte commands and
+    // Emergency Stop), in which case we must not coalesce across it.
+
     bool commandBufDequeue(legacyCommandStruct* t_legacyCommand);
-    // Attempt to retrieve a command from the Command Buffer if conditions are met (i.e. 30ms has passed since last retrieval.)
+    // Attempt to retrieve a command from the urgent buffer, else the Command Buffer, if LEGACY_CMD_SPACING (or the previous
+    // command's wire time, if longer) has passed since the previous command started.  Cancelled elements are skipped.
     // Returns true if we were able to get a new command.
     // Called by Engineer::sendCommandToTrain().
 
     void sendCommandToLegacyBase(legacyCommandStruct t_legacyCommand);
-    // Send a command to the Legacy base.
+    // Send a command to the Legacy base, and set m_legacyTransmitInterval from its length.
+
+    byte commandLength(const legacyCommandStruct t_legacyCommand);  // 3, 6, or 9 bytes.
     // Called by Engineer::sendCommandToTrain().
 
     byte legacyChecksum(byte leg1, byte leg2, byte leg4, byte leg5, byte leg7);
@@ -126,11 +161,6 @@ class Engineer {
     bool outOfRangeLegacyDevType(char t_devType);  // E/T = Legacy Engine or Train
     bool outOfRangeDevNum(char t_devType, byte t_devNum);  // Can be 1..9 or 1..50 depending on TMCC Train vs other
     bool outOfRangeTMCCDialogueNum(byte t_devParm1);
-    bool outOfRangeLocoSpeed(char t_devType, byte t_devParm1);
-    bool outOfRangeQuill(byte t_devParm1);
-    bool outOfRangeRPM(byte t_devParm1);
-    bool outOfRangeLabor(byte t_devParm1);
-    bool outOfRangeSmoke(byte t_devParm1);
     bool outOfRangeLegacyDialogueNum(byte t_devParm1);
 
     // *** LEGACY COMMAND BUFFER ***
@@ -144,10 +174,25 @@ class Engineer {
     unsigned int         m_legacyCommandBufHead  = 0;  // Next array element to be written.
     unsigned int         m_legacyCommandBufTail  = 0;  // Next array element to be removed.
     unsigned int         m_legacyCommandBufCount = 0;  // Number active elements in buffer.  Max is LEGACY_CMD_HEAP_RECS.
-    unsigned long        m_legacyLastTransmit;         // Class global variable that updates each time we actually send a command (ms) 
+    unsigned long        m_legacyLastTransmit;         // Class global variable that updates each time we actually send a command (micros)
+    unsigned long        m_legacyTransmitInterval;     // LEGACY_CMD_SPACING, or wire time of last cmd if longer (micros.)  Wait to send again.
+    // Urgent lane, same circular buffer scheme.  Small, and usually empty.
+    legacyCommandStruct* m_pLegacyUrgentBuf;
+    unsigned long        m_legacyUrgentTime[LEGACY_CMD_URGENT_RECS];  // millis() when each urgent element was enqueued.
+    byte                 m_legacyUrgentBufHead  = 0;
+    byte                 m_legacyUrgentBufTail  = 0;
+    byte                 m_legacyUrgentBufCount = 0;
+    unsigned int         m_legacyUrgentSent;           // Urgent commands sent since init.
+    unsigned long        m_legacyUrgentWorstWait;      // Longest ms any urgent command waited in the urgent buffer.
+    unsigned int         m_legacyCommandsCancelled;    // Abs Speed commands cancelled by an urgent Stop Immed or Emergency Stop.
+    unsigned int         m_legacyCommandsQueued;       // Total commands passed to commandBufEnqueue() since init.
+    unsigned int         m_legacyCommandsCoalesced;    // Abs Speed commands that overwrote an unsent Abs Speed for the same loco.
+    unsigned int         m_legacyCommandBufMaxCount;   // High-water mark of m_legacyCommandBufCount.
 
     Loco_Reference* m_pLoco;
     Delayed_Action* m_pDelayedAction;   // Pointer to the Delayed Action class so we can call its functions.
+    Event_Journal* m_pJournal;          // nullptr if this module doesn't keep a journal.
+    Loop_Profiler* m_pProfiler = nullptr;  // nullptr unless setProfiler() was called.
     Train_Progress* m_pTrainProgress;   // Pointer to the Train Progress class so we can update loco current speed/time.
     bool m_debugOn = false;
 
@@ -0,0 +1,150 @@
+// EVENT_JOURNAL.CPP Rev: 10/19/26.
+// Ring-buffered binary event journal in FRAM.  See Event_Journal.h.
+
+#include "Event_Journal.h"
+
+// Column headings for dump()
+static const char JOURNAL_MODULE_NAME[8][4] PROGMEM = { "NUL", "MAS", "LEG", "SNS", "BTN", "SWT", "LED", "OCC" };
+
+Event_Journal::Event_Journal() {  // Constructor
+  // Rev: 10/19/26.
+  m_pStorage = nullptr;
+  return;
+}
+
+void Event_Journal::begin(FRAM* t_pStorage) {
+  // Rev: 10/19/26.
+  m_pStorage = t_pStorage;
+  if (m_pStorage == nullptr) {
+    sprintf(lcdString, "UN-INIT'd EJ PTR"); pLCD2004->println(lcdString); Serial.println(lcdString); endWithFlashingLED(5);
+  }
+  m_pStorage->readStream(FRAM_ADDR_MAS_LOG_FILE, sizeof(m_header), (byte*)&m_header);
+  if (m_header.signature != JOURNAL_SIGNATURE) {  // New FRAM, or one that has never held a journal
+    Event_Journal::reset();
+  }
+  Event_Journal::log(JOURNAL_EVENT_BOOT, LOCO_ID_NULL, 0, 0, 0);
+  return;
+}
+
+void Event_Journal::reset() {
+  // Rev: 10/19/26.
+  m_header.signature = JOURNAL_SIGNATURE;
+  m_header.recordsWritten = 0;
+  Event_Journal::writeHeader();
+  return;
+}
+
+void Event_Journal::log(const byte t_eventType, const byte t_locoNum, const unsigned int t_routeElement, const byte t_item,
+                        const unsigned int t_value) {
+  // Rev: 10/19/26.
+  // Write the record, then the header, so a reset between the two just loses this record.
+  m_record.timestamp = millis();
+  m_record.module = THIS_MODULE;
+  m_record.eventType = t_eventType;
+  m_record.locoNum = t_locoNum;
+  m_record.item = t_item;
+  m_record.routeElement = t_routeElement;
+  m_record.value = t_value;
+  m_pStorage->writeStream(Event_Journal::recordAddress(m_header.recordsWritten), sizeof(m_record), (byte*)&m_record);
+  m_header.recordsWritten++;
+  Event_Journal::writeHeader();
+  return;
+}
+
+unsigned long Event_Journal::recordsWritten() {
+  // Rev: 10/19/26.
+  return m_header.recordsWritten;
+}
+
+void Event_Journal::dump() {
+  // Rev: 10/19/26.
+  // Oldest record still in the ring first.  Timestamps are seconds.milliseconds since that module's most recent BOOT record.
+  unsigned long firstRecNum = 0;
+  if (m_header.recordsWritten > JOURNAL_RECS) {
+    firstRecNum = m_header.recordsWritten - JOURNAL_RECS;
+  }
+  Serial.print(F("EVENT JOURNAL: ")); Serial.print(m_header.recordsWritten - firstRecNum);
+  Serial.print(F(" of ")); Serial.print(m_header.recordsWritten); Serial.println(F(" records."));
+  char moduleName[4];
+  char timeString[14];
+  for (unsigned long recNum = firstRecNum; recNum < m_header.recordsWritten; recNum++) {
+    m_pStorage->readStream(Event_Journal::recordAddress(recNum), sizeof(m_record), (byte*)&m_record);
+    if (m_record.module < 8) {
+      strcpy_P(moduleName, JOURNAL_MODULE_NAME[m_record.module]);
+    } else {
+      strcpy(moduleName, "???");
+    }
+    sprintf(timeString, "%7lu.%03u ", m_record.timestamp / 1000, (unsigned int)(m_record.timestamp % 1000));
+    Serial.print(timeString); Serial.print(moduleName); Serial.print(' ');
+    switch (m_record.eventType) {
+      case JOURNAL_EVENT_BOOT:
+        Serial.println(F("BOOT ----------------"));
+        break;
+      case JOURNAL_EVENT_MODE_STATE:
+        Serial.print(F("Mode ")); Serial.print(m_record.item);
+        Serial.print(F(" State ")); Serial.println(m_record.value);
+        break;
+      case JOURNAL_EVENT_SENSOR_TRIP:
+        Serial.print(F("Sensor ")); Serial.print(m_record.item);
+        if (m_record.value == SENSOR_STATUS_TRIPPED) {
+          Serial.print(F(" tripped"));
+        } else {
+          Serial.print(F(" cleared"));
+        }
+        if (m_record.locoNum != LOCO_ID_NULL) {
+          Serial.print(F(" by loco ")); Serial.print(m_record.locoNum);
+          Serial.print(F(" at element ")); Serial.print(m_record.routeElement);
+        }
+        Serial.println();
+        break;
+      case JOURNAL_EVENT_ROUTE_ADDED:
+        Serial.print(F("Loco ")); Serial.print(m_record.locoNum);
+        Serial.print(F(" route ")); Serial.print(m_record.routeElement);
+        Serial.print(F(" (")); Serial.print((char)m_record.item);
+        Serial.print(F(") countdown ")); Serial.print(m_record.value); Serial.println(F(" sec"));
+        break;
+      case JOURNAL_EVENT_BLOCK_RESERVED:
+        Serial.print(F("Block ")); Serial.print(m_record.item);
+        if (m_record.value == BE) {
+          Serial.print(F(" BE"));
+        } else {
+          Serial.print(F(" BW"));
+        }
+        Serial.print(F(" reserved for loco ")); Serial.println(m_record.locoNum);
+        break;
+      case JOURNAL_EVENT_BLOCK_RELEASED:
+        Serial.print(F("Block ")); Serial.print(m_record.item); Serial.println(F(" released"));
+        break;
+      case JOURNAL_EVENT_TURNOUT_THROWN:
+        Serial.print(F("Turnout ")); Serial.print(m_record.item);
+        Serial.print(' '); Serial.println((char)m_record.value);
+        break;
+      case JOURNAL_EVENT_LEGACY_CMD:
+        Serial.print(F("Legacy dev ")); Serial.print(m_record.locoNum);
+        Serial.print(F(" cmd ")); Serial.print(m_record.item);
+        Serial.print(F(" parm ")); Serial.println(m_record.value);
+        break;
+      default:
+        Serial.print(F("Event ")); Serial.print(m_record.eventType);
+        Serial.print(F(" loco ")); Serial.print(m_record.locoNum);
+        Serial.print(F(" elem ")); Serial.print(m_record.routeElement);
+        Serial.print(F(" item ")); Serial.print(m_record.item);
+        Serial.print(F(" value ")); Serial.println(m_record.value);
+        break;
+    }
+  }
+  Serial.println(F("END OF JOURNAL."));
+  return;
+}
+
+void Event_Journal::writeHeader() {
+  // Rev: 10/19/26.
+  m_pStorage->writeStream(FRAM_ADDR_MAS_LOG_FILE, sizeof(m_header), (byte*)&m_header);
+  return;
+}
+
+unsigned long Event_Journal::recordAddress(const unsigned long t_recNum) {
+  // Rev: 10/19/26.
+  return FRAM_ADDR_MAS_LOG_FILE + sizeof(journalHeaderStruct) +
+         ((t_recNum % JOURNAL_RECS) * sizeof(journalRecordStruct));
+}
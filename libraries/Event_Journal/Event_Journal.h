@@ -0,0 +1,77 @@
+// EVENT_JOURNAL.H Rev: 10/19/26.
+// An append-only ring of fixed-size binary records in FRAM at FRAM_ADDR_MAS_LOG_FILE, so after an incident we can see much more
+// than the last four lines on the LCD.  Each module that keeps a journal (MAS and LEG so far) uses its own FRAM.
+// Each record is 12 bytes: millis() timestamp, module, event type, loco, route element, and two event-specific fields.
+// Logging costs two short SPI writes (the record and the 6-byte header), about 40 microseconds, so it's fine to log every sensor
+// trip, route, reservation change, and Legacy command.  Records bypass the FRAM write-back cache (see FRAM.h.)
+// When the ring is full, the oldest records are overwritten.
+// dump() sends a readable timeline, oldest record first, to the Serial monitor.  A JOURNAL_EVENT_BOOT record is written by
+// begin(), since timestamps start over at zero each time a module is reset.
+// O_FRAM_Populator/Event_Journal.py prints the same timeline from a FRAM image saved with FRAM_Image.py.  If the record layout or
+// the event types change here, change them there too.
+// 10/19/26: Ring size is now however many records fit in FRAM_BYTES_MAS_LOG_FILE (8192), replacing FRAM_RECS_MAS_LOG_FILE.
+
+#ifndef EVENT_JOURNAL_H
+#define EVENT_JOURNAL_H
+
+#include <Train_Consts_Global.h>
+#include <Train_Functions.h>
+#include <Display_2004.h>
+#include <FRAM.h>
+
+// Event types, and what the optional fields of each record hold:
+//                                                   locoNum  routeElement          item            value
+const byte JOURNAL_EVENT_BOOT             = 1;  //   -        -                     -               -
+const byte JOURNAL_EVENT_MODE_STATE       = 2;  //   -        -                     Mode            State
+const byte JOURNAL_EVENT_SENSOR_TRIP      = 3;  //   loco/0   Train Progress elem   Sensor num      SENSOR_STATUS_TRIPPED/CLEARED
+const byte JOURNAL_EVENT_ROUTE_ADDED      = 4;  //   loco     Route Ref rec num     'E'xt/'C'ont    Countdown (sec)
+const byte JOURNAL_EVENT_BLOCK_RESERVED   = 5;  //   loco     -                     Block num       BE/BW
+const byte JOURNAL_EVENT_BLOCK_RELEASED   = 6;  //   -        -                     Block num       -
+const byte JOURNAL_EVENT_TURNOUT_THROWN   = 7;  //   -        -                     Turnout num     TURNOUT_DIR_NORMAL/REVERSE
+const byte JOURNAL_EVENT_LEGACY_CMD       = 8;  //   devNum   -                     Device command  Parm 1
+
+class Event_Journal {
+
+  public:
+
+    Event_Journal();  // Constructor must be called above setup() so the object will be global to the module.
+    void begin(FRAM* t_pStorage);  // Picks up where the journal left off (or resets it if FRAM has never held a journal.)
+    void reset();  // Discard all records.
+    void log(const byte t_eventType, const byte t_locoNum, const unsigned int t_routeElement, const byte t_item,
+             const unsigned int t_value);
+    void dump();  // Send the whole journal, oldest first, to the Serial monitor as a readable timeline.
+    unsigned long recordsWritten();  // Total since last reset(); only the most recent JOURNAL_RECS are kept.
+
+  private:
+
+    void writeHeader();
+    unsigned long recordAddress(const unsigned long t_recNum);  // t_recNum is 0..(recordsWritten - 1); wraps around the ring.
+
+    static const unsigned int JOURNAL_SIGNATURE = 0x4A4C;  // "JL" says the header holds a valid count.
+
+    // The header is at FRAM_ADDR_MAS_LOG_FILE, followed by the ring of records.
+    struct journalHeaderStruct {
+      unsigned int signature;        // JOURNAL_SIGNATURE
+      unsigned long recordsWritten;  // Next record goes in slot (recordsWritten % JOURNAL_RECS)
+    };
+    journalHeaderStruct m_header;
+
+    // JOURNAL RECORD.  12 bytes.
+    struct journalRecordStruct {
+      unsigned long timestamp;    // millis() when logged
+      byte module;                // THIS_MODULE i.e. ARDUINO_MAS
+      byte eventType;             // JOURNAL_EVENT_xxx
+      byte locoNum;               // 1..TOTAL_TRAINS, or 0 if n/a
+      byte item;                  // Event-specific i.e. sensor, block, or turnout number
+      unsigned int routeElement;  // Event-specific i.e. Route Ref rec num
+      unsigned int value;         // Event-specific i.e. direction or Legacy parm
+    };
+    journalRecordStruct m_record;
+
+    static const unsigned int JOURNAL_RECS = (FRAM_BYTES_MAS_LOG_FILE - sizeof(journalHeaderStruct)) / sizeof(journalRecordStruct);
+
+    FRAM* m_pStorage;
+
+};
+
+#endif
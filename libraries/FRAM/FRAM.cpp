@@ -1,4 +1,6 @@
-// FRAM.CPP Rev: 11/12/22 
+// FRAM.CPP Rev: 10/19/26
+// 10/19/26: Added optional write-back cache: enableWriteCache(), serviceWriteCache(), flush(), displayCacheStats().
+// 10/19/26: Added readStream(), writeStream(), setSPIClock(), and testFRAMSpeed().
 // 11/12/20: begin() no longer needs to pass Display_2004* t_pLCD2004 as a parm, so long as we #include <Train_Functions.h>
 //           The original begin was: void FRAM::begin(Display_2004* t_pLCD2004) {
 //                                   pLCD2004 = t_pLCD2004;
@@ -10,12 +12,19 @@
 
 #include "FRAM.h"
 
+// So pFlushBeforeHalt (a plain function pointer, see Train_Functions.h) can reach the FRAM object that has the cache.
+static FRAM* pCachedFRAM = nullptr;
+static void flushCachedFRAM() {
+  pCachedFRAM->flush();
+}
+
 FRAM::FRAM(ferroPartNumber t_partNum, byte t_pin):Hackscribble_Ferro (t_partNum, t_pin) {  // Constructor.
   // MB85RS4MT is new 2022 Adafruit 512KB break-out part number
   // MB85RS2MT was our previous 256KB home-built FRAM part number
   // Hackscribble_Ferro library uses standard Arduino SPI pin definitions:  MOSI, MISO, SCK.
   // Above contructor creates an instance of Ferro using the standard Arduino SS pin and FRAM part number.
   // You specify a FRAM part number and SS pin number.  Specify the chip as MB85RS4MT (previously MB85RS2MT, previously MB85RS64.)
+  m_pCacheLine = nullptr;  // Write-back cache is off unless enableWriteCache() is called
   return;
 }
 
@@ -44,11 +53,71 @@ void FRAM::begin() {  // Initialize the Hackscribble FRAM.  Must be called in se
 }
 
 ferroResult FRAM::read(unsigned long t_startAddress, byte t_numberOfBytes, byte* t_buffer) {
-  return Hackscribble_Ferro::readFerro(t_startAddress, t_numberOfBytes, t_buffer);
+  if (m_pCacheLine == nullptr) {
+    return Hackscribble_Ferro::readFerro(t_startAddress, t_numberOfBytes, t_buffer);
+  }
+  // If every byte requested is in cache lines, we don't need to touch the FRAM at all.
+  ferroResult result = Hackscribble_Ferro::_checkRange(t_startAddress, t_numberOfBytes);
+  if (result != ferroOK) {
+    return result;
+  }
+  unsigned long firstLine = t_startAddress & ~((unsigned long)(FRAM_CACHE_LINE_BYTES - 1));
+  unsigned long lastLine = (t_startAddress + t_numberOfBytes - 1) & ~((unsigned long)(FRAM_CACHE_LINE_BYTES - 1));
+  if ((findCacheLine(firstLine) != nullptr) && (findCacheLine(lastLine) != nullptr) &&
+      ((lastLine - firstLine) <= FRAM_CACHE_LINE_BYTES)) {
+    m_cacheReadHits++;
+  } else {
+    result = Hackscribble_Ferro::readFerro(t_startAddress, t_numberOfBytes, t_buffer);
+  }
+  copyFromCache(t_startAddress, t_numberOfBytes, t_buffer);  // Cached bytes may be newer than FRAM
+  return result;
 }
 
 ferroResult FRAM::write(unsigned long t_startAddress, byte t_numberOfBytes, byte* t_buffer) {
-  return Hackscribble_Ferro::writeFerro(t_startAddress, t_numberOfBytes, t_buffer);
+  if (m_pCacheLine == nullptr) {
+    return Hackscribble_Ferro::writeFerro(t_startAddress, t_numberOfBytes, t_buffer);
+  }
+  ferroResult result = Hackscribble_Ferro::_checkRange(t_startAddress, t_numberOfBytes);
+  if (result != ferroOK) {
+    return result;
+  }
+  m_cacheWritesRequested++;
+  m_cacheBytesRequested = m_cacheBytesRequested + t_numberOfBytes;
+  if (t_numberOfBytes > FRAM_CACHE_LINE_BYTES) {  // Too big to be worth caching; write through
+    m_cacheWritesToFRAM++;
+    m_cacheBytesWritten = m_cacheBytesWritten + t_numberOfBytes;
+    copyToCache(t_startAddress, t_numberOfBytes, t_buffer);  // Keep any cached copy current (it stays dirty, which is harmless)
+    return Hackscribble_Ferro::writeFerro(t_startAddress, t_numberOfBytes, t_buffer);
+  }
+  // A record of up to FRAM_CACHE_LINE_BYTES spans at most two lines.  Make sure both are loaded, then update them.
+  unsigned long firstLine = t_startAddress & ~((unsigned long)(FRAM_CACHE_LINE_BYTES - 1));
+  unsigned long lastLine = (t_startAddress + t_numberOfBytes - 1) & ~((unsigned long)(FRAM_CACHE_LINE_BYTES - 1));
+  cacheLineStruct* pFirstLine = loadCacheLine(firstLine, nullptr);
+  if (lastLine != firstLine) {
+    loadCacheLine(lastLine, pFirstLine);  // Don't re-use the line we just loaded
+  }
+  copyToCache(t_startAddress, t_numberOfBytes, t_buffer);
+  return ferroOK;
+}
+
+ferroResult FRAM::readStream(unsigned long t_startAddress, unsigned int t_numberOfBytes, byte* t_buffer) {
+  ferroResult result = Hackscribble_Ferro::readFerroStream(t_startAddress, t_numberOfBytes, t_buffer);
+  if ((result == ferroOK) && (m_pCacheLine != nullptr)) {
+    copyFromCache(t_startAddress, t_numberOfBytes, t_buffer);
+  }
+  return result;
+}
+
+ferroResult FRAM::writeStream(unsigned long t_startAddress, unsigned int t_numberOfBytes, byte* t_buffer) {
+  ferroResult result = Hackscribble_Ferro::writeFerroStream(t_startAddress, t_numberOfBytes, t_buffer);
+  if ((result == ferroOK) && (m_pCacheLine != nullptr)) {
+    copyToCache(t_startAddress, t_numberOfBytes, t_buffer);
+  }
+  return result;
+}
+
+void FRAM::setSPIClock(byte t_clockDivider) {
+  Hackscribble_Ferro::setSPIClockDivider(t_clockDivider);
 }
 
 unsigned long FRAM::bottomAddress() {
@@ -203,3 +272,249 @@ void FRAM::testQuadRAM(unsigned long t_numBytesToTest) {
   //delete pTestArray2;
   return;
 }
+
+void FRAM::testFRAMSpeed(unsigned int t_bufferSize) {
+  // Rev: 10/19/26.
+  // Route_Reference::getFirstMatchingOrigin() notes say FRAM reads 8192 bytes one byte at a time in 206ms, and 64 bytes at a time
+  // in 24ms.  Repeat that, then try 255-byte read() calls and t_bufferSize-byte readStream() calls, at SPI clock DIV2, DIV4, and
+  // DIV8.  Writes re-write the bytes just read back to the same addresses, so the FRAM contents are unchanged.
+  // t_bufferSize is allocated on the heap (QuadRAM if present), so 1024 is fine without QuadRAM and 8192 is fine with it.
+  if (t_bufferSize < 255) {
+    t_bufferSize = 255;
+  }
+  byte* pBuffer = new byte[t_bufferSize];
+  byte oldClock = Hackscribble_Ferro::getSPIClockDivider();
+  const byte clockDividers[3] = { SPI_CLOCK_DIV2, SPI_CLOCK_DIV4, SPI_CLOCK_DIV8 };
+  const byte clockMHz[3] = { 8, 4, 2 };
+  Serial.print(F("FRAM speed test: ")); Serial.print(FRAM_SPEED_TEST_BYTES); Serial.println(F(" bytes, times in us."));
+  Serial.println(F("MHz  rd1    rd64   rd255  rdStrm wr64   wrStrm"));
+  for (byte c = 0; c < 3; c++) {
+    Hackscribble_Ferro::setSPIClockDivider(clockDividers[c]);
+    sprintf(lcdString, "%-4i", clockMHz[c]); Serial.print(lcdString);
+    sprintf(lcdString, " %-6lu", timeFRAMRead(1, pBuffer)); Serial.print(lcdString);
+    sprintf(lcdString, " %-6lu", timeFRAMRead(64, pBuffer)); Serial.print(lcdString);
+    sprintf(lcdString, " %-6lu", timeFRAMRead(255, pBuffer)); Serial.print(lcdString);
+    sprintf(lcdString, " %-6lu", timeFRAMRead(t_bufferSize, pBuffer)); Serial.print(lcdString);
+    sprintf(lcdString, " %-6lu", timeFRAMWrite(64, pBuffer)); Serial.print(lcdString);
+    sprintf(lcdString, " %-6lu", timeFRAMWrite(t_bufferSize, pBuffer)); Serial.println(lcdString);
+  }
+  Hackscribble_Ferro::setSPIClockDivider(oldClock);
+  sprintf(lcdString, "Stream buf %u", t_bufferSize); Serial.println(lcdString);
+  delete[] pBuffer;
+  return;
+}
+
+unsigned long FRAM::timeFRAMRead(unsigned int t_chunkSize, byte* t_buffer) {
+  // Rev: 10/19/26.
+  // Read FRAM_SPEED_TEST_BYTES starting at FRAM address 0, t_chunkSize bytes per call.  Uses read() for chunks up to 255 bytes (so
+  // we measure what existing callers get) and readStream() for anything larger.
+  unsigned long startTime = micros();
+  for (unsigned long address = 0; address < FRAM_SPEED_TEST_BYTES; address += t_chunkSize) {
+    unsigned int numBytes = t_chunkSize;
+    if ((address + numBytes) > FRAM_SPEED_TEST_BYTES) {
+      numBytes = FRAM_SPEED_TEST_BYTES - address;
+    }
+    if (numBytes <= 255) {
+      FRAM::read(address, numBytes, t_buffer);
+    } else {
+      FRAM::readStream(address, numBytes, t_buffer);
+    }
+  }
+  return micros() - startTime;
+}
+
+unsigned long FRAM::timeFRAMWrite(unsigned int t_chunkSize, byte* t_buffer) {
+  // Rev: 10/19/26.
+  // Same as timeFRAMRead() but each chunk is read (not timed) and then written back to the same address (timed.)
+  unsigned long totalTime = 0;
+  for (unsigned long address = 0; address < FRAM_SPEED_TEST_BYTES; address += t_chunkSize) {
+    unsigned int numBytes = t_chunkSize;
+    if ((address + numBytes) > FRAM_SPEED_TEST_BYTES) {
+      numBytes = FRAM_SPEED_TEST_BYTES - address;
+    }
+    FRAM::readStream(address, numBytes, t_buffer);
+    unsigned long startTime = micros();
+    if (numBytes <= 255) {
+      FRAM::write(address, numBytes, t_buffer);
+    } else {
+      FRAM::writeStream(address, numBytes, t_buffer);
+    }
+    totalTime = totalTime + (micros() - startTime);
+  }
+  return totalTime;
+}
+
+void FRAM::enableWriteCache(unsigned long t_flushIntervalMs) {
+  // Rev: 10/19/26.
+  // Call once in setup() after begin().  t_flushIntervalMs is the longest that a changed byte will sit in the cache, provided the
+  // module calls serviceWriteCache() regularly.
+  if (m_pCacheLine == nullptr) {
+    m_pCacheLine = new cacheLineStruct[FRAM_CACHE_LINES];
+  }
+  for (byte i = 0; i < FRAM_CACHE_LINES; i++) {
+    m_pCacheLine[i].valid = false;
+  }
+  m_cacheFlushIntervalMs = t_flushIntervalMs;
+  m_cacheLastFlushTime = millis();
+  m_cacheBytesRequested = 0;
+  m_cacheBytesWritten = 0;
+  m_cacheWritesRequested = 0;
+  m_cacheWritesToFRAM = 0;
+  m_cacheReadHits = 0;
+  pCachedFRAM = this;
+  pFlushBeforeHalt = flushCachedFRAM;
+  return;
+}
+
+void FRAM::serviceWriteCache() {
+  // Rev: 10/19/26.
+  if ((m_pCacheLine != nullptr) && ((millis() - m_cacheLastFlushTime) >= m_cacheFlushIntervalMs)) {
+    flush();
+  }
+  return;
+}
+
+void FRAM::flush() {
+  // Rev: 10/19/26.
+  if (m_pCacheLine == nullptr) {
+    return;
+  }
+  for (byte i = 0; i < FRAM_CACHE_LINES; i++) {
+    flushCacheLine(&m_pCacheLine[i]);
+  }
+  m_cacheLastFlushTime = millis();
+  return;
+}
+
+void FRAM::displayCacheStats() {
+  // Rev: 10/19/26.
+  if (m_pCacheLine == nullptr) {
+    Serial.println(F("FRAM write cache not enabled."));
+    return;
+  }
+  Serial.print(F("FRAM writes requested: ")); Serial.print(m_cacheWritesRequested);
+  Serial.print(F(" (")); Serial.print(m_cacheBytesRequested); Serial.println(F(" bytes)"));
+  Serial.print(F("FRAM writes performed: ")); Serial.print(m_cacheWritesToFRAM);
+  Serial.print(F(" (")); Serial.print(m_cacheBytesWritten); Serial.println(F(" bytes)"));
+  Serial.print(F("FRAM reads from cache: ")); Serial.println(m_cacheReadHits);
+  return;
+}
+
+FRAM::cacheLineStruct* FRAM::findCacheLine(unsigned long t_lineAddress) {
+  // Rev: 10/19/26.
+  for (byte i = 0; i < FRAM_CACHE_LINES; i++) {
+    if ((m_pCacheLine[i].valid) && (m_pCacheLine[i].address == t_lineAddress)) {
+      m_pCacheLine[i].lastUsed = millis();
+      return &m_pCacheLine[i];
+    }
+  }
+  return nullptr;
+}
+
+FRAM::cacheLineStruct* FRAM::loadCacheLine(unsigned long t_lineAddress, cacheLineStruct* t_pKeepLine) {
+  // Rev: 10/19/26.
+  // Return the line holding t_lineAddress, loading it from FRAM if necessary.  When we need a line, use an empty one if there is
+  // one, else the least-recently-used clean one, else the least-recently-used dirty one (which we must flush first.)
+  // t_pKeepLine, if not nullptr, will not be re-used.
+  cacheLineStruct* pLine = findCacheLine(t_lineAddress);
+  if (pLine != nullptr) {
+    return pLine;
+  }
+  for (byte i = 0; i < FRAM_CACHE_LINES; i++) {
+    cacheLineStruct* pCandidate = &m_pCacheLine[i];
+    if (pCandidate == t_pKeepLine) {
+      continue;
+    }
+    if (pCandidate->valid == false) {
+      pLine = pCandidate;
+      break;
+    }
+    if (pLine == nullptr) {
+      pLine = pCandidate;
+    } else {
+      bool candidateClean = (pCandidate->dirtyFirst > pCandidate->dirtyLast);
+      bool lineClean = (pLine->dirtyFirst > pLine->dirtyLast);
+      if ((candidateClean && !lineClean) ||
+          ((candidateClean == lineClean) && ((millis() - pCandidate->lastUsed) > (millis() - pLine->lastUsed)))) {
+        pLine = pCandidate;
+      }
+    }
+  }
+  if (pLine->valid) {
+    flushCacheLine(pLine);
+  }
+  ferroResult result = Hackscribble_Ferro::readFerro(t_lineAddress, FRAM_CACHE_LINE_BYTES, pLine->data);
+  if (result != ferroOK) {
+    sprintf(lcdString, "FRAM CACHE ERR %i", result); pLCD2004->println(lcdString); Serial.println(lcdString); endWithFlashingLED(5);
+  }
+  pLine->address = t_lineAddress;
+  pLine->lastUsed = millis();
+  pLine->valid = true;
+  pLine->dirtyFirst = FRAM_CACHE_LINE_BYTES;  // Clean
+  pLine->dirtyLast = 0;
+  return pLine;
+}
+
+void FRAM::flushCacheLine(cacheLineStruct* t_pLine) {
+  // Rev: 10/19/26.
+  // Write only the changed bytes of this line to FRAM, in one transaction.
+  if ((t_pLine->valid == false) || (t_pLine->dirtyFirst > t_pLine->dirtyLast)) {
+    return;
+  }
+  byte numBytes = t_pLine->dirtyLast - t_pLine->dirtyFirst + 1;
+  Hackscribble_Ferro::writeFerro(t_pLine->address + t_pLine->dirtyFirst, numBytes, &t_pLine->data[t_pLine->dirtyFirst]);
+  m_cacheWritesToFRAM++;
+  m_cacheBytesWritten = m_cacheBytesWritten + numBytes;
+  t_pLine->dirtyFirst = FRAM_CACHE_LINE_BYTES;  // Clean
+  t_pLine->dirtyLast = 0;
+  return;
+}
+
+void FRAM::copyFromCache(unsigned long t_startAddress, unsigned int t_numberOfBytes, byte* t_buffer) {
+  // Rev: 10/19/26.
+  // Overwrite any bytes of t_buffer (which holds FRAM t_startAddress..) that are also in a cache line, since the cache is newer.
+  unsigned long endAddress = t_startAddress + t_numberOfBytes;  // One past the last byte
+  for (byte i = 0; i < FRAM_CACHE_LINES; i++) {
+    cacheLineStruct* pLine = &m_pCacheLine[i];
+    if ((pLine->valid == false) || (pLine->address >= endAddress) ||
+        ((pLine->address + FRAM_CACHE_LINE_BYTES) <= t_startAddress)) {
+      continue;
+    }
+    unsigned long address = max(t_startAddress, pLine->address);
+    unsigned long lastAddress = min(endAddress, pLine->address + FRAM_CACHE_LINE_BYTES);
+    for (; address < lastAddress; address++) {
+      t_buffer[address - t_startAddress] = pLine->data[address - pLine->address];
+    }
+  }
+  return;
+}
+
+void FRAM::copyToCache(unsigned long t_startAddress, unsigned int t_numberOfBytes, byte* t_buffer) {
+  // Rev: 10/19/26.
+  // Update any cache lines that overlap t_startAddress..; marks only bytes that actually change as dirty.  So re-writing a whole
+  // Block Reservation record to change reservedForTrain only flushes that one byte.
+  unsigned long endAddress = t_startAddress + t_numberOfBytes;  // One past the last byte
+  for (byte i = 0; i < FRAM_CACHE_LINES; i++) {
+    cacheLineStruct* pLine = &m_pCacheLine[i];
+    if ((pLine->valid == false) || (pLine->address >= endAddress) ||
+        ((pLine->address + FRAM_CACHE_LINE_BYTES) <= t_startAddress)) {
+      continue;
+    }
+    unsigned long address = max(t_startAddress, pLine->address);
+    unsigned long lastAddress = min(endAddress, pLine->address + FRAM_CACHE_LINE_BYTES);
+    for (; address < lastAddress; address++) {
+      byte offset = address - pLine->address;
+      byte newValue = t_buffer[address - t_startAddress];
+      if (pLine->data[offset] != newValue) {
+        pLine->data[offset] = newValue;
+        if (offset < pLine->dirtyFirst) {
+          pLine->dirtyFirst = offset;
+        }
+        if (offset > pLine->dirtyLast) {
+          pLine->dirtyLast = offset;
+        }
+      }
+    }
+  }
+  return;
+}
@@ -1,4 +1,7 @@
-// FRAM.H Rev: 11/12/22.
+// FRAM.H Rev: 10/19/26.
+// 10/19/26: Added optional write-back cache for small, frequently re-written records (Block/Turnout Res'n, Sensor Block.)
+// 10/19/26: Added readStream()/writeStream() for transfers longer than 255 bytes in a single SPI transaction, setSPIClock(), and
+//           testFRAMSpeed() benchmark (non-destructive) that repeats the Route_Reference "8192 bytes in 24ms" measurement.
 // 11/12/20: begin() no longer needs to pass Display_2004* t_pLCD2004 as a parm, so long as we #include <Train_Functions.h>
 //           The original begin was: void FRAM::begin(Display_2004* t_pLCD2004)
 // 06/30/22: Added chip select pin to FRAM and Hackscribble_Ferro classes, so we can one again use more than one (for copy util.)
@@ -10,6 +13,8 @@
 // FRAM is a child class of parent Hackscribble_Ferro, in order to be able to make both of them static, via a
 // single instantiation from the main program.
 // The byte buffer t_buffer can be up to 255 (not 256) bytes long (limited because t_numberOfBytes is a byte value.)
+// For longer transfers use readStream()/writeStream(), which take an unsigned int length and keep the chip selected for the whole
+// transfer.  Each read()/write() call costs a chip select plus 4 bytes (opcode and 24-bit address) before any data moves.
 
 // As of 12/09/22, ONLY MAS, LEG, and OCC need FRAMand QuadRAM.  No other modules need either one.
 // LED(green turnouts) does not need anything in FRAM or QuadRAM - it just illuminates turnout orientation by monitoring RS-485
@@ -48,6 +53,17 @@
 // QuadRAM writes 524,288 bytes in 49.606 seconds = 10.57 bytes/msec = 0.09461 msec/byte
 // QuadRAM reads  524,288 bytes in 52.839 seconds =  9.92 bytes/msec = 0.10081 msec/byte
 
+// 10/19/26: WRITE-BACK CACHE.  Block_Reservation::setBlockReservation() and friends re-write a whole record to FRAM for what is
+// usually a one-byte change, and often re-write the same record several times in a row.  If a module calls enableWriteCache(),
+// write() calls of up to FRAM_CACHE_LINE_BYTES are held in a few 32-byte "lines" in the heap, and only the bytes that actually
+// changed are written to FRAM when:
+//   * serviceWriteCache() is called and t_flushIntervalMs has passed since the last flush (call it every pass through loop),
+//   * flush() is called (i.e. on every Mode change),
+//   * a line must be re-used for a different address, or
+//   * haltIfHaltPinPulledLow() or endWithFlashingLED() are called (see pFlushBeforeHalt in Train_Functions.h.)
+// read() and readStream() always see the cached data.  Larger writes go straight to FRAM (updating any cached copy.)
+// The cache is off unless enableWriteCache() is called, so modules that don't call it behave exactly as before.
+
 #ifndef FRAM_H
 #define FRAM_H
 
@@ -57,6 +73,8 @@
 #include <SPI.h>                          // FRAM is connected via SPI interface
 #include <Hackscribble_Ferro.h>           // This is the library that manages the FRAM hardware
 
+const unsigned long FRAM_CACHE_FLUSH_MS = 1000;  // Suggested enableWriteCache() interval: longest a change waits to reach FRAM.
+
 class FRAM : private Hackscribble_Ferro {
 
   public:
@@ -65,6 +83,13 @@ class FRAM : private Hackscribble_Ferro {
     void begin();  // Initialize the Hackscribble FRAM.  Must be called in setup() before using.
     ferroResult read(unsigned long t_startAddress, byte t_numberOfBytes, byte* t_buffer);   // General FRAM read, max 255 bytes.
     ferroResult write(unsigned long t_startAddress, byte t_numberOfBytes, byte* t_buffer);  // General FRAM write, max 255 bytes.
+    ferroResult readStream(unsigned long t_startAddress, unsigned int t_numberOfBytes, byte* t_buffer);   // 1..65535 bytes.
+    ferroResult writeStream(unsigned long t_startAddress, unsigned int t_numberOfBytes, byte* t_buffer);  // 1..65535 bytes.
+    void setSPIClock(byte t_clockDivider);  // SPI_CLOCK_DIV2 (default, fastest) .. SPI_CLOCK_DIV128
+    void enableWriteCache(unsigned long t_flushIntervalMs);  // Call once in setup() if desired.  See notes above.
+    void serviceWriteCache();  // Call every time through loop(); flushes if t_flushIntervalMs has elapsed.
+    void flush();              // Write all changed cached bytes to FRAM now.
+    void displayCacheStats();
     unsigned long bottomAddress();
     unsigned long topAddress();
     void setFRAMRevDate(byte t_month, byte t_day, byte t_year);
@@ -72,11 +97,41 @@ class FRAM : private Hackscribble_Ferro {
     void testFRAM();  // Write then read random byte to every location.
     void testSRAM();  // Write then read random byte to SRAM just to compare read/write speeds to FRAM and QuadRAM
     void testQuadRAM(unsigned long t_numBytesToTest);  // Maximum about 56,647 "testable" bytes with QuadRAM
+    void testFRAMSpeed(unsigned int t_bufferSize);  // Time reading 8192 bytes various ways.  Rewrites same data; not destructive.
 
   protected:
 
   private:
 
+    static const unsigned int FRAM_SPEED_TEST_BYTES = 8192;
+
+    static const byte FRAM_CACHE_LINES      = 8;   // 8 lines * 40 bytes = 320 bytes of heap, only if enableWriteCache() is called.
+    static const byte FRAM_CACHE_LINE_BYTES = 32;  // Must be a power of 2.  Larger than any record we write often.
+    struct cacheLineStruct {
+      unsigned long address;      // FRAM address of data[0]; always a multiple of FRAM_CACHE_LINE_BYTES
+      unsigned long lastUsed;     // millis() when last read or written, to choose a line to re-use
+      bool valid;                 // data[] holds a copy of FRAM at address
+      byte dirtyFirst;            // First and last bytes of data[] that differ from FRAM; dirtyFirst > dirtyLast means clean.
+      byte dirtyLast;
+      byte data[FRAM_CACHE_LINE_BYTES];
+    };
+    cacheLineStruct* m_pCacheLine;  // nullptr unless enableWriteCache() has been called
+    unsigned long m_cacheFlushIntervalMs;
+    unsigned long m_cacheLastFlushTime;
+    unsigned long m_cacheBytesRequested;  // Bytes callers asked to write through write() while the cache was enabled
+    unsigned long m_cacheBytesWritten;    // Bytes actually written to FRAM (flushes and write-throughs)
+    unsigned long m_cacheWritesRequested; // write() calls
+    unsigned long m_cacheWritesToFRAM;    // SPI write transactions actually performed
+    unsigned long m_cacheReadHits;        // read() calls satisfied entirely from the cache
+
+    cacheLineStruct* findCacheLine(unsigned long t_lineAddress);
+    cacheLineStruct* loadCacheLine(unsigned long t_lineAddress, cacheLineStruct* t_pKeepLine);  // Find or re-use a line
+    void flushCacheLine(cacheLineStruct* t_pLine);
+    void copyFromCache(unsigned long t_startAddress, unsigned int t_numberOfBytes, byte* t_buffer);  // Overlay cached bytes
+    void copyToCache(unsigned long t_startAddress, unsigned int t_numberOfBytes, byte* t_buffer);    // Update cached copies
+    unsigned long timeFRAMRead(unsigned int t_chunkSize, byte* t_buffer);    // Returns microseconds to read FRAM_SPEED_TEST_BYTES
+    unsigned long timeFRAMWrite(unsigned int t_chunkSize, byte* t_buffer);   // Returns microseconds to re-write same
+
 };
 
 #endif
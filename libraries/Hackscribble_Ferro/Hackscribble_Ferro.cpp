@@ -1,3 +1,5 @@
+// 10/19/26: Added readFerroStream()/writeFerroStream() for transfers longer than 255 bytes, and setSPIClockDivider().
+//           _readMemory()/_writeMemory() now take an unsigned int count; readFerro()/writeFerro() are unchanged for callers.
 // 06/30/22: FRAM duplication utility will require us to use digitalWrite(_chipSelect, LOW/HIGH) to select/de-select chips.
 //           If we were only using one FRAM, we could keep it selected all the time and run about 14% faster, but in order to
 //           support "Duplicate a FRAM" util with two FRAMs, we need to select/deselect each chip as we read and write.
@@ -25,6 +27,7 @@
 #include "Hackscribble_Ferro.h"
 
 boolean Hackscribble_Ferro::_spiIsRunning = false;
+byte Hackscribble_Ferro::_spiClockDivider = HS_SPI_DEFAULT_CLOCK;
 
 Hackscribble_Ferro::Hackscribble_Ferro(ferroPartNumber partNumber, byte chipSelect) {  // Constructor
   _partNumber                             = partNumber;
@@ -70,7 +73,7 @@ void Hackscribble_Ferro::_initialiseSPI(void)
 	SPI.begin();
 	SPI.setBitOrder(MSBFIRST);
 	SPI.setDataMode (HS_SPI_DEFAULT_MODE);
-	SPI.setClockDivider(HS_SPI_DEFAULT_CLOCK);
+	SPI.setClockDivider(_spiClockDivider);
 }
 	
 void Hackscribble_Ferro::_initialiseCS()
@@ -129,7 +132,7 @@ void Hackscribble_Ferro::_writeStatusRegister(byte value)
 }
 
 
-void Hackscribble_Ferro::_readMemory(unsigned long address, byte numberOfBytes, byte *buffer)
+void Hackscribble_Ferro::_readMemory(unsigned long address, unsigned int numberOfBytes, byte *buffer)
 {
 	_select();
 	SPI.transfer(_READ);
@@ -139,7 +142,7 @@ void Hackscribble_Ferro::_readMemory(unsigned long address, byte numberOfBytes,
 	}
 	SPI.transfer(address / 256);
 	SPI.transfer(address % 256);
-	for (byte i = 0; i < numberOfBytes; i++)
+	for (unsigned int i = 0; i < numberOfBytes; i++)
 	{
 		buffer[i] = SPI.transfer(_dummy);
 	}
@@ -147,7 +150,7 @@ void Hackscribble_Ferro::_readMemory(unsigned long address, byte numberOfBytes,
 }
 
 
-void Hackscribble_Ferro::_writeMemory(unsigned long address, byte numberOfBytes, byte *buffer)
+void Hackscribble_Ferro::_writeMemory(unsigned long address, unsigned int numberOfBytes, byte *buffer)
 {
 	_select();
 	SPI.transfer(_WREN);
@@ -160,7 +163,7 @@ void Hackscribble_Ferro::_writeMemory(unsigned long address, byte numberOfBytes,
 	}
 	SPI.transfer(address / 256);
 	SPI.transfer(address % 256);
-	for (byte i = 0; i < numberOfBytes; i++)
+	for (unsigned int i = 0; i < numberOfBytes; i++)
 	{
 		SPI.transfer(buffer[i]);
 	}
@@ -295,6 +298,70 @@ ferroResult Hackscribble_Ferro::writeFerro(unsigned long startAddress, byte numb
 	return ferroOK;
 }
 
+ferroResult Hackscribble_Ferro::_checkRange(unsigned long startAddress, unsigned long numberOfBytes)
+{
+	// Same validations as readFerro/writeFerro, but without the 255-byte limit.
+	if ((startAddress < _bottomAddress) || (startAddress > _topAddress))
+	{
+		return ferroBadStartAddress;
+	}
+	if (numberOfBytes == 0)
+	{
+		return ferroBadNumberOfBytes;
+	}
+	if ((startAddress + numberOfBytes - 1) > _topAddress)
+	{
+		return ferroBadFinishAddress;
+	}
+	return ferroOK;
+}
+
+ferroResult Hackscribble_Ferro::readFerroStream(unsigned long startAddress, unsigned int numberOfBytes, byte *buffer)
+{
+	// Rev: 10/19/26.
+	// Copies numberOfBytes (1..65535) bytes from FRAM into buffer in a single transaction: CS stays low and the FRAM auto-increments
+	// its address, so we only pay for select/opcode/address once rather than once per 255 bytes.  Caller owns the buffer, which
+	// on a Mega will usually be in QuadRAM heap for anything more than a few hundred bytes.
+	ferroResult result = _checkRange(startAddress, numberOfBytes);
+	if (result != ferroOK)
+	{
+		return result;
+	}
+	_readMemory(startAddress, numberOfBytes, buffer);
+	return ferroOK;
+}
+
+ferroResult Hackscribble_Ferro::writeFerroStream(unsigned long startAddress, unsigned int numberOfBytes, byte *buffer)
+{
+	// Rev: 10/19/26.
+	// Copies numberOfBytes (1..65535) bytes from buffer into FRAM in a single transaction.  FRAM has no page size or write delay,
+	// so a single WREN covers the whole transfer.
+	ferroResult result = _checkRange(startAddress, numberOfBytes);
+	if (result != ferroOK)
+	{
+		return result;
+	}
+	_writeMemory(startAddress, numberOfBytes, buffer);
+	return ferroOK;
+}
+
+void Hackscribble_Ferro::setSPIClockDivider(byte clockDivider)
+{
+	// Rev: 10/19/26.
+	// SPI_CLOCK_DIV2 is the fastest the AVR can go (8MHz on a 16MHz Mega) and is the default.  Use DIV4 or DIV8 if long leads or
+	// a second FRAM on the bus (i.e. O_FRAM_Duplicator) give read errors.  May be called before or after ferroBegin().
+	_spiClockDivider = clockDivider;
+	if (_spiIsRunning)
+	{
+		SPI.setClockDivider(_spiClockDivider);
+	}
+}
+
+byte Hackscribble_Ferro::getSPIClockDivider()
+{
+	return _spiClockDivider;
+}
+
 ferroResult Hackscribble_Ferro::format()
 {
 	// 6/21/21: Fills FRAM with 0s.
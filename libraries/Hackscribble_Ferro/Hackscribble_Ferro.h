@@ -1,3 +1,5 @@
+// 10/19/26: Added readFerroStream()/writeFerroStream() which take an unsigned int byte count and keep CS asserted for the whole
+//           transfer, and setSPIClockDivider() so a slower SPI clock can be used with long leads (i.e. two FRAMs when copying.)
 // 6/29/22: Removed hard-coded "SS" from constructor and pass whatever chipSelect value we get passed from FRAM constructor.
 // 6/27/22: Added support for MB85RS4MT 512KB (524288-bit) Adafruit FRAM breakout board.
 // 6/21/21: Eliminated MAX_BUF_SIZE from solution; made _maxBufferSize a const (255.)  Re-wrote format().
@@ -73,6 +75,17 @@ class Hackscribble_Ferro {
 		ferroResult format();
 		ferroResult readFerro(unsigned long startAddress, byte numberOfBytes, byte* buffer);
 		ferroResult writeFerro(unsigned long startAddress, byte numberOfBytes, byte* buffer);
+		// Same as readFerro/writeFerro but numberOfBytes may be 1..65535; one select, opcode and address for the whole transfer.
+		ferroResult readFerroStream(unsigned long startAddress, unsigned int numberOfBytes, byte* buffer);
+		ferroResult writeFerroStream(unsigned long startAddress, unsigned int numberOfBytes, byte* buffer);
+		void setSPIClockDivider(byte clockDivider);  // SPI_CLOCK_DIV2 (default, 8MHz on a Mega) .. SPI_CLOCK_DIV128
+		byte getSPIClockDivider();
+
+	protected:
+
+		// Validates startAddress/numberOfBytes like readFerro/writeFerro but without the 255-byte limit.  Protected so FRAM's
+		// write-back cache can validate requests it doesn't pass straight through.
+		ferroResult _checkRange(unsigned long startAddress, unsigned long numberOfBytes);
 
 	private:
 
@@ -81,6 +94,7 @@ class Hackscribble_Ferro {
 		volatile byte *_out;
 		byte _bit;
 		static boolean _spiIsRunning;
+		static byte _spiClockDivider;  // SPI is shared, so the clock applies to every Hackscribble_Ferro object
 		// FRAM opcodes
 		static const byte _WREN = 0x06;
 		static const byte _WRDI = 0x04;
@@ -104,8 +118,8 @@ class Hackscribble_Ferro {
 		unsigned long _topAddress;
 		byte _readStatusRegister(void);
 		void _writeStatusRegister(byte value);
-		void _readMemory(unsigned long address, byte numberOfBytes, byte *buffer);
-		void _writeMemory(unsigned long address, byte numberOfBytes, byte *buffer);
+		void _readMemory(unsigned long address, unsigned int numberOfBytes, byte *buffer);
+		void _writeMemory(unsigned long address, unsigned int numberOfBytes, byte *buffer);
 		void _initialiseSPI(void);
 		void _initialiseCS(void);
 		void _select();
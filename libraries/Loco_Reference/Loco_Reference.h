@@ -1,10 +1,11 @@
-// LOCO_REFERENCE.H Rev: 02/17/24.
+// LOCO_REFERENCE.H Rev: 10/19/26.
 // A set of functions to retrieve data from the Locomotive Reference table, which is stored in FRAM.
 // Needed only by MAS, OCC and LEG.
 
 // IMPORTANT: As of 1/27/23, our populate() data is not correct, but the Excel spreadsheet reflects known values, so when we're
 // done testing and ready to use, manually enter the legit data in the Loco_Reference::populate() function of Loco_Reference.cpp.
 
+// 10/19/26: Table size is checked against FRAM_BYTES_LOCO_REF at compile time.
 // 02/17/24: Removed Last-Known Block and Total Run Time fields as unnecessary (6 bytes total.)
 // 03/16/23: Wrote getLocoInBlock() that GIVEN A BLOCK NUM returns the LOCO NUM, if any, with a matching Last-Known Block Num;
 //           else returns 0.  Called by OCC during Registration to use as the default locoNum when prompting what loco is
@@ -155,6 +156,8 @@ class Loco_Reference {
       unsigned int  highMmToCrawl;
     };
     locoReferenceStruct m_locoReference;
+    static_assert(TOTAL_TRAINS * sizeof(locoReferenceStruct) <= FRAM_BYTES_LOCO_REF,
+                  "Loco Reference table overruns FRAM_BYTES_LOCO_REF.");
 
     FRAM* m_pStorage;           // Pointer to the FRAM memory module
 
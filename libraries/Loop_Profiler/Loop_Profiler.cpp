@@ -0,0 +1,108 @@
+// LOOP_PROFILER.CPP Rev: 10/19/26.
+// Per-stage main loop timing histograms.  See Loop_Profiler.h.
+
+#include <Loop_Profiler.h>
+
+// Column headings for display(); indexed by LOOP_STAGE_xxx
+static const char LOOP_STAGE_NAME[LOOP_STAGES][16] PROGMEM =
+  { "Whole pass", "Message intake", "Train Progress", "Delayed Action", "Engineer send", "LED painting", "LCD/Serial out",
+    "Dispatcher" };
+
+Loop_Profiler::Loop_Profiler() {  // Constructor
+  // Rev: 10/19/26.
+  m_pStage = nullptr;
+  return;
+}
+
+void Loop_Profiler::begin() {
+  // Rev: 10/19/26.
+  m_pStage = (loopStageStruct*)arenaAllocate(F("Loop Profiler"), sizeof(loopStageStruct) * LOOP_STAGES, ARENA_QUADRAM);
+  Loop_Profiler::reset();
+  return;
+}
+
+void Loop_Profiler::reset() {
+  // Rev: 10/19/26.
+  for (byte stage = 0; stage < LOOP_STAGES; stage++) {
+    memset(&m_pStage[stage], 0, sizeof(loopStageStruct));
+    m_pStage[stage].minMicros = 0xFFFFFFFF;
+  }
+  return;
+}
+
+void Loop_Profiler::record(const byte t_stage, const unsigned long t_micros) {
+  // Rev: 10/19/26.
+  if (t_stage >= LOOP_STAGES) {
+    sprintf(lcdString, "BAD LOOP STAGE %i", t_stage); pLCD2004->println(lcdString); Serial.println(lcdString); endWithFlashingLED(1);
+  }
+  loopStageStruct* pStage = &m_pStage[t_stage];
+  pStage->count++;
+  if (t_micros < pStage->minMicros) {
+    pStage->minMicros = t_micros;
+  }
+  if (t_micros > pStage->maxMicros) {
+    pStage->maxMicros = t_micros;
+  }
+  pStage->totalMicros += t_micros;
+  if (pStage->totalMicros >= 1000000UL) {
+    pStage->totalSeconds += pStage->totalMicros / 1000000UL;
+    pStage->totalMicros = pStage->totalMicros % 1000000UL;
+  }
+  // Bucket number is the number of significant bits in t_micros.
+  byte bucket = 0;
+  unsigned long remaining = t_micros;
+  while ((remaining != 0) && (bucket < (LOOP_PROFILE_BUCKETS - 1))) {
+    remaining = remaining >> 1;
+    bucket++;
+  }
+  pStage->bucket[bucket]++;
+  return;
+}
+
+void Loop_Profiler::display() {
+  // Rev: 10/19/26.
+  // p99 is the top of the bucket that holds the 99th percentile (or max, if that's lower), so it's within a factor of two.
+  char stageName[16];
+  char line[81];
+  Serial.println(F("Loop stage (microseconds)    count        min        avg        max       p99"));
+  for (byte stage = 0; stage < LOOP_STAGES; stage++) {
+    loopStageStruct* pStage = &m_pStage[stage];
+    if (pStage->count == 0) {
+      continue;
+    }
+    unsigned long avgMicros = (unsigned long)((((double)pStage->totalSeconds * 1000000.0) + pStage->totalMicros) / pStage->count);
+    unsigned long p99Rank = pStage->count - (pStage->count / 100);  // Samples at or below the 99th percentile
+    unsigned long cumulative = 0;
+    byte bucket = 0;
+    while (bucket < (LOOP_PROFILE_BUCKETS - 1)) {
+      cumulative = cumulative + pStage->bucket[bucket];
+      if (cumulative >= p99Rank) {
+        break;
+      }
+      bucket++;
+    }
+    unsigned long p99Micros = pStage->maxMicros;
+    if ((bucket < (LOOP_PROFILE_BUCKETS - 1)) && (((1UL << bucket) - 1) < p99Micros)) {
+      p99Micros = (1UL << bucket) - 1;
+    }
+    strcpy_P(stageName, LOOP_STAGE_NAME[stage]);
+    sprintf(line, "%-15s %15lu %10lu %10lu %10lu %9lu", stageName, pStage->count, pStage->minMicros, avgMicros,
+            pStage->maxMicros, p99Micros);
+    Serial.println(line);
+    // Histogram; only the buckets that were used.  "<64:12" means 12 samples took 32..63 microseconds.
+    Serial.print(F("  "));
+    for (bucket = 0; bucket < LOOP_PROFILE_BUCKETS; bucket++) {
+      if (pStage->bucket[bucket] == 0) {
+        continue;
+      }
+      if (bucket == (LOOP_PROFILE_BUCKETS - 1)) {
+        Serial.print(F(">=")); Serial.print(1UL << (bucket - 1));
+      } else {
+        Serial.print(F("<")); Serial.print(1UL << bucket);
+      }
+      Serial.print(F(":")); Serial.print(pStage->bucket[bucket]); Serial.print(F(" "));
+    }
+    Serial.println();
+  }
+  return;
+}
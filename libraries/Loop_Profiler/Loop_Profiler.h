@@ -0,0 +1,81 @@
+// LOOP_PROFILER.H Rev: 10/19/26.
+// Times the main stages of a module's Auto/Park loop, so we can see which one is making us late for a stop sensor.
+// Each stage gets a count, min, average, max, and a histogram with one bucket per power of two microseconds, from which
+// display() estimates the 99th percentile.  Stages may nest (i.e. Train Progress work that populates Delayed Action), so they
+// don't add up to LOOP_STAGE_PASS.
+// A timing costs two micros() calls and a few dozen instructions.  Nothing is sent to Serial while timing; call display() after
+// Auto/Park mode has stopped.
+// Usage: put a Loop_Timer at the top of any { } block to charge everything in that block to one stage:
+//   { Loop_Timer timer(pProfiler, LOOP_STAGE_MESSAGES); msgType = pMessage->available(); }
+
+#ifndef LOOP_PROFILER_H
+#define LOOP_PROFILER_H
+
+#include <Train_Consts_Global.h>
+#include <Train_Functions.h>
+
+const byte LOOP_STAGE_PASS           = 0;  // One whole pass through the Auto/Park loop
+const byte LOOP_STAGE_MESSAGES       = 1;  // RS485 intake: pMessage->available()
+const byte LOOP_STAGE_TRAIN_PROGRESS = 2;  // Adding Routes to, and following sensor trips through, Train Progress
+const byte LOOP_STAGE_DELAYED_ACTION = 3;  // Populating Delayed Action, and Engineer retrieving ripe records from it
+const byte LOOP_STAGE_ENGINEER_SEND  = 4;  // Engineer sending from the Legacy Command Buffer
+const byte LOOP_STAGE_LEDS           = 5;  // Painting control panel LEDs
+const byte LOOP_STAGE_DISPLAY        = 6;  // LCD and Serial output
+const byte LOOP_STAGE_DISPATCH       = 7;  // MAS Dispatcher looking for and assigning Routes
+const byte LOOP_STAGES               = 8;
+
+class Loop_Profiler {
+
+  public:
+
+    Loop_Profiler();  // Constructor must be called above setup() so the object will be global to the module.
+    void begin();     // Allocates the stage table from the QuadRAM arena.
+    void reset();     // Call when Auto/Park mode starts.
+    void record(const byte t_stage, const unsigned long t_micros);
+    void display();   // Send count, min, avg, max, p99 and histogram of every stage used to the Serial monitor.
+
+  private:
+
+    // Bucket b counts times of [2^(b-1), 2^b) microseconds; bucket 0 is zero microseconds and the last bucket holds everything
+    // from 262,144 (2^18) up.
+    static const byte LOOP_PROFILE_BUCKETS = 20;
+
+    struct loopStageStruct {
+      unsigned long count;
+      unsigned long minMicros;
+      unsigned long maxMicros;
+      unsigned long totalSeconds;  // Whole seconds of time spent in this stage...
+      unsigned long totalMicros;   // ...plus this many microseconds; kept < 1,000,000 so we never overflow in a long session.
+      unsigned long bucket[LOOP_PROFILE_BUCKETS];
+    };
+    loopStageStruct* m_pStage;  // LOOP_STAGES records; 100 bytes each.
+
+};
+
+class Loop_Timer {
+
+  // Records the time from construction to the end of the enclosing { } block against t_stage.  Does nothing if t_pProfiler is
+  // nullptr, so classes can time themselves only when the module has given them a profiler.
+
+  public:
+
+    Loop_Timer(Loop_Profiler* t_pProfiler, const byte t_stage) {
+      m_pProfiler = t_pProfiler;
+      m_stage = t_stage;
+      m_startMicros = micros();
+    }
+    ~Loop_Timer() {
+      if (m_pProfiler != nullptr) {
+        m_pProfiler->record(m_stage, micros() - m_startMicros);
+      }
+    }
+
+  private:
+
+    Loop_Profiler* m_pProfiler;
+    byte m_stage;
+    unsigned long m_startMicros;
+
+};
+
+#endif
@@ -1,4 +1,8 @@
-// MESSAGE.CPP Rev: 06/21/24.  COMPLETE AND READY FOR TESTING *****************************************************************************************************************
+// MESSAGE.CPP Rev: 10/19/26.  COMPLETE AND READY FOR TESTING *****************************************************************************************************************
+
+// 10/19/26: Added bus statistics and the 'H'ealth request/reply messages; see Message.h.
+// 10/19/26: Added optional polled bus arbitration; see Message.h and RS485_POLLED_BUS in Train_Consts_Global.h.  Poll type is
+//   'G'o-ahead since 'P' is Play audio, and MAS no longer blocks waiting for the poll reply.
 
 // 06/21/24: Re-worked forThisModule() which messages which modules want to know about.
 // 03/04/24: Added code to filter out Mode message STATE_STOPPING for OCC as no OCC mode cares about STOPPING.
@@ -75,6 +79,17 @@ void Message::begin(HardwareSerial * t_mySerial, long unsigned int t_myBaud) {
   pinMode(PIN_OUT_RS485_TX_LED, OUTPUT);
   digitalWrite(PIN_OUT_RS485_RX_LED, LOW);       // Turn off the receive LED
   pinMode(PIN_OUT_RS485_RX_LED, OUTPUT);
+  for (byte i = 0; i < RS485_POLL_NUM_MODULES; i++) {
+    m_pollLastTimeByModule[i] = 0;
+  }
+  for (byte i = 0; i < RS485_MESSAGE_TYPES; i++) {
+    m_typeSent[i] = 0;
+    m_typeReceived[i] = 0;
+    m_typeRejected[i] = 0;
+  }
+  for (byte i = 0; i < RS485_GRANT_BUCKETS; i++) {
+    m_grantBucket[i] = 0;
+  }
   if (pLCD2004) {
     sprintf(lcdString, "RS485 init ok!"); pLCD2004->println(lcdString);
   }
@@ -113,16 +128,47 @@ char Message::available() {
   // won't occur as of 10/14/20.  The only messages that use the same type are 'S'ensor and 'B'utton messages to/from MAS.
 
   while (getMessageRS485(m_RS485Buf) == true) {  // As long as we find a new incoming RS485 message, get it and check it.
+    // POLLED BUS: Whatever the module MAS polled sends next -- its "nothing to send" reply, or the Button/Sensor message it was
+    // holding -- is its answer to the poll, and frees the bus for the next poll.
+    if ((RS485_POLLED_BUS) && (THIS_MODULE == ARDUINO_MAS) && (m_pollOutstanding) &&
+        (m_RS485Buf[RS485_FROM_OFFSET] == m_pollOutstandingModule)) {
+      pollReplyReceived();
+    }
+    // POLLED BUS: If MAS is polling us and we got here, we don't have anything to send (if we did, we'd be waiting for the poll
+    // inside of sendBTNtoMASButton() or sendSNStoALLSensorStatus()) so tell MAS so it can move on to the next module.
+    // MAS just discards the reply; there's nothing else in it.
+    if ((RS485_POLLED_BUS) && (m_RS485Buf[RS485_TYPE_OFFSET] == 'G')) {
+      if ((THIS_MODULE != ARDUINO_MAS) && (m_RS485Buf[RS485_TO_OFFSET] == THIS_MODULE)) {
+        sendModuletoMASPollReply();
+      }
+      continue;
+    }
+    // BUS HEALTH: MAS asking this module for its statistics is handled here, transparently to the calling module.  MAS only sees
+    // a Health reply inside of getModuletoMASHealth(); one that shows up here is late, so discard it.
+    if (m_RS485Buf[RS485_TYPE_OFFSET] == 'H') {
+      if ((THIS_MODULE != ARDUINO_MAS) && (m_RS485Buf[RS485_TO_OFFSET] == THIS_MODULE)) {
+        sendModuletoMASHealth(m_RS485Buf[RS485_MAS_ANY_HEALTH_PAGE_OFFSET]);
+      }
+      continue;
+    }
     // OK, there *is* a message.  If it's one that the caller cares about, return the type and we're done here.
     if (forThisModule(m_RS485Buf) == true) {
       return m_RS485Buf[RS485_TYPE_OFFSET];
     }
     // Well, there *is* a message but it's not something the calling module cares about, so ignore it and look for another.
+    countMessage(m_typeRejected, m_RS485Buf[RS485_TYPE_OFFSET]);
   }
   // If we drop from the above 'while' loop, it means that we have cleared the incoming RS485 buffer with no relevant messages.
   // But *if we were called from MAS* then we're not done yet!
   // See if we can find if any of the 3 digital RTS lines have been pulled low by BTN, SNS, or LEG asking to send MAS a message:
 
+  // POLLED BUS: Rather than checking the RTS lines, see if it's time to poll the next module.  The RTS lines are ignored.  The
+  // module's answer will be picked up by the above 'while' loop on a later call.
+  if ((THIS_MODULE == ARDUINO_MAS) && (RS485_POLLED_BUS)) {
+    pollNextModule();
+    return ' ';
+  }
+
   // Is BTN telling MAS that it wants to send a message, by pulling MAS's incoming RTS line low?
   if ((THIS_MODULE == ARDUINO_MAS) && (digitalRead(PIN_IN_REQ_TX_BTN) == LOW)) {
     // BTN wants to send MAS an RS485 message that a turnout button has been pressed!
@@ -393,19 +439,11 @@ void Message::sendBTNtoMASButton(const byte t_buttonNum) {
   // Always check for incoming messages BEFORE calling this function to send a button press, for two reasons:
   // 1. We need to clear out the incoming RS485 buffer in order to prepare to receive our "okay to xmit" message, and
   // 2. We need to be sure MAS isn't sending us a mode-change command that would negate us needing to send this message.
-  // First pull PIN_OUT_REQ_TX_BTN low, to tell A-MAS that we want to send it a "turnout button pressed" message...
-  digitalWrite(PIN_OUT_REQ_TX_BTN, LOW);
-  // Wait for an RS485 command from MAS requesting button status.  Remember that it's possible that we may
-  // receive some RS485 messages that are irrelevant first, so ignore all RS485 messages until we get ours.
-  m_RS485Buf[RS485_TO_OFFSET] = 0;  // Anything other than ARDUINO_BTN
-  do {
-    getMessageRS485(m_RS485Buf);
-  } while (m_RS485Buf[RS485_TO_OFFSET] != ARDUINO_BTN);
-  // Got an RS485 command addressed to BTN.  We could also check to confirm that it was from MAS, and that
-  // the command was 'B' for "send pushbutton number that was pressed", but since BTN has only ONE RS485
-  // message that it could ever receive, and it would be this command from MAS, no need to check here.
-  // Return the "I have a message for you, MAS" digital line back to HIGH state...
-  digitalWrite(PIN_OUT_REQ_TX_BTN, HIGH);  // Turn off the "I have a button press to report" digital line
+  // Pull PIN_OUT_REQ_TX_BTN low to tell A-MAS that we want to send it a "turnout button pressed" message, and wait for MAS's
+  // okay (or, if RS485_POLLED_BUS, just wait for MAS to poll us.)
+  // Remember that it's possible that we may receive some RS485 messages that are irrelevant first, so ignore all RS485 messages
+  // until we get ours.  BTN has only ONE RS485 message that it could ever receive addressed to it, so no need to check type.
+  waitForPermissionToSend();
   // Send an RS485 message to MAS indicating which turnout pushbutton was pressed.  1..32 (not 0..31)
   // 12/15/20: If MAS is not seeing this message, it could be because we are transmitting so quickly after receiving the
   // "permission to transmit button number" message from MAS, that MAS hasn't had time to transition from transmit mode into
@@ -494,19 +532,10 @@ void Message::sendSNStoALLSensorStatus(const byte t_sensorNum, char t_sensorStat
   // Always check for incoming messages BEFORE calling this function to send a button press, for two reasons:
   // 1. We need to clear out the incoming RS485 buffer in order to prepare to receive our "okay to xmit" message, and
   // 2. We need to be sure MAS isn't sending us a mode-change command that would negate us needing to send this message.
-  // First pull PIN_OUT_REQ_TX_SNS low, to tell A-MAS that we want to send it a "sensor status" message...
-  digitalWrite(PIN_OUT_REQ_TX_SNS, LOW);
-  // Wait for an RS485 command from MAS requesting sensor status.  Remember that it's possible that we may
-  // receive some RS485 messages that are irrelevant first, so ignore all RS485 messages until we get ours.
-  m_RS485Buf[RS485_TO_OFFSET] = 0;   // Discard any incoming messages other than to ARDUINO_SNS.  Should not happen!
-  // We shouldn't see anything other than to SNS, but also what we are doing here is waiting for MAS to xmit it's okay message.
-  do {
-    getMessageRS485(m_RS485Buf);
-  } while (m_RS485Buf[RS485_TO_OFFSET] != ARDUINO_SNS);
-  // Got an RS485 command addressed to SNS.  We could also check to confirm that it was from MAS, and that
-  // the command was 'S' for "send sensor status", but we won't bother since we shouldn't get anything else.
-  // Return the "I have a message for you, MAS" digital line back to HIGH state...
-  digitalWrite(PIN_OUT_REQ_TX_SNS, HIGH);  // Turn off the "I have a sensor change to report" digital line
+  // Pull PIN_OUT_REQ_TX_SNS low to tell A-MAS that we want to send it a "sensor status" message, and wait for MAS's okay (or, if
+  // RS485_POLLED_BUS, just wait for MAS to poll us.)  Remember that it's possible that we may receive some RS485 messages that
+  // are irrelevant first, so ignore all RS485 messages until we get ours.
+  waitForPermissionToSend();
   // Send an RS485 message to MAS indicating status of requested sensor
   // 12/15/20: If MAS is not seeing this message, it could be because we are transmitting so quickly after receiving the
   // "permission to transmit sensor change" message from MAS, that MAS hasn't had time to transition from transmit mode into
@@ -534,10 +563,360 @@ void Message::getSNStoALLSensorStatus(byte* t_sensorNum, char* t_sensorStatus) {
   return;
 }
 
+void Message::displayBusStats() {
+  // Rev: 10/19/26.
+  // Send THIS_MODULE's RS485 bus statistics to the Serial monitor.  Counts by message type, totals, time spent sending, and
+  // bus arbitration: MAS reports on polling; BTN and SNS report how long they had to wait for permission to transmit, which we
+  // can compare between the RTS pin scheme and the polled scheme.
+  Serial.println(F("=========== RS485 BUS STATS ==========="));
+  Serial.println(F("Type  Sent  Rcvd  Reject"));
+  for (byte i = 0; i < RS485_MESSAGE_TYPES; i++) {
+    if ((m_typeSent[i] > 0) || (m_typeReceived[i] > 0)) {
+      sprintf(lcdString, " %c  %5u %5u ", 'A' + i, m_typeSent[i], m_typeReceived[i]); Serial.print(lcdString);
+      sprintf(lcdString, " %5u", m_typeRejected[i]); Serial.println(lcdString);
+    }
+  }
+  unsigned long framesSent = totalOfCounter(m_typeSent);
+  Serial.print(F("Bad checksums:           ")); Serial.println(m_badChecksums);
+  Serial.print(F("Bytes sent:              ")); Serial.println(m_bytesSent);
+  Serial.print(F("Bytes received:          ")); Serial.println(m_bytesReceived);
+  if (framesSent > 0) {
+    Serial.print(F("Avg send time (us):      ")); Serial.println(m_sendMicrosTotal / framesSent);
+    Serial.print(F("Avg pacing delay (us):   ")); Serial.println(m_sendPaceMicrosTotal / framesSent);
+  }
+  Serial.print(F("Worst send time (us):    ")); Serial.println(m_sendMicrosWorst);
+  if (RS485_POLLED_BUS) {
+    Serial.println(F("Arbitration:             POLLED"));
+  } else {
+    Serial.println(F("Arbitration:             RTS PINS"));
+  }
+  if (THIS_MODULE == ARDUINO_MAS) {
+    Serial.print(F("Polls sent:              ")); Serial.println(m_pollsSent);
+    Serial.print(F("Poll timeouts:           ")); Serial.println(m_pollTimeouts);
+    Serial.print(F("Poll cycle config (ms):  ")); Serial.println(RS485_POLL_CYCLE_MS);
+    Serial.print(F("Worst poll cycle (ms):   ")); Serial.println(m_pollCycleWorstMs);
+    Serial.print(F("Worst poll reply (us):   ")); Serial.println(m_pollReplyWorstMicros);
+  } else if (m_grantCount > 0) {
+    Serial.print(F("Waits to xmit:           ")); Serial.println(m_grantCount);
+    Serial.print(F("Min/avg/max wait (us):   ")); Serial.print(m_grantMinMicros); Serial.print(F(" / "));
+    Serial.print(m_grantTotalMicros / m_grantCount); Serial.print(F(" / ")); Serial.println(m_grantMaxMicros);
+    Serial.print(F("Waits <1ms: ")); Serial.print(m_grantBucket[0]); Serial.print(F(" <5ms: ")); Serial.print(m_grantBucket[1]);
+    Serial.print(F(" <20ms: ")); Serial.print(m_grantBucket[2]); Serial.print(F(" <100ms: ")); Serial.print(m_grantBucket[3]);
+    Serial.print(F(" >=100ms: ")); Serial.println(m_grantBucket[4]);
+  }
+  Serial.println(F("======================================="));
+  return;
+}
+
+void Message::displayBusHealthReport() {
+  // Rev: 10/19/26.
+  // MAS only.  Display MAS's own stats, then ask every other module for its stats and display a one-line summary of each.
+  // Page 0 (all modules): frames sent, frames received, bad checksums, rejects, bytes sent+received, avg send micros.
+  // Pages 1 and 2 (BTN and SNS only): request-to-grant wait count/min/avg/max, and histogram.
+  // MAS holds the bus while collecting, so only call this when STATE_STOPPED.  A module that doesn't answer within
+  // RS485_HEALTH_REPLY_TIMEOUT_MS (i.e. isn't calling available() because it's busy, or isn't powered up) is reported as such.
+  if (THIS_MODULE != ARDUINO_MAS) {
+    return;
+  }
+  displayBusStats();
+  const byte healthModule[] = { ARDUINO_OCC, ARDUINO_LEG, ARDUINO_SNS, ARDUINO_BTN, ARDUINO_SWT, ARDUINO_LED };
+  Serial.println(F("=========== RS485 BUS HEALTH =========="));
+  Serial.println(F("Mod  Sent  Rcvd BadCRC Reject     Bytes AvgSend(us)"));
+  for (byte i = 0; i < sizeof(healthModule); i++) {
+    if (getModuletoMASHealth(healthModule[i], 0) == false) {
+      sprintf(lcdString, "%3u No reply.", healthModule[i]); Serial.println(lcdString);
+      continue;
+    }
+    sprintf(lcdString, "%3u %5u %5u ", healthModule[i], getUnsignedInt(RS485_ANY_MAS_HEALTH_DATA_OFFSET),
+            getUnsignedInt(RS485_ANY_MAS_HEALTH_DATA_OFFSET + 2));
+    Serial.print(lcdString);
+    sprintf(lcdString, " %5u  %5u ", getUnsignedInt(RS485_ANY_MAS_HEALTH_DATA_OFFSET + 4),
+            getUnsignedInt(RS485_ANY_MAS_HEALTH_DATA_OFFSET + 6));
+    Serial.print(lcdString);
+    sprintf(lcdString, "%9lu ", getUnsignedLong(RS485_ANY_MAS_HEALTH_DATA_OFFSET + 8)); Serial.print(lcdString);
+    sprintf(lcdString, "%11u", getUnsignedInt(RS485_ANY_MAS_HEALTH_DATA_OFFSET + 12)); Serial.println(lcdString);
+    if ((healthModule[i] != ARDUINO_BTN) && (healthModule[i] != ARDUINO_SNS)) {
+      continue;
+    }
+    if (getModuletoMASHealth(healthModule[i], 1) == true) {
+      Serial.print(F("    Waits: ")); Serial.print(getUnsignedInt(RS485_ANY_MAS_HEALTH_DATA_OFFSET));
+      Serial.print(F(" min/avg/max (us): ")); Serial.print(getUnsignedLong(RS485_ANY_MAS_HEALTH_DATA_OFFSET + 2));
+      Serial.print(F(" / ")); Serial.print(getUnsignedLong(RS485_ANY_MAS_HEALTH_DATA_OFFSET + 6));
+      Serial.print(F(" / ")); Serial.println(getUnsignedLong(RS485_ANY_MAS_HEALTH_DATA_OFFSET + 10));
+    }
+    if (getModuletoMASHealth(healthModule[i], 2) == true) {
+      Serial.print(F("    Waits <1ms: ")); Serial.print(getUnsignedInt(RS485_ANY_MAS_HEALTH_DATA_OFFSET));
+      Serial.print(F(" <5ms: ")); Serial.print(getUnsignedInt(RS485_ANY_MAS_HEALTH_DATA_OFFSET + 2));
+      Serial.print(F(" <20ms: ")); Serial.print(getUnsignedInt(RS485_ANY_MAS_HEALTH_DATA_OFFSET + 4));
+      Serial.print(F(" <100ms: ")); Serial.print(getUnsignedInt(RS485_ANY_MAS_HEALTH_DATA_OFFSET + 6));
+      Serial.print(F(" >=100ms: ")); Serial.println(getUnsignedInt(RS485_ANY_MAS_HEALTH_DATA_OFFSET + 8));
+    }
+  }
+  Serial.println(F("======================================="));
+  return;
+}
+
 // *****************************************************************************************
 // *************************** P R I V A T E   F U N C T I O N S ***************************
 // *****************************************************************************************
 
+// *** BUS HEALTH STATISTICS ***
+
+void Message::sendMAStoModuleHealthRequest(const byte t_module, const byte t_page) {
+  // Rev: 10/19/26.
+  // THIS PRIVATE FUNCTION IS ONLY CALLED BY getModuletoMASHealth().
+  int recLen = 6;
+  m_RS485Buf[RS485_LEN_OFFSET] = recLen;  // Length is 6 bytes: Length, From, To, 'H', page, CRC
+  m_RS485Buf[RS485_FROM_OFFSET] = ARDUINO_MAS;
+  m_RS485Buf[RS485_TO_OFFSET] = t_module;
+  m_RS485Buf[RS485_TYPE_OFFSET] = 'H';  // Health
+  m_RS485Buf[RS485_MAS_ANY_HEALTH_PAGE_OFFSET] = t_page;
+  m_RS485Buf[recLen - 1] = calcChecksumCRC8(m_RS485Buf, recLen - 1);
+  sendMessageRS485(m_RS485Buf);
+  return;
+}
+
+void Message::sendModuletoMASHealth(const byte t_page) {
+  // Rev: 10/19/26.
+  // THIS PRIVATE FUNCTION IS ONLY CALLED BY available() when MAS requests a page of our statistics.
+  // All pages are 19 bytes: Length, From, To, 'H', page, 14 bytes of data, CRC.  Unused bytes are zero.
+  // Page 0: frames sent (2), frames received (2), bad checksums (2), rejects (2), bytes sent+received (4), avg send micros (2).
+  // Page 1: request-to-grant waits (2), min micros (4), avg micros (4), max micros (4).
+  // Page 2: request-to-grant histogram buckets (5 x 2.)
+  int recLen = 19;
+  m_RS485Buf[RS485_LEN_OFFSET] = recLen;
+  m_RS485Buf[RS485_FROM_OFFSET] = THIS_MODULE;
+  m_RS485Buf[RS485_TO_OFFSET] = ARDUINO_MAS;
+  m_RS485Buf[RS485_TYPE_OFFSET] = 'H';  // Health
+  m_RS485Buf[RS485_ANY_MAS_HEALTH_PAGE_OFFSET] = t_page;
+  for (byte i = RS485_ANY_MAS_HEALTH_DATA_OFFSET; i < recLen - 1; i++) {
+    m_RS485Buf[i] = 0;
+  }
+  if (t_page == 0) {
+    unsigned long framesSent = totalOfCounter(m_typeSent);
+    putUnsignedInt(RS485_ANY_MAS_HEALTH_DATA_OFFSET, framesSent);
+    putUnsignedInt(RS485_ANY_MAS_HEALTH_DATA_OFFSET + 2, totalOfCounter(m_typeReceived));
+    putUnsignedInt(RS485_ANY_MAS_HEALTH_DATA_OFFSET + 4, m_badChecksums);
+    putUnsignedInt(RS485_ANY_MAS_HEALTH_DATA_OFFSET + 6, totalOfCounter(m_typeRejected));
+    putUnsignedLong(RS485_ANY_MAS_HEALTH_DATA_OFFSET + 8, m_bytesSent + m_bytesReceived);
+    if (framesSent > 0) {
+      putUnsignedInt(RS485_ANY_MAS_HEALTH_DATA_OFFSET + 12, m_sendMicrosTotal / framesSent);
+    }
+  } else if ((t_page == 1) && (m_grantCount > 0)) {
+    putUnsignedInt(RS485_ANY_MAS_HEALTH_DATA_OFFSET, m_grantCount);
+    putUnsignedLong(RS485_ANY_MAS_HEALTH_DATA_OFFSET + 2, m_grantMinMicros);
+    putUnsignedLong(RS485_ANY_MAS_HEALTH_DATA_OFFSET + 6, m_grantTotalMicros / m_grantCount);
+    putUnsignedLong(RS485_ANY_MAS_HEALTH_DATA_OFFSET + 10, m_grantMaxMicros);
+  } else if (t_page == 2) {
+    for (byte i = 0; i < RS485_GRANT_BUCKETS; i++) {
+      putUnsignedInt(RS485_ANY_MAS_HEALTH_DATA_OFFSET + (i * 2), m_grantBucket[i]);
+    }
+  }
+  m_RS485Buf[recLen - 1] = calcChecksumCRC8(m_RS485Buf, recLen - 1);
+  sendMessageRS485(m_RS485Buf);
+  return;
+}
+
+bool Message::getModuletoMASHealth(const byte t_module, const byte t_page) {
+  // Rev: 10/19/26.
+  // MAS only.  Request a page of statistics from t_module and wait for the reply, which will be left in m_RS485Buf[].
+  // Returns false if t_module doesn't reply within RS485_HEALTH_REPLY_TIMEOUT_MS.  Anything else that arrives meanwhile is
+  // discarded; we're only called when STATE_STOPPED so there shouldn't be anything else.
+  sendMAStoModuleHealthRequest(t_module, t_page);
+  unsigned long requestTime = millis();
+  while ((millis() - requestTime) < RS485_HEALTH_REPLY_TIMEOUT_MS) {
+    if ((getMessageRS485(m_RS485Buf) == true) &&
+        (m_RS485Buf[RS485_TYPE_OFFSET] == 'H') &&
+        (m_RS485Buf[RS485_FROM_OFFSET] == t_module) &&
+        (m_RS485Buf[RS485_ANY_MAS_HEALTH_PAGE_OFFSET] == t_page)) {
+      return true;
+    }
+  }
+  return false;
+}
+
+void Message::countMessage(unsigned int t_counter[], const char t_type) {
+  // Rev: 10/19/26.
+  if ((t_type >= 'A') && (t_type <= 'Z')) {
+    t_counter[t_type - 'A']++;
+  }
+  return;
+}
+
+unsigned long Message::totalOfCounter(const unsigned int t_counter[]) {
+  // Rev: 10/19/26.
+  unsigned long total = 0;
+  for (byte i = 0; i < RS485_MESSAGE_TYPES; i++) {
+    total = total + t_counter[i];
+  }
+  return total;
+}
+
+void Message::putUnsignedInt(const byte t_offset, const unsigned long t_value) {
+  // Rev: 10/19/26.  Saturates at 65535 rather than wrapping, so a big number in the report is never mistaken for a small one.
+  unsigned int value = 65535;
+  if (t_value < 65535) {
+    value = t_value;
+  }
+  m_RS485Buf[t_offset]     = (value >> 8) & 0xFF;
+  m_RS485Buf[t_offset + 1] = value & 0xFF;
+  return;
+}
+
+void Message::putUnsignedLong(const byte t_offset, const unsigned long t_value) {
+  // Rev: 10/19/26.
+  m_RS485Buf[t_offset]     = (t_value >> 24) & 0xFF;
+  m_RS485Buf[t_offset + 1] = (t_value >> 16) & 0xFF;
+  m_RS485Buf[t_offset + 2] = (t_value >> 8) & 0xFF;
+  m_RS485Buf[t_offset + 3] = t_value & 0xFF;
+  return;
+}
+
+unsigned int Message::getUnsignedInt(const byte t_offset) {
+  // Rev: 10/19/26.
+  return (m_RS485Buf[t_offset] << 8) | m_RS485Buf[t_offset + 1];
+}
+
+unsigned long Message::getUnsignedLong(const byte t_offset) {
+  // Rev: 10/19/26.
+  return ((unsigned long)m_RS485Buf[t_offset] << 24) | ((unsigned long)m_RS485Buf[t_offset + 1] << 16) |
+         ((unsigned long)m_RS485Buf[t_offset + 2] << 8) | (unsigned long)m_RS485Buf[t_offset + 3];
+}
+
+// *** POLLED BUS ARBITRATION (ONLY USED IF RS485_POLLED_BUS) ***
+
+void Message::pollNextModule() {
+  // Rev: 10/19/26.
+  // MAS only.  Called by available() after it has emptied the incoming buffer.  Each module in m_pollModule[] gets its own slot
+  // of RS485_POLL_CYCLE_MS / RS485_POLL_NUM_MODULES ms, so the whole list is polled once per RS485_POLL_CYCLE_MS -- assuming MAS
+  // calls available() at least that often, which is what m_pollCycleWorstMs will tell us.
+  // We don't wait for the reply here.  Until it arrives (see available()) or RS485_POLL_REPLY_TIMEOUT_MS passes, the polled
+  // module owns the bus, so we don't poll anyone else.
+  if (m_pollOutstanding) {
+    if ((micros() - m_pollSentMicros) <= (RS485_POLL_REPLY_TIMEOUT_MS * 1000)) {
+      return;  // Still waiting for the polled module
+    }
+    m_pollTimeouts++;
+    m_pollOutstanding = false;
+  }
+  if ((millis() - m_pollLastTime) < (RS485_POLL_CYCLE_MS / RS485_POLL_NUM_MODULES)) {
+    return;  // Not time for the next slot yet
+  }
+  m_pollLastTime = millis();
+  const byte pollIndex = m_pollIndex;
+  const byte module = m_pollModule[pollIndex];
+  m_pollIndex = (m_pollIndex + 1) % RS485_POLL_NUM_MODULES;
+  if (m_pollLastTimeByModule[pollIndex] != 0) {
+    unsigned long cycleMs = m_pollLastTime - m_pollLastTimeByModule[pollIndex];
+    if (cycleMs > m_pollCycleWorstMs) {
+      m_pollCycleWorstMs = cycleMs;
+    }
+  }
+  m_pollLastTimeByModule[pollIndex] = m_pollLastTime;
+  sendMAStoModulePoll(module);
+  m_pollsSent++;
+  m_pollOutstanding = true;
+  m_pollOutstandingModule = module;
+  m_pollSentMicros = micros();
+  return;
+}
+
+void Message::pollReplyReceived() {
+  // Rev: 10/19/26.
+  // MAS only.  Called by available() when the module we polled has answered, with either a 'G' reply or a Button/Sensor message.
+  const unsigned long replyMicros = micros() - m_pollSentMicros;
+  if (replyMicros > m_pollReplyWorstMicros) {
+    m_pollReplyWorstMicros = replyMicros;
+  }
+  m_pollOutstanding = false;
+  return;
+}
+
+void Message::waitForPollReply() {
+  // Rev: 10/19/26.
+  // MAS only.  Called by sendMessageRS485() so that MAS never transmits on top of a polled module's reply.  We don't read the reply
+  // here (it might be a Button or Sensor message the caller needs); we just wait until all of it is sitting in the incoming serial
+  // buffer for available() to handle, or the poll times out.  Since only the polled module may transmit, the first complete
+  // message in the buffer is its reply.
+  while (m_pollOutstanding) {
+    const byte bytesAvailableInBuffer = m_mySerial->available();
+    if ((bytesAvailableInBuffer > 0) && (bytesAvailableInBuffer >= m_mySerial->peek())) {
+      return;  // Bus is free again; m_pollOutstanding stays true until available() sees the reply
+    }
+    if ((micros() - m_pollSentMicros) > (RS485_POLL_REPLY_TIMEOUT_MS * 1000)) {
+      m_pollTimeouts++;
+      m_pollOutstanding = false;
+    }
+  }
+  return;
+}
+
+void Message::sendMAStoModulePoll(const byte t_module) {
+  // Rev: 10/19/26.
+  // THIS PRIVATE FUNCTION IS ONLY CALLED BY pollNextModule().  "You may transmit one message now."
+  int recLen = 5;
+  m_RS485Buf[RS485_LEN_OFFSET] = recLen;  // Length is 5 bytes: Length, From, To, 'G', CRC
+  m_RS485Buf[RS485_FROM_OFFSET] = ARDUINO_MAS;
+  m_RS485Buf[RS485_TO_OFFSET] = t_module;
+  m_RS485Buf[RS485_TYPE_OFFSET] = 'G';  // Go-ahead poll
+  m_RS485Buf[recLen - 1] = calcChecksumCRC8(m_RS485Buf, recLen - 1);
+  sendMessageRS485(m_RS485Buf);
+  return;
+}
+
+void Message::sendModuletoMASPollReply() {
+  // Rev: 10/19/26.
+  // THIS PRIVATE FUNCTION IS ONLY CALLED BY available() when a module is polled and has nothing to send.
+  int recLen = 5;
+  m_RS485Buf[RS485_LEN_OFFSET] = recLen;  // Length is 5 bytes: Length, From, To, 'G', CRC
+  m_RS485Buf[RS485_FROM_OFFSET] = THIS_MODULE;
+  m_RS485Buf[RS485_TO_OFFSET] = ARDUINO_MAS;
+  m_RS485Buf[RS485_TYPE_OFFSET] = 'G';  // Go-ahead reply: nothing to send
+  m_RS485Buf[recLen - 1] = calcChecksumCRC8(m_RS485Buf, recLen - 1);
+  sendMessageRS485(m_RS485Buf);
+  return;
+}
+
+void Message::waitForPermissionToSend() {
+  // Rev: 10/19/26.
+  // BTN and SNS only.  Pulled out of sendBTNtoMASButton() and sendSNStoALLSensorStatus().
+  // RTS PIN SCHEME: Pull our RTS line low, and wait for MAS's Ok-To-Send message, which is the only message ever addressed to us
+  //   while we're waiting.  Then release the RTS line.
+  // POLLED SCHEME: Just wait until MAS polls us; any other message addressed to us is ignored.  MAS only sends SNS "send status
+  //   of sensor n" requests during registration, when no sensor changes are being reported, so we won't lose one here.
+  const unsigned long waitStartMicros = micros();
+  byte requestPin = PIN_OUT_REQ_TX_BTN;
+  if (THIS_MODULE == ARDUINO_SNS) {
+    requestPin = PIN_OUT_REQ_TX_SNS;
+  }
+  if (!RS485_POLLED_BUS) {
+    digitalWrite(requestPin, LOW);  // Tell MAS we have a message for it
+  }
+  m_RS485Buf[RS485_TO_OFFSET] = 0;  // Anything other than THIS_MODULE
+  do {
+    getMessageRS485(m_RS485Buf);
+  } while ((m_RS485Buf[RS485_TO_OFFSET] != THIS_MODULE) ||
+           ((RS485_POLLED_BUS) && (m_RS485Buf[RS485_TYPE_OFFSET] != 'G')));
+  if (!RS485_POLLED_BUS) {
+    digitalWrite(requestPin, HIGH);  // Turn off the "I have a message for you, MAS" digital line
+  }
+  const unsigned long waitMicros = micros() - waitStartMicros;
+  m_grantCount++;
+  m_grantTotalMicros = m_grantTotalMicros + waitMicros;
+  if (waitMicros < m_grantMinMicros) {
+    m_grantMinMicros = waitMicros;
+  }
+  if (waitMicros > m_grantMaxMicros) {
+    m_grantMaxMicros = waitMicros;
+  }
+  byte bucket = 0;
+  while ((bucket < (RS485_GRANT_BUCKETS - 1)) && (waitMicros >= m_grantBucketLimitMicros[bucket])) {
+    bucket++;
+  }
+  m_grantBucket[bucket]++;
+  return;
+}
+
 bool Message::forThisModule(const byte t_msg[]) {  // Check if the message in the buffer is for the calling module or not.
   // Rev: 06/21/24.  Re-worked which messages which modules want to know about.
   // This function only works if it is called with a legitimate incoming message in the t_msg[] buffer.
@@ -632,9 +1011,15 @@ bool Message::forThisModule(const byte t_msg[]) {  // Check if the message in th
 }
 
 void Message::sendMessageRS485(byte t_msg[]) {
+  // Rev: 10/19/26.  Added bus statistics (count, bytes, and time spent here including the pacing delay.)  Polled bus: MAS waits
+  //   for any pending poll reply before transmitting.
   // Rev: 10-18-20.  Added delay between successive transmits to avoid overflowing modules' incoming serial buffer.
   // This routine must *only* be called when an entire message is ready to write, not a byte at a time.
   // This version, as part of the RS485 message class, automatically calculates and adds the CRC checksum.
+  const unsigned long sendStartMicros = micros();
+  if ((RS485_POLLED_BUS) && (THIS_MODULE == ARDUINO_MAS)) {
+    waitForPollReply();
+  }
   digitalWrite(PIN_OUT_RS485_TX_LED, HIGH);  // Turn on the transmit LED
   digitalWrite(PIN_OUT_RS485_TX_ENABLE, RS485_TRANSMIT);  // Turn on transmit mode (set HIGH)
   byte tMsgLen = getLen(t_msg);
@@ -651,6 +1036,7 @@ void Message::sendMessageRS485(byte t_msg[]) {
   // Delayed Action table.  We should know if this happens because the receive function *should* detect a full input buffer and
   // do an emergency stop.  May not be a good permanent fix.  See header.
   while ((millis() - m_messageLastSentTime) < RS485_MESSAGE_DELAY_MS) {}  // Pause to help prevent receiver's in buffer overflow.
+  m_sendPaceMicrosTotal = m_sendPaceMicrosTotal + (micros() - sendStartMicros);
   while (m_mySerial->availableForWrite() < tMsgLen) {}  // Wait until there is enough room in the outgoing buffer for this message.
   m_mySerial->write(t_msg, tMsgLen);  
   // 12/15/20: In addition to waiting *before* we transmit, to avoid overflowing our own output buffer, and the recipient's input
@@ -669,6 +1055,13 @@ void Message::sendMessageRS485(byte t_msg[]) {
   digitalWrite(PIN_OUT_RS485_TX_ENABLE, RS485_RECEIVE);  // Switch back to receive mode (set LOW)
   digitalWrite(PIN_OUT_RS485_TX_LED, LOW);  // Turn off the transmit LED
   m_messageLastSentTime = millis();         // Keeps track of *when* this message was last sent.
+  const unsigned long sendMicros = micros() - sendStartMicros;
+  m_sendMicrosTotal = m_sendMicrosTotal + sendMicros;
+  if (sendMicros > m_sendMicrosWorst) {
+    m_sendMicrosWorst = sendMicros;
+  }
+  countMessage(m_typeSent, t_msg[RS485_TYPE_OFFSET]);
+  m_bytesSent = m_bytesSent + tMsgLen;
   return;
 }
 
@@ -707,10 +1100,17 @@ bool Message::getMessageRS485(byte* t_msg) {
     for (byte i = 0; i < incomingMsgLen; i++) {  // Get the RS485 incoming bytes and put them in the t_msg[] byte array
       t_msg[i] = m_mySerial->read();
     }
-    if (getChecksum(t_msg) != calcChecksumCRC8(t_msg, incomingMsgLen - 1)) {  // Bad checksum.  Fatal!
-      sprintf(lcdString, "RS485 bad checksum!"); pLCD2004->println(lcdString); Serial.println(lcdString); endWithFlashingLED(1);
+    m_bytesReceived = m_bytesReceived + incomingMsgLen;
+    if (getChecksum(t_msg) != calcChecksumCRC8(t_msg, incomingMsgLen - 1)) {  // Bad checksum.  Fatal (normally.)
+      m_badChecksums++;
+      if (RS485_HALT_ON_BAD_CHECKSUM) {
+        sprintf(lcdString, "RS485 bad checksum!"); pLCD2004->println(lcdString); Serial.println(lcdString); endWithFlashingLED(1);
+      }
+      digitalWrite(PIN_OUT_RS485_RX_LED, LOW);  // Turn off the receive LED
+      return false;  // Message has been discarded
     }
     // At this point, we have a complete and legit message with good CRC, which may or may not be for us.
+    countMessage(m_typeReceived, t_msg[RS485_TYPE_OFFSET]);
     digitalWrite(PIN_OUT_RS485_RX_LED, LOW);  // Turn off the receive LED
     return true;
   }
@@ -1,4 +1,17 @@
-// MESSAGE.H Rev: 02/20/24.  COMPLETE AND READY FOR TESTING *****************************************************************************************************************
+// MESSAGE.H Rev: 10/19/26.  COMPLETE AND READY FOR TESTING *****************************************************************************************************************
+// 10/19/26: Added bus statistics: frames sent/received/rejected by message type, bad checksums, bytes on the wire, time spent in
+//   sendMessageRS485() (including the RS485_MESSAGE_DELAY_MS pacing), and min/avg/max plus a histogram of the request-to-grant
+//   wait for BTN/SNS.  New 'H'ealth message type lets MAS collect every module's statistics via displayBusHealthReport(); modules
+//   reply automatically from within available(), so no module sketch needs to know about it.
+// 10/19/26: Added optional polled bus arbitration (RS485_POLLED_BUS in Train_Consts_Global.h.)  Rather than waiting for BTN or
+//   SNS to pull an RTS line low, MAS's available() sends a 'G'o-ahead poll message to the next module in the poll list each time
+//   its slot comes up.  The module either transmits its pending Button/Sensor message, or replies with a 5-byte 'G'o-ahead reply
+//   meaning "nothing to send."  MAS doesn't wait for the reply; available() picks it up on a later call, and sendMessageRS485()
+//   only holds off (at most RS485_POLL_REPLY_TIMEOUT_MS) if MAS needs to transmit while a reply is still due.  ('P' was already
+//   taken by the MAS-to-OCC 'P'lay audio message.)  Worst-case wait to transmit is thus bounded by RS485_POLL_CYCLE_MS no matter how busy MAS's loop is, and
+//   adding a module is a matter of adding it to the poll list rather than running another wire.  displayBusStats() reports the
+//   worst poll cycle, poll reply time, poll timeouts, and (on BTN/SNS) the worst wait for permission to transmit, which can be
+//   compared against the same wait measured with the RTS pin scheme.
 // 2/20/24 Added Debug on/off prompt:
 //   MAS-to-LEG Registration Debug On|Off.
 // 3/9/23 Add Audio on/off prompt:
@@ -73,8 +86,31 @@ class Message {
     void sendSNStoALLSensorStatus(const byte t_sensorNum, const char t_sensorStatus);
     void  getSNStoALLSensorStatus(byte* t_sensorNum, char* t_sensorStatus);
 
+    // *** BUS STATISTICS (ANY MODE, BUT ONLY WHEN STOPPED SINCE MAS HOLDS THE BUS WHILE COLLECTING) ***
+    void displayBusStats();          // Send THIS_MODULE's RS485 bus statistics to the Serial monitor.
+    void displayBusHealthReport();   // MAS only: Request statistics from every module and send a report to the Serial monitor.
+
   private:
 
+    // *** POLLED BUS ARBITRATION (ONLY USED IF RS485_POLLED_BUS) ***
+    void pollNextModule();                         // MAS: Poll next module if its slot is due and no reply is pending.
+    void pollReplyReceived();                      // MAS: The polled module answered; it's no longer due a reply.
+    void waitForPollReply();                       // MAS: Before transmitting, let a pending poll reply arrive or time out.
+    void sendMAStoModulePoll(const byte t_module);  // MAS to BTN/SNS: You may transmit one message now.
+    void sendModuletoMASPollReply();                // BTN/SNS to MAS: I have nothing to transmit.
+    void waitForPermissionToSend();                 // BTN/SNS: Wait for Ok-To-Send (RTS pin scheme) or for a Poll.
+
+    // *** BUS HEALTH STATISTICS ***
+    void sendMAStoModuleHealthRequest(const byte t_module, const byte t_page);  // MAS to any: Send me page n of your stats.
+    void sendModuletoMASHealth(const byte t_page);                               // Any to MAS: Here is page n of my stats.
+    bool getModuletoMASHealth(const byte t_module, const byte t_page);  // MAS: Wait for reply; false if module didn't answer.
+    void countMessage(unsigned int t_counter[], const char t_type);  // Bump per-message-type counter, if type is 'A'..'Z'.
+    unsigned long totalOfCounter(const unsigned int t_counter[]);     // Sum of a per-message-type counter across all types.
+    void putUnsignedInt(const byte t_offset, const unsigned long t_value);  // Into m_RS485Buf[], saturated at 65535.
+    void putUnsignedLong(const byte t_offset, const unsigned long t_value);
+    unsigned int getUnsignedInt(const byte t_offset);
+    unsigned long getUnsignedLong(const byte t_offset);
+
     // ***** HERE ARE THE LOW-LEVEL CALLS THAT TALK TO THE RS485 NETWORK, AND ASSEMBLE AND DISASSEMBLE MESSAGES *****
 
     bool forThisModule(const byte t_msg[]);  // Returns true if a message is for the calling module i.e. MAS, OCC, etc.
@@ -108,6 +144,45 @@ class Message {
           unsigned long m_messageLastSentTime  = 0;  // Keeps track of *when* a message was last sent
     const unsigned long RS485_MESSAGE_DELAY_MS = 2;  // How long should we wait between RS485 transmissions?
 
+    // Polled bus arbitration.  Poll list is in the order modules are polled; RS485_POLL_NUM_MODULES must match.
+    const byte m_pollModule[RS485_POLL_NUM_MODULES] = { ARDUINO_SNS, ARDUINO_BTN };
+    byte          m_pollIndex = 0;                                 // Which module in m_pollModule[] we'll poll next.
+    unsigned long m_pollLastTime = 0;                              // millis() when MAS sent the most recent poll.
+    unsigned long m_pollLastTimeByModule[RS485_POLL_NUM_MODULES];  // millis() when we last polled each module.
+    bool          m_pollOutstanding = false;                       // True from sending a poll until its reply or timeout.
+    byte          m_pollOutstandingModule = 0;                     // Module we polled, if m_pollOutstanding.
+    unsigned long m_pollSentMicros = 0;                            // micros() when we sent that poll.
+    unsigned long m_pollsSent = 0;
+    unsigned long m_pollTimeouts = 0;          // Polled module didn't reply within RS485_POLL_REPLY_TIMEOUT_MS.
+    unsigned long m_pollCycleWorstMs = 0;      // Longest time between successive polls of the same module.
+    unsigned long m_pollReplyWorstMicros = 0;  // Longest time from sending a poll until available() saw the reply.
+
+    // Bus statistics.  Per-message-type counters are indexed by type letter - 'A', and are unsigned int (rather than long) to save
+    // memory on modules that are short of it; 65K messages of any one type is a long operating session.
+    // If RS485_HALT_ON_BAD_CHECKSUM is false, a message with a bad CRC is counted and discarded rather than halting.  Only change
+    // this while diagnosing a noisy bus, since we'd be silently losing messages.
+    const bool          RS485_HALT_ON_BAD_CHECKSUM  = true;
+    const unsigned long RS485_HEALTH_REPLY_TIMEOUT_MS = 250;  // Modules only answer when they call available(), so be generous.
+    static const byte   RS485_MESSAGE_TYPES = 'Z' - 'A' + 1;
+    unsigned int  m_typeSent[RS485_MESSAGE_TYPES];
+    unsigned int  m_typeReceived[RS485_MESSAGE_TYPES];
+    unsigned int  m_typeRejected[RS485_MESSAGE_TYPES];  // Received but forThisModule() said we don't care about it.
+    unsigned int  m_badChecksums = 0;
+    unsigned long m_bytesSent = 0;
+    unsigned long m_bytesReceived = 0;
+    unsigned long m_sendMicrosTotal = 0;       // Total time spent in sendMessageRS485(), including pacing delay.
+    unsigned long m_sendMicrosWorst = 0;
+    unsigned long m_sendPaceMicrosTotal = 0;   // Portion of m_sendMicrosTotal spent waiting out RS485_MESSAGE_DELAY_MS.
+    // BTN/SNS request-to-grant wait (RTS line pulled low, or message pending, until MAS says go.)  Histogram buckets are
+    // < 1ms, < 5ms, < 20ms, < 100ms, and >= 100ms.
+    static const byte   RS485_GRANT_BUCKETS = 5;
+    const unsigned long m_grantBucketLimitMicros[RS485_GRANT_BUCKETS - 1] = { 1000, 5000, 20000, 100000 };
+    unsigned int  m_grantCount = 0;
+    unsigned long m_grantMinMicros = 0xFFFFFFFF;
+    unsigned long m_grantMaxMicros = 0;
+    unsigned long m_grantTotalMicros = 0;
+    unsigned int  m_grantBucket[RS485_GRANT_BUCKETS];
+
 };
 
 #endif
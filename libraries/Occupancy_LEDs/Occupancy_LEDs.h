@@ -1,5 +1,12 @@
-// OCCUPANCY_LEDs.H Rev: 07/30/24.  FINISHED BUT NOT YET TESTED.
+// OCCUPANCY_LEDs.H Rev: 10/19/26.  FINISHED BUT NOT YET TESTED.
 // Part of O_OCC.
+// 10/19/26: paintAllBlockOccupancyLEDs() now keeps a Reserved and Occupied block bit mask per loco, and only asks Train Progress
+//           to re-scan the locos it has flagged as changed via blockViewChanged().  Was a full scan of every loco's route.
+// 10/19/26: All painting now goes to a frame buffer m_portImage[] of the eight 16-bit Centipede ports (red/blue block LEDs on
+//           ports 0..3, white sensor LEDs on ports 4..7), which is then flushed with one portWrite() per port that differs from
+//           what we last wrote.  Each Centipede digitalWrite() is an I2C read-modify-write, so painting every white LED used to
+//           take 52 x 2 I2C transactions; now it's at most 4.  Replaces m_oldBlockStatus[], which only covered the block LEDs and
+//           didn't know about LEDs lit by paintOneBlockOccupancyLED().
 // 07/30/24: Deleted paintOneOccupancySensorLED() since thus far we only paint all or darken all.
 //           Also swapped the order of Red/Blue so RED = Reserved (but not occupied) and BLUE = Occupied.
 // 06/18/24: Deleted getSensorStatus() as we don't need it.  Use SENSOR_BLOCK to keep track of sensor status T/C.  I.e. for
@@ -48,7 +55,8 @@ class Occupancy_LEDs {
 
     void paintAllBlockOccupancyLEDs();
     // AUTO/PARK RUNNING/STOPPING modes only.
-    // Scan Train Progress and illuminate all RED "reserved" and BLUE "occupied" LEDs.  We will ONLY call this function when we
+    // Update from Train Progress and illuminate all RED "reserved" and BLUE "occupied" LEDs.  Only locos whose Train Progress
+    // pointers changed since the last call are re-scanned (all locos the first time after begin().)  We will ONLY call this when we
     // first start Auto or Park mode (Park, because we can't guarantee that we will run Auto mode before starting Park mode) AND
     // whenever a Sensor state-change message is received when Auto/Park is Running/Stopping.  This is the only time that we'll
     // want to paint the entire control panel blue/red LEDs.  So we won't even bother checking mode and state here.
@@ -63,8 +71,14 @@ class Occupancy_LEDs {
     // Set all blocks to initially *not* occupied by STATIC equipment.  Populated during Registration.
 
     void initNewBlockStatus();
-    void initOldBlockStatus();
-    // These two Block Status arrays are only used by paintAllBlockOccupancyLEDs(), which is only called when a sensor status
+    // This Block Status array is only used by paintAllBlockOccupancyLEDs(), which is only called when a sensor status changes
+    // or a route is added in Auto/Park mode.
+
+    void setFramePin(const byte t_pinNum, const byte t_level);
+    // Set Centipede pin 0..127 HIGH (LED off) or LOW (LED on) in our frame buffer.  Doesn't touch the Centipede.
+
+    void flushFrame();
+    // Write each Centipede port whose frame buffer value differs from what we last wrote to it.
 
     const byte LED_OFF              =   0;  // Used by Sensor Status and Block Status arrays.
     const byte LED_SENSOR_OCCUPIED  =   1;  // Used by Sensor Status array.
@@ -81,12 +95,25 @@ class Occupancy_LEDs {
     // STATIC BLOCK bool array defined during Registration will be true for every block that's occupied by STATIC equipment.
     bool m_staticBlock[TOTAL_BLOCKS];
 
-    // RED/BLUE LED BLOCK STATUS.  Tells us how each RED/BLUE BLOCK OCCUPANCY LED *should* be lit and *were* lit.
-    // We'll compare new with old to see if we can avoid individual LED digitalWrite() commands to save time.
+    // RED/BLUE LED BLOCK STATUS.  Tells us how each RED/BLUE BLOCK OCCUPANCY LED *should* be lit.
     // Array element corresponds to (block number - 1) = 0..25 for blocks 1..26.
     // Notice there are TWO Centipede pins for each two-color LED (one for RED and one for BLUE.)
     byte m_newBlockStatus[TOTAL_BLOCKS];  // This will store how LEDs should be illuminated
-    byte m_oldBlockStatus[TOTAL_BLOCKS];  // This will store how they have previously been illuminated
+
+    // PER-LOCO BLOCK MASKS.  Element = locoNum - 1.  As last returned by Train_Progress::getBlockView() for each loco.
+    // m_rescanAllLocos forces a full refresh on the first paint after begin().
+    blockBitmap   m_locoReservedBlocks[TOTAL_TRAINS];
+    blockBitmap   m_locoOccupiedBlocks[TOTAL_TRAINS];
+    bool          m_rescanAllLocos;
+
+    // CENTIPEDE FRAME BUFFER.  One 16-bit value per Centipede port (chip), two Centipedes = 8 ports = pins 0..127.
+    // Bit LOW = LED on, HIGH = LED off, same as the Centipede.  m_portImage[] is how the ports *should* be, and m_portWritten[] is
+    // how we last wrote them.  m_portWrittenValid is false until we've written every port once, since begin() can be called when
+    // LEDs are already lit.
+    static const byte OCC_LED_PORTS = 8;
+    unsigned m_portImage[OCC_LED_PORTS];
+    unsigned m_portWritten[OCC_LED_PORTS];
+    bool     m_portWrittenValid;
 
     // RED/BLUE control panel block reservation and occupancy LEDs connect to Centipede 1 (address 0.)
     // WHITE control panel occupancy-indication LEDs connect to Centipede 2 (address 1.)
@@ -1,4 +1,5 @@
-// ROTARY_PROMPT.CPP Rev: 03/23/23.
+// ROTARY_PROMPT.CPP Rev: 10/19/26.
+// 10/19/26: getRotaryResponse() keeps the encoder state in m_rotaryState between reads; it was reading an uninitialized local.
 // Part of O_OCC.
 // Pass an array of prompts to be displayed on the 8-char LED Backpack.  Operator can then use the Rotary Encoder to scroll through
 // the list bidirectionally, and select one by pressing the Rotary Encoder.
@@ -71,7 +72,7 @@ byte Rotary_Prompt::getSelection(rotaryEncoderPromptStruct* t_encoderPromptArray
 // ***** PRIVATE FUNCTION *****
 
 byte Rotary_Prompt::getRotaryResponse() {
-  // Rev: 03/14/23.
+  // Rev: 10/19/26.
   // Wait until either a rotation or press is detected, then return that info.
   // Returns direction of rotation as DIR_CCW (16) or DIR_CW (32), or press as DIR_PUSH (1).
   // Occasionially I did notice that it returned a "left" right after uploading but couldn't repeat reliably enough to find
@@ -80,8 +81,8 @@ byte Rotary_Prompt::getRotaryResponse() {
 
     // See if the dial was turned a notch in either direction...
     unsigned char pinState = (digitalRead(PIN_IN_ROTARY_2) << 1) | digitalRead(PIN_IN_ROTARY_1);
-    byte rotaryState = rotaryTableFullStep[rotaryState & 0xf][pinState];
-    byte stateReturn = (rotaryState & 0x30);
+    m_rotaryState = rotaryTableFullStep[m_rotaryState & 0xf][pinState];
+    byte stateReturn = (m_rotaryState & 0x30);
     if ((stateReturn == DIR_CCW) || (stateReturn == DIR_CW)) {  // The dial was turned in either direction!
       delay(10);  // Was getting very occasional bounce without a delay here.
       return stateReturn;
@@ -1,4 +1,5 @@
-// ROTARY_PROMPT.H Rev: 03/23/23.
+// ROTARY_PROMPT.H Rev: 10/19/26.
+// 10/19/26: Renamed the unused rotaryNewState to m_rotaryState; getRotaryResponse() now keeps the encoder state in it.
 // Part of O_OCC.
 // Pass an array of prompts to be displayed on the 8-char LED Backpack.  Operator can then use the Rotary Encoder to scroll through
 // the list bidirectionally, and select one by pressing the Rotary Encoder.
@@ -67,7 +68,7 @@ class Rotary_Prompt {
       {0x6, 0x5, 0x0, 0x20},
       {0x6, 0x5, 0x4,  0x0},
     };
-    unsigned char rotaryNewState = 0;      // Value will be 0, 16, or 32 depending on how rotary being turned
+    unsigned char m_rotaryState  = 0;      // Row of rotaryTableFullStep; bits 0x30 are set to DIR_CCW or DIR_CW when a notch completes
     unsigned char rotaryTurned   = false;
     unsigned char rotaryPushed   = false;
 
@@ -1,4 +1,7 @@
-// ROUTE_REFERENCE.CPP Rev: 03/01/23.  TESTED AND WORKING.
+// ROUTE_REFERENCE.CPP Rev: 10/19/26.  TESTED AND WORKING.
+// 10/19/26: Route bitmaps are only built (and allocated) when Dispatcher calls buildRouteBitmaps(), not by begin().
+// 10/19/26: Route bitmaps are blockBitmap/turnoutBitmap, sized by LAYOUT_LEVELS.
+// 10/19/26: Added precomputed route block/turnout bitmaps and route conflict matrix.
 // 03/01/23: Removed levels field.
 // 01/24/23: Constructor needs to set initial value of index field (recNum) to a NON-ZERO, impossible value.  If we initialized it
 //           to 0 and our first lookup was for record 0, our code would think the real record had already been loaded and return
@@ -41,7 +44,7 @@ Route_Reference::Route_Reference() {  // Constructor
 }
 
 void Route_Reference::begin(FRAM* t_pStorage) {
-  // Rev: 12/22/22.
+  // Rev: 10/19/26.  No longer builds the route bitmaps; Dispatcher calls buildRouteBitmaps() itself.
   m_pStorage = t_pStorage;  // Pointer to FRAM so we can access our table.
   if (m_pStorage == nullptr) {
     sprintf(lcdString, "UN-INIT'd RR PTR"); pLCD2004->println(lcdString); Serial.println(lcdString); endWithFlashingLED(5);
@@ -230,6 +233,47 @@ routeElement Route_Reference::getElement(const unsigned int t_recNum, const byte
   return m_routeReference.route[t_elementNum];
 }
 
+blockBitmap Route_Reference::blockBits(const unsigned int t_recNum) {
+  // Rev: 10/19/26.
+  if (Route_Reference::outOfRangeRecNum(t_recNum)) {
+    sprintf(lcdString, "BAD RT BB REC %i", t_recNum); pLCD2004->println(lcdString); Serial.println(lcdString); endWithFlashingLED(5);
+  }
+  Route_Reference::checkRouteBitmaps();
+  return m_pBitmaps->blockBits[t_recNum];
+}
+
+turnoutBitmap Route_Reference::turnoutBits(const unsigned int t_recNum) {
+  // Rev: 10/19/26.
+  if (Route_Reference::outOfRangeRecNum(t_recNum)) {
+    sprintf(lcdString, "BAD RT TB REC %i", t_recNum); pLCD2004->println(lcdString); Serial.println(lcdString); endWithFlashingLED(5);
+  }
+  Route_Reference::checkRouteBitmaps();
+  return m_pBitmaps->turnoutBits[t_recNum];
+}
+
+bool Route_Reference::routeIsClear(const unsigned int t_recNum, const blockBitmap& t_reservedBlockBits,
+                                   const turnoutBitmap& t_reservedTurnoutBits) {
+  // Rev: 10/19/26.
+  // Caller passes bitmaps of blocks and turnouts that are reserved for someone else (not including the train that wants the
+  // route, since it's fine for a route to include the block it's sitting in, etc.)
+  if (Route_Reference::outOfRangeRecNum(t_recNum)) {
+    sprintf(lcdString, "BAD RT RIC REC %i", t_recNum); pLCD2004->println(lcdString); Serial.println(lcdString); endWithFlashingLED(5);
+  }
+  Route_Reference::checkRouteBitmaps();
+  return ((!m_pBitmaps->blockBits[t_recNum].intersects(t_reservedBlockBits)) &&
+          (!m_pBitmaps->turnoutBits[t_recNum].intersects(t_reservedTurnoutBits)));
+}
+
+bool Route_Reference::routesConflict(const unsigned int t_recNum1, const unsigned int t_recNum2) {
+  // Rev: 10/19/26.
+  // True if the two routes have any block or turnout in common.  A route always conflicts with itself.
+  if ((Route_Reference::outOfRangeRecNum(t_recNum1)) || (Route_Reference::outOfRangeRecNum(t_recNum2))) {
+    sprintf(lcdString, "BAD RT CNF %i %i", t_recNum1, t_recNum2); pLCD2004->println(lcdString); Serial.println(lcdString); endWithFlashingLED(5);
+  }
+  Route_Reference::checkRouteBitmaps();
+  return ((m_pBitmaps->conflicts[t_recNum1][t_recNum2 / 8] >> (t_recNum2 % 8)) & 0x01);
+}
+
 void Route_Reference::display(const unsigned int t_recNum) {
   // Rev: 01/24/23.
   // Display a single route; not the entire table.  For testing and debugging purposes only.
@@ -301,6 +345,8 @@ void Route_Reference::populate() {  // Populate the Route Reference table.
   // NOTES REGARDING MEMORY USAGE: We can populate an absolute maximum of 39 Route Reference records at a time; 40 blows up.
   // I'll break the Route Reference elements into groups of 25 elements each.
   // Just comment in/out GROUP_1, GROUP_2, etc. one at a time as we run and re-run the populate() utility.
+  // O_FRAM_Populator/FRAM_Tables.py reads every GROUP below when it builds an image on the PC, so keep one "data[n] = {...};"
+  // per route.
   // Careful don't call this m_routeReference, which would confuse with our "regular" variable that holds just one record.
   // The Route Reference table is composed of the following:
   // When stored in FRAM, routes are sorted by ORIGIN + PRIORITY + DESTINATION.
@@ -432,6 +478,9 @@ void Route_Reference::populate() {  // Populate the Route Reference table.
   }
   delete[] data;  // Free up the data[] array memory reserved by "new"
   Serial.println(F("Memory after delete: ")); freeMemory();
+  if (m_pBitmaps != nullptr) {
+    Route_Reference::buildRouteBitmaps();  // Table has changed so our bitmaps may be stale.
+  }
   //m_pStorage->setFRAMRevDate(01, 26, 23);  // ALWAYS UPDATE FRAM DATE IF WE CHANGE A FILE!
   return;
 }
@@ -462,6 +511,64 @@ void Route_Reference::getRouteReference(const unsigned int t_recNum) {  // Popul
   return;
 }
 
+void Route_Reference::buildRouteBitmaps() {
+  // Rev: 10/19/26.
+  // Read every Route record once and note which blocks and turnouts it uses, then build the route-vs-route conflict matrix from
+  // those bitmaps.  74 routes * 170 bytes is a quick read from FRAM.  Block and turnout numbers outside 1..TOTAL_BLOCKS and
+  // 1..TOTAL_TURNOUTS are ignored, so this is harmless if FRAM hasn't been populated yet (populate() rebuilds them.)
+  // Opt-in: the first call allocates the bitmaps on the heap, so modules that never call this don't pay for them.
+  if (m_pBitmaps == nullptr) {
+    m_pBitmaps = new routeBitmapStruct;
+    if (m_pBitmaps == nullptr) {
+      sprintf(lcdString, "RT BITMAP NO MEM"); pLCD2004->println(lcdString); Serial.println(lcdString); endWithFlashingLED(5);
+    }
+  }
+  for (unsigned int recNum = 0; recNum < FRAM_RECS_ROUTE_TOTAL; recNum++) {
+    Route_Reference::getRouteReference(recNum);
+    blockBitmap blockBits;
+    turnoutBitmap turnoutBits;
+    for (byte elementNum = 0; elementNum < FRAM_SEGMENTS_ROUTE_REF; elementNum++) {
+      const byte recType = m_routeReference.route[elementNum].routeRecType;
+      const byte recVal  = m_routeReference.route[elementNum].routeRecVal;
+      if (recType == ER) {
+        break;
+      }
+      if ((recType == BE) || (recType == BW)) {
+        blockBits.set(recVal);  // Ignores recVal outside 1..TOTAL_BLOCKS
+      } else if ((recType == TN) || (recType == TR)) {
+        turnoutBits.set(recVal);
+      }
+    }
+    m_pBitmaps->blockBits[recNum] = blockBits;
+    m_pBitmaps->turnoutBits[recNum] = turnoutBits;
+  }
+  for (unsigned int recNum1 = 0; recNum1 < FRAM_RECS_ROUTE_TOTAL; recNum1++) {
+    for (unsigned int recNum2 = 0; recNum2 < FRAM_RECS_ROUTE_TOTAL; recNum2++) {
+      if ((recNum1 == recNum2) ||
+          m_pBitmaps->blockBits[recNum1].intersects(m_pBitmaps->blockBits[recNum2]) ||
+          m_pBitmaps->turnoutBits[recNum1].intersects(m_pBitmaps->turnoutBits[recNum2])) {
+        m_pBitmaps->conflicts[recNum1][recNum2 / 8] |= (1 << (recNum2 % 8));
+      } else {
+        m_pBitmaps->conflicts[recNum1][recNum2 / 8] &= ~(1 << (recNum2 % 8));
+      }
+    }
+  }
+  return;
+}
+
+void Route_Reference::checkRouteBitmaps() {
+  // Rev: 10/19/26.
+  if (m_pBitmaps == nullptr) {
+    sprintf(lcdString, "RT BITMAPS NOT BUILT"); pLCD2004->println(lcdString); Serial.println(lcdString); endWithFlashingLED(5);
+  }
+  return;
+}
+
+bool Route_Reference::outOfRangeRecNum(const unsigned int t_recNum) {
+  // Rev: 10/19/26.
+  return (t_recNum > (FRAM_RECS_ROUTE_TOTAL - 1));
+}
+
 unsigned long Route_Reference::routeReferenceAddress(const unsigned int t_recNum) {
   // Rev: 01/24/23.
   // Returns the FRAM byte address of the given record number 0..n in the Route Reference table.
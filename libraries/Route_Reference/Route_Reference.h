@@ -1,7 +1,19 @@
-// ROUTE_REFERENCE.H Rev: 09/08/24.  TESTED AND WORKING.
+// ROUTE_REFERENCE.H Rev: 10/19/26.  TESTED AND WORKING.
 // Route Reference table is stored in FRAM, and is used by MAS, OCC, and LEG to maintain their Train Progress tables.
 // All three modules must have identical matching Route tables in FRAM, as MAS sends FRAM record number to identify routes.
 
+// 10/19/26: Added per-route block and turnout bitmaps, plus a route-vs-route conflict matrix, built once by begin() (and again
+// after populate().)  Bit (n - 1) of blockBits() is set if Block n appears anywhere in the route (BE or BW); same for turnouts
+// (TN or TR) in turnoutBits().  Given bitmaps of blocks and turnouts
+// reserved for *other* trains (Block_Reservation::reservedBits() and Turnout_Reservation::reservedBits()), checking if a route
+// is clear is just two ANDs, and routesConflict() tells us if two routes share any block or turnout, all without touching FRAM.
+// Costs 8 bytes per route for the bitmaps plus one bit per pair of routes for the matrix; about 1.3K on the heap for 74 routes.
+// 10/19/26: Bitmaps are now blockBitmap and turnoutBitmap (see Train_Consts_Global.h), so they grow with LAYOUT_LEVELS; with one
+// level they are still an unsigned long each.
+// 10/19/26: The bitmaps are now opt-in.  Only Dispatcher uses them, so Dispatcher::begin() calls buildRouteBitmaps(), which
+// allocates them on the heap; OCC, LEG and the utility sketches no longer spend the FRAM pass or the memory.  Calling blockBits(),
+// turnoutBits(), routeIsClear() or routesConflict() before buildRouteBitmaps() is fatal.
+
 // 09/08/24: Deprecated Route Rule 9; we will now allow turnouts to occur  multiple times in a route without any special
 // considerations; let's hope MAS can throw them the instant the sensor ahead of them is tripped.
 
@@ -177,11 +189,22 @@ class Route_Reference {
     byte         getPriority(const unsigned int t_recNum);  // 1..5; 1 = Highest priority
     routeElement getElement(const unsigned int t_recNum, const byte t_elementNum);  // Get 1 route element at a time, 0..79.
 
+    // Precomputed bitmaps of Block n or Turnout n.  No FRAM access, but buildRouteBitmaps() must have been called first.
+    void buildRouteBitmaps();  // Read every route from FRAM once and build the bitmaps and conflict matrix.  Again after changes.
+    blockBitmap   blockBits(const unsigned int t_recNum);    // Every block (BE/BW) that appears in this route.
+    turnoutBitmap turnoutBits(const unsigned int t_recNum);  // Every turnout (TN/TR) that appears in this route.
+    bool routeIsClear(const unsigned int t_recNum, const blockBitmap& t_reservedBlockBits,
+                      const turnoutBitmap& t_reservedTurnoutBits);  // True if none of the route's blocks/turnouts are in the masks.
+    bool routesConflict(const unsigned int t_recNum1, const unsigned int t_recNum2);  // True if routes share a block or turnout.
+
     void display(const unsigned int t_recNum);  // Display a single record to Serial COM.
     void populate();  // Special utility reads hard-coded data, writes records to FRAM.
 
   private:
 
+    void checkRouteBitmaps();  // Fatal if buildRouteBitmaps() hasn't been called.
+    bool outOfRangeRecNum(const unsigned int t_recNum);  // 0..FRAM_RECS_ROUTE_TOTAL - 1
+
     void          getRouteReference(const unsigned int t_recNum);      // Populate pRouteReference data for FRAM t_recNum.
     unsigned long routeReferenceAddress(const unsigned int t_recNum);  // Return the FRAM recNum address in Route Reference.
 
@@ -217,6 +240,16 @@ class Route_Reference {
                                                     // 2 bytes/route element = 160 bytes for the route elements.
     };
     routeReferenceStruct m_routeReference;  // Local working struct variable holds one record.
+    static_assert(FRAM_RECS_ROUTE_TOTAL * sizeof(routeReferenceStruct) <= FRAM_BYTES_ROUTE_REF,
+                  "Route Reference table overruns FRAM_BYTES_ROUTE_REF.");
+
+    // Only allocated (on the heap) by buildRouteBitmaps(); nullptr until then.
+    struct routeBitmapStruct {
+      blockBitmap   blockBits[FRAM_RECS_ROUTE_TOTAL];    // Block n is set if it's in the route.
+      turnoutBitmap turnoutBits[FRAM_RECS_ROUTE_TOTAL];  // Turnout n is set if it's in the route.
+      byte conflicts[FRAM_RECS_ROUTE_TOTAL][(FRAM_RECS_ROUTE_TOTAL + 7) / 8];  // Bit set if route pair shares a blk/turnout.
+    };
+    routeBitmapStruct* m_pBitmaps = nullptr;
 
     FRAM* m_pStorage;           // Pointer to the FRAM memory module
 
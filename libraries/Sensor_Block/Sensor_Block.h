@@ -1,5 +1,6 @@
-// SENSOR_BLOCK.H Rev: 01/26/23.  TESTED AND WORKING.
+// SENSOR_BLOCK.H Rev: 10/19/26.  TESTED AND WORKING.
 // ONE RECORD FOR EACH SENSOR.
+// 10/19/26: Table size is checked against FRAM_BYTES_SNS_BLK_XREF at compile time.
 // 12/14/20: Added sensor status field Tripped/Cleared get/set for modules *other than* SNS.
 // A set of functions to retrieve data from the Sensor Block cross reference table, which is stored in FRAM.
 // Also used to store the current status of each sensor, as they are tripped and cleared, for use by individual Arduinos so they
@@ -47,6 +48,8 @@ class Sensor_Block {
 
     };
     sensorBlockStruct m_sensorBlock;
+    static_assert(TOTAL_SENSORS * sizeof(sensorBlockStruct) <= FRAM_BYTES_SNS_BLK_XREF,
+                  "Sensor-Block Xref table overruns FRAM_BYTES_SNS_BLK_XREF.");
 
     FRAM* m_pStorage;           // Pointer to the FRAM memory module
 
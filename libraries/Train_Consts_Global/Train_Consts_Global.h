@@ -1,4 +1,14 @@
-// TRAIN_CONSTS_GLOBAL.H Rev: 02/17/24.
+// TRAIN_CONSTS_GLOBAL.H Rev: 10/19/26.
+// 10/19/26: Layout size is now set in one place, LAYOUT_LEVELS, which sizes TOTAL_BLOCKS/TURNOUTS/SENSORS, the Route and Deadlock
+//           record counts, and the FRAM address map.  Added Layout_Bitmap<> for block and turnout bit masks of any size.
+//           Each FRAM table now has a FRAM_BYTES_xxx size; FRAM_RECS_MAS_LOG_FILE became FRAM_BYTES_MAS_LOG_FILE.
+// 10/19/26: FRAM_ADDR_MAS_LOG_FILE now holds the Event_Journal header and ring; added FRAM_RECS_MAS_LOG_FILE.
+// 10/19/26: Replaced LEGACY_CMD_DELAY (30ms) with LEGACY_CMD_SPACING (25ms, never less than wire time) and added
+//           LEGACY_CMD_URGENT_RECS.
+// 10/19/26: Added RS485 'H'ealth message offsets for Message bus statistics report.
+// 10/19/26: Added RS485_POLLED_BUS and related consts for optional polled RS485 bus arbitration (see Message.h.)
+// 10/19/26: Moved TURNOUTS_TO_FIRE_AT_ONCE here from O_SWT so LED's green LEDs keep pace with SWT's solenoids.
+// 10/19/26: Added FRAM_RECS_ROUTE_TOTAL for sizing Route_Reference block/turnout bitmaps and route conflict matrix.
 // 02/17/23: Updated pin number for OCC WAV Trigger status input
 // 03/21/23: Added RS485_MAS_ALL_ROUTE_EXT_CONT_OFFSET for send/getMAStoALLRoute()
 // 03/02/23: Added LOCO_ID_POWERMASTER_n consts for use by LEG.
@@ -53,10 +63,27 @@ const byte STATE_RUNNING   = 1;
 const byte STATE_STOPPING  = 2;
 const byte STATE_STOPPED   = 3;
 
+// *** LAYOUT SIZE ***
+// Everything that grows when we add the second level is derived from LAYOUT_LEVELS: tables, bit masks, FRAM addresses, and the
+// range checks on block/turnout/sensor numbers in RS485 messages.  Level 2 is assumed to be the same size as level 1 until it's
+// designed; when it is, change the _PER_LEVEL consts below (or replace them with per-level totals) and nothing else.
+// Every module must be compiled with the same LAYOUT_LEVELS, and FRAM must be re-populated after changing it.
+// Blocks, turnouts and sensors are sent in RS485 messages and stored in routeElement.routeRecVal as one byte, so each total must
+// be less than 255.
+#ifndef LAYOUT_LEVELS
+#define LAYOUT_LEVELS 1  // 1 = Level 1 only, as of 10/19/26.  Can be overridden on the compiler command line (-DLAYOUT_LEVELS=2.)
+#endif
+const byte          BLOCKS_PER_LEVEL         =  26;
+const byte          TURNOUTS_PER_LEVEL       =  32;  // 30 connected, but 32 relays.
+const byte          SENSORS_PER_LEVEL        =  52;
+const unsigned int  ROUTES_EAST_PER_LEVEL    =  38;  // 38 "level 1 only" EB routes as of 01/16/22.
+const unsigned int  ROUTES_WEST_PER_LEVEL    =  36;  // 36 "level 1 only" WB routes as of 01/16/22.
+const unsigned int  DEADLOCKS_PER_LEVEL      =  30;
+
 // *** VARIOUS MAXIMUM VALUES ***
-const byte TOTAL_BLOCKS           =  26;
-const byte TOTAL_TURNOUTS         =  32;  // 30 connected, but 32 relays and we're using 32 bits in last-known.
-const byte TOTAL_SENSORS          =  52;
+const byte TOTAL_BLOCKS           = BLOCKS_PER_LEVEL * LAYOUT_LEVELS;    // 26 for one level
+const byte TOTAL_TURNOUTS         = TURNOUTS_PER_LEVEL * LAYOUT_LEVELS;  // 32 for one level
+const byte TOTAL_SENSORS          = SENSORS_PER_LEVEL * LAYOUT_LEVELS;   // 52 for one level
 const byte TOTAL_TRAINS           =  50;
 const byte TOTAL_LEG_ACCY_RELAYS  =  16;  // 0..15 LEG accessory relays so far.
 
@@ -76,30 +103,98 @@ const byte FRAMVERSION[3] { 06, 18, 60 };     // If used, this must match the ve
 // *** OFFSETS OF VARIOUS TABLES IN FRAM.  I.E. STARTING ADDRESSES. ***
 // Last-known turnout orientation (MAS only) is stored in the Turnout Reservation file.
 // Last-known block and dir of each train (MAS only) is stored in the Block Reservation file.
+// 10/19/26: Each table's address is the previous table's address plus the space reserved for it, and the space for each table
+// that grows with the layout is multiplied by LAYOUT_LEVELS.  With one level, every address is the same as before.  Each class
+// static_asserts that its records fit in the space reserved for them, so a bigger layout can't silently overlap the next table.
 const unsigned long FRAM_ADDR_REV_DATE       =      0;  // Three bytes: Month, Day, Year i.e. 11,27,20.
-const unsigned long FRAM_ADDR_TURNOUT_RESN   =    256;  // Turnout res'ervatio'ns for 32 turnouts.
-//                  TOTAL_TURNOUTS = 32 (defined above) number of Turnout Reservation table records.
-const unsigned long FRAM_ADDR_SNS_BLK_XREF   =    512;  // Sensor-Block Xref for 52 sensors.  MAS, OCC, and LEG.
-//                  TOTAL_SENSORS  = 52 (defined above) number of Sensor-Block Xref table records.
-const unsigned long FRAM_ADDR_BLOCK_RESN     =   1024;  // Block Reservation for 26 blocks.  MAS, OCC, and LEG.  MAS, OCC, and LEG.
-//                  TOTAL_BLOCKS   = 26 (defined above) number of Block Reservation table records.
-const unsigned long FRAM_ADDR_DEADLOCK       =   3072;  // Deadlock table; currently 32 deadlocks @ 23 bytes each.  MAS only.
+const unsigned long FRAM_ADDR_TURNOUT_RESN   =    256;  // Turnout res'ervatio'ns for TOTAL_TURNOUTS turnouts.  MAS only.
+const unsigned long FRAM_BYTES_TURNOUT_RESN  =    256UL * LAYOUT_LEVELS;
+const unsigned long FRAM_ADDR_SNS_BLK_XREF   = FRAM_ADDR_TURNOUT_RESN + FRAM_BYTES_TURNOUT_RESN;  // 512.  Sensor-Block Xref for
+const unsigned long FRAM_BYTES_SNS_BLK_XREF  =    512UL * LAYOUT_LEVELS;                           // TOTAL_SENSORS.  MAS/OCC/LEG.
+const unsigned long FRAM_ADDR_BLOCK_RESN     = FRAM_ADDR_SNS_BLK_XREF + FRAM_BYTES_SNS_BLK_XREF;   // 1024.  Block Reservation for
+const unsigned long FRAM_BYTES_BLOCK_RESN    =   2048UL * LAYOUT_LEVELS;                           // TOTAL_BLOCKS.  MAS/OCC/LEG.
+const unsigned long FRAM_ADDR_DEADLOCK       = FRAM_ADDR_BLOCK_RESN + FRAM_BYTES_BLOCK_RESN;       // 3072.  Deadlock table; 23
+const unsigned long FRAM_BYTES_DEADLOCK      =   2048UL * LAYOUT_LEVELS;                           // bytes/record.  MAS only.
 const byte          FRAM_FIELDS_DEADLOCK     =     11;  // Max possible num facing blocks to constitute a deadlock, per Deadlocks table.
-const unsigned int  FRAM_RECS_DEADLOCK       =     30;  // Deadlock table NUMBER OF RECORDS.
-const unsigned long FRAM_ADDR_LOCO_REF       =   5120;  // Loco (train) Reference table.  MAS, OCC, and LEG.
-//                  TOTAL_TRAINS   = 50 (defined above) number of Loco Reference table records.
-const unsigned long FRAM_ADDR_SENSOR_ACTION  =  12714;  // Sensor Action table, for sure LEG, maybe also OCC for PA Announcements?
-const unsigned long FRAM_RECS_SENSOR_ACTION  =    200;  // Absolutely NO IDEA how many records, if any, will be in this file yet.
-
-const unsigned long FRAM_ADDR_ROUTE_REF      =  19114;  // Route Reference EB routes starting address, followed by WB. MAS/OCC/LEG.
-const unsigned int  FRAM_RECS_ROUTE_EAST     =     38;  // 38 "level 1 only" EB routes as of 01/16/22.
-const unsigned int  FRAM_RECS_ROUTE_WEST     =     36;  // 36 "level 1 only" WB routes as of 01/16/22.
+                                                        // Not scaled by LAYOUT_LEVELS; it's a property of the track plan.
+const unsigned int  FRAM_RECS_DEADLOCK       = DEADLOCKS_PER_LEVEL * LAYOUT_LEVELS;  // Deadlock table NUMBER OF RECORDS.
+const unsigned long FRAM_ADDR_LOCO_REF       = FRAM_ADDR_DEADLOCK + FRAM_BYTES_DEADLOCK;  // 5120.  Loco Reference.  MAS/OCC/LEG.
+const unsigned long FRAM_BYTES_LOCO_REF      =   7594;  // TOTAL_TRAINS records; doesn't depend on the size of the layout.
+const unsigned long FRAM_ADDR_SENSOR_ACTION  = FRAM_ADDR_LOCO_REF + FRAM_BYTES_LOCO_REF;  // 12714.  Sensor Action table, for sure
+const unsigned long FRAM_BYTES_SENSOR_ACTION =   6400UL * LAYOUT_LEVELS;                  // LEG, maybe also OCC for PA Announcements?
+const unsigned long FRAM_RECS_SENSOR_ACTION  =    200UL * LAYOUT_LEVELS;  // NO IDEA how many records, if any, will be in this file yet.
+
+const unsigned long FRAM_ADDR_ROUTE_REF      = FRAM_ADDR_SENSOR_ACTION + FRAM_BYTES_SENSOR_ACTION;  // 19114.  Route Reference EB
+const unsigned long FRAM_BYTES_ROUTE_REF     = 166912UL * LAYOUT_LEVELS;                            // routes, then WB. MAS/OCC/LEG.
+const unsigned int  FRAM_RECS_ROUTE_EAST     = ROUTES_EAST_PER_LEVEL * LAYOUT_LEVELS;  // 38 for one level.
+const unsigned int  FRAM_RECS_ROUTE_WEST     = ROUTES_WEST_PER_LEVEL * LAYOUT_LEVELS;  // 36 for one level.
+const unsigned int  FRAM_RECS_ROUTE_TOTAL    = FRAM_RECS_ROUTE_EAST + FRAM_RECS_ROUTE_WEST;  // 74 EB + WB routes, rec nums 0..73.
 // 12/21/22: Rather than define a fixed FRAM address where the WB route records start, we'll just calculate it in the
 // Route_Reference class, using: FRAM_ADDR_ROUTE_REF + (FRAM_RECS_ROUTE_EAST + sizeof(routeReferenceStruct)).
 // const unsigned int  FRAM_FIRST_EAST_ROUTE    =      0;  // Index (starting at 0) into FRAM Route Reference table where the first Eastbound route can be found.
 // const unsigned int  FRAM_FIRST_WEST_ROUTE    =    326;  // Index (starting at 326) into FRAM Route Reference table where the first Westbound route can be found.
 const byte          FRAM_SEGMENTS_ROUTE_REF  =     80;  // Route Reference max number of "routeElement" segments per route.  Used when defining routeReferenceStruct.
-const unsigned long FRAM_ADDR_MAS_LOG_FILE   = 186026;  // Address of the two-byte "next byte to write" in the log file.  Each record will need to include locoNum + routeElement.
+const unsigned long FRAM_ADDR_MAS_LOG_FILE   = FRAM_ADDR_ROUTE_REF + FRAM_BYTES_ROUTE_REF;  // 186026.  Event_Journal 6-byte
+                                                        // header, followed by the ring of 12-byte records.  MAS/LEG.
+const unsigned long FRAM_BYTES_MAS_LOG_FILE  =  98310;  // 6-byte header + 8192 12-byte records; ends at 284336 with one level.
+const unsigned long FRAM_ADDR_TOP            = 524287;  // Top writable address of our 512K FRAM.
+
+static_assert((BLOCKS_PER_LEVEL * LAYOUT_LEVELS < 255) && (TURNOUTS_PER_LEVEL * LAYOUT_LEVELS < 255) &&
+              (SENSORS_PER_LEVEL * LAYOUT_LEVELS < 255), "Block, turnout and sensor numbers must fit in one byte; see LAYOUT SIZE.");
+static_assert(FRAM_ADDR_MAS_LOG_FILE + FRAM_BYTES_MAS_LOG_FILE - 1 <= FRAM_ADDR_TOP, "FRAM tables don't fit in FRAM; see LAYOUT SIZE.");
+
+// *** LAYOUT BIT MASKS ***
+// Layout_Bitmap<N> has one bit for each item 1..N (i.e. blocks or turnouts), used to compare a route against every reservation
+// in one pass (see Route_Reference::routeIsClear().)  It's stored as unsigned longs, so with one level blockBitmap and
+// turnoutBitmap are each a single unsigned long and compile to the same few instructions as the plain unsigned long we used
+// before; a bigger layout just adds a word and a loop.  Numbers outside 1..N are ignored by set().
+template <unsigned int BITS> class Layout_Bitmap {
+
+  public:
+
+    Layout_Bitmap() {
+      clear();
+    }
+    void clear() {
+      for (byte i = 0; i < WORDS; i++) {
+        m_word[i] = 0;
+      }
+    }
+    void set(const byte t_num) {  // t_num is 1..BITS
+      if ((t_num >= 1) && (t_num <= BITS)) {
+        m_word[(t_num - 1) / 32] |= (1UL << ((t_num - 1) % 32));
+      }
+    }
+    bool isSet(const byte t_num) const {
+      return ((t_num >= 1) && (t_num <= BITS) && ((m_word[(t_num - 1) / 32] & (1UL << ((t_num - 1) % 32))) != 0));
+    }
+    bool intersects(const Layout_Bitmap& t_other) const {  // True if any item is set in both
+      for (byte i = 0; i < WORDS; i++) {
+        if ((m_word[i] & t_other.m_word[i]) != 0) {
+          return true;
+        }
+      }
+      return false;
+    }
+    void add(const Layout_Bitmap& t_other) {  // Set every item that's set in t_other
+      for (byte i = 0; i < WORDS; i++) {
+        m_word[i] |= t_other.m_word[i];
+      }
+    }
+    void remove(const Layout_Bitmap& t_other) {  // Clear every item that's set in t_other
+      for (byte i = 0; i < WORDS; i++) {
+        m_word[i] &= ~t_other.m_word[i];
+      }
+    }
+
+  private:
+
+    static const byte WORDS = (BITS + 31) / 32;
+    unsigned long m_word[WORDS];
+
+};
+typedef Layout_Bitmap<TOTAL_BLOCKS>   blockBitmap;    // 4 bytes with one level
+typedef Layout_Bitmap<TOTAL_TURNOUTS> turnoutBitmap;  // 4 bytes with one level
 
 // *** DELAYED-ACTION-RELATED CONSTS ***
 const          int  HEAP_RECS_DELAYED_ACTION =   1000;  // int vs unsigned int because we compare it to values that can be negative; eliminates compiler warnings
@@ -254,7 +349,9 @@ const byte TMCC_DIALOGUE_CONDUCTOR_DEPARTURE     = 4;  // 3 bytes: 2.      When
 const byte TMCC_DIALOGUE_CONDUCTOR_TICKETS_DINER = 5;  // 3 bytes: 2.      When MOVING: Conductor says "Welcome aboard/Tickets please/1st seating."
 const byte TMCC_DIALOGUE_CONDUCTOR_STOPPING      = 6;  // 6 bytes: Aux1+2. When MOVING: Conductor says "Next stop coming up."
 
-const byte LEGACY_CMD_DELAY           =  30;  // ms for Engineer to wait between successive 3-byte Legacy or TMCC cmds going out the serial port.
+const byte LEGACY_CMD_SPACING         =  25;  // ms from the first byte of one cmd to the first byte of the next; the Legacy base
+                                              // ignores cmds closer than ~25ms.  Leaves ~22ms after a 3-byte cmd, ~16ms after 9 bytes.
+const byte LEGACY_CMD_URGENT_RECS     =  10;  // Engineer urgent lane (Stop Immed, Emergency Stop, PowerMasters) jumps ahead of the rest.
 const byte LEGACY_CMD_BYTES           =   9;  // Element size is always 9 bytes to hold largest possible Legacy command.
 const int  LEGACY_CMD_HEAP_RECS       = 100;  // How many struct elements in the Engineer Legacy Command buffer (9 bytes/element)
 const byte LOCO_ID_NULL               =   0;  // Used for "no train."
@@ -311,6 +408,9 @@ const char ROUTE_TYPE_CONTINUATION    = 'C';  // This is a route that will be ad
 
 const char TURNOUT_DIR_NORMAL         = 'N';
 const char TURNOUT_DIR_REVERSE        = 'R';
+// SWT energizes up to this many turnout solenoids at once, and LED updates this many turnout LEDs at a time to match.  Must not
+// exceed the number of solenoids our turnout power supply can hold at once.  Set it to 1 to return to one-at-a-time.
+const byte TURNOUTS_TO_FIRE_AT_ONCE   =   3;
 
 // Serial port speed
 // 6/5/22: These should really be i.e. SERIAL_SPEED_MONITOR, SERIAL_SPEED_2004LCD, SERIAL_SPEED_RS485, SERIAL_SPEED_LEGACY_BASE
@@ -331,6 +431,15 @@ const byte RS485_TO_OFFSET   =  2;        // third byte of message is the ID of
 const byte RS485_TYPE_OFFSET =  3;        // fourth byte of message is the type of message such as M for Mode, S for Smoke, etc.
 // Note also that the LAST byte of every message is a CRC8 checksum of all bytes except the last.
 
+// RS485 BUS ARBITRATION: By default, BTN and SNS pull a digital RTS line low and MAS grants the bus.  If RS485_POLLED_BUS is true,
+// MAS instead polls each module in Message's poll list in turn, one every RS485_POLL_CYCLE_MS / RS485_POLL_NUM_MODULES ms, so
+// every module is guaranteed a chance to transmit at least once per cycle without any RTS wiring.  ALL MODULES MUST BE COMPILED
+// WITH THE SAME SETTING, which is why it lives here rather than in Message.h.
+const bool          RS485_POLLED_BUS            = false;  // false = digital RTS lines (original); true = MAS polls in time slots.
+const unsigned long RS485_POLL_CYCLE_MS         =    20;  // Every module in the poll list gets a transmit slot this often.
+const unsigned long RS485_POLL_REPLY_TIMEOUT_MS =     5;  // Max time a polled module owns the bus before MAS moves on.
+const byte          RS485_POLL_NUM_MODULES      =     2;  // Number of modules in Message's poll list (SNS and BTN.)
+
 // These RS485 message offsets are specific to individual modules (though all are used by O-MAS).
 // The 3-char name refers to FROM, TO, and MESSAGE TYPE.
 // Confirmed okay as of 03/03/23.
@@ -353,6 +462,9 @@ const byte RS485_MAS_ALL_SET_TURNOUT_DIR_OFFSET    =  5;  // char N|R
 const byte RS485_MAS_SNS_SENSOR_NUM_OFFSET         =  4;  // byte 1..52
 const byte RS485_SNS_ALL_SENSOR_NUM_OFFSET         =  4;  // byte 1..52
 const byte RS485_SNS_ALL_SENSOR_TRIP_CLEAR_OFFSET  =  5;  // char T|C
+const byte RS485_MAS_ANY_HEALTH_PAGE_OFFSET        =  4;  // byte 0..2 which page of bus statistics MAS is requesting
+const byte RS485_ANY_MAS_HEALTH_PAGE_OFFSET        =  4;  // byte 0..2 which page of bus statistics is being returned
+const byte RS485_ANY_MAS_HEALTH_DATA_OFFSET        =  5;  // 14 bytes of statistics; layout depends on page (see Message.cpp)
 
 // *** ARDUINO PIN NUMBERS:
 // *** STANDARD I/O PORT PIN NUMBERS ***
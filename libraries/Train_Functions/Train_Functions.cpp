@@ -1,11 +1,27 @@
-// TRAIN_FUNCTIONS.CPP Rev: 05/23/24.
+// TRAIN_FUNCTIONS.CPP Rev: 10/19/26.
 // Declares and defines several functions that are global to all (or nearly all) Arduino modules.
+// 10/19/26: endWithFlashingLED() flushes any LCD lines still queued (Display_2004 queued mode) so the error message is shown.
+// 10/19/26: Added arenaAllocate() and memoryMap(): QuadRAM and internal SRAM arenas for long-lived tables, and a boot memory map.
+// 10/19/26: Added paintFreeMemory(), noteHeapUsed() and memoryReport(): stack and heap high-water marks, internal and QuadRAM.
+// 10/19/26: haltIfHaltPinPulledLow() and endWithFlashingLED() flush FRAM's write-back cache (if enabled) via pFlushBeforeHalt.
 // 05/23/24: Always digitalWrite(pin, LOW) before pinMode(pin, OUTPUT) else will write high briefly.
 // 04/15/24: Increased the False Halt delay from 1ms to 5ms; was getting too many false halts when pressing turnout buttons.
 // 06/30/22: Removed pinMode and digitalWrite for FRAM; we'll do that in Hackscribble_Ferro class.
 
 #include "Train_Functions.h"
 
+void (*pFlushBeforeHalt)() = nullptr;  // Set by FRAM::enableWriteCache()
+
+static void flushBeforeHalt() {
+  // Clear the pointer before calling it, in case the flush itself fails and calls endWithFlashingLED().
+  void (*pFlush)() = pFlushBeforeHalt;
+  pFlushBeforeHalt = nullptr;
+  if (pFlush != nullptr) {
+    pFlush();
+  }
+  return;
+}
+
 void initializePinIO() {
 
   // First we'll set up pins that are appropriate for all modules.
@@ -140,6 +156,7 @@ void haltIfHaltPinPulledLow() {
         pShiftRegister->initializePinsForOutput();  // SWT: Release all relay coils that might be activating turnout solenoids
         wdt_disable();  // No longer need WDT since solenoids are released and we are terminating program here.
       }
+      flushBeforeHalt();  // Trains and relays are taken care of; now save anything FRAM's write-back cache hasn't written yet
       chirp();
       sprintf(lcdString, "HALT PIN LOW!");
       pLCD2004->println(lcdString);
@@ -165,6 +182,10 @@ void endWithFlashingLED(int t_numFlashes) {  // Works for all modules, including
   }
   // The rest of the function applies to all modules including MAS, SNS, OCC, LED, and BTN:
   requestEmergencyStop();
+  flushBeforeHalt();  // Save anything FRAM's write-back cache hasn't written yet
+  if (pLCD2004 != nullptr) {
+    pLCD2004->flush();  // If we're in Auto/Park, the error message (and what led up to it) may still be waiting in the LCD queue
+  }
   // Infinite loop:
   while (true) {
     for (int i = 1; i <= t_numFlashes; i++) {
@@ -319,3 +340,243 @@ unsigned int freeMemory () {  // Excellent little utility that returns the amoun
 
   return (unsigned int)(SP - (int)&__bss_end);
 }
+
+// *** MEMORY HIGH-WATER MARKS ***
+// See Train_Functions.h.  Memory map with QuadRAM (see initializeQuadRAM()):
+//   0x2200..0xFFFF QuadRAM:  heap grows up from __malloc_heap_start; painted from the heap top to __malloc_heap_end.  The
+//                            QuadRAM arena sits above __malloc_heap_end.
+//   0x0200..0x21FF Internal: .data and .bss (globals) up to __bss_end, then the internal arena; painted from there to just below
+//                            the stack, which grows down from RAMEND.  Without QuadRAM, the heap sits between the globals and the
+//                            stack, and we paint from the heap top instead.
+const byte MEMORY_PAINT        = 0xC5;  // Not 0x00 or 0xFF, which the stack and heap are full of.
+const byte MEMORY_STACK_MARGIN =   64;  // Don't paint the top of the stack; paintFreeMemory() and its callers are using it.
+const byte MEMORY_NOTES_MAX    =   16;  // LEG calls noteHeapUsed() the most, 14 times.
+
+struct memoryNoteStruct {
+  const __FlashStringHelper* name;  // i.e. F("Train_Progress")
+  unsigned int bytes;
+};
+static memoryNoteStruct* memoryNotes = nullptr;  // On the heap, so it doesn't cost internal SRAM when we have QuadRAM.
+static byte memoryNotesCount = 0;
+static char* memoryHeapPainted = nullptr;        // Heap top when we painted; everything below it was already in use.
+static char* memoryHeapNoted = nullptr;          // Heap top at the previous noteHeapUsed().
+
+extern void* __brkval;          // Top of heap per avr-libc malloc(), or 0 if nothing has been allocated yet.
+extern unsigned int __bss_end;  // Top of global data.
+extern unsigned int __data_start;
+
+static char* heapTop() {
+  return (__brkval == 0) ? __malloc_heap_start : (char*)__brkval;
+}
+
+static bool heapIsExternal() {  // True once initializeQuadRAM() has moved the heap.
+  return ((unsigned int)__malloc_heap_start > RAMEND);
+}
+
+static char* arenaInternalTop = nullptr;  // First byte above the internal arena; nullptr until the first ARENA_INTERNAL block.
+
+static char* internalFreeBottom() {  // Lowest internal SRAM address the stack could grow down to.
+  if (!heapIsExternal()) {
+    return heapTop();
+  }
+  return (arenaInternalTop == nullptr) ? (char*)&__bss_end : arenaInternalTop;
+}
+
+void paintFreeMemory() {
+  // Rev: 10/19/26.
+  memoryNotes = new memoryNoteStruct[MEMORY_NOTES_MAX];
+  memoryNotesCount = 0;
+  memoryHeapPainted = heapTop();
+  memoryHeapNoted = memoryHeapPainted;
+  char* stackLimit = (char*)(SP - MEMORY_STACK_MARGIN);
+  for (char* p = internalFreeBottom(); p < stackLimit; p++) {
+    *p = MEMORY_PAINT;
+  }
+  if (heapIsExternal()) {
+    for (char* p = memoryHeapPainted; p < __malloc_heap_end; p++) {
+      *p = MEMORY_PAINT;
+    }
+  }
+  return;
+}
+
+void noteHeapUsed(const __FlashStringHelper* t_name) {
+  // Rev: 10/19/26.  Charges t_name with all heap allocated since the previous call, including malloc's 2-byte header for each
+  // allocation (it's heap we can't use either.)  So call it right after an object's new *and* begin(), since many begin()s
+  // allocate their tables.
+  if ((memoryNotes == nullptr) || (memoryNotesCount >= MEMORY_NOTES_MAX)) {
+    return;  // memoryReport() lumps anything we didn't note under "Not itemized."
+  }
+  char* top = heapTop();
+  memoryNotes[memoryNotesCount].name = t_name;
+  memoryNotes[memoryNotesCount].bytes = (top > memoryHeapNoted) ? (unsigned int)(top - memoryHeapNoted) : 0;
+  memoryNotesCount++;
+  memoryHeapNoted = top;
+  return;
+}
+
+void memoryReport() {
+  // Rev: 10/19/26.
+  if (memoryNotes == nullptr) {
+    Serial.println(F("No memory report; setup() did not call paintFreeMemory()."));
+    return;
+  }
+  // The first unpainted byte above the globals/heap is the deepest the stack has ever reached.
+  char* freeBottom = internalFreeBottom();
+  char* stackDeepest = freeBottom;
+  while ((stackDeepest < (char*)SP) && (*stackDeepest == MEMORY_PAINT)) {
+    stackDeepest++;
+  }
+  Serial.println(F("==================== MEMORY REPORT ==================="));
+  Serial.print  (F("Globals (.data + .bss)              = ")); Serial.println((unsigned int)&__bss_end - (unsigned int)&__data_start);
+  Serial.print  (F("Stack now                           = ")); Serial.println(RAMEND - SP);
+  Serial.print  (F("Stack high-water                    = ")); Serial.println(RAMEND - (unsigned int)stackDeepest + 1);
+  Serial.print  (F("  INTERNAL SRAM NEVER USED ---------> ")); Serial.println((unsigned int)(stackDeepest - freeBottom));
+  char* top = heapTop();
+  char* heapHighest = top;
+  if (heapIsExternal()) {
+    // The highest unpainted byte in QuadRAM is the highest the heap has ever reached, even if it's since been freed.
+    char* p = __malloc_heap_end;
+    while ((p > top) && (*(p - 1) == MEMORY_PAINT)) {
+      p--;
+    }
+    heapHighest = p;
+    Serial.println(F("Heap is in QuadRAM"));
+  } else {
+    Serial.println(F("Heap is in internal SRAM (high-water is current size)"));
+  }
+  Serial.print  (F("Heap now                            = ")); Serial.println((unsigned int)(top - __malloc_heap_start));
+  Serial.print  (F("Heap high-water                     = ")); Serial.println((unsigned int)(heapHighest - __malloc_heap_start));
+  if (heapIsExternal()) {
+    Serial.print(F("  QUADRAM NEVER USED ---------------> ")); Serial.println((unsigned int)(__malloc_heap_end - heapHighest));
+  }
+  Serial.println(F("Heap by object (incl. 2-byte headers):"));
+  Serial.print  (F("  Before paintFreeMemory()          = ")); Serial.println((unsigned int)(memoryHeapPainted - __malloc_heap_start));
+  long itemized = 0;
+  for (byte i = 0; i < memoryNotesCount; i++) {
+    Serial.print(F("  ")); Serial.print(memoryNotes[i].name);
+    for (byte j = strlen_P((const char*)memoryNotes[i].name); j < 34; j++) {
+      Serial.print(' ');
+    }
+    Serial.print(F("= ")); Serial.println(memoryNotes[i].bytes);
+    itemized += memoryNotes[i].bytes;
+  }
+  Serial.print  (F("  Not itemized                      = ")); Serial.println((long)(top - memoryHeapPainted) - itemized);
+  Serial.println(F("Arena blocks are not on the heap; see memoryMap()."));
+  Serial.println(F("======================================================"));
+  return;
+}
+
+// *** MEMORY ARENAS ***
+// See Train_Functions.h.  The QuadRAM arena grows down from XMEM_END and the heap grows up from XMEM_START; the boundary between
+// them is __malloc_heap_end, which malloc() will never go past.
+const byte         ARENA_HEAP           =    2;  // Recorded in place of t_arena when there's no QuadRAM.
+const byte         ARENA_ALIGN          =    4;  // AVR doesn't need it, but it's free and keeps addresses tidy in the memory map.
+const unsigned int ARENA_INTERNAL_BYTES =  512;  // Most internal SRAM we'll take from the stack for ARENA_INTERNAL.
+const unsigned int ARENA_LOW_BYTES      = 4096;  // memoryMap() warns if less QuadRAM than this is left for the heap.
+const byte         ARENA_REGIONS_MAX    =   12;
+
+struct arenaRegionStruct {
+  const __FlashStringHelper* name;  // i.e. F("Train Progress")
+  char* start;
+  unsigned int bytes;
+  byte arena;                       // ARENA_QUADRAM, ARENA_INTERNAL, or ARENA_HEAP
+};
+static arenaRegionStruct* arenaRegions = nullptr;  // On the heap, like memoryNotes.
+static byte arenaRegionsCount = 0;
+
+void* arenaAllocate(const __FlashStringHelper* t_name, const unsigned int t_bytes, const byte t_arena) {
+  // Rev: 10/19/26.
+  if (arenaRegions == nullptr) {
+    arenaRegions = new arenaRegionStruct[ARENA_REGIONS_MAX];
+  }
+  char* block = nullptr;
+  byte arena = t_arena;
+  if (!heapIsExternal()) {
+    arena = ARENA_HEAP;
+    block = (char*)malloc(t_bytes);
+  } else {
+    if (arena == ARENA_INTERNAL) {
+      char* internalEnd = (char*)&__bss_end + ARENA_INTERNAL_BYTES;
+      char* start = (arenaInternalTop == nullptr) ? (char*)&__bss_end : arenaInternalTop;
+      start = (char*)(((unsigned int)start + (ARENA_ALIGN - 1)) & ~(ARENA_ALIGN - 1));
+      if ((start < internalEnd) && (t_bytes <= (unsigned int)(internalEnd - start))) {
+        block = start;
+        arenaInternalTop = start + t_bytes;
+      } else {
+        arena = ARENA_QUADRAM;  // Slower, but better than taking it from the stack.
+      }
+    }
+    if (arena == ARENA_QUADRAM) {
+      char* top = heapTop();
+      if (t_bytes + ARENA_ALIGN <= (unsigned int)(__malloc_heap_end - top)) {
+        block = (char*)(((unsigned int)__malloc_heap_end - t_bytes) & ~(ARENA_ALIGN - 1));
+        __malloc_heap_end = block;  // malloc() can't have gone past top, so it will never reach our block now.
+      }
+    }
+  }
+  if (block == nullptr) {
+    sprintf(lcdString, "ARENA FULL %u", t_bytes); pLCD2004->println(lcdString); Serial.print(t_name); Serial.print(F(": "));
+    Serial.println(lcdString); endWithFlashingLED(1);
+  }
+  if (arenaRegionsCount < ARENA_REGIONS_MAX) {  // Otherwise memoryMap() just won't list it.
+    arenaRegions[arenaRegionsCount].name = t_name;
+    arenaRegions[arenaRegionsCount].start = block;
+    arenaRegions[arenaRegionsCount].bytes = t_bytes;
+    arenaRegions[arenaRegionsCount].arena = arena;
+    arenaRegionsCount++;
+  }
+  return block;
+}
+
+static void memoryMapLine(const char* t_start, const char* t_end, const __FlashStringHelper* t_name) {
+  // One line of the memory map: first and last address in hex, size in bytes, and what's there.
+  if (t_end <= t_start) {
+    return;
+  }
+  char line[30];
+  sprintf(line, "  %04X..%04X %6u  ", (unsigned int)t_start, (unsigned int)t_end - 1, (unsigned int)(t_end - t_start));
+  Serial.print(line); Serial.println(t_name);
+  return;
+}
+
+static void memoryMapRegions(const byte t_arena, const bool t_descending) {
+  // QuadRAM blocks were carved top-down, so list them in reverse to keep the map in address order.
+  for (byte i = 0; i < arenaRegionsCount; i++) {
+    const byte r = t_descending ? (arenaRegionsCount - 1 - i) : i;
+    if (arenaRegions[r].arena == t_arena) {
+      memoryMapLine(arenaRegions[r].start, arenaRegions[r].start + arenaRegions[r].bytes, arenaRegions[r].name);
+    }
+  }
+  return;
+}
+
+void memoryMap() {
+  // Rev: 10/19/26.  Addresses in hex, sizes in decimal, lowest address first.
+  Serial.println(F("===================== MEMORY MAP ====================="));
+  Serial.println(F("Internal SRAM:"));
+  memoryMapLine((char*)&__data_start, (char*)&__bss_end, F("Globals (.data + .bss)"));
+  if (heapIsExternal()) {
+    memoryMapRegions(ARENA_INTERNAL, false);
+  } else {
+    memoryMapLine(__malloc_heap_start, heapTop(), F("Heap"));
+    memoryMapRegions(ARENA_HEAP, false);  // These are inside the heap, not after it.
+  }
+  memoryMapLine(internalFreeBottom(), (char*)SP + 1, F("FREE for stack"));
+  memoryMapLine((char*)SP + 1, (char*)RAMEND + 1, F("Stack now"));
+  if (heapIsExternal()) {
+    Serial.println(F("QuadRAM:"));
+    memoryMapLine(__malloc_heap_start, heapTop(), F("Heap"));
+    memoryMapLine(heapTop(), __malloc_heap_end, F("FREE for heap"));
+    memoryMapRegions(ARENA_QUADRAM, true);
+    const unsigned int heapFree = (unsigned int)(__malloc_heap_end - heapTop());
+    if (heapFree < ARENA_LOW_BYTES) {
+      sprintf(lcdString, "QUADRAM LOW %u", heapFree); pLCD2004->println(lcdString); Serial.println(lcdString);
+    }
+  }
+  if (arenaRegionsCount >= ARENA_REGIONS_MAX) {
+    Serial.println(F("(More arena blocks than ARENA_REGIONS_MAX; not all are listed.)"));
+  }
+  Serial.println(F("======================================================"));
+  return;
+}
@@ -1,4 +1,7 @@
-// TRAIN_FUNCTIONS.H Rev: 02/28/23.
+// TRAIN_FUNCTIONS.H Rev: 10/19/26.
+// 10/19/26: Added arenaAllocate() and memoryMap(): named, never-freed blocks for long-lived tables, and a boot memory map.
+// 10/19/26: Added paintFreeMemory(), noteHeapUsed() and memoryReport() for stack and heap high-water marks.
+// 10/19/26: Added pFlushBeforeHalt so FRAM's write-back cache can be flushed by haltIfHaltPinPulledLow() and endWithFlashingLED().
 // Not a class, just a group of functions -- but must be #included in every Trains program.
 // Declares and defines several functions that are global to all (or nearly all) Arduino modules.
 // Any non-const global variables should be declared here as extern, and defined in the .ino or .cpp file.
@@ -41,6 +44,10 @@ extern Centipede* pShiftRegister;  // Needed to release SWT Turnout and LEG Acce
 
 extern void wdt_disable();  // Used by SWT to release all turnout solenoids in haltIfHaltPinPulledLow()
 
+// If a module enables FRAM's write-back cache, FRAM points this at a function that writes any unsaved data to FRAM.  We can't
+// call FRAM directly from here because not every module has FRAM (see pStorage note above.)  nullptr if there's nothing to flush.
+extern void (*pFlushBeforeHalt)();
+
 void initializePinIO();
 void haltIfHaltPinPulledLow();
 void endWithFlashingLED(int t_numFlashes);
@@ -86,4 +93,32 @@ unsigned writeBit(unsigned t_val, byte t_bit, byte t_bitVal);
 
 unsigned int freeMemory ();  // Excellent little utility that returns the amount of unused SRAM.
 
+// MEMORY HIGH-WATER MARKS.  freeMemory() only tells us what's free right now; these tell us how close we've ever come.
+// Call paintFreeMemory() in setup() right after initializeQuadRAM(), before any "new".  It fills the unused internal SRAM between
+// our globals (or internal heap) and the stack, and the unused QuadRAM heap, with MEMORY_PAINT.  Whatever the stack or heap ever
+// overwrites is gone for good, so memoryReport() can later scan for the deepest the stack has been and the highest the heap has
+// reached, no matter when it happened.
+// Call noteHeapUsed(F("Train_Progress")) after each new/begin() pair in setup() to record how much heap that object took; the
+// report lists them, which is how we size HEAP_RECS_* and the like from data rather than guesswork.
+// memoryReport() prints to Serial only, and takes roughly 10ms to scan QuadRAM, so only call it while STOPPED.
+void paintFreeMemory();
+void noteHeapUsed(const __FlashStringHelper* t_name);
+void memoryReport();
+
+// MEMORY ARENAS.  Train Progress, Delayed Action, the Engineer's buffers etc. are allocated once in setup() and never freed, so
+// rather than "new" them onto the heap among everything else, their classes ask for a named block from one of two arenas:
+//   ARENA_QUADRAM:  Big tables.  Carved down from the top of QuadRAM, lowering __malloc_heap_end as we go, so the heap (which grows
+//                   up from the bottom of QuadRAM) can never run into them and they can't be fragmented by it.
+//   ARENA_INTERNAL: Small structures we touch every pass through loop().  Carved up from the top of our globals in internal SRAM,
+//                   which saves a clock cycle on every access vs. QuadRAM.  Limited to ARENA_INTERNAL_BYTES so the stack keeps
+//                   the rest; anything that won't fit goes in QuadRAM instead.
+// Blocks are aligned to ARENA_ALIGN bytes.  If there's no QuadRAM (heap in internal SRAM), blocks come from the heap via malloc().
+// Running out of room is a fatal error at boot, rather than a nullptr that bites us later.
+// Call memoryMap() at the end of setup() to send the layout of internal SRAM and QuadRAM, and every named block, to Serial.  It
+// also warns on the LCD if less than ARENA_LOW_BYTES of QuadRAM is left for the heap.
+const byte ARENA_QUADRAM  = 0;
+const byte ARENA_INTERNAL = 1;
+void* arenaAllocate(const __FlashStringHelper* t_name, const unsigned int t_bytes, const byte t_arena);
+void memoryMap();
+
 #endif
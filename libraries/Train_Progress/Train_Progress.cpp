@@ -1,5 +1,8 @@
-// TRAIN_PROGRESS.CPP Rev: 08/07/24.  SOME UTILITY FUNCTIONS WORKING SO FAR BUT NOT TESTED ****************************************************************************************
+// TRAIN_PROGRESS.CPP Rev: 10/19/26.  SOME UTILITY FUNCTIONS WORKING SO FAR BUT NOT TESTED ****************************************************************************************
 // Part of O_MAS, O_OCC, and O_LEG.
+// 10/19/26: The Train Progress table comes from the QuadRAM arena rather than "new"; see arenaAllocate().
+// 10/19/26: getBlockView() returns blockBitmaps.
+// 10/19/26: Added blockViewChanged() and getBlockView() for OCC incremental block LED painting.
 // IMPORTANT: This class expects t_locoNum to always be passed and returned 1..50, but corresponding Train Progress class array
 // elements are internally stored in array elements 0..49.
 // So beware of bugs due to pTrainProgress[0..TOTAL_TRAINS - 1] rather than [1..TOTAL_TRAINS].
@@ -14,7 +17,7 @@
 #include "Train_Progress.h"
 
 Train_Progress::Train_Progress() {   // Constructor
-  // Rev: 04/11/24.
+  // Rev: 10/19/26.
   // HEAP STORAGE: We want the PRIVATE 50-element trainProgress[] structure array to reside on the HEAP.  We will allocate
   // the memory using "new" in the constructor, and point our private pointer at it.
   // The calling .INO program defines a pointer pTrainProgress (via new) to a Train_Progress class instance.
@@ -25,7 +28,9 @@ Train_Progress::Train_Progress() {   // Constructor
   // I.e. the following defines an array that is part of a single class instance; it's not creating multiple class instances.
   // And it doesn't matter if we create this array with "new" or just as a "static" array because all of the class data is already
   // defined to be on the heap.
-  m_pTrainProgress = new trainProgressStruct[TOTAL_TRAINS];  // i.e. One Train Progress table for each of 50 locos = 0..49
+  // 10/19/26: Now a named, never-freed block at the top of QuadRAM rather than "new", so it's out of the way of the heap.
+  m_pTrainProgress = (trainProgressStruct*)arenaAllocate(F("Train Progress"), sizeof(trainProgressStruct) * TOTAL_TRAINS,
+                                                         ARENA_QUADRAM);  // i.e. One Train Progress table for each of 50 locos
   // NOTE FOR TESTING: SINCE WE'RE INSTANTIATING TRAIN PROGRESS ON THE HEAP (WITH "NEW") IN THE CALLING .INO PROGRAM, THE
   // ENTIRE CLASS OBJECT WILL RESIDE ON THE HEAP.  SO WE SHOULD BE ABLE TO ACCESS IT AS A REGULAR ARRAY AND SRAM USAGE SHOULD
   // BE EXACTLY THE SAME AS USING EITHER OF THESE STATEMENTS:
@@ -79,6 +84,7 @@ void Train_Progress::resetTrainProgress(const byte t_locoNum) {
   m_pTrainProgress[m_trainProgressLocoTableNum].crawlPtr = 0;
   m_pTrainProgress[m_trainProgressLocoTableNum].stopPtr = 0;
   m_pTrainProgress[m_trainProgressLocoTableNum].lastTrippedPtr = 0;
+  m_pTrainProgress[m_trainProgressLocoTableNum].blockViewChanged = true;
   for (byte routeElement = 0; routeElement < HEAP_RECS_TRAIN_PROGRESS; routeElement++) {  // 0..139 if max 140 route elements.xxxxx
       m_pTrainProgress[m_trainProgressLocoTableNum].route[routeElement].routeRecType = ER;
       m_pTrainProgress[m_trainProgressLocoTableNum].route[routeElement].routeRecVal = 0;
@@ -148,6 +154,7 @@ void Train_Progress::setInitialRoute(const byte t_locoNum, const routeElement t_
   m_pTrainProgress[m_trainProgressLocoTableNum].crawlPtr = 2;
   m_pTrainProgress[m_trainProgressLocoTableNum].stopPtr = 5;
   m_pTrainProgress[m_trainProgressLocoTableNum].lastTrippedPtr = 5;
+  m_pTrainProgress[m_trainProgressLocoTableNum].blockViewChanged = true;
 
   // Element 0 VL00 must always be a Velocity zero command.
   m_pTrainProgress[m_trainProgressLocoTableNum].route[0].routeRecType = VL;  // Velocity zero
@@ -264,12 +271,12 @@ byte Train_Progress::locoThatClearedSensor(const byte t_sensorNum) {
 }
 
 bool Train_Progress::timeToStartLoco(const byte t_locoNum) {
+  // Rev: 10/19/26.  Comparison was backwards (true until the start time, not after it) and not safe across millis() rollover.
   // Rev: 08/03/24.  NOT YET TESTED
-  // Returns true if "timeToStart" > millis()
-  // Counterintuitively, this function is called by MAS (not LEG!) to decide when to get a loco moving -- MAS will send a "sensor
-  // tripped" message to OCC and LEG when it wants it to start moving.
+  // Returns true if millis() has reached "timeToStart".
+  // Called by LEG's Conductor::evaluateLoco() to decide when a stopped loco with an Extension route may get moving.
   m_trainProgressLocoTableNum = t_locoNum - 1;  // m_trainProgressLocoTableNum 0..49 == t_locoNum 1..50
-  if (m_pTrainProgress[m_trainProgressLocoTableNum].timeToStart > millis()) {
+  if ((long)(millis() - m_pTrainProgress[m_trainProgressLocoTableNum].timeToStart) >= 0) {  // Rollover-safe
     return true;  // Yep, it's okay to get this loco moving!
   } else {
     return false;  // No, we don't want to start this loco yet
@@ -453,6 +460,7 @@ void Train_Progress::setActive(const byte t_locoNum, const bool t_active) {
   // For inactive, set t_active = false
   m_trainProgressLocoTableNum = t_locoNum - 1;  // m_trainProgressLocoTableNum 0..49 == t_locoNum 1..50
   m_pTrainProgress[m_trainProgressLocoTableNum].isActive = t_active;
+  m_pTrainProgress[m_trainProgressLocoTableNum].blockViewChanged = true;
   return;
 }
 
@@ -542,6 +550,52 @@ bool Train_Progress::blockOccursAgainInRoute(const byte t_locoNum, const byte t_
   return false;
 }
 
+bool Train_Progress::blockViewChanged(const byte t_locoNum) {
+  // Rev: 10/19/26.
+  m_trainProgressLocoTableNum = t_locoNum - 1;  // m_trainProgressLocoTableNum 0..49 == t_locoNum 1..50
+  return m_pTrainProgress[m_trainProgressLocoTableNum].blockViewChanged;
+}
+
+void Train_Progress::getBlockView(const byte t_locoNum, blockBitmap* t_reservedBlocks, blockBitmap* t_occupiedBlocks) {
+  // Rev: 10/19/26.  Moved here from Occupancy_LEDs::paintAllBlockOccupancyLEDs().
+  // 1. All blocks between TAIL and NEXT-TO-TRIP are Occupied.  This works even if the loco is between sensors within a block.
+  // 2. All blocks between NEXT-TO-TRIP and HEAD are Reserved (but not Occupied.)
+  // TAIL, NEXT-TO-TRIP, and HEAD pointers are guaranteed never to point to Block elements.
+  // There is a potential problem if a block occurs more than once in a Route, one occurrence might be occupied and the other just
+  // reserved.  Occupied wins, so we clear any Reserved bit for a block that is also Occupied.
+  if (outOfRangeLocoNum(t_locoNum)) {
+    sprintf(lcdString, "T.P. LOCONUM ERR 10"); pLCD2004->println(lcdString); endWithFlashingLED(5);
+  }
+  m_trainProgressLocoTableNum = t_locoNum - 1;  // m_trainProgressLocoTableNum 0..49 == t_locoNum 1..50
+  m_pTrainProgress[m_trainProgressLocoTableNum].blockViewChanged = false;
+  t_reservedBlocks->clear();
+  t_occupiedBlocks->clear();
+  if (!m_pTrainProgress[m_trainProgressLocoTableNum].isActive) {
+    return;
+  }
+  byte nextToTripPointer = m_pTrainProgress[m_trainProgressLocoTableNum].nextToTripPtr;
+  byte tailPointer       = m_pTrainProgress[m_trainProgressLocoTableNum].tailPtr;
+  bool foundNextToTrip = false;  // Becomes true when working pointer reaches nextToTripPtr; blocks change from Reserved to Occupied.
+  // Since HEAD does not point to *any* type of element, we'll start at the first element behind it and work back to TAIL.
+  byte workingPointer = decrementTrainProgressPtr(m_pTrainProgress[m_trainProgressLocoTableNum].headPtr);
+  while (workingPointer != tailPointer) {
+    if (workingPointer == nextToTripPointer) {
+      foundNextToTrip = true;
+    }
+    routeElement thisElement = m_pTrainProgress[m_trainProgressLocoTableNum].route[workingPointer];
+    if ((thisElement.routeRecType == BE) || (thisElement.routeRecType == BW)) {
+      if (foundNextToTrip == false) {  // Still a RESERVED element; not yet occupied.
+        t_reservedBlocks->set(thisElement.routeRecVal);
+      } else {  // We are behind nextToTrip and thus this block is OCCUPIED
+        t_occupiedBlocks->set(thisElement.routeRecVal);
+      }
+    }
+    workingPointer = decrementTrainProgressPtr(workingPointer);
+  }
+  t_reservedBlocks->remove(*t_occupiedBlocks);
+  return;
+}
+
 bool Train_Progress::turnoutOccursAgainInRoute(const byte t_locoNum, const byte t_turnoutNum, const byte t_elementNum) {
   // Rev: 08/03/24.  NEEDS TO BE TESTED!
   // Does a given turnout occur (again) further ahead in this route (regardless of orientation)?
@@ -595,6 +649,7 @@ void Train_Progress::setNextToTripPtr(const byte t_locoNum, const byte t_nextToT
   }
   m_trainProgressLocoTableNum = t_locoNum - 1;  // m_trainProgressLocoTableNum 0..49 == t_locoNum 1..50
   m_pTrainProgress[m_trainProgressLocoTableNum].nextToTripPtr = t_nextToTripPtr;
+  m_pTrainProgress[m_trainProgressLocoTableNum].blockViewChanged = true;
   return;
 }
 
@@ -617,6 +672,7 @@ void Train_Progress::setTailPtr(const byte t_locoNum, const byte t_tailPtr) {
   }
   m_trainProgressLocoTableNum = t_locoNum - 1;  // m_trainProgressLocoTableNum 0..49 == t_locoNum 1..50
   m_pTrainProgress[m_trainProgressLocoTableNum].tailPtr = t_tailPtr;
+  m_pTrainProgress[m_trainProgressLocoTableNum].blockViewChanged = true;
   return;
 }
 
@@ -637,7 +693,8 @@ void Train_Progress::setLastTrippedPtr(const byte t_locoNum, const byte t_lastTr
 
 void Train_Progress::addRoute(const byte t_locoNum, const unsigned int t_routeRecNum, const char t_continuationOrExtension,
   const unsigned long t_countdown) {
-  // Rev: 08/07/24.  READY FOR TESTING -- I feel very good about this.
+  // Rev: 10/19/26.  READY FOR TESTING -- I feel very good about this.
+  // 10/19/26: The BE/BW check before overwriting VL01 on a forward Continuation was always fatal (|| instead of &&.)
   // *** Be sure to call pTrainProgress->display(locoNum) before and after adding a route, with every combination of Extension and
   // *** Continuation, with the new route starting in Forward and Reverse. ******************************************************************************
   // 08/07/24: New logic to handle Continuation route that starts in Reverse -- loco must stop before beginning new Route.
@@ -726,7 +783,7 @@ void Train_Progress::addRoute(const byte t_locoNum, const unsigned int t_routeRe
       // So just add 1 to the tempElementPtr and we'll be pointing at the block number we need the speed of
       byte blockElementPtr = incrementTrainProgressPtr(tempElementPtr);
       // It had better be a BE or BW record -- let's confirm.
-      if ((m_pTrainProgress[m_trainProgressLocoTableNum].route[blockElementPtr].routeRecType != BE) ||
+      if ((m_pTrainProgress[m_trainProgressLocoTableNum].route[blockElementPtr].routeRecType != BE) &&
           (m_pTrainProgress[m_trainProgressLocoTableNum].route[blockElementPtr].routeRecType != BW)) {
         sprintf(lcdString, "T.P. ER ERR C"); pLCD2004->println(lcdString); endWithFlashingLED(5);
       }
@@ -861,18 +918,21 @@ void Train_Progress::addRoute(const byte t_locoNum, const unsigned int t_routeRe
   m_pTrainProgress[m_trainProgressLocoTableNum].contPtr = tempElementPtr;     // Set new value for CONTINUATION pointer.
 
   // FINALLY, the entire new Continuation or Extension route has been added, and all 8 pointers are up to date.  Done!
+  m_pTrainProgress[m_trainProgressLocoTableNum].blockViewChanged = true;  // Head moved, and maybe NextToTrip.
   return;
 }
 
 byte Train_Progress::decrementTrainProgressPtr(const byte t_oldPtrVal) {
-  // Rev: 03/04/24.  COMPLETE BUT NEEDS TO BE TESTED.
+  // Rev: 10/19/26.
   // Gives us the rec num 0..139 (num route elements - 1) of the PREVIOUS element in Train Progress (regardless of loco.)
   // DOES NOT actually change the value of the pointer -- the caller should do that if desired.
   // Can be used for any Train Progress pointer such as headPtr, stationPtr, etc.
-  // Strange but true -- this magical hocus pokus will convert -1 into HEAP_RECS_TRAIN_PROGRESS - 1 (i.e. 139.)
-  // I.e. if HEAP_RECS_TRAIN_PROGRESS = 100, and we send t_oldPtrVal = 0, this function will return 99.
-  // Same as take mod of number and then check if the result is less than 0, if so, just add the modular number.
-  return (((t_oldPtrVal - 1) % HEAP_RECS_TRAIN_PROGRESS) + HEAP_RECS_TRAIN_PROGRESS) % HEAP_RECS_TRAIN_PROGRESS;
+  // 10/19/26: Was ((t_oldPtrVal - 1) % HEAP_RECS_TRAIN_PROGRESS ...), but HEAP_RECS_TRAIN_PROGRESS is unsigned, so -1 became
+  // 65535 and 0 wrapped back to 15 instead of 139.
+  if (t_oldPtrVal == 0) {
+    return HEAP_RECS_TRAIN_PROGRESS - 1;
+  }
+  return t_oldPtrVal - 1;
 }
 
 void Train_Progress::checkIfTrainProgressFull(const byte t_locoNum) {  // Check this loco's Train Progress buffer full
@@ -1,6 +1,10 @@
-// TRAIN_PROGRESS.H Rev: 08/22/24.  HEAP STORAGE.  Used by MAS, LEG, and OCC.  Not needed by SNS or LED.
+// TRAIN_PROGRESS.H Rev: 10/19/26.  HEAP STORAGE.  Used by MAS, LEG, and OCC.  Not needed by SNS or LED.
 // Part of O_MAS, O_OCC, and O_LEG.
 // Keeps track of the route and location of each train during Registration, Auto and Park modes.
+// 10/19/26: Added blockViewChanged() and getBlockView() so OCC's Occupancy_LEDs can re-scan only the locos whose Reserved or
+// Occupied blocks may have changed (route added, nextToTrip or tail moved, reset, etc.) rather than every loco on every sensor
+// change.  getBlockView() also moves the Reserved/Occupied scan into this class, where it belongs.
+// 10/19/26: getBlockView() returns blockBitmaps, so it's no longer limited to 32 blocks.
 // 08/04/24: Added lastTrippedPtr to Train Progress.  LEG needs to keep track of where the loco is located and I can't think of a
 // way to check that using nextToClearPtr, nextToTripPtr, stopPtr, headPtr, etc.
 // 08/05/24: Removed expectedStopTime field and functions as not needed for anything.
@@ -347,7 +351,7 @@ class Train_Progress {
                                                          // lastTrippedPtr for the loco, using the sensor pointer number.
     byte locoThatClearedSensor(const byte t_sensorNum);  // Returns locoNum whose next-to-clear sensor was cleared.
 
-    bool timeToStartLoco(const byte t_locoNum);  // Returns true if "timeToStart" > millis()
+    bool timeToStartLoco(const byte t_locoNum);  // Returns true once millis() has reached "timeToStart"
 
     void display(const byte t_locoNum);  // Sends one loco's Train Progress table to the Serial monitor.
 
@@ -392,6 +396,15 @@ class Train_Progress {
     // So we can release reservation if possible.
     // Requires t_elementNum so it knows where in Train Progress to start looking.
 
+    bool blockViewChanged(const byte t_locoNum);
+    // True if this loco's Reserved and/or Occupied blocks may have changed since getBlockView() was last called for it.  Set any
+    // time headPtr, nextToTripPtr, tailPtr or isActive change.  Used by OCC so it only re-scans locos that have moved.
+
+    void getBlockView(const byte t_locoNum, blockBitmap* t_reservedBlocks, blockBitmap* t_occupiedBlocks);
+    // Returns bit masks of this loco's Reserved (NextToTrip..Head) and Occupied (Tail..NextToTrip) blocks.
+    // A block that is both Reserved and Occupied (i.e. occurs more than once in the route) is returned as Occupied only.
+    // Returns zero masks for an inactive loco.  Clears the blockViewChanged() flag for this loco.
+
 // FUNCTIONS CALLED BY Occupancy_LEDs and maybe LEG Auto/Park.  Sloppy encapsulation, should be private, but okay for now...
 
     // Increment/Decrement Pointer functions return the next/prev rec num 0..139; they don't update the passed value.
@@ -443,6 +456,7 @@ private:
       byte          crawlPtr;        // Penultimate sensor must always slow to Crawl, turn on loco's bell, etc.
       byte          stopPtr;         // Last sensor in route, must always stop immediately when tripped.
       byte          lastTrippedPtr;  // Element of sensor that loco is sitting on, if stopped, or most recently tripped, if moving.
+      bool          blockViewChanged;  // Head, NextToTrip, Tail or isActive changed since last getBlockView().
       routeElement  route[HEAP_RECS_TRAIN_PROGRESS];  // 0..(HEAP_RECS_TRAIN_PROGRESS - 1) = 0..139.  I.e. BW03, TN23, VL00.
     };
 
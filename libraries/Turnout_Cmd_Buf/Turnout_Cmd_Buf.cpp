@@ -0,0 +1,101 @@
+// TURNOUT_CMD_BUF.CPP Rev: 10/19/26.
+// Part of O_SWT and O_LED.
+// Circular buffer of incoming "set turnout" commands, which coalesces superseded commands for the same turnout.  See header.
+
+#include "Turnout_Cmd_Buf.h"
+
+Turnout_Cmd_Buf::Turnout_Cmd_Buf() {  // Constructor
+  // Rev: 10/19/26.
+  Turnout_Cmd_Buf::begin();
+  return;
+}
+
+void Turnout_Cmd_Buf::begin() {
+  // Rev: 10/19/26.
+  m_head = 0;
+  m_tail = 0;
+  m_count = 0;
+  m_received = 0;
+  m_coalesced = 0;
+  m_dequeued = 0;
+  m_maxCount = 0;
+  return;
+}
+
+bool Turnout_Cmd_Buf::isEmpty() {
+  return (m_count == 0);
+}
+
+bool Turnout_Cmd_Buf::isFull() {
+  return (m_count == MAX_TURNOUTS_TO_BUF);
+}
+
+void Turnout_Cmd_Buf::enqueue(const byte t_turnoutNum, const char t_turnoutDir) {
+  // Rev: 10/19/26.
+  // If there is already a waiting command for this turnout, just update its direction (it keeps its place in line.)
+  // Otherwise insert a record at the head of the turnout command buffer, then increment head and count.
+  // If the buffer is already full, trigger a fatal error and terminate.
+  if ((t_turnoutNum < 1) || (t_turnoutNum > TOTAL_TURNOUTS) ||
+      ((t_turnoutDir != TURNOUT_DIR_NORMAL) && (t_turnoutDir != TURNOUT_DIR_REVERSE))) {
+    sprintf(lcdString, "Turnout buf error!"); pLCD2004->println(lcdString); Serial.println(lcdString); endWithFlashingLED(3);
+  }
+  m_received++;
+  for (byte i = 0; i < m_count; i++) {  // Look at each waiting record, oldest to newest
+    byte element = (m_tail + i) % MAX_TURNOUTS_TO_BUF;
+    if (m_turnoutCmdBuf[element].turnoutNum == t_turnoutNum) {
+      m_turnoutCmdBuf[element].turnoutDir = t_turnoutDir;  // Supersedes whatever was waiting for this turnout
+      m_coalesced++;
+      return;
+    }
+  }
+  if (!Turnout_Cmd_Buf::isFull()) {
+    m_turnoutCmdBuf[m_head].turnoutNum = t_turnoutNum;  // Store the turnout number 1..TOTAL_TURNOUTS
+    m_turnoutCmdBuf[m_head].turnoutDir = t_turnoutDir;  // Store the orientation Normal or Reverse
+    m_head = (m_head + 1) % MAX_TURNOUTS_TO_BUF;
+    m_count++;
+    if (m_count > m_maxCount) {
+      m_maxCount = m_count;
+    }
+  } else {
+    sprintf(lcdString, "Turnout buf ovflow!"); pLCD2004->println(lcdString); Serial.println(lcdString); endWithFlashingLED(3);
+  }
+  return;
+}
+
+bool Turnout_Cmd_Buf::dequeue(byte* t_turnoutNum, char* t_turnoutDir) {
+  // Rev: 10/19/26.
+  // Retrieve a record, if any, from the turnout command buffer.
+  // If the turnout command buffer is not empty, retrieves a record from the buffer and puts the retrieved data into the called
+  // parameters.
+  // Returns 'false' if buffer is empty, and the passed parameters remain undefined.  Not fatal.
+  // Data will be at tail, then tail will be incremented (modulo size), and count will be decremented.
+  if (Turnout_Cmd_Buf::peek(t_turnoutNum, t_turnoutDir)) {
+    m_tail = (m_tail + 1) % MAX_TURNOUTS_TO_BUF;
+    m_count--;
+    m_dequeued++;
+    return true;
+  } else {
+    return false;  // Turnout command buffer is empty
+  }
+}
+
+bool Turnout_Cmd_Buf::peek(byte* t_turnoutNum, char* t_turnoutDir) {
+  // Rev: 10/19/26.
+  // Same as dequeue() but leaves the record in the buffer.  Returns false if buffer is empty.
+  if (!Turnout_Cmd_Buf::isEmpty()) {
+    *t_turnoutNum = m_turnoutCmdBuf[m_tail].turnoutNum;
+    *t_turnoutDir = m_turnoutCmdBuf[m_tail].turnoutDir;
+    return true;
+  } else {
+    return false;  // Turnout command buffer is empty
+  }
+}
+
+void Turnout_Cmd_Buf::displayStats() {
+  // Rev: 10/19/26.
+  Serial.print(F("Turnout cmds rec'd: ")); Serial.print(m_received);
+  Serial.print(F(", coalesced: ")); Serial.print(m_coalesced);
+  Serial.print(F(", executed: ")); Serial.print(m_dequeued);
+  Serial.print(F(", max waiting: ")); Serial.println(m_maxCount);
+  return;
+}
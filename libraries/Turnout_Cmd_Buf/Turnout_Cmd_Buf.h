@@ -0,0 +1,68 @@
+// TURNOUT_CMD_BUF.H Rev: 10/19/26.
+// Part of O_SWT and O_LED.
+// Circular buffer of incoming RS485 "set turnout" commands from MAS, shared by SWT (which throws the turnout solenoids) and LED
+// (which paints the green turnout LEDs.)  Previously each module had its own identical copy of this code.
+// The reason we need to buffer is because we take a (relatively) long time to throw each turnout, whereas the RS485 messages
+// can flood in very quickly.
+// COALESCING: If a command arrives for a turnout that already has a command waiting in the buffer (not yet dequeued,) the waiting
+// command is simply updated with the new direction rather than adding another record.  Only the last orientation matters, so
+// this saves a solenoid firing (SWT) or a repaint (LED) every time an operator flips a turnout button several times in a row, or
+// MAS re-sends a turnout that's already waiting.  Commands for the same turnout are thus never executed out of order, and the
+// waiting command keeps its place in line.  Once a command has been dequeued (i.e. SWT is firing that solenoid) a new command
+// for the same turnout is a new record.
+// Since there can never be more than one waiting record per turnout, the buffer can never hold more than TOTAL_TURNOUTS records.
+// We used to allow MAX_TURNOUTS_TO_BUF = 80 records (routes for 10 trains x 8 turnouts) but that can't happen now.
+
+// DESCRIPTION OF CIRCULAR BUFFERS Rev: 9/5/17.  See also OneNote "Circular Buffers 8/20/17."
+// Each element is two bytes: byte turnoutNum and char turnoutDir.
+// We use CLOCKWISE circular buffers, and track HEAD, TAIL, and COUNT.
+// HEAD always points to the UNUSED cell where the next new element will be inserted (enqueued), UNLESS the queue is full,
+// in which case head points to tail and new data cannot be added until the tail data is dequeued.
+// TAIL always points to the last active element, UNLESS the queue is empty, in which case it points to garbage.
+// COUNT is the total number of active elements, which can range from zero to the size of the buffer.
+// Note that HEAD == TAIL *both* when the buffer is empty and when full, so we use COUNT as the test for full/empty status.
+
+#ifndef TURNOUT_CMD_BUF_H
+#define TURNOUT_CMD_BUF_H
+
+#include <Train_Consts_Global.h>
+#include <Train_Functions.h>
+#include <Display_2004.h>
+
+class Turnout_Cmd_Buf {
+
+  public:
+
+    Turnout_Cmd_Buf();  // Constructor must be called above setup() so the object will be global to the module.
+
+    void begin();  // Empty the buffer and reset the counters.
+
+    bool isEmpty();
+    bool isFull();
+    void enqueue(const byte t_turnoutNum, const char t_turnoutDir);  // Fatal error if buffer full (should be impossible.)
+    bool dequeue(byte* t_turnoutNum, char* t_turnoutDir);  // Returns false if buffer is empty.
+    bool peek(byte* t_turnoutNum, char* t_turnoutDir);     // Same as dequeue() but leaves the record in the buffer.
+
+    void displayStats();  // Send counts of commands received, coalesced, and dequeued to the Serial monitor.
+
+  private:
+
+    static const byte MAX_TURNOUTS_TO_BUF = TOTAL_TURNOUTS;  // At most one waiting command per turnout; see header.
+
+    byte m_head;   // Next array element to be written.
+    byte m_tail;   // Next array element to be removed.
+    byte m_count;  // Num active elements in buffer.  Max is MAX_TURNOUTS_TO_BUF.
+    struct turnoutCmdBufStruct {
+      byte turnoutNum;  // 1..TOTAL_TURNOUTS
+      char turnoutDir;  // 'N' = TURNOUT_DIR_NORMAL for Normal, 'R' = TURNOUT_DIR_REVERSE for Reverse
+    };
+    turnoutCmdBufStruct m_turnoutCmdBuf[MAX_TURNOUTS_TO_BUF];
+
+    unsigned int m_received;   // Commands passed to enqueue()
+    unsigned int m_coalesced;  // Commands that updated a waiting command rather than adding a new one
+    unsigned int m_dequeued;   // Commands actually executed (passed back by dequeue())
+    byte         m_maxCount;   // Most records ever waiting at once
+
+};
+
+#endif
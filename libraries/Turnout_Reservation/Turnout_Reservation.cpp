@@ -1,5 +1,7 @@
-// TURNOUT_RESERVATION.CPP Rev: 04/14/24.  FINISHED.
+// TURNOUT_RESERVATION.CPP Rev: 10/19/26.  FINISHED.
 // A set of functions to read and update the Turnout Reservation table, which is stored in FRAM.
+// 10/19/26: reservedBits() returns a turnoutBitmap.
+// 10/19/26: Added reservedBits().
 
 #include <Turnout_Reservation.h>
 
@@ -116,6 +118,19 @@ byte Turnout_Reservation::reservedForTrain(const byte t_turnoutNum) {
   return m_turnoutReservation.reservedForTrain;
 }
 
+turnoutBitmap Turnout_Reservation::reservedBits(const byte t_exceptLocoNum) {
+  // Rev: 10/19/26.
+  // Every turnout reserved for anyone but t_exceptLocoNum.  Pass LOCO_ID_NULL to get every reserved turnout.
+  turnoutBitmap reserved;
+  for (byte turnoutNum = 1; turnoutNum <= TOTAL_TURNOUTS; turnoutNum++) {
+    const byte locoNum = Turnout_Reservation::reservedForTrain(turnoutNum);
+    if ((locoNum != LOCO_ID_NULL) && (locoNum != t_exceptLocoNum)) {
+      reserved.set(turnoutNum);
+    }
+  }
+  return reserved;
+}
+
 void Turnout_Reservation::display(const byte t_turnoutNum) {
   // Rev: 01/25/23.
   // Display a single Turnout Reservation record; not the entire table.  For testing and debugging purposes only.
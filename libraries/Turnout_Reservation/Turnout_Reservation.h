@@ -1,6 +1,8 @@
-// TURNOUT_RESERVATION.H Rev: 04/14/24.  FINISHED.
+// TURNOUT_RESERVATION.H Rev: 10/19/26.  FINISHED.
 // A set of functions to read and update the Turnout Reservation table, which is stored in FRAM.
 // For modules *other than* SWT and LED.  I.e. for MAS, and possibly OCC and LEG (for use in tracking occupancy).
+// 10/19/26: reservedBits() returns a turnoutBitmap, so it isn't limited to 32 turnouts.
+// 10/19/26: Added reservedBits() for use with Route_Reference turnout bitmaps.
 // 04/14/24: Started using TURNOUT_DIR_NORMAL and TURNOUT_DIR_REVERSE instead of 'N' and 'R'
 // 04/14/24: Removed getTurnoutNumber as it was pointless -- you passed it the turnout number you wanted to retrieve!
 // 03/05/23: Renamed reserve() to reserveTurnout()
@@ -49,6 +51,9 @@ class Turnout_Reservation {
     // Return train number this turnout is currently reserved for, including LOCO_ID_NULL and LOCO_ID_STATIC.
     byte reservedForTrain(const byte t_turnoutNum);
 
+    // Return a bitmap with bit (n - 1) set for every Turnout n reserved for any train (incl. STATIC) other than t_exceptLocoNum.
+    turnoutBitmap reservedBits(const byte t_exceptLocoNum);
+
     void display(const byte t_turnoutNum);  // Display a single record to Serial COM.
     void populate();  // Special utility reads hard-coded data, writes records to FRAM.
 
@@ -67,6 +72,8 @@ class Turnout_Reservation {
       byte reservedForTrain;      // Variable: 0 = unreserved, TRAIN_STATIC = permanently reserved, 1..8 = train number
     };
     turnoutReservationStruct m_turnoutReservation;
+    static_assert(TOTAL_TURNOUTS * sizeof(turnoutReservationStruct) <= FRAM_BYTES_TURNOUT_RESN,
+                  "Turnout Reservation table overruns FRAM_BYTES_TURNOUT_RESN.");
 
     FRAM* m_pStorage;           // Pointer to the FRAM memory module
 